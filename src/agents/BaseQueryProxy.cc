@@ -11,6 +11,7 @@ using namespace agents;
 
 string BaseQueryProxy::ABORT = "abort";
 string BaseQueryProxy::ANSWER_BUNDLE = "answer_bundle";
+string BaseQueryProxy::BINARY_ANSWER_BUNDLE = "binary_answer_bundle";
 string BaseQueryProxy::FINISHED = "finished";
 
 string BaseQueryProxy::UNIQUE_ASSIGNMENT_FLAG = "unique_assignment_flag";
@@ -23,6 +24,7 @@ string BaseQueryProxy::USE_LINK_TEMPLATE_CACHE = "use_link_template_cache";
 string BaseQueryProxy::POPULATE_METTA_MAPPING = "populate_metta_mapping";
 string BaseQueryProxy::USE_METTA_AS_QUERY_TOKENS = "use_metta_as_query_tokens";
 string BaseQueryProxy::ALLOW_INCOMPLETE_CHAIN_PATH = "allow_incomplete_chain_path";
+string BaseQueryProxy::ANSWER_FORMAT_VERSION = "answer_format_version";
 
 BaseQueryProxy::BaseQueryProxy() {
     // constructor typically used in processor
@@ -85,10 +87,20 @@ bool BaseQueryProxy::finished() {
 
 void BaseQueryProxy::push(shared_ptr<QueryAnswer> answer) {
     lock_guard<mutex> semaphore(this->api_mutex);
-    this->answer_bundle_vector.push_back(answer->tokenize());
-    LOG_DEBUG("Answer pushed to bundle: " + answer->to_string() + " tokens: [" +
-              this->answer_bundle_vector.back() + "]");
-    if (this->answer_bundle_vector.size() >= this->parameters.get<unsigned int>(MAX_BUNDLE_SIZE)) {
+    unsigned int bundle_size;
+    // Peers which don't know the binary format don't send ANSWER_FORMAT_VERSION
+    if (this->parameters.get_or<unsigned int>(ANSWER_FORMAT_VERSION, 0) >=
+        BinaryAnswerWriter::BINARY_FORMAT_VERSION) {
+        this->binary_answer_bundle_writer.add(answer.get());
+        bundle_size = this->binary_answer_bundle_writer.size();
+        LOG_DEBUG("Answer pushed to binary bundle: " + answer->to_string());
+    } else {
+        this->answer_bundle_vector.push_back(answer->tokenize());
+        bundle_size = this->answer_bundle_vector.size();
+        LOG_DEBUG("Answer pushed to bundle: " + answer->to_string() + " tokens: [" +
+                  this->answer_bundle_vector.back() + "]");
+    }
+    if (bundle_size >= this->parameters.get<unsigned int>(MAX_BUNDLE_SIZE)) {
         flush_answer_bundle();
     }
 }
@@ -99,6 +111,12 @@ void BaseQueryProxy::flush_answer_bundle() {
         to_remote_peer(ANSWER_BUNDLE, this->answer_bundle_vector);
         this->answer_bundle_vector.clear();
     }
+    if (this->binary_answer_bundle_writer.size() > 0) {
+        // Command args are protobuf strings which must be valid UTF-8
+        to_remote_peer(BINARY_ANSWER_BUNDLE,
+                       {Utils::base64_encode(this->binary_answer_bundle_writer.buffer())});
+        this->binary_answer_bundle_writer.clear();
+    }
     Utils::sleep();  // TODO remove this
 }
 
@@ -187,11 +205,11 @@ void BaseQueryProxy::recursive_metta_mapping(string handle, map<string, string>&
 }
 
 void BaseQueryProxy::populate_metta_mapping(QueryAnswer* answer) {
-    for (string& handle : answer->get_handles_vector()) {
+    for (string handle : answer->get_handles_vector()) {
         recursive_metta_mapping(handle, answer->metta_expression);
     }
     for (unsigned int i = 0; i < answer->get_paths_size(); i++) {
-        for (string& handle : answer->get_path_vector(i)) {
+        for (string handle : answer->get_path_vector(i)) {
             recursive_metta_mapping(handle, answer->metta_expression);
         }
     }
@@ -208,6 +226,8 @@ bool BaseQueryProxy::from_remote_peer(const string& command, const vector<string
     } else {
         if (command == ANSWER_BUNDLE) {
             answer_bundle(args);
+        } else if (command == BINARY_ANSWER_BUNDLE) {
+            binary_answer_bundle(args);
         } else {
             return false;
         }
@@ -230,3 +250,22 @@ void BaseQueryProxy::answer_bundle(const vector<string>& args) {
         }
     }
 }
+
+void BaseQueryProxy::binary_answer_bundle(const vector<string>& args) {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    if (!this->is_aborting()) {
+        if (args.size() == 0) {
+            RAISE_ERROR("Invalid empty binary query answer bundle");
+        } else {
+            for (const string& encoded_bundle : args) {
+                string bundle = Utils::base64_decode(encoded_bundle);
+                BinaryAnswerReader reader(bundle);
+                QueryAnswer* query_answer;
+                while ((query_answer = reader.next()) != NULL) {
+                    this->answer_queue.enqueue((void*) query_answer);
+                    this->answer_count++;
+                }
+            }
+        }
+    }
+}
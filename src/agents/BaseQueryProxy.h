@@ -38,7 +38,8 @@ class BaseQueryProxy : public BaseProxy {
     // Constructors, destructors and static state
 
     // Commands allowed at the proxy level (caller <--> processor)
-    static string ANSWER_BUNDLE;  // Delivery of a bundle with QueryAnswer objects
+    static string ANSWER_BUNDLE;         // Delivery of a bundle with QueryAnswer objects
+    static string BINARY_ANSWER_BUNDLE;  // Same as ANSWER_BUNDLE in the binary format
     static string ABORT;          // Abort current query
     static string FINISHED;       // Notification that all query results have alkready been delivered
 
@@ -89,6 +90,11 @@ class BaseQueryProxy : public BaseProxy {
     static string ALLOW_INCOMPLETE_CHAIN_PATH;  // When true, CHAIN operator returns incomplete paths
                                                 // as well as complete ones.
 
+    static string ANSWER_FORMAT_VERSION;  // Latest version of the binary QueryAnswer format the
+                                          // caller is able to decode (0 means text format only).
+                                          // The processor answers in the binary format iff
+                                          // this is not older than the version it writes.
+
     /**
      * Destructor.
      */
@@ -210,6 +216,13 @@ class BaseQueryProxy : public BaseProxy {
      */
     void answer_bundle(const vector<string>& args);
 
+    /**
+     * Piggyback method called by BINARY_ANSWER_BUNDLE command
+     *
+     * @param args Command arguments (base64-encoded bundles built by BinaryAnswerWriter)
+     */
+    void binary_answer_bundle(const vector<string>& args);
+
     /**
      * Piggyback method called by FINISHED command
      *
@@ -229,6 +242,7 @@ class BaseQueryProxy : public BaseProxy {
     string context;
     vector<string> query_tokens;
     vector<string> answer_bundle_vector;
+    BinaryAnswerWriter binary_answer_bundle_writer;
     shared_ptr<AtomDB> atomdb;
 };
 
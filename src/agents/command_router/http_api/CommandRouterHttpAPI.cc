@@ -380,10 +380,9 @@ string CommandRouterHttpAPI::generate_execution_id() {
     static atomic<uint64_t> counter{0};
     auto ms = Utils::get_current_time_millis();
     auto seed = std::to_string(ms) + "-" + std::to_string(counter.fetch_add(1));
-    char* hash = compute_hash((char*) seed.c_str());
-    string execution_id = string("exec-") + hash;
-    delete[] hash;
-    return execution_id;
+    char hash[HANDLE_HASH_SIZE];
+    compute_hash_into(seed.data(), seed.size(), hash);
+    return string("exec-") + hash;
 }
 
 bool CommandRouterHttpAPI::is_valid_command(const string& command) const {
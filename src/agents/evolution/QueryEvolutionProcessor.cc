@@ -496,7 +496,7 @@ string QueryEvolutionProcessor::answer_to_string_2(shared_ptr<QueryAnswer> answe
         string path = "";
         vector<string> path_link = {" -> ", " -> "};
         bool first = true;
-        for (string& handle : answer->get_path_vector(i)) {
+        for (string handle : answer->get_path_vector(i)) {
             auto link = db->get_link(handle);
             if ((link == nullptr) || (link->arity() != 3)) {
                 return "Invalid link: " + handle;
@@ -532,7 +532,7 @@ string QueryEvolutionProcessor::answer_to_string_1(shared_ptr<QueryAnswer> answe
     string path = "";
     string path_link = " -> ";
     bool first = true;
-    for (string& handle : answer->get_path_vector(0)) {
+    for (string handle : answer->get_path_vector(0)) {
         auto link = db->get_link(handle);
         auto target1 = db->get_link(link->targets[1]);
         auto target2 = db->get_link(link->targets[2]);
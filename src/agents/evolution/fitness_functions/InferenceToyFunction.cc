@@ -23,8 +23,8 @@ float InferenceToyFunction::eval(shared_ptr<QueryAnswer> query_answer) {
     unsigned int num_paths = query_answer->get_paths_size();
     for (unsigned int path_index = 0; path_index < num_paths; path_index++) {
         LOG_DEBUG("Path index: " << path_index);
-        vector<string>& path = query_answer->get_path_vector(path_index);
-        for (string& handle : path) {
+        vector<CompactHandle>& path = query_answer->get_path_vector(path_index);
+        for (string handle : path) {
             atom = db->get_atom(handle);
             LOG_DEBUG("Link: " << atom->to_string());
             strength *= atom->custom_attributes.get_or<double>(STRENGTH_TAG, 1.0);
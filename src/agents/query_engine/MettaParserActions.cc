@@ -159,6 +159,11 @@ void MettaParserActions::expression_end(bool toplevel, const string& metta_expre
                 this->proxy->parameters.get<bool>(PatternMatchingQueryProxy::DISREGARD_IMPORTANCE_FLAG),
                 this->proxy->parameters.get<bool>(PatternMatchingQueryProxy::UNIQUE_VALUE_FLAG),
                 this->proxy->parameters.get<bool>(BaseQueryProxy::USE_LINK_TEMPLATE_CACHE));
+            new_link_template->set_cache_policy(
+                this->proxy->parameters.get<bool>(
+                    PatternMatchingQueryProxy::LINK_TEMPLATE_CACHE_REFRESH),
+                this->proxy->parameters.get<unsigned int>(
+                    PatternMatchingQueryProxy::LINK_TEMPLATE_CACHE_MAX_ENTRY_SIZE));
             this->element_stack.push(new_link_template);
         }
     } else if ((this->current_expression_type == AND) || (this->current_expression_type == ANDNOT) ||
@@ -188,10 +193,18 @@ void MettaParserActions::expression_end(bool toplevel, const string& metta_expre
             }
             if (this->current_expression_type == AND) {
                 LOG_DEBUG("Pushing AND");
-                new_operator = make_shared<And<2>>(clauses, link_templates, false);
+                new_operator = make_shared<And<2>>(
+                    clauses,
+                    link_templates,
+                    false,
+                    this->proxy->parameters.get<bool>(PatternMatchingQueryProxy::HASH_JOIN_FLAG));
             } else if (this->current_expression_type == ANDNOT) {
                 LOG_DEBUG("Pushing ANDNOT");
-                new_operator = make_shared<And<2>>(clauses, link_templates, true);
+                new_operator = make_shared<And<2>>(
+                    clauses,
+                    link_templates,
+                    true,
+                    this->proxy->parameters.get<bool>(PatternMatchingQueryProxy::HASH_JOIN_FLAG));
             } else {
                 LOG_DEBUG("Pushing OR");
                 new_operator = make_shared<Or<2>>(clauses, link_templates);
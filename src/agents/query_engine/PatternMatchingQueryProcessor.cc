@@ -20,6 +20,7 @@
 #include "Or.h"
 #include "Chain.h"
 #include "PatternMatchingQueryProxy.h"
+#include "QueryCostEstimator.h"
 #include "ServiceBus.h"
 #include "Sink.h"
 #include "StoppableThread.h"
@@ -160,12 +161,25 @@ void PatternMatchingQueryProcessor::process_query_answers(
     set<string>& joint_answer,  // used to stimulate attention broker
     unsigned int& answer_count) {
     QueryAnswer* answer;
-    unsigned int max_answers = proxy->parameters.get<unsigned int>(BaseQueryProxy::MAX_ANSWERS);
+    unsigned int answer_limit = get_answer_limit(proxy);
+    unsigned int offset = get_offset(proxy);
     bool populate_metta = proxy->parameters.get<bool>(BaseQueryProxy::POPULATE_METTA_MAPPING);
+    bool exists_flag = proxy->parameters.get_or<bool>(PatternMatchingQueryProxy::EXISTS_FLAG, false);
     while ((answer = query_sink->input_buffer->pop_query_answer()) != NULL) {
         answer_count++;
-        update_attention_broker_single_answer(proxy, answer, joint_answer);
-        if (proxy->parameters.get<bool>(PatternMatchingQueryProxy::COUNT_FLAG)) {
+        if (answer_count > offset) {
+            // Answers skipped because of the offset are never delivered so they don't stimulate
+            // the AttentionBroker
+            update_attention_broker_single_answer(proxy, answer, joint_answer);
+        }
+        if (exists_flag) {
+            // One answer is all an exists_only query needs
+            query_sink->cancellation_token->cancel();
+            delete answer;
+            return;
+        }
+        if (proxy->parameters.get<bool>(PatternMatchingQueryProxy::COUNT_FLAG) ||
+            (answer_count <= offset)) {
             delete answer;
         } else {
             if (populate_metta && answer->metta_expression.size() == 0) {
@@ -173,8 +187,10 @@ void PatternMatchingQueryProcessor::process_query_answers(
             }
             proxy->push(shared_ptr<QueryAnswer>(answer));
         }
-        if (answer_count == max_answers) {
-            LOG_INFO("Limit number of answers reached: " << max_answers);
+        if (answer_count == answer_limit) {
+            LOG_INFO("Limit number of answers reached: " << answer_limit);
+            // Elements upstream stop producing answers right away
+            query_sink->cancellation_token->cancel();
             proxy->flush_answer_bundle();
             proxy->abort({});
             return;
@@ -191,20 +207,39 @@ void PatternMatchingQueryProcessor::thread_process_one_query(
         LOG_DEBUG("Setting up query tree");
         LOG_INFO("Proxy: " << proxy->to_string());
         shared_ptr<QueryElement> root_query_element;
+        QueryCostEstimator estimator(
+            proxy->parameters.get_or<bool>(PatternMatchingQueryProxy::COST_BASED_JOIN_FLAG, false),
+            proxy->parameters.get_or<bool>(PatternMatchingQueryProxy::EXPLAIN_FLAG, false));
         if (proxy->parameters.get<bool>(BaseQueryProxy::USE_METTA_AS_QUERY_TOKENS)) {
             root_query_element = parse_metta_query(proxy);
         } else {
-            root_query_element = setup_query_tree(proxy);
+            root_query_element = setup_query_tree(proxy, estimator);
         }
         set<string> joint_answer;  // used to stimulate attention broker
         string command = proxy->get_command();
         if (root_query_element == NULL) {
             RAISE_ERROR("Invalid empty query tree.");
         } else {
-            if (command == ServiceBus::PATTERN_MATCHING_QUERY) {
+            if ((command == ServiceBus::PATTERN_MATCHING_QUERY) &&
+                proxy->parameters.get_or<bool>(PatternMatchingQueryProxy::EXPLAIN_FLAG, false)) {
+                explain_query(proxy, estimator, root_query_element);
+            } else if ((command == ServiceBus::PATTERN_MATCHING_QUERY) &&
+                       is_countable_by_index(proxy, root_query_element)) {
+                count_by_index(proxy, dynamic_pointer_cast<LinkTemplate>(root_query_element));
+            } else if (command == ServiceBus::PATTERN_MATCHING_QUERY) {
                 LinkTemplate* root_link_template = dynamic_cast<LinkTemplate*>(root_query_element.get());
                 shared_ptr<Sink> query_sink;
                 if (root_link_template != NULL) {
+                    const string& streaming_flag = PatternMatchingQueryProxy::IMPORTANCE_STREAMING_FLAG;
+                    if (proxy->parameters.get<bool>(streaming_flag) &&
+                        !proxy->parameters.get<bool>(PatternMatchingQueryProxy::COUNT_FLAG)) {
+                        root_link_template->set_top_k_streaming(
+                            get_answer_limit(proxy),
+                            proxy->parameters.get<unsigned int>(
+                                PatternMatchingQueryProxy::IMPORTANCE_CHUNK_SIZE));
+                    }
+                    // Answers beyond the limit would be discarded so they aren't even fetched
+                    root_link_template->set_answer_limit(get_answer_limit(proxy));
                     root_link_template->build();
                     query_sink = make_shared<Sink>(
                         root_link_template->get_source_element(),
@@ -217,17 +252,24 @@ void PatternMatchingQueryProcessor::thread_process_one_query(
                     LOG_DEBUG("Query tree sink Operator: " + query_sink->id);
                 }
                 unsigned int answer_count = 0;
+                bool exists_flag =
+                    proxy->parameters.get_or<bool>(PatternMatchingQueryProxy::EXISTS_FLAG, false);
                 LOG_DEBUG("Processing QueryAnswer objects");
-                while (!(query_sink->finished() || proxy->is_aborting())) {
+                while (!(query_sink->finished() || proxy->is_aborting() ||
+                         (exists_flag && (answer_count > 0)))) {
                     process_query_answers(proxy, query_sink, joint_answer, answer_count);
-                    Utils::sleep();
+                    query_sink->input_buffer->wait_query_answer();
                 }
+                // Elements still working on this query (e.g. when it's been aborted or max_answers
+                // has been reached) stop right away rather than when the query tree is shut down
+                query_sink->cancellation_token->cancel();
                 proxy->flush_answer_bundle();
                 STOP_WATCH_FINISH(benchmark_query_thread, "Benchmark::PatternMatchingQuery");
                 STOP_WATCH_FINISH(query_thread, "PatternMatchingQuery");
-                if (proxy->parameters.get<bool>(PatternMatchingQueryProxy::COUNT_FLAG) &&
+                if ((proxy->parameters.get<bool>(PatternMatchingQueryProxy::COUNT_FLAG) ||
+                     exists_flag) &&
                     (!proxy->is_aborting())) {
-                    LOG_DEBUG("Answering count_only query");
+                    LOG_DEBUG("Answering count_only (or exists_only) query");
                     proxy->to_remote_peer(PatternMatchingQueryProxy::COUNT,
                                           {std::to_string(answer_count)});
                 }
@@ -267,6 +309,66 @@ void PatternMatchingQueryProcessor::thread_process_one_query(
     LOG_DEBUG("Command finished: <" << proxy->get_command() << ">");
 }
 
+void PatternMatchingQueryProcessor::explain_query(shared_ptr<PatternMatchingQueryProxy> proxy,
+                                                  QueryCostEstimator& estimator,
+                                                  shared_ptr<QueryElement> root_query_element) {
+    // The query tree is built (so every element is estimated) but no Sink is attached to it, so
+    // nothing is actually fetched from the AtomDB
+    auto root_link_template = dynamic_pointer_cast<LinkTemplate>(root_query_element);
+    if (root_link_template != nullptr) {
+        root_link_template->build();
+        estimator.add_link_template(root_link_template);
+    }
+    LOG_DEBUG("Answering explain query");
+    proxy->to_remote_peer(PatternMatchingQueryProxy::EXPLAIN, estimator.explain(root_query_element));
+    Utils::sleep(500);
+    proxy->query_processing_finished();
+}
+
+unsigned int PatternMatchingQueryProcessor::get_offset(shared_ptr<PatternMatchingQueryProxy> proxy) {
+    if (proxy->parameters.get<bool>(PatternMatchingQueryProxy::COUNT_FLAG) ||
+        proxy->parameters.get_or<bool>(PatternMatchingQueryProxy::EXISTS_FLAG, false)) {
+        return 0;
+    }
+    return proxy->parameters.get_or<unsigned int>(PatternMatchingQueryProxy::OFFSET, 0);
+}
+
+unsigned int PatternMatchingQueryProcessor::get_answer_limit(
+    shared_ptr<PatternMatchingQueryProxy> proxy) {
+    unsigned int max_answers = proxy->parameters.get<unsigned int>(BaseQueryProxy::MAX_ANSWERS);
+    return (max_answers == 0 ? 0 : get_offset(proxy) + max_answers);
+}
+
+bool PatternMatchingQueryProcessor::is_countable_by_index(shared_ptr<PatternMatchingQueryProxy> proxy,
+                                                          shared_ptr<QueryElement> root_query_element) {
+    // Answers are required to stimulate the AttentionBroker and max_answers would be reached
+    // (which aborts the query) before the count is delivered
+    if ((!proxy->parameters.get<bool>(PatternMatchingQueryProxy::COUNT_FLAG) &&
+         !proxy->parameters.get_or<bool>(PatternMatchingQueryProxy::EXISTS_FLAG, false)) ||
+        (proxy->parameters.get<unsigned int>(BaseQueryProxy::ATTENTION_UPDATE) !=
+         BaseQueryProxy::NONE) ||
+        (proxy->parameters.get<unsigned int>(BaseQueryProxy::MAX_ANSWERS) != 0)) {
+        return false;
+    }
+    auto root_link_template = dynamic_pointer_cast<LinkTemplate>(root_query_element);
+    return (root_link_template != nullptr) && root_link_template->is_count_exact();
+}
+
+void PatternMatchingQueryProcessor::count_by_index(shared_ptr<PatternMatchingQueryProxy> proxy,
+                                                   shared_ptr<LinkTemplate> link_template) {
+    // No Sink is attached to the LinkTemplate so no link is fetched from the AtomDB
+    link_template->build();
+    unsigned int count = link_template->count_matching_links();
+    if (proxy->parameters.get_or<bool>(PatternMatchingQueryProxy::EXISTS_FLAG, false)) {
+        count = min(count, (unsigned int) 1);
+    }
+    LOG_DEBUG("Answering count_only (or exists_only) query using the pattern index");
+    proxy->to_remote_peer(PatternMatchingQueryProxy::COUNT, {std::to_string(count)});
+    Utils::sleep(500);
+    proxy->query_processing_finished();
+    LOG_INFO("Total counted answers: " << count);
+}
+
 void PatternMatchingQueryProcessor::remove_query_thread(const string& stoppable_thread_id) {
     lock_guard<mutex> semaphore(this->query_threads_mutex);
     this->query_threads.erase(this->query_threads.find(stoppable_thread_id));
@@ -299,7 +401,7 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::parse_metta_query(
 }
 
 shared_ptr<QueryElement> PatternMatchingQueryProcessor::setup_query_tree(
-    shared_ptr<PatternMatchingQueryProxy> proxy) {
+    shared_ptr<PatternMatchingQueryProxy> proxy, QueryCostEstimator& estimator) {
     stack<unsigned int> execution_stack;
     stack<shared_ptr<QueryElement>> element_stack;
     unsigned int cursor = 0;
@@ -347,22 +449,25 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::setup_query_tree(
         } else if (query_tokens[cursor] == LinkSchema::LINK_TEMPLATE) {
             element_stack.push(build_link_template(proxy, cursor, element_stack));
         } else if (query_tokens[cursor] == AND) {
-            element_stack.push(build_and(proxy, false, cursor, element_stack));
+            element_stack.push(build_and(proxy, false, cursor, element_stack, estimator));
             if (proxy->parameters.get<bool>(BaseQueryProxy::UNIQUE_ASSIGNMENT_FLAG)) {
-                element_stack.push(build_unique_assignment_filter(proxy, cursor, element_stack));
+                element_stack.push(
+                    build_unique_assignment_filter(proxy, cursor, element_stack, estimator));
             }
         } else if (query_tokens[cursor] == ANDNOT) {
-            element_stack.push(build_and(proxy, true, cursor, element_stack));
+            element_stack.push(build_and(proxy, true, cursor, element_stack, estimator));
             if (proxy->parameters.get<bool>(BaseQueryProxy::UNIQUE_ASSIGNMENT_FLAG)) {
-                element_stack.push(build_unique_assignment_filter(proxy, cursor, element_stack));
+                element_stack.push(
+                    build_unique_assignment_filter(proxy, cursor, element_stack, estimator));
             }
         } else if (query_tokens[cursor] == OR) {
-            element_stack.push(build_or(proxy, cursor, element_stack));
+            element_stack.push(build_or(proxy, cursor, element_stack, estimator));
             if (proxy->parameters.get<bool>(BaseQueryProxy::UNIQUE_ASSIGNMENT_FLAG)) {
-                element_stack.push(build_unique_assignment_filter(proxy, cursor, element_stack));
+                element_stack.push(
+                    build_unique_assignment_filter(proxy, cursor, element_stack, estimator));
             }
         } else if (query_tokens[cursor] == CHAIN) {
-            element_stack.push(build_chain(proxy, cursor, element_stack));
+            element_stack.push(build_chain(proxy, cursor, element_stack, estimator));
         } else {
             RAISE_ERROR("Invalid token <" + query_tokens[cursor] +
                         "> in PATTERN_MATCHING_QUERY message. Query: " + Utils::join(query_tokens) +
@@ -406,38 +511,38 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_link_template(
         proxy->parameters.get<bool>(PatternMatchingQueryProxy::DISREGARD_IMPORTANCE_FLAG),
         proxy->parameters.get<bool>(PatternMatchingQueryProxy::UNIQUE_VALUE_FLAG),
         proxy->parameters.get<bool>(BaseQueryProxy::USE_LINK_TEMPLATE_CACHE));
+    link_template->set_cache_policy(
+        proxy->parameters.get<bool>(PatternMatchingQueryProxy::LINK_TEMPLATE_CACHE_REFRESH),
+        proxy->parameters.get<unsigned int>(
+            PatternMatchingQueryProxy::LINK_TEMPLATE_CACHE_MAX_ENTRY_SIZE));
     LOG_DEBUG("New LinkTemplate: " + link_template->to_string());
     LOG_DEBUG("Building LinkTemplate... Done.");
     return link_template;
 }
 
-#define BUILD_AND(N, AND_NOT_FLAG)                                                                \
+#define BUILD_AND(N, AND_NOT_FLAG, HASH_JOIN_FLAG)                                                \
     {                                                                                             \
         vector<shared_ptr<QueryElement>> link_templates;                                          \
         array<shared_ptr<QueryElement>, N> clauses;                                               \
         for (unsigned int i = 0; i < N; i++) {                                                    \
-            LinkTemplate* link_template = dynamic_cast<LinkTemplate*>(element_stack.top().get()); \
+            LinkTemplate* link_template = dynamic_cast<LinkTemplate*>(operands[i].get());         \
             if (link_template != NULL) {                                                          \
-                link_templates.push_back(element_stack.top());                                    \
-                link_template->build();                                                           \
+                link_templates.push_back(operands[i]);                                            \
                 clauses[i] = link_template->get_source_element();                                 \
             } else {                                                                              \
-                if (element_stack.top()->is_operator) {                                           \
-                    clauses[i] = element_stack.top();                                             \
-                } else {                                                                          \
-                    RAISE_ERROR("All AND clauses are supposed to be LinkTemplate or Operator");   \
-                }                                                                                 \
+                clauses[i] = operands[i];                                                         \
             }                                                                                     \
-            element_stack.pop();                                                                  \
         }                                                                                         \
-        return make_shared<And<N>>(clauses, link_templates, AND_NOT_FLAG);                        \
+        and_operator = make_shared<And<N>>(clauses, link_templates, AND_NOT_FLAG, HASH_JOIN_FLAG); \
+        break;                                                                                    \
     }
 
 shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_and(
     shared_ptr<PatternMatchingQueryProxy> proxy,
     bool and_not_flag,
     unsigned int cursor,
-    stack<shared_ptr<QueryElement>>& element_stack) {
+    stack<shared_ptr<QueryElement>>& element_stack,
+    QueryCostEstimator& estimator) {
     const vector<string> query_tokens = proxy->get_query_tokens();
     unsigned int num_clauses = std::stoi(query_tokens[cursor + 1]);
     if (element_stack.size() < num_clauses) {
@@ -446,24 +551,30 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_and(
             "Query: " +
             Utils::join(query_tokens) + " near token at position: " + std::to_string(cursor));
     }
+    if ((num_clauses == 0) || (num_clauses > 10)) {
+        RAISE_ERROR("PATTERN_MATCHING_QUERY message: max supported num_clauses for AND: 10");
+    }
+    vector<shared_ptr<QueryElement>> operands =
+        pop_operands(num_clauses, "AND", element_stack, estimator);
+    bool hash_join_flag = estimator.use_hash_join(
+        operands, and_not_flag, proxy->parameters.get<bool>(PatternMatchingQueryProxy::HASH_JOIN_FLAG));
+    shared_ptr<QueryElement> and_operator;
     // clang-format off
     switch (num_clauses) {
-        case  1: BUILD_AND(1, and_not_flag)
-        case  2: BUILD_AND(2, and_not_flag)
-        case  3: BUILD_AND(3, and_not_flag)
-        case  4: BUILD_AND(4, and_not_flag)
-        case  5: BUILD_AND(5, and_not_flag)
-        case  6: BUILD_AND(6, and_not_flag)
-        case  7: BUILD_AND(7, and_not_flag)
-        case  8: BUILD_AND(8, and_not_flag)
-        case  9: BUILD_AND(9, and_not_flag)
-        case 10: BUILD_AND(10, and_not_flag)
+        case  1: BUILD_AND(1, and_not_flag, hash_join_flag)
+        case  2: BUILD_AND(2, and_not_flag, hash_join_flag)
+        case  3: BUILD_AND(3, and_not_flag, hash_join_flag)
+        case  4: BUILD_AND(4, and_not_flag, hash_join_flag)
+        case  5: BUILD_AND(5, and_not_flag, hash_join_flag)
+        case  6: BUILD_AND(6, and_not_flag, hash_join_flag)
+        case  7: BUILD_AND(7, and_not_flag, hash_join_flag)
+        case  8: BUILD_AND(8, and_not_flag, hash_join_flag)
+        case  9: BUILD_AND(9, and_not_flag, hash_join_flag)
+        case 10: BUILD_AND(10, and_not_flag, hash_join_flag)
         // clang-format on
-        default: {
-            RAISE_ERROR("PATTERN_MATCHING_QUERY message: max supported num_clauses for AND: 10");
-        }
     }
-    return NULL;  // Just to avoid warnings. This is not actually reachable.
+    estimator.add_and(and_operator, operands, and_not_flag, hash_join_flag);
+    return and_operator;
 }
 
 #define BUILD_OR(N)                                                                               \
@@ -471,29 +582,24 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_and(
         vector<shared_ptr<QueryElement>> link_templates;                                          \
         array<shared_ptr<QueryElement>, N> clauses;                                               \
         for (unsigned int i = 0; i < N; i++) {                                                    \
-            LinkTemplate* link_template = dynamic_cast<LinkTemplate*>(element_stack.top().get()); \
+            LinkTemplate* link_template = dynamic_cast<LinkTemplate*>(operands[i].get());         \
             if (link_template != NULL) {                                                          \
-                link_templates.push_back(element_stack.top());                                    \
-                link_template->build();                                                           \
+                link_templates.push_back(operands[i]);                                            \
                 clauses[i] = link_template->get_source_element();                                 \
-                LOG_DEBUG("OR input[" << i << "]: " << element_stack.top()->to_string());         \
             } else {                                                                              \
-                if (element_stack.top()->is_operator) {                                           \
-                    clauses[i] = element_stack.top();                                             \
-                    LOG_DEBUG("OR input[" << i << "]: " << element_stack.top()->to_string());     \
-                } else {                                                                          \
-                    RAISE_ERROR("All OR clauses are supposed to be LinkTemplate or Operator");    \
-                }                                                                                 \
+                clauses[i] = operands[i];                                                         \
             }                                                                                     \
-            element_stack.pop();                                                                  \
+            LOG_DEBUG("OR input[" << i << "]: " << operands[i]->to_string());                     \
         }                                                                                         \
-        return make_shared<Or<N>>(clauses, link_templates);                                       \
+        or_operator = make_shared<Or<N>>(clauses, link_templates);                                \
+        break;                                                                                    \
     }
 
 shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_or(
     shared_ptr<PatternMatchingQueryProxy> proxy,
     unsigned int cursor,
-    stack<shared_ptr<QueryElement>>& element_stack) {
+    stack<shared_ptr<QueryElement>>& element_stack,
+    QueryCostEstimator& estimator) {
     LOG_DEBUG("Building OR operator");
     const vector<string> query_tokens = proxy->get_query_tokens();
     unsigned int num_clauses = std::stoi(query_tokens[cursor + 1]);
@@ -502,6 +608,12 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_or(
             "PATTERN_MATCHING_QUERY message: parse error in tokens - too few arguments for OR. Query: " +
             Utils::join(query_tokens) + " near token at position: " + std::to_string(cursor));
     }
+    if ((num_clauses == 0) || (num_clauses > 10)) {
+        RAISE_ERROR("PATTERN_MATCHING_QUERY message: max supported num_clauses for OR: 10");
+    }
+    vector<shared_ptr<QueryElement>> operands =
+        pop_operands(num_clauses, "OR", element_stack, estimator);
+    shared_ptr<QueryElement> or_operator;
     // clang-format off
     switch (num_clauses) {
         case  1: BUILD_OR(1)
@@ -515,17 +627,38 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_or(
         case  9: BUILD_OR(9)
         case 10: BUILD_OR(10)
         // clang-format on
-        default: {
-            RAISE_ERROR("PATTERN_MATCHING_QUERY message: max supported num_clauses for OR: 10");
+    }
+    estimator.add_or(or_operator, operands);
+    return or_operator;
+}
+
+vector<shared_ptr<QueryElement>> PatternMatchingQueryProcessor::pop_operands(
+    unsigned int num_operands,
+    const string& operator_name,
+    stack<shared_ptr<QueryElement>>& element_stack,
+    QueryCostEstimator& estimator) {
+    vector<shared_ptr<QueryElement>> operands;
+    for (unsigned int i = 0; i < num_operands; i++) {
+        shared_ptr<QueryElement> element = element_stack.top();
+        shared_ptr<LinkTemplate> link_template = dynamic_pointer_cast<LinkTemplate>(element);
+        if (link_template != nullptr) {
+            link_template->build();
+            estimator.add_link_template(link_template);
+        } else if (!element->is_operator) {
+            RAISE_ERROR("All " + operator_name +
+                        " clauses are supposed to be LinkTemplate or Operator");
         }
+        operands.push_back(element);
+        element_stack.pop();
     }
-    return NULL;  // Just to avoid warnings. This is not actually reachable.
+    return operands;
 }
 
 shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_chain(
     shared_ptr<PatternMatchingQueryProxy> proxy,
     unsigned int cursor,
-    stack<shared_ptr<QueryElement>>& element_stack) {
+    stack<shared_ptr<QueryElement>>& element_stack,
+    QueryCostEstimator& estimator) {
     LOG_DEBUG("Building CHAIN operator...");
     const vector<string> query_tokens = proxy->get_query_tokens();
     QueryAnswerElement link_selector;
@@ -582,10 +715,12 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_chain(
     LOG_DEBUG(string("Allow incomplete paths: ") + (incomplete_flag ? "true" : "false"));
 
     array<shared_ptr<QueryElement>, 1> clauses;
-    clauses[0] = element_stack.top();
+    shared_ptr<QueryElement> input = element_stack.top();
+    clauses[0] = input;
     shared_ptr<LinkTemplate> link_template = dynamic_pointer_cast<LinkTemplate>(clauses[0]);
     if (link_template != nullptr) {
         link_template->build();
+        estimator.add_link_template(link_template);
         clauses[0] = link_template->get_source_element();
     }
     LOG_DEBUG("Input: " + clauses[0]->to_string());
@@ -600,7 +735,11 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_chain(
                            link_selector,
                            tail_reference,
                            head_reference,
-                           incomplete_flag);
+                           incomplete_flag,
+                           proxy->parameters.get_or<unsigned int>(
+                               PatternMatchingQueryProxy::CHAIN_EXPANSION_WORKERS,
+                               Chain::DEFAULT_EXPANSION_WORKERS));
+    estimator.add_unary(chain_operator, input, "CHAIN");
     LOG_DEBUG("Building CHAIN operator... DONE");
 
     return chain_operator;
@@ -629,7 +768,8 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_link(
 shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_unique_assignment_filter(
     shared_ptr<PatternMatchingQueryProxy> proxy,
     unsigned int cursor,
-    stack<shared_ptr<QueryElement>>& element_stack) {
+    stack<shared_ptr<QueryElement>>& element_stack,
+    QueryCostEstimator& estimator) {
     if (element_stack.size() < 1) {
         RAISE_ERROR(
             ("PATTERN_MATCHING_QUERY message: parse error in tokens - too few arguments for "
@@ -640,5 +780,7 @@ shared_ptr<QueryElement> PatternMatchingQueryProcessor::build_unique_assignment_
 
     shared_ptr<QueryElement> input = element_stack.top();
     element_stack.pop();
-    return make_shared<UniqueAssignmentFilter>(input);
+    auto filter = make_shared<UniqueAssignmentFilter>(input);
+    estimator.add_unary(filter, input, "UNIQUE_ASSIGNMENT_FILTER");
+    return filter;
 }
@@ -9,6 +9,7 @@
 #include "AtomDBSingleton.h"
 #include "BusCommandProcessor.h"
 #include "PatternMatchingQueryProxy.h"
+#include "QueryCostEstimator.h"
 #include "QueryElement.h"
 #include "Sink.h"
 #include "StoppableThread.h"
@@ -53,9 +54,25 @@ class PatternMatchingQueryProcessor : public BusCommandProcessor {
                                set<string>& joint_answer,
                                unsigned int& answer_count);
     shared_ptr<QueryElement> parse_metta_query(shared_ptr<PatternMatchingQueryProxy> proxy);
-    shared_ptr<QueryElement> setup_query_tree(shared_ptr<PatternMatchingQueryProxy> proxy);
+    shared_ptr<QueryElement> setup_query_tree(shared_ptr<PatternMatchingQueryProxy> proxy,
+                                              QueryCostEstimator& estimator);
     void thread_process_one_query(shared_ptr<StoppableThread>,
                                   shared_ptr<PatternMatchingQueryProxy> proxy);
+    void explain_query(shared_ptr<PatternMatchingQueryProxy> proxy,
+                       QueryCostEstimator& estimator,
+                       shared_ptr<QueryElement> root_query_element);
+    // Number of answers skipped before the first one delivered to the caller
+    unsigned int get_offset(shared_ptr<PatternMatchingQueryProxy> proxy);
+    // Number of answers processed before the query is aborted (0 means no limit)
+    unsigned int get_answer_limit(shared_ptr<PatternMatchingQueryProxy> proxy);
+    bool is_countable_by_index(shared_ptr<PatternMatchingQueryProxy> proxy,
+                               shared_ptr<QueryElement> root_query_element);
+    void count_by_index(shared_ptr<PatternMatchingQueryProxy> proxy,
+                        shared_ptr<LinkTemplate> link_template);
+    vector<shared_ptr<QueryElement>> pop_operands(unsigned int num_operands,
+                                                  const string& operator_name,
+                                                  stack<shared_ptr<QueryElement>>& element_stack,
+                                                  QueryCostEstimator& estimator);
     shared_ptr<QueryElement> build_link_template(shared_ptr<PatternMatchingQueryProxy> proxy,
                                                  unsigned int cursor,
                                                  stack<shared_ptr<QueryElement>>& element_stack);
@@ -67,15 +84,18 @@ class PatternMatchingQueryProcessor : public BusCommandProcessor {
     shared_ptr<QueryElement> build_and(shared_ptr<PatternMatchingQueryProxy> proxy,
                                        bool and_not_flag,
                                        unsigned int cursor,
-                                       stack<shared_ptr<QueryElement>>& element_stack);
+                                       stack<shared_ptr<QueryElement>>& element_stack,
+                                       QueryCostEstimator& estimator);
 
     shared_ptr<QueryElement> build_or(shared_ptr<PatternMatchingQueryProxy> proxy,
                                       unsigned int cursor,
-                                      stack<shared_ptr<QueryElement>>& element_stack);
+                                      stack<shared_ptr<QueryElement>>& element_stack,
+                                      QueryCostEstimator& estimator);
 
     shared_ptr<QueryElement> build_chain(shared_ptr<PatternMatchingQueryProxy> proxy,
                                          unsigned int cursor,
-                                         stack<shared_ptr<QueryElement>>& element_stack);
+                                         stack<shared_ptr<QueryElement>>& element_stack,
+                                         QueryCostEstimator& estimator);
 
     shared_ptr<QueryElement> build_link(shared_ptr<PatternMatchingQueryProxy> proxy,
                                         unsigned int cursor,
@@ -84,7 +104,8 @@ class PatternMatchingQueryProcessor : public BusCommandProcessor {
     shared_ptr<QueryElement> build_unique_assignment_filter(
         shared_ptr<PatternMatchingQueryProxy> proxy,
         unsigned int cursor,
-        stack<shared_ptr<QueryElement>>& element_stack);
+        stack<shared_ptr<QueryElement>>& element_stack,
+        QueryCostEstimator& estimator);
 
     void remove_query_thread(const string& stoppable_thread_id);
 
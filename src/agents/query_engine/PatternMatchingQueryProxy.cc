@@ -12,11 +12,23 @@ using namespace query_engine;
 // Constructors, destructors and initialization
 
 string PatternMatchingQueryProxy::COUNT = "count";
+string PatternMatchingQueryProxy::EXPLAIN = "explain";
 
 string PatternMatchingQueryProxy::POSITIVE_IMPORTANCE_FLAG = "positive_importance_flag";
 string PatternMatchingQueryProxy::DISREGARD_IMPORTANCE_FLAG = "disregard_importance_flag";
 string PatternMatchingQueryProxy::UNIQUE_VALUE_FLAG = "unique_value_flag";
 string PatternMatchingQueryProxy::COUNT_FLAG = "count_flag";
+string PatternMatchingQueryProxy::EXISTS_FLAG = "exists_flag";
+string PatternMatchingQueryProxy::OFFSET = "offset";
+string PatternMatchingQueryProxy::HASH_JOIN_FLAG = "hash_join_flag";
+string PatternMatchingQueryProxy::LINK_TEMPLATE_CACHE_REFRESH = "link_template_cache_refresh";
+string PatternMatchingQueryProxy::LINK_TEMPLATE_CACHE_MAX_ENTRY_SIZE =
+    "link_template_cache_max_entry_size";
+string PatternMatchingQueryProxy::IMPORTANCE_STREAMING_FLAG = "importance_streaming_flag";
+string PatternMatchingQueryProxy::IMPORTANCE_CHUNK_SIZE = "importance_chunk_size";
+string PatternMatchingQueryProxy::COST_BASED_JOIN_FLAG = "cost_based_join_flag";
+string PatternMatchingQueryProxy::EXPLAIN_FLAG = "explain_flag";
+string PatternMatchingQueryProxy::CHAIN_EXPANSION_WORKERS = "chain_expansion_workers";
 
 PatternMatchingQueryProxy::PatternMatchingQueryProxy() {
     // constructor typically used in processor
@@ -43,14 +55,19 @@ PatternMatchingQueryProxy::~PatternMatchingQueryProxy() {}
 
 shared_ptr<QueryAnswer> PatternMatchingQueryProxy::pop() {
     lock_guard<mutex> semaphore(this->api_mutex);
-    if (this->parameters.get<bool>(COUNT_FLAG)) {
-        RAISE_ERROR("Can't pop QueryAnswers from count_only queries.");
+    if (this->parameters.get<bool>(COUNT_FLAG) || this->parameters.get_or<bool>(EXISTS_FLAG, false)) {
+        RAISE_ERROR("Can't pop QueryAnswers from count_only or exists_only queries.");
         return shared_ptr<QueryAnswer>(NULL);
     } else {
         return BaseQueryProxy::pop();
     }
 }
 
+vector<string> PatternMatchingQueryProxy::get_query_plan() {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    return this->query_plan;
+}
+
 // -------------------------------------------------------------------------------------------------
 // Server-side API
 
@@ -69,6 +86,9 @@ bool PatternMatchingQueryProxy::from_remote_peer(const string& command, const ve
         if (command == COUNT) {
             count_answer(args);
             return true;
+        } else if (command == EXPLAIN) {
+            explain_answer(args);
+            return true;
         } else {
             RAISE_ERROR("Invalid proxy command: <" + command + ">");
             return false;
@@ -82,10 +102,22 @@ void PatternMatchingQueryProxy::count_answer(const vector<string>& args) {
         if (args.size() != 1) {
             RAISE_ERROR("Invalid args for count command");
         }
-        if (!this->parameters.get<bool>(COUNT_FLAG)) {
-            RAISE_ERROR("Invalid count command. Query is not count_only.");
+        if (!this->parameters.get<bool>(COUNT_FLAG) &&
+            !this->parameters.get_or<bool>(EXISTS_FLAG, false)) {
+            RAISE_ERROR("Invalid count command. Query is not count_only or exists_only.");
         } else {
             this->set_count(stoi(args[0]));
         }
     }
 }
+
+void PatternMatchingQueryProxy::explain_answer(const vector<string>& args) {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    if (!this->is_aborting()) {
+        if (!this->parameters.get_or<bool>(EXPLAIN_FLAG, false)) {
+            RAISE_ERROR("Invalid explain command. Query is not an explain query.");
+        } else {
+            this->query_plan = args;
+        }
+    }
+}
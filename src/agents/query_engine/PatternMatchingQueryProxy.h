@@ -29,7 +29,8 @@ class PatternMatchingQueryProxy : public BaseQueryProxy {
     // Constructors, destructors and static state
 
     // Commands allowed at the proxy level (caller <--> processor)
-    static string COUNT;  // Delivery of the final result of a count_only query
+    static string COUNT;    // Delivery of the final result of a count_only query
+    static string EXPLAIN;  // Delivery of the query plan of an explain query
 
     // Query command's optional parameters
     static string POSITIVE_IMPORTANCE_FLAG;   // Indicates that only answers whose importance > 0
@@ -51,6 +52,48 @@ class PatternMatchingQueryProxy : public BaseQueryProxy {
     static string COUNT_FLAG;  // Indicates that this query is supposed to count the results and not
                                // actually provide the query answers (i.e. no QueryAnswer is sent
                                // from the command executor and the caller of the query).
+                               // Queries made of a single LinkTemplate are counted straight from
+                               // the AtomDB pattern index whenever that count is exact.
+
+    static string EXISTS_FLAG;  // Like COUNT_FLAG but the query stops as soon as the first answer is
+                                // found, so the count delivered to the caller is either 0 or 1.
+
+    static string OFFSET;  // Number of answers skipped (i.e. not delivered to the caller) before
+                           // the first delivered one. Used together with max_answers to paginate
+                           // query results. Ignored by count_only and exists_only queries.
+
+    static string HASH_JOIN_FLAG;  // When true, AND operators combine the answers of their clauses
+                                   // using a symmetric hash join on the variables shared by the
+                                   // clauses instead of evaluating all the combinations of answers.
+
+    static string LINK_TEMPLATE_CACHE_REFRESH;  // When true (and the LinkTemplate cache is enabled),
+                                                // cached results are disregarded and replaced by
+                                                // the ones fetched from the AtomDB.
+
+    static string LINK_TEMPLATE_CACHE_MAX_ENTRY_SIZE;  // LinkTemplate results with more links than
+                                                       // this are not cached (0 means no limit).
+
+    static string IMPORTANCE_STREAMING_FLAG;  // When true and the query is a single LinkTemplate,
+                                              // importance is requested in chunks and a heap
+                                              // bounded to max_answers keeps the top links seen
+                                              // across the chunks, instead of fetching the
+                                              // importance of all the links and sorting them.
+                                              // Answers are the exact top max_answers links.
+
+    static string IMPORTANCE_CHUNK_SIZE;  // Number of links whose importance is requested at once
+                                          // when IMPORTANCE_STREAMING_FLAG is true.
+
+    static string COST_BASED_JOIN_FLAG;  // When true, the join strategy of AND operators is
+                                         // chosen using cardinality estimates from the AtomDB
+                                         // (see QueryCostEstimator) rather than by
+                                         // HASH_JOIN_FLAG alone.
+
+    static string EXPLAIN_FLAG;  // When true, the query is not executed. The query plan (elements
+                                 // of the query tree with their estimated number of answers and
+                                 // join strategies) is sent back instead (see get_query_plan()).
+
+    static string CHAIN_EXPANSION_WORKERS;  // Number of tasks expanding paths in each search
+                                            // direction of CHAIN operators.
 
     /**
      * Empty constructor typically used on server side.
@@ -83,6 +126,14 @@ class PatternMatchingQueryProxy : public BaseQueryProxy {
      */
     virtual shared_ptr<QueryAnswer> pop();
 
+    /**
+     * Returns the query plan sent back by an explain query (see EXPLAIN_FLAG), one line per
+     * element of the query tree. It's empty until the query is finished.
+     *
+     * @return The query plan sent back by an explain query.
+     */
+    vector<string> get_query_plan();
+
     // ---------------------------------------------------------------------------------------------
     // Server-side API
 
@@ -111,10 +162,18 @@ class PatternMatchingQueryProxy : public BaseQueryProxy {
      */
     void count_answer(const vector<string>& args);
 
+    /**
+     * Piggyback method called by EXPLAIN command
+     *
+     * @param args Command arguments (the lines of the query plan)
+     */
+    void explain_answer(const vector<string>& args);
+
    private:
     void init();
 
     mutex api_mutex;
+    vector<string> query_plan;
 };
 
 }  // namespace query_engine
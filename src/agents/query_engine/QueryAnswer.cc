@@ -28,6 +28,13 @@ QueryAnswer::QueryAnswer(const string& handle, double importance) {
     this->strength = 0;
 }
 
+QueryAnswer::QueryAnswer(const Handle& handle, double importance) {
+    this->importance = importance;
+    this->handles.push_back({});
+    this->handles[0].push_back(handle);
+    this->strength = 0;
+}
+
 QueryAnswer::~QueryAnswer() {}
 
 QueryAnswer* QueryAnswer::copy(QueryAnswer* other) {  // Static method
@@ -78,9 +85,9 @@ bool QueryAnswer::merge(QueryAnswer* other,
                 RAISE_ERROR("Invalid importance merger function");
             }
             this->strength = this->strength * other->strength;
-            for (string handle1 : other->handles[0]) {
+            for (const CompactHandle& handle1 : other->handles[0]) {
                 bool flag = true;
-                for (string handle2 : this->handles[0]) {
+                for (const CompactHandle& handle2 : this->handles[0]) {
                     if (handle1 == handle2) {
                         flag = false;
                     }
@@ -89,8 +96,11 @@ bool QueryAnswer::merge(QueryAnswer* other,
                     this->handles[0].push_back(handle1);
                 }
                 // Only merge if the other has a non-empty metta expression
-                if (!other->metta_expression[handle1].empty()) {
-                    this->metta_expression[handle1] = other->metta_expression[handle1];
+                if (!other->metta_expression.empty()) {
+                    string handle = handle1.to_string();
+                    if (!other->metta_expression[handle].empty()) {
+                        this->metta_expression[handle] = other->metta_expression[handle];
+                    }
                 }
             }
             if (other->handles.size() > 1) {
@@ -109,8 +119,12 @@ string QueryAnswer::to_string(bool metta_flag) {
     for (auto& vector : this->handles) {
         answer += "[";
         bool empty_flag = true;
-        for (string handle : vector) {
-            answer += (metta_flag ? metta_expression[handle] : handle);
+        for (const CompactHandle& handle : vector) {
+            if (metta_flag) {
+                answer += metta_expression[handle];
+            } else {
+                handle.append_to(answer);
+            }
             answer += ", ";
             empty_flag = false;
         }
@@ -145,11 +159,11 @@ json QueryAnswer::to_json(bool metta_flag) {
 
     json handles_json = json::array();
     json metta_expressions_json = json::array();
-    for (const vector<string>& group : this->handles) {
+    for (const vector<CompactHandle>& group : this->handles) {
         json group_json = json::array();
         json metta_group_json = json::array();
-        for (const string& handle : group) {
-            group_json.push_back(handle);
+        for (const CompactHandle& handle : group) {
+            group_json.push_back(handle.to_string());
             if (metta_flag) {
                 auto it = this->metta_expression.find(handle);
                 if (it != this->metta_expression.end() && !it->second.empty()) {
@@ -164,7 +178,7 @@ json QueryAnswer::to_json(bool metta_flag) {
     json assignment_json = json::object();
     json assignment_metta_json = json::object();
     for (const auto& pair : this->assignment.table) {
-        assignment_json[pair.first] = pair.second;
+        assignment_json[pair.first] = pair.second.to_string();
         if (metta_flag) {
             auto it = this->metta_expression.find(pair.second);
             if (it != this->metta_expression.end() && !it->second.empty()) {
@@ -219,7 +233,7 @@ void QueryAnswer::from_json(const json& json_data) {
                 RAISE_ERROR("Invalid QueryAnswer JSON: handles[" + std::to_string(i) +
                             "] must be an array");
             }
-            vector<string> group;
+            vector<CompactHandle> group;
             group.reserve(handles_json[i].size());
             for (size_t j = 0; j < handles_json[i].size(); j++) {
                 const json& handle_json = handles_json[i][j];
@@ -288,8 +302,8 @@ const string& QueryAnswer::tokenize() {
     for (auto& vector : this->handles) {
         this->token_representation += std::to_string(vector.size());
         this->token_representation += space;
-        for (string handle : vector) {
-            this->token_representation += handle;
+        for (const CompactHandle& handle : vector) {
+            handle.append_to(this->token_representation);
             this->token_representation += space;
         }
     }
@@ -298,7 +312,7 @@ const string& QueryAnswer::tokenize() {
     for (auto pair : this->assignment.table) {
         this->token_representation += pair.first;
         this->token_representation += space;
-        this->token_representation += pair.second;
+        pair.second.append_to(this->token_representation);
         this->token_representation += space;
     }
     this->token_representation += std::to_string(this->metta_expression.size());
@@ -472,6 +486,200 @@ void QueryAnswer::untokenize(const string& tokens) {
     }
 }
 
+// -------------------------------------------------------------------------------------------------
+// Binary format
+
+static inline void write_varint(string& output, uint64_t value) {
+    while (value >= 0x80) {
+        output.push_back((char) ((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    output.push_back((char) value);
+}
+
+static inline uint64_t read_varint(const char* data, size_t size, size_t& cursor) {
+    uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        if (cursor >= size) {
+            RAISE_ERROR("Invalid binary QueryAnswer - truncated varint");
+        }
+        unsigned char byte = (unsigned char) data[cursor++];
+        value |= ((uint64_t) (byte & 0x7F)) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    RAISE_ERROR("Invalid binary QueryAnswer - varint is too long");
+    return 0;
+}
+
+static inline void write_double(string& output, double value) {
+    output.append((const char*) &value, sizeof(double));
+}
+
+static inline double read_double(const char* data, size_t size, size_t& cursor) {
+    if (cursor + sizeof(double) > size) {
+        RAISE_ERROR("Invalid binary QueryAnswer - truncated double");
+    }
+    double value;
+    memcpy(&value, data + cursor, sizeof(double));
+    cursor += sizeof(double);
+    return value;
+}
+
+static inline void write_string(string& output, const string& value) {
+    write_varint(output, value.size());
+    output.append(value);
+}
+
+static inline string read_string(const char* data, size_t size, size_t& cursor) {
+    uint64_t length = read_varint(data, size, cursor);
+    if (length > size - cursor) {
+        RAISE_ERROR("Invalid binary QueryAnswer - truncated string");
+    }
+    string value(data + cursor, length);
+    cursor += length;
+    return value;
+}
+
+static const unsigned char STRING_HANDLES = 0x01;
+
+static inline void write_handle(string& output, const string& handle, bool compact) {
+    if (compact) {
+        output.append((const char*) Handle(handle).data(), Handle::SIZE);
+    } else {
+        write_string(output, handle);
+    }
+}
+
+static inline void write_handle(string& output, const CompactHandle& handle, bool compact) {
+    if (compact) {
+        output.append((const char*) handle.get_handle().data(), Handle::SIZE);
+    } else {
+        write_string(output, handle.to_string());
+    }
+}
+
+static inline CompactHandle read_handle(const char* data,
+                                        size_t size,
+                                        size_t& cursor,
+                                        bool compact) {
+    if (!compact) {
+        return CompactHandle(read_string(data, size, cursor));
+    }
+    if (cursor + Handle::SIZE > size) {
+        RAISE_ERROR("Invalid binary QueryAnswer - truncated handle");
+    }
+    CompactHandle handle(Handle::from_bytes((const unsigned char*) data + cursor));
+    cursor += Handle::SIZE;
+    return handle;
+}
+
+void QueryAnswer::binary_tokenize(string& output, map<string, unsigned int>& labels) {
+    bool compact = true;
+    for (auto& vector : this->handles) {
+        for (const CompactHandle& handle : vector) {
+            compact = compact && handle.is_handle();
+        }
+    }
+    for (const auto& pair : this->assignment.table) {
+        compact = compact && pair.second.is_handle();
+    }
+    for (auto& pair : this->metta_expression) {
+        compact = compact && Handle::is_canonical(pair.first);
+    }
+
+    output.push_back((char) (compact ? 0 : STRING_HANDLES));
+    write_double(output, this->strength);
+    write_double(output, this->importance);
+    write_varint(output, this->handles.size());
+    for (auto& vector : this->handles) {
+        write_varint(output, vector.size());
+        for (const CompactHandle& handle : vector) {
+            write_handle(output, handle, compact);
+        }
+    }
+    write_varint(output, this->assignment.table.size());
+    for (const auto& pair : this->assignment.table) {
+        auto iterator = labels.find(pair.first);
+        if (iterator == labels.end()) {
+            unsigned int index = labels.size();
+            labels[pair.first] = index;
+            write_varint(output, index);
+            write_string(output, pair.first);
+        } else {
+            write_varint(output, iterator->second);
+        }
+        write_handle(output, pair.second, compact);
+    }
+    write_varint(output, this->metta_expression.size());
+    for (auto& pair : this->metta_expression) {
+        write_handle(output, pair.first, compact);
+        write_string(output, pair.second);
+    }
+}
+
+void QueryAnswer::binary_untokenize(const char* data, size_t size, vector<string>& labels) {
+    size_t cursor = 0;
+    if (size == 0) {
+        RAISE_ERROR("Invalid binary QueryAnswer - empty record");
+    }
+    bool compact = ((data[cursor++] & STRING_HANDLES) == 0);
+    this->strength = read_double(data, size, cursor);
+    this->importance = read_double(data, size, cursor);
+
+    uint64_t handles_size = read_varint(data, size, cursor);
+    if (handles_size >= MAX_NUMBER_OF_OPERATION_CLAUSES) {
+        RAISE_ERROR("Invalid handles_size: " + std::to_string(handles_size) +
+                    " untokenizing QueryAnswer");
+    }
+    for (unsigned int i = 0; i < handles_size; i++) {
+        uint64_t vector_size = read_varint(data, size, cursor);
+        unsigned int path_index = 0;
+        if (i > 0) {
+            path_index = this->add_path();
+        }
+        for (unsigned int j = 0; j < vector_size; j++) {
+            if (i == 0) {
+                this->handles[0].push_back(read_handle(data, size, cursor, compact));
+            } else {
+                this->handles[path_index + 1].push_back(read_handle(data, size, cursor, compact));
+            }
+        }
+    }
+
+    uint64_t assignment_size = read_varint(data, size, cursor);
+    if (assignment_size > MAX_NUMBER_OF_VARIABLES_IN_QUERY) {
+        RAISE_ERROR("Invalid number of assignments: " + std::to_string(assignment_size) +
+                    " untokenizing QueryAnswer");
+    }
+    for (unsigned int i = 0; i < assignment_size; i++) {
+        uint64_t index = read_varint(data, size, cursor);
+        if (index == labels.size()) {
+            labels.push_back(read_string(data, size, cursor));
+        } else if (index > labels.size()) {
+            RAISE_ERROR("Invalid binary QueryAnswer - unknown label index: " +
+                        std::to_string(index));
+        }
+        CompactHandle value = read_handle(data, size, cursor, compact);
+        if (value.is_handle()) {
+            this->assignment.assign(labels[index], value.get_handle());
+        } else {
+            this->assignment.assign(labels[index], value.to_string());
+        }
+    }
+
+    uint64_t metta_mapping_size = read_varint(data, size, cursor);
+    for (unsigned int i = 0; i < metta_mapping_size; i++) {
+        string handle = read_handle(data, size, cursor, compact).to_string();
+        this->metta_expression[handle] = read_string(data, size, cursor);
+    }
+
+    if (cursor != size) {
+        RAISE_ERROR("Invalid binary QueryAnswer - invalid data after QueryAnswer definition");
+    }
+}
+
 string QueryAnswer::get(const QueryAnswerElement& key, bool return_empty_when_not_found) {
     string answer = "";
     switch (key.type) {
@@ -505,7 +713,7 @@ string QueryAnswer::get(const string& key, bool return_empty_when_not_found) {
 string QueryAnswer::get(unsigned int key, bool return_empty_when_not_found) {
     string answer = "";
     if (key < this->handles[0].size()) {
-        answer = this->handles[0][key];
+        answer = this->handles[0][key].to_string();
     } else {
         if (!return_empty_when_not_found) {
             RAISE_ERROR("Invalid handle index: " + std::to_string(key));
@@ -520,7 +728,7 @@ string QueryAnswer::get(unsigned int key_path,
     string answer = "";
     if (key_path < (this->handles.size() - 1)) {
         if (key_element < this->handles[key_path + 1].size()) {
-            answer = this->handles[key_path + 1][key_element];
+            answer = this->handles[key_path + 1][key_element].to_string();
         }
     }
     if ((answer == "") && (!return_empty_when_not_found)) {
@@ -534,17 +742,20 @@ vector<string> QueryAnswer::get_all(const QueryAnswerElement& key, HandleDecoder
     vector<string> answer;
     switch (key.type) {
         case QueryAnswerElement::ALL_HANDLES:
-            answer = this->handles[0];
+            answer.reserve(this->handles[0].size());
+            for (const CompactHandle& handle : this->handles[0]) {
+                answer.push_back(handle.to_string());
+            }
             break;
         case QueryAnswerElement::ALL_VARIABLE_VALUES:
-            for (auto& pair : this->assignment.table) {
+            for (const auto& pair : this->assignment.table) {
                 answer.push_back(pair.second);
             }
             break;
         case QueryAnswerElement::ALL_PATH_HANDLES:
             for (unsigned int i = 1; i < this->handles.size(); i++) {
                 for (unsigned int j = 0; j < this->handles[i].size(); j++) {
-                    answer.push_back(this->handles[i][j]);
+                    answer.push_back(this->handles[i][j].to_string());
                 }
             }
             break;
@@ -557,7 +768,8 @@ vector<string> QueryAnswer::get_all(const QueryAnswerElement& key, HandleDecoder
             }
             auto& path = get_path_vector(key.path_index);
             bool first_handle = true;
-            for (string& handle : path) {
+            for (const CompactHandle& compact_handle : path) {
+                string handle = compact_handle.to_string();
                 auto atom = decoder->get_atom(handle);
                 if (atom == nullptr) {
                     RAISE_ERROR("Atom doesn't exist: " + handle);
@@ -643,6 +855,8 @@ void QueryAnswer::rewrite_query(const vector<string>& original_query,
 
 void QueryAnswer::add_handle(const string& handle) { this->handles[0].push_back(handle); }
 
+void QueryAnswer::add_handle(const Handle& handle) { this->handles[0].push_back(handle); }
+
 unsigned int QueryAnswer::add_path() {
     if (this->handles.size() == 0) {
         RAISE_ERROR("Invalid QueryAnswer setup. Trying to add a path to an uninitialized  QueryAnswer");
@@ -668,6 +882,14 @@ void QueryAnswer::add_path_element(unsigned int path_index, const string& handle
     }
 }
 
+void QueryAnswer::add_path_element(unsigned int path_index, const Handle& handle) {
+    if (path_index >= get_paths_size()) {
+        RAISE_ERROR("Invalid path index: " + std::to_string(path_index) +
+                    " QueryAnswer: " + to_string());
+    }
+    this->handles[path_index + 1].push_back(handle);
+}
+
 unsigned int QueryAnswer::get_handles_size() { return this->handles[0].size(); }
 
 unsigned int QueryAnswer::get_paths_size() {
@@ -679,9 +901,9 @@ unsigned int QueryAnswer::get_paths_size() {
     }
 }
 
-vector<string>& QueryAnswer::get_handles_vector() { return this->handles[0]; }
+vector<CompactHandle>& QueryAnswer::get_handles_vector() { return this->handles[0]; }
 
-vector<string>& QueryAnswer::get_path_vector(unsigned int path_index) {
+vector<CompactHandle>& QueryAnswer::get_path_vector(unsigned int path_index) {
     if ((this->handles.size() == 0) || (path_index >= (this->handles.size() - 1))) {
         RAISE_ERROR("Invalid path index: " + std::to_string(path_index) +
                     " QueryAnswer: " + to_string());
@@ -690,9 +912,81 @@ vector<string>& QueryAnswer::get_path_vector(unsigned int path_index) {
 }
 
 string QueryAnswer::compute_hash() {
-    vector<string> hashes;
-    for (auto& v : this->handles) {
-        hashes.push_back(Hasher::composite_handle(v));
+    vector<vector<string>> batch;
+    batch.reserve(this->handles.size());
+    for (const auto& vector : this->handles) {
+        batch.push_back({vector.begin(), vector.end()});
     }
-    return Hasher::composite_handle(hashes);
+    return Hasher::composite_handle(Hasher::composite_handles(batch));
+}
+
+// -------------------------------------------------------------------------------------------------
+// BinaryAnswerWriter
+
+const char BinaryAnswerWriter::BINARY_FORMAT_MAGIC[] = "\x01QA";
+
+BinaryAnswerWriter::BinaryAnswerWriter() { clear(); }
+
+BinaryAnswerWriter::~BinaryAnswerWriter() {}
+
+void BinaryAnswerWriter::add(QueryAnswer* answer) {
+    this->record.clear();
+    answer->binary_tokenize(this->record, this->labels);
+    write_varint(this->bundle, this->record.size());
+    this->bundle.append(this->record);
+    this->count++;
+}
+
+unsigned int BinaryAnswerWriter::size() { return this->count; }
+
+const string& BinaryAnswerWriter::buffer() { return this->bundle; }
+
+void BinaryAnswerWriter::clear() {
+    this->bundle.clear();
+    this->bundle.append(BINARY_FORMAT_MAGIC);
+    this->bundle.push_back((char) BINARY_FORMAT_VERSION);
+    this->labels.clear();
+    this->count = 0;
+}
+
+// -------------------------------------------------------------------------------------------------
+// BinaryAnswerReader
+
+BinaryAnswerReader::BinaryAnswerReader(const string& buffer) : bundle(buffer) {
+    if (!is_binary_bundle(buffer)) {
+        RAISE_ERROR("Invalid binary QueryAnswer bundle - missing header");
+    }
+    this->cursor = strlen(BinaryAnswerWriter::BINARY_FORMAT_MAGIC);
+    unsigned int version = (unsigned char) buffer[this->cursor++];
+    if ((version == 0) || (version > BinaryAnswerWriter::BINARY_FORMAT_VERSION)) {
+        RAISE_ERROR("Unsupported binary QueryAnswer bundle version: " + std::to_string(version));
+    }
+}
+
+BinaryAnswerReader::~BinaryAnswerReader() {}
+
+bool BinaryAnswerReader::is_binary_bundle(const string& buffer) {
+    size_t magic_size = strlen(BinaryAnswerWriter::BINARY_FORMAT_MAGIC);
+    return (buffer.size() > magic_size) &&
+           (buffer.compare(0, magic_size, BinaryAnswerWriter::BINARY_FORMAT_MAGIC) == 0);
+}
+
+QueryAnswer* BinaryAnswerReader::next() {
+    if (this->cursor == this->bundle.size()) {
+        return NULL;
+    }
+    const char* data = this->bundle.data();
+    size_t record_size = read_varint(data, this->bundle.size(), this->cursor);
+    if (record_size > this->bundle.size() - this->cursor) {
+        RAISE_ERROR("Invalid binary QueryAnswer bundle - truncated answer");
+    }
+    QueryAnswer* answer = new QueryAnswer();
+    try {
+        answer->binary_untokenize(data + this->cursor, record_size, this->labels);
+    } catch (...) {
+        delete answer;
+        throw;
+    }
+    this->cursor += record_size;
+    return answer;
 }
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "Assignment.h"
+#include "Handle.h"
 #include "HandleDecoder.h"
 #include "Utils.h"
 #include "expression_hasher.h"
@@ -355,6 +356,14 @@ class QueryAnswer {
      */
     QueryAnswer(const string& handle, double importance);
 
+    /**
+     * Constructor.
+     *
+     * @param handle First handle in this QueryAnswer.
+     * @param importance Estimated importance of this QueryAnswer.
+     */
+    QueryAnswer(const Handle& handle, double importance);
+
     /**
      * Constructor.
      *
@@ -379,6 +388,13 @@ class QueryAnswer {
      */
     void add_handle(const string& handle);
 
+    /**
+     * Adds a handle to this QueryAnswer.
+     *
+     * @param handles Handle to be added to this QueryAnswer.
+     */
+    void add_handle(const Handle& handle);
+
     /**
      * Adds a new path in the QueryAnswer (e.g. by CHAIN operator).
      *
@@ -395,6 +411,14 @@ class QueryAnswer {
      */
     void add_path_element(unsigned int path_index, const string& handle);
 
+    /**
+     * Adds a new hop in the given path.
+     *
+     * @param path_index Index of the path which shaw be updated.
+     * @param handle The handle of the atom that is the new hop in the path.
+     */
+    void add_path_element(unsigned int path_index, const Handle& handle);
+
     /**
      * Merges this QueryAnswer with the passed one.
      *
@@ -443,6 +467,32 @@ class QueryAnswer {
      */
     void untokenize(const string& tokens);
 
+    /**
+     * Appends a compact binary representation of this QueryAnswer to the passed buffer.
+     *
+     * Strength and importance are written as raw doubles, sizes as varints and handles as their
+     * Handle::SIZE raw bytes (unless some handle isn't a lower case hex handle, in which case all
+     * handles are written as length-prefixed strings). Variable labels are written as indexes in
+     * the passed label table, which is shared by all the answers in a bundle; labels which are not
+     * in the table yet are written in full right after their (new) index and inserted in it.
+     *
+     * This is supposed to be used through BinaryAnswerWriter, which adds the version header and
+     * the length prefix of each answer.
+     *
+     * @param output Buffer where the binary representation is appended.
+     * @param labels Label table (CHANGED BY SIDE-EFFECT).
+     */
+    void binary_tokenize(string& output, map<string, unsigned int>& labels);
+
+    /**
+     * Rebuilds a QueryAnswer from the binary representation written by binary_tokenize().
+     *
+     * @param data Binary representation.
+     * @param size Number of bytes in the binary representation (they are all supposed to be used).
+     * @param labels Label table (CHANGED BY SIDE-EFFECT), same as in binary_tokenize().
+     */
+    void binary_untokenize(const char* data, size_t size, vector<string>& labels);
+
     /**
      * Returns a string representation of this QueryAnswer (mainly for debugging; not optimized to
      * production environment).
@@ -512,19 +562,102 @@ class QueryAnswer {
 
     unsigned int get_handles_size();
     unsigned int get_paths_size();
-    vector<string>& get_handles_vector();
-    vector<string>& get_path_vector(unsigned int path_index);
+    vector<CompactHandle>& get_handles_vector();
+    vector<CompactHandle>& get_path_vector(unsigned int path_index);
     string compute_hash();
 
    private:
     void merge_paths(QueryAnswer* other);
 
     /**
-     * Handles which are the constituents of this QueryAnswer.
+     * Handles which are the constituents of this QueryAnswer. They are kept as CompactHandle so
+     * copying and merging answers doesn't allocate a string per handle.
      */
-    vector<vector<string>> handles;
+    vector<vector<CompactHandle>> handles;
 
     string token_representation;
 };
 
+/**
+ * Builds bundles of QueryAnswers in the compact binary format (see QueryAnswer::binary_tokenize()).
+ *
+ * A bundle is a header (BINARY_FORMAT_MAGIC followed by a version byte) followed by the answers,
+ * each one prefixed by its length (a varint). Bundles are meant to be decoded by
+ * BinaryAnswerReader, which rejects versions it doesn't know.
+ */
+class BinaryAnswerWriter {
+   public:
+    static const unsigned int BINARY_FORMAT_VERSION = 1;  // Latest version of the binary format
+    static const char BINARY_FORMAT_MAGIC[];              // Prefix of all binary bundles
+
+    BinaryAnswerWriter();
+    ~BinaryAnswerWriter();
+
+    /**
+     * Appends an answer to the current bundle.
+     *
+     * @param answer Answer being appended.
+     */
+    void add(QueryAnswer* answer);
+
+    /**
+     * Returns the number of answers in the current bundle.
+     *
+     * @return The number of answers in the current bundle.
+     */
+    unsigned int size();
+
+    /**
+     * Returns the current bundle.
+     *
+     * @return The current bundle.
+     */
+    const string& buffer();
+
+    /**
+     * Discards the current bundle and starts a new (empty) one.
+     */
+    void clear();
+
+   private:
+    string bundle;
+    map<string, unsigned int> labels;
+    unsigned int count;
+    string record;  // Reused buffer where each answer is written before its length is known
+};
+
+/**
+ * Iterates through the QueryAnswers in a bundle built by BinaryAnswerWriter.
+ */
+class BinaryAnswerReader {
+   public:
+    /**
+     * Constructor. An exception is thrown if the passed buffer isn't a binary bundle of a known
+     * version.
+     *
+     * @param buffer A bundle built by BinaryAnswerWriter. It's not copied so it's supposed to
+     * outlive this reader.
+     */
+    BinaryAnswerReader(const string& buffer);
+    ~BinaryAnswerReader();
+
+    /**
+     * Returns true iff the passed buffer starts with the binary bundle header (of any version).
+     */
+    static bool is_binary_bundle(const string& buffer);
+
+    /**
+     * Decodes and returns the next answer in the bundle (allocated with new, so the caller
+     * becomes its owner) or NULL if there are no more answers.
+     *
+     * @return The next answer in the bundle or NULL if there are no more answers.
+     */
+    QueryAnswer* next();
+
+   private:
+    const string& bundle;
+    size_t cursor;
+    vector<string> labels;
+};
+
 }  // namespace query_engine
@@ -0,0 +1,99 @@
+#include "QueryAnswerChannel.h"
+
+#include "Utils.h"
+
+using namespace query_node;
+using namespace commons;
+
+unordered_map<string, weak_ptr<QueryAnswerChannel>> QueryAnswerChannel::CHANNELS;
+mutex QueryAnswerChannel::CHANNELS_MUTEX;
+
+// --------------------------------------------------------------------------------
+// Public methods
+
+QueryAnswerChannel::QueryAnswerChannel(unsigned int capacity) {
+    if (capacity == 0) {
+        RAISE_ERROR("Invalid QueryAnswerChannel capacity: 0");
+    }
+    this->capacity = capacity;
+}
+
+QueryAnswerChannel::~QueryAnswerChannel() {}
+
+unsigned int QueryAnswerChannel::push(deque<unique_ptr<QueryAnswer>>& batch,
+                                      function<void()> space_available) {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    unsigned int count = 0;
+    while (!batch.empty() && (this->answers.size() < this->capacity)) {
+        this->answers.push_back(std::move(batch.front()));
+        batch.pop_front();
+        count++;
+    }
+    if (!batch.empty() && space_available) {
+        this->waiting_producers.push_back(space_available);
+    }
+    if ((count > 0) && this->listener) {
+        this->listener();
+    }
+    return count;
+}
+
+QueryAnswer* QueryAnswerChannel::pop() {
+    vector<function<void()>> producers;
+    QueryAnswer* query_answer = NULL;
+    {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        if (!this->answers.empty()) {
+            query_answer = this->answers.front().release();
+            this->answers.pop_front();
+        }
+        if (!this->waiting_producers.empty() && (this->answers.size() <= (this->capacity / 2))) {
+            producers.swap(this->waiting_producers);
+        }
+    }
+    for (auto producer : producers) {
+        producer();
+    }
+    return query_answer;
+}
+
+bool QueryAnswerChannel::empty() {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    return this->answers.empty();
+}
+
+unsigned int QueryAnswerChannel::size() {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    return this->answers.size();
+}
+
+unsigned int QueryAnswerChannel::get_capacity() { return this->capacity; }
+
+void QueryAnswerChannel::set_listener(function<void()> listener) {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    this->listener = listener;
+}
+
+void QueryAnswerChannel::register_channel(const string& server_id,
+                                          shared_ptr<QueryAnswerChannel> channel) {
+    lock_guard<mutex> semaphore(CHANNELS_MUTEX);
+    auto iterator = CHANNELS.find(server_id);
+    if ((iterator != CHANNELS.end()) && !iterator->second.expired()) {
+        RAISE_ERROR("QueryAnswerChannel already registered for server: " + server_id);
+    }
+    CHANNELS[server_id] = channel;
+}
+
+void QueryAnswerChannel::unregister_channel(const string& server_id) {
+    lock_guard<mutex> semaphore(CHANNELS_MUTEX);
+    CHANNELS.erase(server_id);
+}
+
+shared_ptr<QueryAnswerChannel> QueryAnswerChannel::get_channel(const string& server_id) {
+    lock_guard<mutex> semaphore(CHANNELS_MUTEX);
+    auto iterator = CHANNELS.find(server_id);
+    if (iterator == CHANNELS.end()) {
+        return nullptr;
+    }
+    return iterator->second.lock();
+}
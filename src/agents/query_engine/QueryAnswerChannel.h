@@ -0,0 +1,98 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "QueryAnswer.h"
+
+using namespace std;
+using namespace query_engine;
+
+namespace query_node {
+
+/**
+ * Typed in-process channel used to move QueryAnswer objects from QueryNodeClients to a
+ * QueryNodeServer living in the same process (i.e. when the RAM MessageBroker is used), instead of
+ * encoding each pointer as a string argument of a Message.
+ *
+ * The channel owns the answers it holds and has a bounded capacity. Producers are never blocked:
+ * push() moves as many answers as there is room for and, when the channel is full, registers a
+ * function which is called once the consumer has drained it to half its capacity. This way
+ * producers running as tasks in a WorkStealingExecutor can just yield and be woken up later.
+ *
+ * Channels are registered by server node ID so clients can find the channel of their server.
+ */
+class QueryAnswerChannel {
+   public:
+    // Default max number of answers held by a channel
+    static constexpr unsigned int DEFAULT_CAPACITY = 10000;
+
+    /**
+     * Constructor.
+     *
+     * @param capacity Max number of answers held by this channel.
+     */
+    QueryAnswerChannel(unsigned int capacity = DEFAULT_CAPACITY);
+    ~QueryAnswerChannel();
+
+    /**
+     * Moves answers from the front of the passed batch to this channel, as many as there is room
+     * for. Answers which don't fit are left in the batch.
+     *
+     * @param batch Answers to be moved.
+     * @param space_available Function called when room is available again in the channel. It's
+     * only registered (and called once) if the channel got full during this call.
+     * @return the number of answers moved to the channel.
+     */
+    unsigned int push(deque<unique_ptr<QueryAnswer>>& batch, function<void()> space_available);
+
+    /**
+     * Removes the first answer of the channel, passing its ownership to the caller.
+     *
+     * @return the removed answer or NULL if the channel is empty.
+     */
+    QueryAnswer* pop();
+
+    bool empty();
+    unsigned int size();
+    unsigned int get_capacity();
+
+    /**
+     * Sets a function which is called (in the producer's thread) whenever answers are pushed.
+     *
+     * @param listener The function to be called or nullptr to remove the current listener.
+     */
+    void set_listener(function<void()> listener);
+
+    /**
+     * Makes a channel available to clients of the server with the passed ID.
+     */
+    static void register_channel(const string& server_id, shared_ptr<QueryAnswerChannel> channel);
+
+    /**
+     * Removes the channel of the server with the passed ID from the registry.
+     */
+    static void unregister_channel(const string& server_id);
+
+    /**
+     * Returns the channel of the server with the passed ID or nullptr if there's none.
+     */
+    static shared_ptr<QueryAnswerChannel> get_channel(const string& server_id);
+
+   private:
+    unsigned int capacity;
+    deque<unique_ptr<QueryAnswer>> answers;
+    vector<function<void()>> waiting_producers;
+    function<void()> listener;
+    mutex api_mutex;
+
+    static unordered_map<string, weak_ptr<QueryAnswerChannel>> CHANNELS;
+    static mutex CHANNELS_MUTEX;
+};
+
+}  // namespace query_node
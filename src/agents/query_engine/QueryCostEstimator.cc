@@ -0,0 +1,127 @@
+#include "QueryCostEstimator.h"
+
+#include <algorithm>
+#include <climits>
+
+#define LOG_LEVEL INFO_LEVEL
+#include "Logger.h"
+
+using namespace query_engine;
+
+// -------------------------------------------------------------------------------------------------
+// Constructors and destructors
+
+QueryCostEstimator::QueryCostEstimator(bool cost_based_join, bool explain) {
+    this->cost_based_join = cost_based_join;
+    this->estimating = cost_based_join || explain;
+}
+
+QueryCostEstimator::~QueryCostEstimator() {}
+
+// -------------------------------------------------------------------------------------------------
+// Public methods
+
+void QueryCostEstimator::add_link_template(shared_ptr<LinkTemplate> link_template) {
+    add(link_template,
+        "LinkTemplate " + link_template->to_string(),
+        (this->estimating ? link_template->count_matching_links() : 0),
+        {});
+}
+
+bool QueryCostEstimator::use_hash_join(const vector<shared_ptr<QueryElement>>& clauses,
+                                 bool and_not_flag,
+                                 bool hash_join_flag) {
+    if (!this->cost_based_join || hash_join_flag) {
+        return hash_join_flag;
+    }
+    unsigned int num_and_clauses = clauses.size() - (and_not_flag ? 1 : 0);
+    return (num_and_clauses > 1) &&
+           (combinations(clauses, num_and_clauses) > HASH_JOIN_MIN_COMBINATIONS);
+}
+
+void QueryCostEstimator::add_and(shared_ptr<QueryElement> and_operator,
+                           const vector<shared_ptr<QueryElement>>& clauses,
+                           bool and_not_flag,
+                           bool hash_join_flag) {
+    unsigned int num_and_clauses = clauses.size() - (and_not_flag ? 1 : 0);
+    unsigned long estimated_count = ULONG_MAX;
+    for (unsigned int i = 0; i < num_and_clauses; i++) {
+        estimated_count = min(estimated_count, estimate(clauses[i]));
+    }
+    string description = (and_not_flag ? "AND_NOT" : "AND");
+    description += (hash_join_flag ? " [hash join]" : " [best-first product]");
+    description += " combinations: " + std::to_string(combinations(clauses, num_and_clauses));
+    add(and_operator, description, estimated_count, clauses);
+}
+
+void QueryCostEstimator::add_or(shared_ptr<QueryElement> or_operator,
+                          const vector<shared_ptr<QueryElement>>& clauses) {
+    unsigned long estimated_count = 0;
+    for (auto clause : clauses) {
+        unsigned long count = estimate(clause);
+        estimated_count = (count > (ULONG_MAX - estimated_count) ? ULONG_MAX : estimated_count + count);
+    }
+    add(or_operator, "OR", estimated_count, clauses);
+}
+
+void QueryCostEstimator::add_unary(shared_ptr<QueryElement> element,
+                             shared_ptr<QueryElement> input,
+                             const string& description) {
+    add(element, description, estimate(input), {input});
+}
+
+unsigned long QueryCostEstimator::estimate(shared_ptr<QueryElement> element) {
+    auto iterator = this->plan.find(element.get());
+    return (iterator == this->plan.end() ? 0 : iterator->second.estimated_count);
+}
+
+vector<string> QueryCostEstimator::explain(shared_ptr<QueryElement> root) {
+    vector<string> lines;
+    explain(root.get(), 0, lines);
+    return lines;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Private methods
+
+void QueryCostEstimator::add(shared_ptr<QueryElement> element,
+                       const string& description,
+                       unsigned long estimated_count,
+                       const vector<shared_ptr<QueryElement>>& children) {
+    PlanNode& node = this->plan[element.get()];
+    node.description = description;
+    node.estimated_count = estimated_count;
+    node.children.clear();
+    for (auto child : children) {
+        node.children.push_back(child.get());
+    }
+    LOG_DEBUG("Query plan: " << description << " estimated answers: " << estimated_count);
+}
+
+void QueryCostEstimator::explain(QueryElement* element, unsigned int depth, vector<string>& lines) {
+    string indentation(2 * depth, ' ');
+    auto iterator = this->plan.find(element);
+    if (iterator == this->plan.end()) {
+        lines.push_back(indentation + element->id + " (not estimated)");
+        return;
+    }
+    const PlanNode& node = iterator->second;
+    lines.push_back(indentation + node.description +
+                    " (estimated answers: " + std::to_string(node.estimated_count) + ")");
+    for (auto child : node.children) {
+        explain(child, depth + 1, lines);
+    }
+}
+
+unsigned long QueryCostEstimator::combinations(const vector<shared_ptr<QueryElement>>& clauses,
+                                         unsigned int count) {
+    unsigned long product = 1;
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned long estimated_count = estimate(clauses[i]);
+        if (estimated_count == 0) {
+            return 0;
+        }
+        product = (product > (ULONG_MAX / estimated_count) ? ULONG_MAX : product * estimated_count);
+    }
+    return product;
+}
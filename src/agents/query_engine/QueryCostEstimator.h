@@ -0,0 +1,125 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "LinkTemplate.h"
+#include "QueryElement.h"
+
+using namespace std;
+using namespace query_element;
+
+namespace query_engine {
+
+/**
+ * Estimates the number of answers of the elements of a query tree while the tree is built from
+ * the query tokens, so the join strategy of AND operators can be chosen from their clauses'
+ * cardinalities and the tree can be explained. It doesn't plan the query: the tree is built as
+ * written in the query.
+ *
+ * LinkTemplates are estimated by the number of links matching their LinkSchema in the AtomDB (see
+ * AtomDB::count_for_pattern(), which doesn't fetch the links). Operators are estimated from their
+ * clauses: the OR of clauses is estimated by the sum of their estimates and the AND of clauses by
+ * the smallest estimate among its (non-negated) clauses, i.e. joins on shared variables are
+ * assumed to be selective. Counting links costs a round trip to the AtomDB per LinkTemplate, so
+ * estimates are computed only when the cost-based join or explain is enabled (otherwise every
+ * element is estimated as 0 and nothing is sent to the AtomDB).
+ *
+ * When the cost-based join is enabled and the product of the clauses' estimates of an AND exceeds
+ * HASH_JOIN_MIN_COMBINATIONS, the hash join is used instead of the best-first product (which
+ * evaluates, in the worst case, every combination of answers). Clauses are not reordered: both
+ * join strategies are symmetric on their clauses (the hash join already probes the most selective
+ * clause first) and the order of the clauses determines the order of the handles in the answers.
+ *
+ * explain() renders the tree (one line per element, indented by depth) so it can be sent back to
+ * the caller of the query (see PatternMatchingQueryProxy::EXPLAIN_FLAG).
+ */
+class QueryCostEstimator {
+   public:
+    // AND operators whose clauses may produce more combinations than this are hash joins
+    static constexpr unsigned long HASH_JOIN_MIN_COMBINATIONS = 100000;
+
+    /**
+     * Constructor.
+     *
+     * @param cost_based_join When false, the join strategies requested by the query are kept.
+     * @param explain When true, estimates are computed (so the tree can be explained) even if
+     * cost_based_join is false.
+     */
+    QueryCostEstimator(bool cost_based_join = true, bool explain = false);
+    ~QueryCostEstimator();
+
+    /**
+     * Estimates a (built) LinkTemplate. Its matching links are counted in the AtomDB only when
+     * the cost-based join or explain is enabled.
+     */
+    void add_link_template(shared_ptr<LinkTemplate> link_template);
+
+    /**
+     * Chooses the join strategy of an AND operator which is about to be built.
+     *
+     * @param clauses Clauses of the AND (already added to this estimator).
+     * @param and_not_flag True iff the last clause is negated.
+     * @param hash_join_flag Join strategy requested by the query.
+     * @return true iff the AND operator is supposed to use the hash join.
+     */
+    bool use_hash_join(const vector<shared_ptr<QueryElement>>& clauses,
+                       bool and_not_flag,
+                       bool hash_join_flag);
+
+    /**
+     * Estimates a newly built AND operator.
+     */
+    void add_and(shared_ptr<QueryElement> and_operator,
+                 const vector<shared_ptr<QueryElement>>& clauses,
+                 bool and_not_flag,
+                 bool hash_join_flag);
+
+    /**
+     * Estimates a newly built OR operator.
+     */
+    void add_or(shared_ptr<QueryElement> or_operator, const vector<shared_ptr<QueryElement>>& clauses);
+
+    /**
+     * Estimates a newly built element which has the same estimate as its single input (e.g.
+     * UniqueAssignmentFilter or Chain).
+     */
+    void add_unary(shared_ptr<QueryElement> element,
+                   shared_ptr<QueryElement> input,
+                   const string& description);
+
+    /**
+     * Returns the estimated number of answers of the passed element.
+     */
+    unsigned long estimate(shared_ptr<QueryElement> element);
+
+    /**
+     * Returns a human readable representation of the plan of the tree rooted at the passed
+     * element, one line per element.
+     */
+    vector<string> explain(shared_ptr<QueryElement> root);
+
+   private:
+    class PlanNode {
+       public:
+        string description;
+        unsigned long estimated_count;
+        vector<QueryElement*> children;
+    };
+
+    void add(shared_ptr<QueryElement> element,
+             const string& description,
+             unsigned long estimated_count,
+             const vector<shared_ptr<QueryElement>>& children);
+    void explain(QueryElement* element, unsigned int depth, vector<string>& lines);
+    unsigned long combinations(const vector<shared_ptr<QueryElement>>& clauses, unsigned int count);
+
+    bool cost_based_join;
+    // True iff LinkTemplates are estimated (i.e. their matching links are counted)
+    bool estimating;
+    unordered_map<QueryElement*, PlanNode> plan;
+};
+
+}  // namespace query_engine
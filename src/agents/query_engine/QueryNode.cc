@@ -1,5 +1,7 @@
 #include "QueryNode.h"
 
+#include <chrono>
+
 #include "LeadershipBroker.h"
 #include "MessageBroker.h"
 #include "Utils.h"
@@ -20,10 +22,12 @@ string QueryNode::QUERY_ANSWERS_FINISHED_COMMAND = "query_answers_finished";
 QueryNode::QueryNode(const string& node_id, bool is_server, MessageBrokerType messaging_backend)
     : DistributedAlgorithmNode(node_id, LeadershipBrokerType::SINGLE_MASTER_SERVER, messaging_backend) {
     this->is_server = is_server;
-    this->query_answer_processor = NULL;
+    this->query_answer_processor = nullptr;
     this->query_answers_finished_flag = false;
     this->shutdown_flag = false;
     this->work_done_flag = false;
+    this->query_answer_capacity = 0;
+    this->query_answer_signal = make_shared<EventSignal>();
     if (messaging_backend == MessageBrokerType::RAM) {
         this->requires_serialization = false;
     } else {
@@ -49,10 +53,11 @@ void QueryNode::graceful_shutdown() {
     this->shutdown_flag_mutex.lock();
     this->shutdown_flag = true;
     this->shutdown_flag_mutex.unlock();
-    if (this->query_answer_processor != NULL) {
-        this->query_answer_processor->join();
-        delete this->query_answer_processor;
-        this->query_answer_processor = NULL;
+    notify_query_answer_signal();
+    // Answers are no longer delivered so producers mustn't wait for room
+    wake_waiting_producers();
+    if ((this->query_answer_processor != nullptr) && !this->query_answer_processor->is_finished()) {
+        this->query_answer_processor->stop();
     }
     LOG_DEBUG("Gracefully shutting down QueryNode " << this->node_id() << " DONE");
 }
@@ -69,6 +74,7 @@ void QueryNode::query_answers_finished() {
     this->query_answers_finished_flag_mutex.lock();
     this->query_answers_finished_flag = true;
     this->query_answers_finished_flag_mutex.unlock();
+    notify_query_answer_signal();
 }
 
 bool QueryNode::is_query_answers_finished() {
@@ -99,71 +105,224 @@ void QueryNode::add_query_answer(QueryAnswer* query_answer) {
         RAISE_ERROR("Invalid addition of new query answer.");
     } else {
         this->query_answer_queue.enqueue((void*) query_answer);
+        notify_query_answer_signal();
+    }
+}
+
+QueryAnswer* QueryNode::pop_query_answer() {
+    QueryAnswer* query_answer = (QueryAnswer*) this->query_answer_queue.dequeue();
+    if (query_answer != NULL) {
+        query_answers_removed();
+    } else if (this->local_channel != nullptr) {
+        query_answer = this->local_channel->pop();
+    }
+    return query_answer;
+}
+
+bool QueryNode::has_room(function<void()> room_available) {
+    if (this->query_answer_capacity == 0) {
+        return true;
+    }
+    lock_guard<mutex> semaphore(this->waiting_producers_mutex);
+    // Size is checked holding the mutex so query_answers_removed() can't miss the new producer
+    if ((this->query_answer_queue.size() < this->query_answer_capacity) || is_shutting_down()) {
+        return true;
+    }
+    this->waiting_producers.push_back(room_available);
+    return false;
+}
+
+bool QueryNode::is_query_answers_empty() {
+    return this->query_answer_queue.empty() &&
+           ((this->local_channel == nullptr) || this->local_channel->empty());
+}
+
+bool QueryNode::wait_query_answer(unsigned int timeout_millis) {
+    shared_ptr<EventSignal> signal;
+    {
+        lock_guard<mutex> semaphore(this->query_answer_signal_mutex);
+        signal = this->query_answer_signal;
     }
+    return signal->wait(timeout_millis);
 }
 
-QueryAnswer* QueryNode::pop_query_answer() { return (QueryAnswer*) this->query_answer_queue.dequeue(); }
+void QueryNode::set_query_answer_signal(shared_ptr<EventSignal> signal) {
+    {
+        lock_guard<mutex> semaphore(this->query_answer_signal_mutex);
+        this->query_answer_signal = signal;
+    }
+    // Answers may have arrived before the new signal was attached
+    signal->notify();
+}
+
+// --------------------------------------------------------------------------------
+// Protected methods
 
-bool QueryNode::is_query_answers_empty() { return this->query_answer_queue.empty(); }
+void QueryNode::notify_query_answer_signal() {
+    lock_guard<mutex> semaphore(this->query_answer_signal_mutex);
+    this->query_answer_signal->notify();
+}
 
-QueryNodeServer::QueryNodeServer(const string& node_id, MessageBrokerType messaging_backend)
+void QueryNode::query_answers_removed() {
+    if (this->query_answer_capacity == 0) {
+        return;
+    }
+    vector<function<void()>> producers;
+    {
+        lock_guard<mutex> semaphore(this->waiting_producers_mutex);
+        if (this->waiting_producers.empty() ||
+            (this->query_answer_queue.size() > (this->query_answer_capacity / 2))) {
+            return;
+        }
+        producers.swap(this->waiting_producers);
+    }
+    for (auto producer : producers) {
+        producer();
+    }
+}
+
+void QueryNode::wake_waiting_producers() {
+    vector<function<void()>> producers;
+    {
+        lock_guard<mutex> semaphore(this->waiting_producers_mutex);
+        producers.swap(this->waiting_producers);
+    }
+    for (auto producer : producers) {
+        producer();
+    }
+}
+
+// --------------------------------------------------------------------------------
+// QueryNodeServer and QueryNodeClient
+
+QueryNodeServer::QueryNodeServer(const string& node_id,
+                                 MessageBrokerType messaging_backend,
+                                 unsigned int channel_capacity)
     : QueryNode(node_id, true, messaging_backend) {
     this->join_network();
-    this->query_answer_processor = new thread(&QueryNodeServer::query_answer_processor_method, this);
+    if (!this->requires_serialization) {
+        this->local_channel = make_shared<QueryAnswerChannel>(channel_capacity);
+        this->local_channel->set_listener([this]() { this->notify_query_answer_signal(); });
+        QueryAnswerChannel::register_channel(node_id, this->local_channel);
+    }
+}
+
+QueryNodeServer::~QueryNodeServer() {
+    if (this->local_channel != nullptr) {
+        QueryAnswerChannel::unregister_channel(this->node_id());
+        // Clients may still hold the channel after this object is gone
+        this->local_channel->set_listener(nullptr);
+    }
 }
 
 void QueryNodeServer::node_joined_network(const string& node_id) { this->add_peer(node_id); }
 
 string QueryNodeServer::cast_leadership_vote() { return this->node_id(); }
 
-void QueryNodeServer::query_answer_processor_method() {
-    while (!this->is_shutting_down()) {
-        Utils::sleep();
+QueryNodeClient::QueryNodeClient(const string& node_id,
+                                 const string& server_id,
+                                 MessageBrokerType messaging_backend)
+    : QueryNode(node_id, true, messaging_backend) {
+    this->server_id = server_id;
+    this->work_done_signal = make_shared<EventSignal>();
+    this->add_peer(server_id);
+    this->join_network();
+    if (!this->requires_serialization) {
+        this->server_channel = QueryAnswerChannel::get_channel(server_id);
+        if (this->server_channel != nullptr) {
+            this->query_answer_capacity = this->server_channel->get_capacity();
+        }
     }
+    // Answers sent to remote peers are sent with (blocking) messaging calls
+    this->query_answer_processor = make_shared<PooledThread>(
+        "query_answer_processor(" + node_id + ")",
+        this,
+        nullptr,
+        (this->requires_serialization ? WorkStealingExecutor::get_shared_io() : nullptr));
+    shared_ptr<PooledThread> processor = this->query_answer_processor;
+    auto signal = make_shared<EventSignal>();
+    signal->set_listener([processor]() { processor->wake(); });
+    this->set_query_answer_signal(signal);
+    this->query_answer_processor->setup();
+    this->query_answer_processor->start();
+}
+
+QueryNodeClient::~QueryNodeClient() {
+    // The processor task must be stopped while this object is still whole
+    this->graceful_shutdown();
 }
 
-void QueryNodeClient::query_answer_processor_method() {
+bool QueryNodeClient::thread_one_step() {
+    if (this->server_channel != nullptr) {
+        return server_channel_step();
+    }
     QueryAnswer* query_answer;
     vector<string> args;
-    bool answers_finished_flag = false;
-    while (!this->is_shutting_down()) {
-        while ((query_answer = (QueryAnswer*) this->query_answer_queue.dequeue()) != NULL) {
-            if (this->requires_serialization) {
-                string tokens = query_answer->tokenize();
-                args.push_back(tokens);
-                delete query_answer;
-            } else {
-                args.push_back(std::to_string((unsigned long) query_answer));
-            }
-        }
-        if (args.empty()) {
-            // The order of the AND clauses below matters
-            if (!answers_finished_flag && this->is_query_answers_finished() &&
-                this->query_answer_queue.empty()) {
-                this->send(QueryNode::QUERY_ANSWERS_FINISHED_COMMAND, args, this->server_id);
-                answers_finished_flag = true;
-                this->work_done_flag = true;
-            }
+    while ((query_answer = (QueryAnswer*) this->query_answer_queue.dequeue()) != NULL) {
+        if (this->requires_serialization) {
+            string tokens = query_answer->tokenize();
+            args.push_back(tokens);
+            delete query_answer;
         } else {
-            if (this->requires_serialization) {
-                this->send(QueryNode::QUERY_ANSWER_TOKENS_FLOW_COMMAND, args, this->server_id);
-            } else {
-                this->send(QueryNode::QUERY_ANSWER_FLOW_COMMAND, args, this->server_id);
-            }
-            args.clear();
+            args.push_back(std::to_string((unsigned long) query_answer));
         }
-        Utils::sleep();
     }
+    if (args.empty()) {
+        // The order of the AND clauses below matters
+        if (this->is_query_answers_finished() && this->query_answer_queue.empty()) {
+            this->send(QueryNode::QUERY_ANSWERS_FINISHED_COMMAND, args, this->server_id);
+            set_work_done();
+        }
+        return false;
+    }
+    if (this->requires_serialization) {
+        this->send(QueryNode::QUERY_ANSWER_TOKENS_FLOW_COMMAND, args, this->server_id);
+    } else {
+        this->send(QueryNode::QUERY_ANSWER_FLOW_COMMAND, args, this->server_id);
+    }
+    return true;
 }
 
-QueryNodeClient::QueryNodeClient(const string& node_id,
-                                 const string& server_id,
-                                 MessageBrokerType messaging_backend)
-    : QueryNode(node_id, true, messaging_backend) {
-    this->query_answer_processor = new thread(&QueryNodeClient::query_answer_processor_method, this);
-    this->server_id = server_id;
-    this->add_peer(server_id);
-    this->join_network();
+bool QueryNodeClient::server_channel_step() {
+    unsigned int capacity = this->server_channel->get_capacity();
+    QueryAnswer* query_answer;
+    while ((this->outgoing_answers.size() < capacity) &&
+           ((query_answer = (QueryAnswer*) this->query_answer_queue.dequeue()) != NULL)) {
+        this->outgoing_answers.push_back(unique_ptr<QueryAnswer>(query_answer));
+    }
+    query_answers_removed();
+    if (this->outgoing_answers.empty()) {
+        // The order of the AND clauses below matters
+        if (this->is_query_answers_finished() && this->query_answer_queue.empty()) {
+            vector<string> args;
+            this->send(QueryNode::QUERY_ANSWERS_FINISHED_COMMAND, args, this->server_id);
+            set_work_done();
+        }
+        return false;
+    }
+    shared_ptr<PooledThread> processor = this->query_answer_processor;
+    // When the channel is full, the task is parked until the server drains it
+    return this->server_channel->push(this->outgoing_answers, [processor]() { processor->wake(); }) > 0;
+}
+
+bool QueryNodeClient::thread_finished() { return this->work_done_flag || this->is_shutting_down(); }
+
+bool QueryNodeClient::wait_work_done(unsigned int timeout_millis) {
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout_millis);
+    while (!this->work_done_flag) {
+        auto now = chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        this->work_done_signal->wait(
+            chrono::duration_cast<chrono::milliseconds>(deadline - now).count() + 1);
+    }
+    return true;
+}
+
+void QueryNodeClient::set_work_done() {
+    this->work_done_flag = true;
+    this->work_done_signal->notify();
 }
 
 void QueryNodeClient::node_joined_network(const string& node_id) {
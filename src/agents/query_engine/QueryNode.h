@@ -1,15 +1,20 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <thread>
 
 #include "DistributedAlgorithmNode.h"
+#include "EventSignal.h"
+#include "PooledThread.h"
 #include "QueryAnswer.h"
+#include "QueryAnswerChannel.h"
 #include "SharedQueue.h"
 
 using namespace std;
 using namespace distributed_algorithm_node;
 using namespace query_engine;
+using namespace processor;
 
 namespace query_node {
 
@@ -27,7 +32,42 @@ class QueryNode : public DistributedAlgorithmNode {
     void add_query_answer(QueryAnswer* query_answer);
     QueryAnswer* pop_query_answer();
     bool is_query_answers_empty();
-    virtual void query_answer_processor_method() = 0;
+
+    /**
+     * Checks whether this node can take more answers. add_query_answer() never refuses answers
+     * so producers are supposed to check this between steps: when this node holds as many answers
+     * as its capacity, the passed function is registered and called (once) when it's been drained
+     * to half its capacity, so producers running as tasks in a WorkStealingExecutor can just yield
+     * rather than piling up answers here.
+     *
+     * Nodes without capacity (the default) always have room.
+     *
+     * @param room_available Function called when there's room again (if this node is full).
+     * @return true iff this node can take more answers.
+     */
+    bool has_room(function<void()> room_available);
+
+    /**
+     * Blocks the caller until a new QueryAnswer arrives, the end of the answer flow is reported,
+     * this node starts shutting down or the timeout expires.
+     *
+     * This is supposed to be used by the (single) consumer of this node's answers instead of
+     * polling pop_query_answer() with a sleep in between.
+     *
+     * @param timeout_millis Max time (in milliseconds) to wait.
+     * @return true iff the method returned because of an event in this node.
+     */
+    bool wait_query_answer(unsigned int timeout_millis = 100);
+
+    /**
+     * Replaces the EventSignal notified when answers arrive (or the flow finishes) in this node.
+     *
+     * Used by elements that consume answers from several QueryNodes (e.g. Operators) so they can
+     * wait for events in any of them using a single EventSignal.
+     *
+     * @param signal The EventSignal to be notified.
+     */
+    void set_query_answer_signal(shared_ptr<EventSignal> signal);
 
     virtual bool is_work_done() { return this->work_done_flag; }  // as Worker
 
@@ -37,9 +77,19 @@ class QueryNode : public DistributedAlgorithmNode {
 
    protected:
     SharedQueue query_answer_queue;
-    thread* query_answer_processor;
+    // Answers sent by in-process clients (servers using the RAM MessageBroker only)
+    shared_ptr<QueryAnswerChannel> local_channel;
+    shared_ptr<PooledThread> query_answer_processor;
     bool requires_serialization;
     bool work_done_flag;
+    // Max number of answers in query_answer_queue before producers are asked to yield (0 means
+    // no limit). See has_room().
+    unsigned int query_answer_capacity;
+
+    void notify_query_answer_signal();
+    // Supposed to be called after answers are removed from query_answer_queue
+    void query_answers_removed();
+    void wake_waiting_producers();
 
    private:
     bool is_server;
@@ -47,29 +97,69 @@ class QueryNode : public DistributedAlgorithmNode {
     mutex shutdown_flag_mutex;
     bool query_answers_finished_flag;
     mutex query_answers_finished_flag_mutex;
+    shared_ptr<EventSignal> query_answer_signal;
+    mutex query_answer_signal_mutex;
+    vector<function<void()>> waiting_producers;
+    mutex waiting_producers_mutex;
 };
 
+/**
+ * Server side of the answer flow. When the RAM MessageBroker is used, the server registers a
+ * QueryAnswerChannel so its (in-process) clients can pass answers directly to it.
+ */
 class QueryNodeServer : public QueryNode {
    public:
-    QueryNodeServer(const string& node_id, MessageBrokerType messaging_backend = MessageBrokerType::RAM);
+    QueryNodeServer(const string& node_id,
+                    MessageBrokerType messaging_backend = MessageBrokerType::RAM,
+                    unsigned int channel_capacity = QueryAnswerChannel::DEFAULT_CAPACITY);
+    ~QueryNodeServer();
 
     void node_joined_network(const string& node_id);
     string cast_leadership_vote();
-    void query_answer_processor_method();
 };
 
-class QueryNodeClient : public QueryNode {
+/**
+ * Client side of the answer flow. Answers added to a QueryNodeClient are forwarded to the server
+ * by a task in the shared WorkStealingExecutor (rather than by a dedicated thread) which is woken
+ * up whenever new answers arrive.
+ *
+ * If the server has a QueryAnswerChannel, answers are moved through it in batches. When the
+ * channel is full the task yields and is woken up by the server once there's room again, so the
+ * answers wait in this node. In that case this node's capacity is the same as the channel's so
+ * producers are asked to yield too (see has_room()) instead of piling up answers here.
+ */
+class QueryNodeClient : public QueryNode, public ThreadMethod {
    public:
     QueryNodeClient(const string& node_id,
                     const string& server_id,
                     MessageBrokerType messaging_backend = MessageBrokerType::RAM);
+    ~QueryNodeClient();
 
     void node_joined_network(const string& node_id);
     string cast_leadership_vote();
-    void query_answer_processor_method();
+
+    // ThreadMethod API
+    bool thread_one_step();
+    bool thread_finished();
+
+    /**
+     * Blocks the caller until all the answers (and the end of the answer flow) have been
+     * delivered to the server or the timeout expires.
+     *
+     * @param timeout_millis Max time (in milliseconds) to wait.
+     * @return true iff the work of this node is done.
+     */
+    bool wait_work_done(unsigned int timeout_millis);
 
    private:
+    bool server_channel_step();
+    void set_work_done();
+
+    shared_ptr<EventSignal> work_done_signal;
+
     string server_id;
+    shared_ptr<QueryAnswerChannel> server_channel;
+    deque<unique_ptr<QueryAnswer>> outgoing_answers;
 };
 
 class QueryAnswerFlow : public Message {
@@ -2,6 +2,7 @@
 
 #include <cstring>
 #include <queue>
+#include <unordered_map>
 
 #include "Logger.h"
 #include "Operator.h"
@@ -17,7 +18,7 @@ namespace query_element {
  * And operates on N clauses. Each clause can be either a Source or another Operator.
  */
 template <unsigned int N>
-class And : public Operator<N> {
+class And : public Operator<N>, public ThreadMethod {
    public:
     enum ImportanceCompositionStrategy { GREATEST, AVERAGE };
     ImportanceCompositionStrategy importance_composer;
@@ -35,11 +36,18 @@ class And : public Operator<N> {
      * operator instead. An AND_NOT operator is like an AND operator but it assumes a NOT attached
      * to its last clause. For instance AND_NOT(A, B, C) is true if A AND B AND NOT C is true.
      * the And operation ends.
+     * @param hash_join_flag When true, answers are combined by a symmetric hash join on the
+     * variables shared by the clauses instead of the best-first product of all clauses. Each
+     * incoming answer is indexed by its assigned values and probed against the answers already
+     * received in the other clauses so only compatible combinations are ever evaluated. Importance
+     * is kept as a secondary ordering criterion (combinations found in each round of incoming
+     * answers are reported in decreasing order of fitness).
      */
     And(const array<shared_ptr<QueryElement>, N>& clauses,
         const vector<shared_ptr<QueryElement>>& link_templates = {},
-        bool not_operator_flag = false)
-        : Operator<N>(clauses), not_operator_flag(not_operator_flag) {
+        bool not_operator_flag = false,
+        bool hash_join_flag = false)
+        : Operator<N>(clauses), not_operator_flag(not_operator_flag), hash_join_flag(hash_join_flag) {
         initialize(clauses);
         this->link_templates = link_templates;
     }
@@ -64,7 +72,8 @@ class And : public Operator<N> {
 
     virtual void setup_buffers() {
         Operator<N>::setup_buffers();
-        this->operator_thread = new thread(&And::and_operator_method, this);
+        LOG_DEBUG("Starting " + this->id);
+        this->start_operator_thread(this);
     }
 
     virtual void graceful_shutdown() {
@@ -74,14 +83,29 @@ class And : public Operator<N> {
             return;
         }
         Operator<N>::graceful_shutdown();
-        if (this->operator_thread != NULL) {
-            this->operator_thread->join();
-            delete this->operator_thread;
-            this->operator_thread = NULL;
-        }
+        this->stop_operator_thread();
         LOG_LOCAL_DEBUG("And::graceful_shutdown() END");
     }
 
+    // --------------------------------------------------------------------------------------------
+    // ThreadMethod API
+
+    virtual bool thread_one_step() {
+        if (!this->output_buffer_has_room()) {
+            // Woken up when the output buffer is drained
+            return false;
+        }
+        if (this->hash_join_flag) {
+            return hash_join_operator_step();
+        } else {
+            return and_operator_step();
+        }
+    }
+
+    virtual bool thread_finished() {
+        return QueryElement::is_flow_finished() || this->output_buffer->is_query_answers_finished();
+    }
+
     // --------------------------------------------------------------------------------------------
     // Private stuff
 
@@ -127,32 +151,53 @@ class And : public Operator<N> {
         }
     };
 
+    /**
+     * Index over the answers of one clause used in hash join mode. AndNot operators also index
+     * the answers of their NOT clause (in both modes) to check candidates against them.
+     *
+     * Answers are indexed by each (variable, value) pair in their assignments. Answers which don't
+     * assign a given variable are compatible with any value for it so they are kept in a separate
+     * list for each known variable.
+     */
+    class JoinIndex {
+       public:
+        unordered_map<string, unordered_map<CompactHandle, vector<unsigned int>>> bound;
+        unordered_map<string, vector<unsigned int>> unbound;
+        unsigned int size;
+        JoinIndex() : size(0) {}
+    };
+
     vector<QueryAnswer*> query_answer[N];
     unsigned int next_input_to_process[N];
     priority_queue<CandidateRecord> border;
     unordered_set<CandidateRecord, hash_function> visited;
     bool all_answers_arrived[N];
     bool no_more_answers_to_arrive;
-    thread* operator_thread;
     unsigned int query_answer_count;
     vector<shared_ptr<QueryElement>> link_templates;
     bool not_operator_flag;
+    bool hash_join_flag;
     unsigned int num_and_clauses;
+    JoinIndex join_index[N];
 
     void initialize(const array<shared_ptr<QueryElement>, N>& clauses) {
         this->importance_composer = AVERAGE;
-        this->operator_thread = NULL;
         for (unsigned int i = 0; i < N; i++) {
             this->next_input_to_process[i] = 0;
             this->all_answers_arrived[i] = false;
         }
         this->no_more_answers_to_arrive = false;
         this->query_answer_count = 0;
+        if (this->hash_join_flag) {
+            this->id = "HashJoin";
+        } else {
+            this->id = "";
+        }
         if (this->not_operator_flag) {
-            this->id = "AndNot(";
+            this->id += "AndNot(";
             this->num_and_clauses = N - 1;
         } else {
-            this->id = "And(";
+            this->id += "And(";
             this->num_and_clauses = N;
         }
         for (unsigned int i = 0; i < N; i++) {
@@ -182,9 +227,10 @@ class And : public Operator<N> {
         }
     }
 
-    void ingest_newly_arrived_answers() {
+    // Returns true iff any new answer has been ingested
+    bool ingest_newly_arrived_answers() {
         if (this->no_more_answers_to_arrive) {
-            return;
+            return false;
         }
         QueryAnswer* answer;
         unsigned int all_arrived_count = 0;
@@ -203,11 +249,8 @@ class And : public Operator<N> {
         }
         if (all_arrived_count == N) {
             this->no_more_answers_to_arrive = true;
-        } else {
-            if (no_new_answer) {
-                Utils::sleep();
-            }
         }
+        return !no_new_answer;
     }
 
     void operate_candidate(const CandidateRecord& candidate) {
@@ -232,15 +275,10 @@ class And : public Operator<N> {
         if (this->not_operator_flag) {
             if (this->query_answer[this->num_and_clauses].size() == 0) {
                 LOG_LOCAL_DEBUG("NOT clause didn't match. Disregarding it.");
-            } else {
-                for (auto answer : this->query_answer[this->num_and_clauses]) {
-                    LOG_LOCAL_DEBUG(new_query_answer->to_string() + " AND NOT " + answer->to_string());
-                    if (new_query_answer->assignment.is_compatible(answer->assignment)) {
-                        LOG_LOCAL_DEBUG("Discarding query answer");
-                        delete new_query_answer;
-                        return;
-                    }
-                }
+            } else if (is_negated(new_query_answer->assignment)) {
+                LOG_LOCAL_DEBUG("Discarding query answer");
+                delete new_query_answer;
+                return;
             }
         }
         this->query_answer_count++;
@@ -248,6 +286,37 @@ class And : public Operator<N> {
         this->output_buffer->add_query_answer(new_query_answer);
     }
 
+    // Anti-join of AndNot operators. Returns true iff any answer of the NOT clause is compatible
+    // with the passed assignment. Answers of the NOT clause are indexed (see JoinIndex) as they
+    // are first needed (i.e. once they have all arrived) so only the ones which are potentially
+    // compatible are checked.
+    bool is_negated(const Assignment& assignment) {
+        unsigned int not_clause = this->num_and_clauses;
+        while (this->next_input_to_process[not_clause] < this->query_answer[not_clause].size()) {
+            index_answer(not_clause, this->next_input_to_process[not_clause]++);
+        }
+        const vector<unsigned int>* bound = NULL;
+        const vector<unsigned int>* unbound = NULL;
+        unsigned int count;
+        if (probe_candidates(not_clause, assignment, &bound, &unbound, count)) {
+            return is_any_compatible(not_clause, *bound, assignment) ||
+                   is_any_compatible(not_clause, *unbound, assignment);
+        }
+        // No variable in common so any answer of the NOT clause is compatible
+        return count > 0;
+    }
+
+    bool is_any_compatible(unsigned int clause,
+                           const vector<unsigned int>& indexes,
+                           const Assignment& assignment) {
+        for (unsigned int index : indexes) {
+            if (this->query_answer[clause][index]->assignment.is_compatible(assignment)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     bool processed_all_input() {
         if (this->border.size() > 0) {
             return false;
@@ -308,69 +377,224 @@ class And : public Operator<N> {
         }
     }
 
-    void and_operator_method() {
-        LOG_DEBUG("Starting " + this->id);
-        STOP_WATCH_START(and_operator);
-        do {
-            if (QueryElement::is_flow_finished() || this->output_buffer->is_query_answers_finished()) {
-                STOP_WATCH_FINISH(and_operator, "AND");
-                return;
+    bool and_operator_step() {
+        ingest_newly_arrived_answers();
+        if (!ready_to_process_candidate()) {
+            return false;
+        }
+        if (processed_all_input()) {
+            bool all_finished_flag = true;
+            for (unsigned int i = 0; i < N; i++) {
+                if (!this->input_buffer[i]->is_query_answers_finished()) {
+                    all_finished_flag = false;
+                    break;
+                }
+            }
+            if (all_finished_flag && !this->output_buffer->is_query_answers_finished() &&
+                // processed_all_input() is double-checked on purpose to avoid race condition
+                processed_all_input()) {
+                this->output_buffer->query_answers_finished();
+                LOG_INFO(this->id << " reported " << this->query_answer_count << " answers.");
+            }
+            return false;
+        }
+        if (this->border.size() == 0) {
+            CandidateRecord candidate;
+            double fitness = 1.0;
+            for (unsigned int i = 0; i < this->num_and_clauses; i++) {
+                candidate.answer[i] = this->query_answer[i][this->next_input_to_process[i]],
+                candidate.index[i] = this->next_input_to_process[i];
+                this->next_input_to_process[i]++;
+                fitness *= candidate.answer[i]->importance;
+            }
+            if (this->not_operator_flag) {
+                candidate.answer[this->num_and_clauses] = NULL;
+                candidate.index[this->num_and_clauses] = 0;
             }
+            candidate.fitness = fitness;
+            this->border.push(candidate);
+            this->visited.insert(candidate);
+        }
+        CandidateRecord candidate = this->border.top();
+        operate_candidate(candidate);
+        expand_border(candidate);
+        this->border.pop();
+        return true;
+    }
 
-            do {
-                if (QueryElement::is_flow_finished()) {
-                    STOP_WATCH_FINISH(and_operator, "AND");
-                    return;
-                }
-                ingest_newly_arrived_answers();
-            } while (!ready_to_process_candidate());
-
-            if (processed_all_input()) {
-                bool all_finished_flag = true;
-                for (unsigned int i = 0; i < N; i++) {
-                    if (!this->input_buffer[i]->is_query_answers_finished()) {
-                        all_finished_flag = false;
-                        break;
-                    }
-                }
-                if (all_finished_flag && !this->output_buffer->is_query_answers_finished() &&
-                    // processed_all_input() is double-checked on purpose to avoid race condition
-                    processed_all_input()) {
-                    this->output_buffer->query_answers_finished();
-                    LOG_INFO(this->id << " reported " << this->query_answer_count << " answers.");
+    // --------------------------------------------------------------------------------------------
+    // Hash join mode
+
+    void index_answer(unsigned int clause, unsigned int index) {
+        JoinIndex& join_index = this->join_index[clause];
+        QueryAnswer* answer = this->query_answer[clause][index];
+        for (const auto& pair : answer->assignment.table) {
+            auto iterator = join_index.bound.find(pair.first);
+            if (iterator == join_index.bound.end()) {
+                // Newly seen variable. All previously indexed answers don't assign it.
+                vector<unsigned int>& unbound = join_index.unbound[pair.first];
+                for (unsigned int i = 0; i < join_index.size; i++) {
+                    unbound.push_back(i);
                 }
-                STOP_WATCH_STOP(and_operator);
-                Utils::sleep();
-                STOP_WATCH_RESTART(and_operator);
+                join_index.bound[pair.first][pair.second].push_back(index);
+            } else {
+                iterator->second[pair.second].push_back(index);
+            }
+        }
+        for (auto& pair : join_index.unbound) {
+            if (answer->assignment.table.find(pair.first) == answer->assignment.table.end()) {
+                pair.second.push_back(index);
+            }
+        }
+        join_index.size++;
+    }
+
+    // Selects the shortest list of answers in the passed clause which are potentially compatible
+    // with the passed assignment. Returns false if all the indexed answers need to be checked
+    // (i.e. the assignment shares no variable with the answers in the clause).
+    bool probe_candidates(unsigned int clause,
+                          const Assignment& assignment,
+                          const vector<unsigned int>** bound_candidates,
+                          const vector<unsigned int>** unbound_candidates,
+                          unsigned int& candidate_count) {
+        static const vector<unsigned int> empty;
+        JoinIndex& join_index = this->join_index[clause];
+        bool found = false;
+        for (const auto& pair : assignment.table) {
+            auto variable_iterator = join_index.bound.find(pair.first);
+            if (variable_iterator == join_index.bound.end()) {
                 continue;
             }
+            auto value_iterator = variable_iterator->second.find(pair.second);
+            const vector<unsigned int>* bound =
+                (value_iterator == variable_iterator->second.end() ? &empty : &value_iterator->second);
+            const vector<unsigned int>* unbound = &join_index.unbound[pair.first];
+            unsigned int count = bound->size() + unbound->size();
+            if ((!found) || (count < candidate_count)) {
+                found = true;
+                candidate_count = count;
+                *bound_candidates = bound;
+                *unbound_candidates = unbound;
+            }
+        }
+        if (!found) {
+            candidate_count = join_index.size;
+        }
+        return found;
+    }
 
-            if (this->border.size() == 0) {
-                if (processed_all_input()) {
-                    continue;
-                }
-                CandidateRecord candidate;
-                double fitness = 1.0;
-                for (unsigned int i = 0; i < this->num_and_clauses; i++) {
-                    candidate.answer[i] = this->query_answer[i][this->next_input_to_process[i]],
-                    candidate.index[i] = this->next_input_to_process[i];
-                    this->next_input_to_process[i]++;
-                    fitness *= candidate.answer[i]->importance;
-                }
-                if (this->not_operator_flag) {
-                    candidate.answer[this->num_and_clauses] = NULL;
-                    candidate.index[this->num_and_clauses] = 0;
-                }
-                candidate.fitness = fitness;
-                this->border.push(candidate);
-                this->visited.insert(candidate);
+    void join_candidate(CandidateRecord& candidate,
+                        bool* joined,
+                        const Assignment& assignment,
+                        unsigned int joined_count) {
+        if (joined_count == this->num_and_clauses) {
+            candidate.fitness = 1.0;
+            for (unsigned int i = 0; i < this->num_and_clauses; i++) {
+                candidate.fitness *= candidate.answer[i]->importance;
+            }
+            this->border.push(candidate);
+            return;
+        }
+        // Greedily probe the clause with the fewest potentially compatible answers
+        int next_clause = -1;
+        bool next_indexed = false;
+        unsigned int next_count = 0;
+        const vector<unsigned int>* next_bound = NULL;
+        const vector<unsigned int>* next_unbound = NULL;
+        for (unsigned int i = 0; i < this->num_and_clauses; i++) {
+            if (joined[i]) {
+                continue;
             }
-            CandidateRecord candidate = this->border.top();
-            operate_candidate(candidate);
-            expand_border(candidate);
+            const vector<unsigned int>* bound = NULL;
+            const vector<unsigned int>* unbound = NULL;
+            unsigned int count;
+            bool indexed = probe_candidates(i, assignment, &bound, &unbound, count);
+            if (count == 0) {
+                return;
+            }
+            if ((next_clause == -1) || (count < next_count)) {
+                next_clause = i;
+                next_indexed = indexed;
+                next_count = count;
+                next_bound = bound;
+                next_unbound = unbound;
+            }
+        }
+        joined[next_clause] = true;
+        if (next_indexed) {
+            for (unsigned int index : *next_bound) {
+                join_with(candidate, joined, assignment, joined_count, next_clause, index);
+            }
+            for (unsigned int index : *next_unbound) {
+                join_with(candidate, joined, assignment, joined_count, next_clause, index);
+            }
+        } else {
+            for (unsigned int index = 0; index < next_count; index++) {
+                join_with(candidate, joined, assignment, joined_count, next_clause, index);
+            }
+        }
+        joined[next_clause] = false;
+    }
+
+    void join_with(CandidateRecord& candidate,
+                   bool* joined,
+                   const Assignment& assignment,
+                   unsigned int joined_count,
+                   unsigned int clause,
+                   unsigned int index) {
+        QueryAnswer* answer = this->query_answer[clause][index];
+        if (!answer->assignment.is_compatible(assignment)) {
+            return;
+        }
+        Assignment new_assignment;
+        new_assignment.copy_from(assignment);
+        new_assignment.add_assignments(answer->assignment);
+        candidate.answer[clause] = answer;
+        candidate.index[clause] = index;
+        join_candidate(candidate, joined, new_assignment, joined_count + 1);
+    }
+
+    void join_newly_arrived_answers() {
+        CandidateRecord candidate;
+        bool joined[N];
+        for (unsigned int i = 0; i < N; i++) {
+            candidate.answer[i] = NULL;
+            candidate.index[i] = 0;
+            joined[i] = false;
+        }
+        for (unsigned int i = 0; i < this->num_and_clauses; i++) {
+            while (this->next_input_to_process[i] < this->query_answer[i].size()) {
+                unsigned int index = this->next_input_to_process[i]++;
+                // The new answer is indexed before probing. As clause i is never probed in its
+                // own join, every combination is built exactly once, when its last answer arrives.
+                index_answer(i, index);
+                candidate.answer[i] = this->query_answer[i][index];
+                candidate.index[i] = index;
+                joined[i] = true;
+                join_candidate(candidate, joined, candidate.answer[i]->assignment, 1);
+                joined[i] = false;
+            }
+        }
+    }
+
+    bool hash_join_operator_step() {
+        // Combinations found in a round of incoming answers are all reported (one per step)
+        // before the next round is ingested
+        bool border_ready =
+            (!this->not_operator_flag) || this->all_answers_arrived[this->num_and_clauses];
+        if (border_ready && (this->border.size() > 0)) {
+            operate_candidate(this->border.top());
             this->border.pop();
-        } while (true);
-        STOP_WATCH_FINISH(and_operator, "AND");
+            return true;
+        }
+        bool new_answers = ingest_newly_arrived_answers();
+        join_newly_arrived_answers();
+        if (this->no_more_answers_to_arrive && (this->border.size() == 0)) {
+            this->output_buffer->query_answers_finished();
+            LOG_INFO(this->id << " reported " << this->query_answer_count << " answers.");
+            return false;
+        }
+        return new_answers || (this->no_more_answers_to_arrive && (this->border.size() > 0));
     }
 };
 
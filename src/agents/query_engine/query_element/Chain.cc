@@ -1,5 +1,7 @@
 #include "Chain.h"
 
+#include <algorithm>
+
 #include "AtomDBSingleton.h"
 #include "Hasher.h"
 #include "Logger.h"
@@ -33,7 +35,8 @@ Chain::Chain(const array<shared_ptr<QueryElement>, 1>& clauses,
              const QueryAnswerElement& link_selector,
              unsigned int tail_reference,
              unsigned int head_reference,
-             bool allow_incomplete_chain_path)
+             bool allow_incomplete_chain_path,
+             unsigned int expansion_workers)
     : Operator<1>(clauses),
       input_link_template(link_template),
       source_reference(source_reference),
@@ -42,6 +45,7 @@ Chain::Chain(const array<shared_ptr<QueryElement>, 1>& clauses,
       link_selector(link_selector),
       tail_reference(tail_reference),
       head_reference(head_reference),
+      expansion_workers(expansion_workers),
       allow_incomplete_chain_path(allow_incomplete_chain_path) {
     initialize(clauses);
 }
@@ -49,7 +53,8 @@ Chain::Chain(const array<shared_ptr<QueryElement>, 1>& clauses,
 Chain::Chain(const array<shared_ptr<QueryElement>, 1>& clauses,
              const string& source_reference,
              const string& target_reference,
-             bool allow_incomplete_chain_path)
+             bool allow_incomplete_chain_path,
+             unsigned int expansion_workers)
     : Chain(clauses,
             nullptr,
             source_reference,
@@ -58,7 +63,8 @@ Chain::Chain(const array<shared_ptr<QueryElement>, 1>& clauses,
             QueryAnswerElement(0),
             1,
             2,
-            allow_incomplete_chain_path) {}
+            allow_incomplete_chain_path,
+            expansion_workers) {}
 
 Chain::~Chain() {
     LOG_DEBUG("Chain::~Chain() BEGIN");
@@ -72,23 +78,50 @@ Chain::~Chain() {
     LOG_DEBUG("~Chain::Chain() END");
 }
 
-shared_ptr<Chain::HeapType> Chain::get_source_index(const string& key) {
-    lock_guard<mutex> semaphore(this->source_index_mutex);
-    auto it = this->source_index.find(key);
-    if (it == this->source_index.end()) {
-        return nullptr;
-    } else {
-        return it->second;
+shared_ptr<Chain::HeapType> Chain::get_frontier(bool forward_flag) {
+    return forward_flag ? this->forward_frontier : this->backward_frontier;
+}
+
+void Chain::get_edges(const string& handle, bool forward_flag, vector<Path>& output) {
+    shared_lock<shared_mutex> semaphore(this->edges_mutex);
+    auto& edges = forward_flag ? this->forward_edges : this->backward_edges;
+    auto iterator = edges.find(handle);
+    if (iterator != edges.end()) {
+        output.insert(output.end(), iterator->second.begin(), iterator->second.end());
     }
 }
 
-shared_ptr<Chain::HeapType> Chain::get_target_index(const string& key) {
-    lock_guard<mutex> semaphore(this->target_index_mutex);
-    auto it = this->target_index.find(key);
-    if (it == this->target_index.end()) {
-        return nullptr;
-    } else {
-        return it->second;
+void Chain::meet_in_the_middle(Path& path) {
+    string end_point = path.end_point();
+    if ((end_point == this->source_reference) || (end_point == this->target_reference)) {
+        // Complete paths are reported by the PathFinders
+        return;
+    }
+    vector<Path> complete_paths;
+    {
+        lock_guard<mutex> semaphore(this->explored_mutex);
+        auto& explored = path.forward_flag ? this->forward_explored : this->backward_explored;
+        auto& opposite = path.forward_flag ? this->backward_explored : this->forward_explored;
+        if ((path.size() <= MAX_MEETING_DEPTH) && (this->count_explored < MAX_MEETING_PATHS)) {
+            record_meeting_path(explored[end_point], path);
+        }
+        auto iterator = opposite.find(end_point);
+        if (iterator != opposite.end()) {
+            for (Path& other : iterator->second) {
+                Path forward_path = path.forward_flag ? path : other;
+                Path backward_path = (path.forward_flag ? other : path).reverse();
+                if (forward_path.allow_concatenation(backward_path)) {
+                    forward_path.concatenate(backward_path);
+                    complete_paths.push_back(forward_path);
+                }
+            }
+        }
+    }
+    for (Path& complete_path : complete_paths) {
+        LOG_DEBUG("[PATH_FINDER] "
+                  << "Paths met in " << convert_handle(end_point) << ": "
+                  << complete_path.to_string());
+        report_path(complete_path);
     }
 }
 
@@ -98,39 +131,31 @@ shared_ptr<Chain::HeapType> Chain::get_target_index(const string& key) {
 void Chain::setup_buffers() {
     LOG_DEBUG("Chain::setup_buffers() BEGIN");
     Operator<1>::setup_buffers();
-    this->operator_thread = make_shared<DedicatedThread>(this->id + ":main_thread", this);
-    this->operator_thread->setup();
-    this->operator_thread->start();
+    // Both the operator (which fetches the input links) and the path finders (which query incoming
+    // sets) block on AtomDB calls
+    start_operator_thread(this, WorkStealingExecutor::get_shared_io());
     if (this->forward_path_finder != NULL) {
-        this->forward_thread =
-            make_shared<DedicatedThread>(this->id + ":forward_thread", this->forward_path_finder);
-        this->forward_thread->setup();
-        this->forward_thread->start();
-    } else {
-        this->forward_thread = nullptr;
+        setup_path_finder(this->forward_path_finder, "forward_thread");
     }
     if (this->backward_path_finder != NULL) {
-        this->backward_thread =
-            make_shared<DedicatedThread>(this->id + ":backward_thread", this->backward_path_finder);
-        this->backward_thread->setup();
-        this->backward_thread->start();
-    } else {
-        this->backward_thread = nullptr;
+        setup_path_finder(this->backward_path_finder, "backward_thread");
+    }
+    // Path finders read path_finder_threads (see path_finders_have_room()) so they are started
+    // only when it's complete
+    for (auto thread : this->path_finder_threads) {
+        thread->start();
     }
     LOG_DEBUG("Chain::setup_buffers() END");
 }
 
 void Chain::graceful_shutdown() {
     LOG_DEBUG("Chain::graceful_shutdown() BEGIN");
-    if ((this->forward_thread != nullptr) && !this->forward_thread->is_finished()) {
-        this->forward_thread->stop();
-    }
-    if ((this->backward_thread != nullptr) && !this->backward_thread->is_finished()) {
-        this->backward_thread->stop();
-    }
-    if (!this->operator_thread->is_finished()) {
-        this->operator_thread->stop();
+    for (auto thread : this->path_finder_threads) {
+        if (!thread->is_finished()) {
+            thread->stop();
+        }
     }
+    stop_operator_thread();
     Operator<1>::graceful_shutdown();
     LOG_DEBUG("Chain::graceful_shutdown() END");
 }
@@ -139,10 +164,10 @@ void Chain::graceful_shutdown() {
 // ThreadMethod API
 
 bool Chain::PathFinder::conditional_refeed(Path& path,
-                                           shared_ptr<HeapType>& candidates_heap,
+                                           unsigned int count_candidates,
                                            unsigned int count_cycles) {
     if (this->chain_operator->all_input_acknowledged() &&
-        (candidates_heap->empty() || (count_cycles == candidates_heap->size()))) {
+        ((count_candidates == 0) || (count_cycles == count_candidates))) {
         LOG_DEBUG("[PATH_FINDER] "
                   << "All input is acknowledged. "
                   << "Reporting incomplete dead-end path: " << path.to_string());
@@ -172,35 +197,23 @@ void Chain::PathFinder::refeed_paths() {
     }
 }
 
-bool Chain::PathFinder::thread_one_step() {
-#if LOG_LEVEL >= DEBUG_LEVEL
-    lock_guard<mutex> semaphore(this->chain_operator->thread_debug_mutex);
-#endif
-    if (this->chain_operator->all_paths_explored()) {
-        return false;
-    }
-    LOG_DEBUG("[PATH_FINDER] " << (this->forward_flag ? "FORWARD" : "BACKWARD") << " PathFinder STEP");
-    shared_ptr<HeapType> base_heap = this->forward_flag
-                                         ? this->chain_operator->get_source_index(this->origin)
-                                         : this->chain_operator->get_target_index(this->origin);
-
-    if (base_heap->empty()) {
+bool Chain::PathFinder::pop_frontier(Path& path) {
+    // Paths are pushed to the frontier (or to the refeeding buffer) only by the operator's thread
+    // before all input is acknowledged or by workers expanding a popped path, so popping and
+    // checking for exhaustion are done atomically with the count of active workers.
+    lock_guard<mutex> semaphore(this->frontier_mutex);
+    shared_ptr<HeapType> frontier = this->chain_operator->get_frontier(this->forward_flag);
+    if (frontier->empty()) {
         LOG_DEBUG("[PATH_FINDER] "
-                  << "Empty base_heap. Trying to refeed paths.");
+                  << "Empty frontier. Trying to refeed paths.");
         this->refeed_paths();
-        if (base_heap->empty()) {
+        if (frontier->empty()) {
             LOG_DEBUG("[PATH_FINDER] "
                       << "No paths to refeed.");
-            if (this->chain_operator->all_input_acknowledged()) {
-                // double check is required to avoid race condition
-                shared_ptr<HeapType> check_heap =
-                    this->forward_flag ? this->chain_operator->get_source_index(this->origin)
-                                       : this->chain_operator->get_target_index(this->origin);
-                if (check_heap == nullptr || check_heap->empty()) {
-                    this->chain_operator->set_all_paths_explored(true);
-                    LOG_DEBUG("[PATH_FINDER] "
-                              << "All paths has been explored");
-                }
+            if (this->chain_operator->all_input_acknowledged() && (this->active_steps == 0)) {
+                this->chain_operator->set_all_paths_explored(true);
+                LOG_DEBUG("[PATH_FINDER] "
+                          << "All paths has been explored");
             }
             return false;
         } else {
@@ -208,8 +221,38 @@ bool Chain::PathFinder::thread_one_step() {
                       << "Paths has been refed.");
         }
     }
+    path = frontier->top_and_pop();
+    this->active_steps++;
+    return true;
+}
 
-    Path previous_path = base_heap->top_and_pop();
+void Chain::PathFinder::finish_step() {
+    lock_guard<mutex> semaphore(this->frontier_mutex);
+    this->active_steps--;
+}
+
+bool Chain::PathFinder::thread_one_step() {
+#if LOG_LEVEL >= DEBUG_LEVEL
+    lock_guard<mutex> semaphore(this->chain_operator->thread_debug_mutex);
+#endif
+    if (this->chain_operator->all_paths_explored()) {
+        return false;
+    }
+    if (!this->chain_operator->path_finders_have_room()) {
+        // Woken up when the output buffer is drained
+        return false;
+    }
+    LOG_DEBUG("[PATH_FINDER] " << (this->forward_flag ? "FORWARD" : "BACKWARD") << " PathFinder STEP");
+    Path previous_path(this->forward_flag);
+    if (!pop_frontier(previous_path)) {
+        return false;
+    }
+    bool answer = expand(previous_path);
+    finish_step();
+    return answer;
+}
+
+bool Chain::PathFinder::expand(Path& previous_path) {
     LOG_DEBUG("[PATH_FINDER] "
               << "Popped: " << previous_path.to_string());
     if (previous_path.end_point() == this->destiny) {
@@ -222,28 +265,27 @@ bool Chain::PathFinder::thread_one_step() {
     LOG_DEBUG("[PATH_FINDER] "
               << "Searching candidate paths " << (this->forward_flag ? "FROM " : "TO ")
               << convert_handle(previous_path.end_point()));
-    shared_ptr<HeapType> candidates_heap =
-        this->forward_flag ? this->chain_operator->get_source_index(previous_path.end_point())
-                           : this->chain_operator->get_target_index(previous_path.end_point());
-    if (candidates_heap->empty()) {
+    vector<Path> candidates;
+    this->chain_operator->get_edges(previous_path.end_point(), this->forward_flag, candidates);
+    if (candidates.empty()) {
         LOG_DEBUG("[PATH_FINDER] "
                   << "Found no candidates.");
-        return !conditional_refeed(previous_path, candidates_heap, 0);
+        return !conditional_refeed(previous_path, 0, 0);
     } else {
         LOG_DEBUG("[PATH_FINDER] "
-                  << "Found " << candidates_heap->size());
+                  << "Found " << candidates.size());
     }
 
-    vector<Path> candidates;
-    candidates_heap->snapshot(candidates);
+    shared_ptr<HeapType> frontier = this->chain_operator->get_frontier(this->forward_flag);
+    unordered_set<string> visited = previous_path.visited_nodes();
     Path new_path(this->forward_flag);
     Path best_path(this->forward_flag);
     double best_sti = -1;
     unsigned int count_cycles = 0;
-    for (Path candidate : candidates) {
+    for (Path& candidate : candidates) {
         LOG_DEBUG("[PATH_FINDER] "
                   << "Candidate: " << candidate.to_string());
-        if (previous_path.allow_concatenation(candidate)) {
+        if (previous_path.allow_concatenation(candidate, visited)) {
             new_path = previous_path;
             new_path.concatenate(candidate);
             if (candidate.path_sti > best_sti) {
@@ -255,7 +297,10 @@ bool Chain::PathFinder::thread_one_step() {
             }
             LOG_DEBUG("[PATH_FINDER] "
                       << "Pushing new path: " << new_path.to_string());
-            base_heap->push(new_path, new_path.path_sti);
+            frontier->push(new_path, new_path.path_sti);
+            if (this->chain_operator->search_direction == BOTH) {
+                this->chain_operator->meet_in_the_middle(new_path);
+            }
         } else {
             LOG_DEBUG("[PATH_FINDER] Discarding because candidate would lead to a cycle.");
             count_cycles++;
@@ -269,7 +314,7 @@ bool Chain::PathFinder::thread_one_step() {
     } else {
         LOG_DEBUG("[PATH_FINDER] "
                   << "No suitable candidate.");
-        return !conditional_refeed(previous_path, candidates_heap, count_cycles);
+        return !conditional_refeed(previous_path, candidates.size(), count_cycles);
     }
 }
 
@@ -278,9 +323,7 @@ void Chain::refeed_paths_forward() {
     while (!this->refeeding_buffer_forward.empty()) {
         Path path = refeeding_buffer_forward.front_and_pop();
         LOG_DEBUG("Refeeding: " << path.to_string());
-        this->source_index_mutex.lock();
-        this->source_index[this->source_reference]->push(path, path.path_sti);
-        this->source_index_mutex.unlock();
+        this->forward_frontier->push(path, path.path_sti);
     }
 }
 
@@ -289,9 +332,7 @@ void Chain::refeed_paths_backward() {
     while (!this->refeeding_buffer_backward.empty()) {
         Path path = refeeding_buffer_backward.front_and_pop();
         LOG_DEBUG("Refeeding: " << path.to_string());
-        this->target_index_mutex.lock();
-        this->target_index[this->target_reference]->push(path, path.path_sti);
-        this->target_index_mutex.unlock();
+        this->backward_frontier->push(path, path.path_sti);
     }
 }
 
@@ -303,14 +344,17 @@ bool Chain::thread_one_step() {
             this->path_finders_stopped = true;
             LOG_DEBUG("[CHAIN OPERATOR] "
                       << "All paths explored. Stopping path finders...");
-            if (forward_thread != nullptr) {
-                this->forward_thread->stop();
-            }
-            if (backward_thread != nullptr) {
-                this->backward_thread->stop();
+            for (auto thread : this->path_finder_threads) {
+                thread->stop();
             }
             LOG_DEBUG("[CHAIN OPERATOR] "
                       << "All paths explored. Stopping path finders. DONE");
+            {
+                lock_guard<mutex> semaphore(this->explored_mutex);
+                this->forward_explored.clear();
+                this->backward_explored.clear();
+                this->count_explored = 0;
+            }
             LOG_DEBUG("[CHAIN OPERATOR] "
                       << "All paths explored. Notifying output buffer...");
             this->output_buffer->query_answers_finished();
@@ -322,6 +366,10 @@ bool Chain::thread_one_step() {
     if (all_input_acknowledged()) {
         return false;
     }
+    if (!output_buffer_has_room()) {
+        // New input may complete paths (see meet_in_the_middle()) so it waits for room too
+        return false;
+    }
 #if LOG_LEVEL >= DEBUG_LEVEL
     {
         lock_guard<mutex> semaphore(this->thread_debug_mutex);
@@ -346,25 +394,34 @@ bool Chain::thread_one_step() {
                 if (link->arity() > max(this->tail_reference, this->head_reference)) {
                     string tail = link->targets[this->tail_reference];
                     string head = link->targets[this->head_reference];
-                    if (forward_active()) {
-                        lock_guard<mutex> semaphore(this->source_index_mutex);
-                        for (string key : {tail, head}) {
-                            if (this->source_index.find(key) == this->source_index.end()) {
-                                this->source_index[key] = make_shared<HeapType>();
+                    double importance = answer->importance;
+                    vector<Path> new_paths;
+                    {
+                        unique_lock<shared_mutex> semaphore(this->edges_mutex);
+                        if (forward_active()) {
+                            Path edge(tail, head, answer, true);
+                            this->forward_edges[tail].push_back(edge);
+                            if (tail == this->source_reference) {
+                                this->forward_frontier->push(edge, importance);
+                                new_paths.push_back(edge);
                             }
                         }
-                        this->source_index[tail]->push(Path(tail, head, answer, true),
-                                                       answer->importance);
-                    }
-                    if (backward_active()) {
-                        lock_guard<mutex> semaphore(this->target_index_mutex);
-                        for (string key : {tail, head}) {
-                            if (this->target_index.find(key) == this->target_index.end()) {
-                                this->target_index[key] = make_shared<HeapType>();
+                        if (backward_active()) {
+                            Path edge(tail,
+                                      head,
+                                      forward_active() ? QueryAnswer::copy(answer) : answer,
+                                      false);
+                            this->backward_edges[head].push_back(edge);
+                            if (head == this->target_reference) {
+                                this->backward_frontier->push(edge, importance);
+                                new_paths.push_back(edge);
                             }
                         }
-                        this->target_index[head]->push(
-                            Path(tail, head, QueryAnswer::copy(answer), false), answer->importance);
+                    }
+                    if (this->search_direction == BOTH) {
+                        for (Path& path : new_paths) {
+                            meet_in_the_middle(path);
+                        }
                     }
                 } else {
                     RAISE_ERROR("Invalid Link " + link->to_string() + " with arity " +
@@ -401,6 +458,8 @@ bool Chain::thread_one_step() {
 #endif
 }
 
+bool Chain::thread_finished() { return this->path_finders_stopped; }
+
 void Chain::report_path(Path& path) {
     lock_guard<mutex> semaphore(this->reported_answers_mutex);
     bool complete_flag =
@@ -412,16 +471,21 @@ void Chain::report_path(Path& path) {
         QueryAnswer* query_answer = new QueryAnswer(path.path_sti);
         query_answer->strength = 1;
         unsigned int path_index = query_answer->add_path();
+        vector<string> path_handles;
+        path_handles.reserve(path.edges.size());
         if (path.forward_flag) {
             for (auto pair : path.edges) {
-                query_answer->add_path_element(path_index, pair.second->get(this->link_selector));
+                path_handles.push_back(pair.second->get(this->link_selector));
             }
         } else {
             for (auto pair = path.edges.rbegin(); pair != path.edges.rend(); ++pair) {
-                query_answer->add_path_element(path_index, pair->second->get(this->link_selector));
+                path_handles.push_back(pair->second->get(this->link_selector));
             }
         }
-        string answer_hash = Hasher::composite_handle(query_answer->get_path_vector(path_index));
+        for (const string& handle : path_handles) {
+            query_answer->add_path_element(path_index, handle);
+        }
+        string answer_hash = Hasher::composite_handle(path_handles);
         if (this->reported_answers.find(answer_hash) == this->reported_answers.end()) {
             this->reported_answers.insert(answer_hash);
             if (this->search_direction == FORWARD) {
@@ -472,6 +536,9 @@ void Chain::initialize(const array<shared_ptr<QueryElement>, 1>& clauses) {
             "Invalid parameters. If CHAIN source or target is a variable, incomplete paths must be "
             "allowed");
     }
+    if (this->expansion_workers == 0) {
+        RAISE_ERROR("Invalid Chain operator with 0 expansion workers.");
+    }
     this->id =
         "CHAIN(" + clauses[0]->id + ", " + this->source_reference + ", " + this->target_reference + ")";
     this->all_input_acknowledged_flag = false;
@@ -487,10 +554,44 @@ void Chain::initialize(const array<shared_ptr<QueryElement>, 1>& clauses) {
         this->backward_path_finder = NULL;
     }
     this->path_finders_stopped = false;
-    this->source_index[this->source_reference] = make_shared<HeapType>();
-    this->source_index[this->target_reference] = make_shared<HeapType>();
-    this->target_index[this->source_reference] = make_shared<HeapType>();
-    this->target_index[this->target_reference] = make_shared<HeapType>();
+    this->forward_frontier = make_shared<HeapType>();
+    this->backward_frontier = make_shared<HeapType>();
+    this->count_explored = 0;
+}
+
+void Chain::record_meeting_path(vector<Path>& paths, Path& path) {
+    if (paths.size() < MAX_MEETING_PATHS_PER_NODE) {
+        paths.push_back(path);
+        this->count_explored++;
+        return;
+    }
+    // Replaces the path with the lowest STI (if it's lower than the new one's)
+    auto lowest = min_element(paths.begin(), paths.end(), [](const Path& left, const Path& right) {
+        return left.path_sti < right.path_sti;
+    });
+    if (lowest->path_sti < path.path_sti) {
+        *lowest = path;
+    }
+}
+
+void Chain::setup_path_finder(PathFinder* path_finder, const string& name) {
+    for (unsigned int i = 0; i < this->expansion_workers; i++) {
+        auto thread = make_shared<PooledThread>(this->id + ":" + name + ":" + std::to_string(i),
+                                                path_finder,
+                                                this->cancellation_token,
+                                                WorkStealingExecutor::get_shared_io());
+        thread->setup();
+        this->path_finder_threads.push_back(thread);
+    }
+}
+
+bool Chain::path_finders_have_room() {
+    vector<shared_ptr<PooledThread>> threads = this->path_finder_threads;
+    return this->output_buffer->has_room([threads]() {
+        for (auto thread : threads) {
+            thread->wake();
+        }
+    });
 }
 
 string Chain::Path::to_string() {
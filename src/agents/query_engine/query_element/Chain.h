@@ -1,14 +1,15 @@
 #pragma once
 
-#include "DedicatedThread.h"
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "Link.h"
 #include "LinkTemplate.h"
 #include "Operator.h"
 #include "ThreadSafeHeap.h"
 #include "ThreadSafeQueue.h"
-#include "map"
-#include "mutex"
-#include "set"
 
 using namespace std;
 using namespace atoms;
@@ -76,6 +77,18 @@ namespace query_element {
  * (Similarity H3 H2)
  * (Similarity H2 H1)
  * (Similarity H1 TARGET)
+ *
+ * Edges are kept in adjacency hash maps keyed by handle (by tail for the forward search and by
+ * head for the backward one). Paths are expanded best-first by PathFinders, one for each search
+ * direction, each one run by a configurable number of workers in the shared WorkStealingExecutor.
+ * When both directions are searched, every path pushed to a frontier is also recorded by its end
+ * point so the two searches meet in the middle: a forward path SOURCE -> ... -> H and a backward
+ * path H -> ... -> TARGET which share no other node are reported as a complete path as soon as
+ * the second one is found, so a path with N edges is found when each search is only about N/2
+ * edges deep. Since complete paths are also found by each search on its own, the recorded paths
+ * are bounded: only paths with up to MAX_MEETING_DEPTH edges are recorded, each end point keeps
+ * the MAX_MEETING_PATHS_PER_NODE paths with the highest STI and at most MAX_MEETING_PATHS paths
+ * are recorded overall. They are all discarded once all paths are explored.
  */
 class Chain : public Operator<1>, public ThreadMethod {
    public:
@@ -165,27 +178,46 @@ class Chain : public Operator<1>, public ThreadMethod {
             }
             return false;
         }
+        // Hashed set with all the nodes in this path
+        inline unordered_set<string> visited_nodes() {
+            unordered_set<string> visited;
+            visited.reserve(this->edges.size() + 1);
+            for (auto& pair : this->edges) {
+                visited.insert(pair.first.first);
+                visited.insert(pair.first.second);
+            }
+            return visited;
+        }
         inline bool allow_concatenation(Path& other) {
+            if ((this->size() == 0) || (other.size() == 0)) {
+                return true;
+            }
+            return allow_concatenation(other, visited_nodes());
+        }
+        // Same as allow_concatenation(other) but using the (previously computed) visited_nodes()
+        // of this path so many candidates can be checked in O(size of the candidate) each
+        inline bool allow_concatenation(Path& other, const unordered_set<string>& visited) {
             if ((this->size() == 0) || (other.size() == 0)) {
                 return true;
             } else if (this->end_point() != other.start_point()) {
                 return false;
             }
-            for (auto pair_other : other.edges) {
-                for (auto pair_this : this->edges) {
-                    if (this->forward_flag) {
-                        if (pair_other.first.second == pair_this.first.first) {
-                            return false;
-                        }
-                    } else {
-                        if (pair_other.first.first == pair_this.first.second) {
-                            return false;
-                        }
-                    }
+            for (auto& pair : other.edges) {
+                const string& next = (this->forward_flag ? pair.first.second : pair.first.first);
+                if (visited.find(next) != visited.end()) {
+                    return false;
                 }
             }
             return true;
         }
+        // The same edges followed in the opposite direction
+        inline Path reverse() {
+            Path other(!this->forward_flag);
+            other.edges.assign(this->edges.rbegin(), this->edges.rend());
+            other.path_sti = this->path_sti;
+            other.sum_sti = this->sum_sti;
+            return other;
+        }
         string to_string();
     };
 
@@ -196,8 +228,17 @@ class Chain : public Operator<1>, public ThreadMethod {
     // --------------------------------------------------------------------------------------------
     // Public methods
 
+    // Default number of workers expanding paths in each search direction
+    static constexpr unsigned int DEFAULT_EXPANSION_WORKERS = 1;
+    // Bounds of the paths recorded to meet in the middle (see class comments)
+    static constexpr unsigned int MAX_MEETING_DEPTH = 8;
+    static constexpr unsigned int MAX_MEETING_PATHS_PER_NODE = 32;
+    static constexpr unsigned int MAX_MEETING_PATHS = 100000;
+
     /**
      * Constructor.
+     *
+     * @param expansion_workers Number of tasks expanding paths in each search direction.
      */
     Chain(const array<shared_ptr<QueryElement>, 1>& clauses,
           shared_ptr<LinkTemplate> link_template,
@@ -207,7 +248,8 @@ class Chain : public Operator<1>, public ThreadMethod {
           const QueryAnswerElement& link_selector,
           unsigned int tail_reference,
           unsigned int head_reference,
-          bool allow_incomplete_chain_path);
+          bool allow_incomplete_chain_path,
+          unsigned int expansion_workers = DEFAULT_EXPANSION_WORKERS);
 
     /**
      * Constructor. Typically used in tests, defaulting the link selector to the first handle in
@@ -217,7 +259,8 @@ class Chain : public Operator<1>, public ThreadMethod {
     Chain(const array<shared_ptr<QueryElement>, 1>& clauses,
           const string& source_reference,
           const string& target_reference,
-          bool allow_incomplete_chain_path = true);
+          bool allow_incomplete_chain_path = true,
+          unsigned int expansion_workers = DEFAULT_EXPANSION_WORKERS);
 
     /**
      * Destructor.
@@ -225,14 +268,22 @@ class Chain : public Operator<1>, public ThreadMethod {
     ~Chain();
 
     /**
-     * Thread-safe access to the source_index map.
+     * Thread-safe access to the heap of paths being expanded in the passed direction.
      */
-    shared_ptr<HeapType> get_source_index(const string& key);
+    shared_ptr<HeapType> get_frontier(bool forward_flag);
 
     /**
-     * Thread-safe access to the target_index map.
+     * Thread-safe copy of the (single edge) paths which may be appended to a path ending in the
+     * passed handle in the passed direction.
      */
-    shared_ptr<HeapType> get_target_index(const string& key);
+    void get_edges(const string& handle, bool forward_flag, vector<Path>& output);
+
+    /**
+     * Records a newly found (incomplete) path by its end point and reports the complete paths
+     * formed by joining it with the paths already found in the opposite direction which end in the
+     * same point (see meet-in-the-middle in the class comments).
+     */
+    void meet_in_the_middle(Path& path);
 
     /**
      * Chain Operator thread.
@@ -286,6 +337,7 @@ class Chain : public Operator<1>, public ThreadMethod {
     // ThreadMethod API
 
     virtual bool thread_one_step();
+    virtual bool thread_finished();
 
     mutex thread_debug_mutex;
 
@@ -306,13 +358,19 @@ class Chain : public Operator<1>, public ThreadMethod {
                 origin = chain_operator->target_reference;
                 destiny = chain_operator->source_reference;
             }
+            this->active_steps = 0;
         }
         ~PathFinder() {}
         bool thread_one_step();
-        bool conditional_refeed(Path& path,
-                                shared_ptr<HeapType>& candidates_heap,
-                                unsigned int count_cycles);
+        bool conditional_refeed(Path& path, unsigned int count_candidates, unsigned int count_cycles);
         void refeed_paths();
+        bool pop_frontier(Path& path);
+        bool expand(Path& path);
+        void finish_step();
+
+        // Number of workers expanding a path popped from the frontier
+        unsigned int active_steps;
+        mutex frontier_mutex;
     };
 
     void initialize(const array<shared_ptr<QueryElement>, 1>& clauses);
@@ -321,6 +379,11 @@ class Chain : public Operator<1>, public ThreadMethod {
         return (search_direction == BACKWARD) || (search_direction == BOTH);
     }
 
+    void setup_path_finder(PathFinder* path_finder, const string& name);
+    // Same as output_buffer_has_room() but the path finders are the ones woken up
+    bool path_finders_have_room();
+    void record_meeting_path(vector<Path>& paths, Path& path);
+
     shared_ptr<LinkTemplate> input_link_template;
     string source_reference;
     string target_reference;
@@ -328,23 +391,29 @@ class Chain : public Operator<1>, public ThreadMethod {
     QueryAnswerElement link_selector;
     unsigned int tail_reference;
     unsigned int head_reference;
+    unsigned int expansion_workers;
     PathFinder* forward_path_finder;
     PathFinder* backward_path_finder;
     bool path_finders_stopped;
-    shared_ptr<DedicatedThread> operator_thread;
-    shared_ptr<DedicatedThread> forward_thread;
-    shared_ptr<DedicatedThread> backward_thread;
+    vector<shared_ptr<PooledThread>> path_finder_threads;
     ThreadSafeQueue<Path> refeeding_buffer_forward;
     ThreadSafeQueue<Path> refeeding_buffer_backward;
-    set<string> known_links;
-    set<string> reported_answers;
-    map<string, shared_ptr<HeapType>> source_index;
-    map<string, shared_ptr<HeapType>> target_index;
+    unordered_set<string> known_links;
+    unordered_set<string> reported_answers;
+    // Adjacency maps: edges by tail (forward) and by head (backward)
+    unordered_map<string, vector<Path>> forward_edges;
+    unordered_map<string, vector<Path>> backward_edges;
+    shared_ptr<HeapType> forward_frontier;
+    shared_ptr<HeapType> backward_frontier;
+    // Paths pushed to the frontiers by end point (only used when both directions are searched)
+    unordered_map<string, vector<Path>> forward_explored;
+    unordered_map<string, vector<Path>> backward_explored;
+    unsigned int count_explored;
     bool all_input_acknowledged_flag;
     bool all_paths_explored_flag;
     bool allow_incomplete_chain_path;
-    mutex source_index_mutex;
-    mutex target_index_mutex;
+    shared_mutex edges_mutex;
+    mutex explored_mutex;
     mutex all_input_acknowledged_mutex;
     mutex all_paths_explored_mutex;
     mutex reported_answers_mutex;
@@ -17,3 +17,7 @@ bool Iterator::finished() {
 }
 
 QueryAnswer* Iterator::pop() { return (QueryAnswer*) this->input_buffer->pop_query_answer(); }
+
+void Iterator::wait(unsigned int timeout_millis) {
+    this->input_buffer->wait_query_answer(timeout_millis);
+}
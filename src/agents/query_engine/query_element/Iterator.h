@@ -48,6 +48,15 @@ class Iterator : public Sink {
      * @return the next query answer or NULL if none are currently available.
      */
     QueryAnswer* pop();
+
+    /**
+     * Blocks the caller until new query answers are available, the answer flow is finished or
+     * the timeout expires. Meant to be used between calls to pop() that returned NULL instead of
+     * sleeping for a fixed amount of time.
+     *
+     * @param timeout_millis Max time (in milliseconds) to wait.
+     */
+    void wait(unsigned int timeout_millis = 100);
 };
 
 }  // namespace query_element
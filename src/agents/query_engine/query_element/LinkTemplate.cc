@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <chrono>
 #include <random>
+#include <set>
 
 #include "AtomDBSingleton.h"
 #include "AttentionBrokerClient.h"
@@ -15,7 +16,8 @@ using namespace query_element;
 using namespace atomdb;
 using namespace attention_broker;
 
-ThreadSafeHashmap<string, shared_ptr<atomdb_api_types::HandleSet>> LinkTemplate::cache;
+LRUCache<string, LinkTemplate::CachedHandles> LinkTemplate::cache(LinkTemplate::DEFAULT_CACHE_CAPACITY);
+atomic<unsigned long> LinkTemplate::stale_cache_entries(0);
 
 LinkTemplate::LinkTemplate(const string& type,
                            const vector<shared_ptr<QueryElement>>& targets,
@@ -44,9 +46,21 @@ LinkTemplate::LinkTemplate(const string& type,
     this->disregard_importance_flag = disregard_importance_flag;
     this->unique_value_flag = unique_value_flag;
     this->use_cache = use_cache;
+    this->refresh_cache = false;
+    this->max_cache_entry_size = 0;
+    this->top_k = 0;
+    this->importance_chunk_size = DEFAULT_IMPORTANCE_CHUNK_SIZE;
+    this->answer_limit = 0;
     this->inner_flag = true;
     this->arity = targets.size();
     this->processor = nullptr;
+    this->processing_finished = false;
+    this->processing_stage = FETCH_STAGE;
+    this->handles_exhausted = false;
+    this->cursor = 0;
+    this->count_matched = 0;
+    this->count_processed = 0;
+    this->processing_done = false;
     unsigned int max_reverse_nesting = 0;
     this->attention_focus_strategy = PERCENTAGE;
     for (auto element : targets) {
@@ -115,7 +129,7 @@ void LinkTemplate::build() {
     }
 }
 
-void LinkTemplate::compute_importance(vector<pair<char*, float>>& handles) {
+void LinkTemplate::fetch_importance(vector<pair<char*, float>>& handles) {
     vector<string> handle_list;
     vector<float> importance_list;
     handle_list.reserve(handles.size());
@@ -127,6 +141,10 @@ void LinkTemplate::compute_importance(vector<pair<char*, float>>& handles) {
     for (unsigned int i = 0; i < importance_list.size(); i++) {
         handles[i].second = importance_list[i];
     }
+}
+
+void LinkTemplate::compute_importance(vector<pair<char*, float>>& handles) {
+    fetch_importance(handles);
     // Sort decreasing by importance value
 
     Utils::shuffle(handles.begin(), handles.end());
@@ -164,127 +182,409 @@ unsigned int LinkTemplate::report_attention_focus(
     return 0;
 }
 
-void LinkTemplate::processor_method(shared_ptr<StoppableThread> monitor) {
-    while (!this->source_element->buffers_set_up() && !monitor->stopped()) {
-        Utils::sleep();
+void LinkTemplate::set_top_k_streaming(unsigned int k, unsigned int chunk_size) {
+    this->top_k = k;
+    this->importance_chunk_size = (chunk_size > 0 ? chunk_size : DEFAULT_IMPORTANCE_CHUNK_SIZE);
+}
+
+void LinkTemplate::set_answer_limit(unsigned int limit) { this->answer_limit = limit; }
+
+void LinkTemplate::set_cache_policy(bool refresh, unsigned int max_entry_size) {
+    this->refresh_cache = refresh;
+    this->max_cache_entry_size = max_entry_size;
+}
+
+unsigned int LinkTemplate::count_matching_links() {
+    if (this->inner_flag) {
+        RAISE_ERROR("LinkTemplate must be built before counting its matching links");
     }
-    if (monitor->stopped()) {
-        return;
+    return AtomDBSingleton::get_instance()->count_for_pattern(this->link_schema);
+}
+
+bool LinkTemplate::is_count_exact() {
+    if (this->positive_importance_flag || this->unique_value_flag ||
+        (this->attention_focus_strictness != 0.0)) {
+        return false;
     }
-    auto db = AtomDBSingleton::get_instance();
-    string link_schema_handle = this->link_schema.handle();
-    shared_ptr<atomdb_api_types::HandleSet> handles;
-    if (this->use_cache && LinkTemplate::fetched_links_cache().contains(link_schema_handle)) {
-        LOG_INFO("Fetching " + link_schema_handle + " from cache");
-        handles = LinkTemplate::fetched_links_cache().get(link_schema_handle);
+    set<string> variables;
+    for (auto target : this->targets) {
+        Terminal* terminal = dynamic_cast<Terminal*>(target.get());
+        if ((terminal == NULL) || terminal->is_link) {
+            return false;
+        }
+        if (terminal->is_variable && !variables.insert(terminal->name).second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned int LinkTemplate::fetch_limit() {
+    // If importance is disregarded, the first answer_limit links in the pattern index are the
+    // answers, as long as all of them are supposed to match (see is_count_exact())
+    if ((this->answer_limit > 0) && this->disregard_importance_flag && is_count_exact()) {
+        return this->answer_limit;
     } else {
+        return 0;
+    }
+}
+
+shared_ptr<atomdb_api_types::HandleSet> LinkTemplate::fetch_handles(const string& link_schema_handle) {
+    auto db = AtomDBSingleton::get_instance();
+    unsigned int max_results = fetch_limit();
+    if (max_results > 0) {
+        // A partial set must not be cached (it would be returned to queries with no limit)
+        LOG_INFO("Fetching at most " + std::to_string(max_results) + " links in " + link_schema_handle +
+                 " from AtomDB");
+        return db->query_for_pattern(this->link_schema, max_results);
+    }
+    if (!this->use_cache) {
         LOG_INFO("Fetching " + link_schema_handle + " from AtomDB");
-        handles = db->query_for_pattern(this->link_schema);
-        if (this->use_cache) {
-            LinkTemplate::fetched_links_cache().set(link_schema_handle, handles);
-        }
+        return db->query_for_pattern(this->link_schema);
     }
-    LOG_DEBUG("Attention Focus Strictness: " + std::to_string(this->attention_focus_strictness));
-    LOG_DEBUG("Positive importance flag: " + string(this->positive_importance_flag ? "true" : "false"));
-    LOG_DEBUG("Disregard importance flag: " +
-              string(this->disregard_importance_flag ? "true" : "false"));
-    LOG_DEBUG("Unique value flag: " + string(this->unique_value_flag ? "true" : "false"));
-    LOG_INFO("Fetched " + std::to_string(handles->size()) + " atoms in " + link_schema_handle);
-
-    vector<pair<char*, float>> tagged_handles;
-    if (handles->size() > 0) {
-        auto iterator = handles->get_iterator();
-        char* handle;
-        while ((handle = iterator->next()) != nullptr) {
-            tagged_handles.push_back(make_pair<char*, float>((char*) handle, 0));
+    // The generation is read before querying the AtomDB so links added while the query is being
+    // processed invalidate the new entry instead of being silently missed by later lookups.
+    unsigned long generation = AtomDB::pattern_generation(this->link_schema);
+    CachedHandles entry;
+    if (!this->refresh_cache && LinkTemplate::cache.get(link_schema_handle, entry)) {
+        if (entry.generation == generation) {
+            LOG_INFO("Fetching " + link_schema_handle + " from cache");
+            return entry.handles;
         }
-        if (!this->disregard_importance_flag) {
-            compute_importance(tagged_handles);
+        LinkTemplate::stale_cache_entries++;
+        LOG_INFO("Cached " + link_schema_handle + " is stale");
+    }
+    LOG_INFO("Fetching " + link_schema_handle + " from AtomDB");
+    entry.handles = db->query_for_pattern(this->link_schema);
+    if (entry.handles == nullptr) {
+        // Some AtomDBs (e.g. RedisMongoDB with no Redis) have no pattern index
+        return nullptr;
+    }
+    entry.generation = generation;
+    size_t count = entry.handles->size();
+    if (entry.handles->is_partial()) {
+        // Some handles are missing (e.g. a RemoteAtomDB peer timed out) so the next query retries
+        LOG_INFO("Not caching partial " + link_schema_handle);
+        LinkTemplate::cache.remove(link_schema_handle);
+    } else if ((this->max_cache_entry_size == 0) || (count <= this->max_cache_entry_size)) {
+        LinkTemplate::cache.set(
+            link_schema_handle, entry, CACHE_BYTES_PER_ENTRY + count * CACHE_BYTES_PER_HANDLE);
+    } else {
+        LinkTemplate::cache.remove(link_schema_handle);
+    }
+    return entry.handles;
+}
+
+bool LinkTemplate::ranked_globally() {
+    // Handles are read from the AtomDB (and have their importance computed) in chunks only when
+    // importance is disregarded or in top-k streaming (see push_top_k()). Otherwise all of them
+    // are ranked by importance at once so an answer limit keeps the globally best ones.
+    return !this->disregard_importance_flag && !top_k_streaming();
+}
+
+bool LinkTemplate::read_chunk() {
+    unsigned int chunk_size = this->importance_chunk_size;
+    bool read_all = ranked_globally();
+    this->tagged_handles.clear();
+    this->cursor = 0;
+    char* handle;
+    while ((read_all || (this->tagged_handles.size() < chunk_size)) &&
+           ((handle = this->handles_iterator->next()) != nullptr)) {
+        this->tagged_handles.push_back(make_pair(handle, (float) 0));
+    }
+    this->handles_exhausted = read_all || (this->tagged_handles.size() < chunk_size);
+    if (this->tagged_handles.empty() || this->disregard_importance_flag) {
+        return !this->tagged_handles.empty();
+    }
+    if (top_k_streaming()) {
+        fetch_importance(this->tagged_handles);
+        if (this->positive_importance_flag) {
+            this->tagged_handles.erase(remove_if(this->tagged_handles.begin(),
+                                                 this->tagged_handles.end(),
+                                                 [](const pair<char*, float>& tagged_handle) {
+                                                     return tagged_handle.second <= 0;
+                                                 }),
+                                       this->tagged_handles.end());
         }
+        // Sorted decreasing by importance (stable so ties are kept in the AtomDB order)
+        stable_sort(this->tagged_handles.begin(),
+                    this->tagged_handles.end(),
+                    [](const pair<char*, float>& left, const pair<char*, float>& right) {
+                        return left.second > right.second;
+                    });
+    } else {
+        compute_importance(this->tagged_handles);
     }
-    vector<AttentionFocusRecord> attention_focus_candidates;
-    if ((this->attention_focus_strictness != 0.0) && (this->attention_focus_strictness != 1.0)) {
-        attention_focus_candidates.reserve(tagged_handles.size());
-    }
-    unsigned int pending = tagged_handles.size();
-    unsigned int processed = 0;
-    unsigned int cursor = 0;
-    Assignment assignment(this->unique_value_flag);
-    unsigned int count_matched = 0;
-    while ((pending > 0) && !monitor->stopped()) {
-        pair<char*, float> tagged_handle = tagged_handles[cursor++];
+    return true;
+}
+
+void LinkTemplate::process_handles(shared_ptr<AtomDB> db) {
+    unsigned int end = min((unsigned int) this->tagged_handles.size(), this->cursor + MATCH_BATCH_SIZE);
+    // Handles are matched in batches [batch_begin, batch_end) (see match_handles())
+    unsigned int batch_begin = this->cursor;
+    unsigned int batch_end = this->cursor;
+    vector<Assignment> batch_assignments;
+    vector<bool> batch_matched;
+    while (this->cursor < end) {
+        pair<char*, float> tagged_handle = this->tagged_handles[this->cursor++];
         if (this->positive_importance_flag && tagged_handle.second <= 0) {
-            pending = 0;
+            // Handles are sorted by importance so the rest of the chunk is skipped
+            this->cursor = this->tagged_handles.size();
+            return;
+        }
+        if (db->allow_nested_indexing()) {
+            if ((this->attention_focus_strictness == 0.0) || (this->attention_focus_strictness == 1.0)) {
+                this->source_element->add_handle(
+                    tagged_handle.first,
+                    tagged_handle.second,
+                    this->handles->get_assignments_by_handle(tagged_handle.first),
+                    this->handles->get_metta_expressions_by_handle(tagged_handle.first));
+            } else {
+                this->attention_focus_candidates.push_back(AttentionFocusRecord(
+                    tagged_handle.first,
+                    tagged_handle.second,
+                    this->handles->get_assignments_by_handle(tagged_handle.first),
+                    this->handles->get_metta_expressions_by_handle(tagged_handle.first)));
+            }
+            this->count_matched++;
         } else {
-            if (tagged_handle.second > 0 || !this->positive_importance_flag) {
-                if (db->allow_nested_indexing()) {
-                    if ((this->attention_focus_strictness == 0.0) ||
-                        (this->attention_focus_strictness == 1.0)) {
-                        this->source_element->add_handle(
-                            tagged_handle.first,
-                            tagged_handle.second,
-                            handles->get_assignments_by_handle(tagged_handle.first),
-                            handles->get_metta_expressions_by_handle(tagged_handle.first));
-                    } else {
-                        attention_focus_candidates.push_back(AttentionFocusRecord(
-                            tagged_handle.first,
-                            tagged_handle.second,
-                            handles->get_assignments_by_handle(tagged_handle.first),
-                            handles->get_metta_expressions_by_handle(tagged_handle.first)));
-                    }
-                    count_matched++;
-                } else {
-                    assignment.clear();
-                    if (this->link_schema.match(string(tagged_handle.first), assignment, *db.get())) {
-                        if ((this->attention_focus_strictness == 0.0) ||
-                            (this->attention_focus_strictness == 1.0)) {
-                            this->source_element->add_handle(
-                                tagged_handle.first, tagged_handle.second, assignment);
-                        } else {
-                            attention_focus_candidates.push_back(AttentionFocusRecord(
-                                tagged_handle.first, tagged_handle.second, assignment, {}));
-                        }
-                        count_matched++;
-                    }
+            if ((this->cursor - 1) >= batch_end) {
+                // No need to fetch more links than the ones required to reach the limit
+                unsigned int batch_size = end - (this->cursor - 1);
+                if ((this->attention_focus_strictness == 0.0) && (this->answer_limit > 0)) {
+                    batch_size = min(batch_size, this->answer_limit - this->count_matched);
                 }
+                batch_begin = this->cursor - 1;
+                batch_end = batch_begin;
+                while ((batch_end < end) && ((batch_end - batch_begin) < batch_size) &&
+                       !(this->positive_importance_flag &&
+                         (this->tagged_handles[batch_end].second <= 0))) {
+                    batch_end++;
+                }
+                batch_matched =
+                    match_handles(this->tagged_handles, batch_begin, batch_end, batch_assignments, db);
             }
-            if ((this->attention_focus_strictness == 1.0) && (count_matched > 0)) {
-                break;
-            }
-            if (!(++processed % 1000000)) {
-                LOG_INFO("Processed " + std::to_string(processed) + "/" +
-                         std::to_string(tagged_handles.size()) + ". " + std::to_string(count_matched) +
-                         " matched so far.");
+            unsigned int offset = this->cursor - 1 - batch_begin;
+            if (batch_matched[offset]) {
+                const Assignment& assignment = batch_assignments[offset];
+                if ((this->attention_focus_strictness == 0.0) ||
+                    (this->attention_focus_strictness == 1.0)) {
+                    this->source_element->add_handle(
+                        tagged_handle.first, tagged_handle.second, assignment);
+                } else {
+                    this->attention_focus_candidates.push_back(
+                        AttentionFocusRecord(tagged_handle.first, tagged_handle.second, assignment, {}));
+                }
+                this->count_matched++;
             }
-            pending--;
+        }
+        if ((this->attention_focus_strictness == 1.0) && (this->count_matched > 0)) {
+            this->processing_done = true;
+            return;
+        }
+        if ((this->attention_focus_strictness == 0.0) && (this->answer_limit > 0) &&
+            (this->count_matched == this->answer_limit)) {
+            LOG_DEBUG("Answer limit reached: " + std::to_string(this->answer_limit));
+            this->processing_done = true;
+            return;
+        }
+        if (!(++this->count_processed % 1000000)) {
+            LOG_INFO("Processed " + std::to_string(this->count_processed) + "/" +
+                     std::to_string(this->handles->size()) + ". " +
+                     std::to_string(this->count_matched) + " matched so far.");
         }
     }
-    LOG_INFO("Matched " + std::to_string(count_matched) + " atoms in " + link_schema_handle);
-    unsigned int reported;
-    if ((this->attention_focus_strictness == 0.0) || (this->attention_focus_strictness == 1.0)) {
-        reported = count_matched;
+}
+
+void LinkTemplate::stream_top_k(shared_ptr<AtomDB> db) {
+    // The chunk is sorted by importance so only its prefix of candidates which would make it into
+    // the current top k (if they match) is matched (i.e. fetched from the AtomDB)
+    unsigned int end = this->cursor;
+    while ((end < this->tagged_handles.size()) && ((end - this->cursor) < MATCH_BATCH_SIZE)) {
+        if ((this->top_k_heap.size() + (end - this->cursor)) < this->top_k) {
+            end++;
+        } else if ((this->top_k_heap.size() == this->top_k) &&
+                   (this->tagged_handles[end].second > this->top_k_heap.front().importance)) {
+            end++;
+        } else {
+            break;
+        }
+    }
+    if (end == this->cursor) {
+        // None of the remaining candidates in the chunk beats the current top k
+        this->count_processed += this->tagged_handles.size() - this->cursor;
+        this->cursor = this->tagged_handles.size();
+        return;
+    }
+    if (db->allow_nested_indexing()) {
+        for (unsigned int i = this->cursor; i < end; i++) {
+            char* handle = this->tagged_handles[i].first;
+            push_top_k(AttentionFocusRecord(handle,
+                                            this->tagged_handles[i].second,
+                                            this->handles->get_assignments_by_handle(handle),
+                                            this->handles->get_metta_expressions_by_handle(handle)));
+        }
     } else {
-        reported = report_attention_focus(attention_focus_candidates);
+        vector<Assignment> assignments;
+        vector<bool> matched = match_handles(this->tagged_handles, this->cursor, end, assignments, db);
+        for (unsigned int i = this->cursor; i < end; i++) {
+            if (matched[i - this->cursor]) {
+                push_top_k(AttentionFocusRecord(this->tagged_handles[i].first,
+                                                this->tagged_handles[i].second,
+                                                assignments[i - this->cursor],
+                                                {}));
+            }
+        }
+    }
+    this->count_processed += end - this->cursor;
+    this->cursor = end;
+}
+
+bool LinkTemplate::higher_importance(const AttentionFocusRecord& left,
+                                     const AttentionFocusRecord& right) {
+    return left.importance > right.importance;
+}
+
+void LinkTemplate::push_top_k(const AttentionFocusRecord& record) {
+    // Min-heap (by importance) so the worst of the top k is the one dropped
+    this->top_k_heap.push_back(record);
+    push_heap(this->top_k_heap.begin(), this->top_k_heap.end(), higher_importance);
+    if (this->top_k_heap.size() > this->top_k) {
+        pop_heap(this->top_k_heap.begin(), this->top_k_heap.end(), higher_importance);
+        this->top_k_heap.pop_back();
+    }
+}
+
+void LinkTemplate::report_top_k() {
+    sort_heap(this->top_k_heap.begin(), this->top_k_heap.end(), higher_importance);
+    for (auto& record : this->top_k_heap) {
+        this->source_element->add_handle(
+            record.handle, record.importance, record.assignment, record.metta_expression);
+        this->count_matched++;
+    }
+    this->top_k_heap.clear();
+}
+
+vector<bool> LinkTemplate::match_handles(const vector<pair<char*, float>>& tagged_handles,
+                                         unsigned int begin,
+                                         unsigned int end,
+                                         vector<Assignment>& assignments,
+                                         shared_ptr<AtomDB> db) {
+    vector<string> batch;
+    batch.reserve(end - begin);
+    for (unsigned int i = begin; i < end; i++) {
+        batch.push_back(string(tagged_handles[i].first));
+    }
+    assignments.assign(batch.size(), Assignment(this->unique_value_flag));
+    return this->link_schema.match(batch, assignments, *db.get());
+}
+
+bool LinkTemplate::top_k_streaming() {
+    return (this->top_k > 0) && !this->disregard_importance_flag &&
+           (this->attention_focus_strictness == 0.0);
+}
+
+bool LinkTemplate::thread_one_step() {
+    if (!this->source_element->buffers_set_up()) {
+        // source_element wakes this task up when its buffers are set up
+        return false;
+    }
+    if (this->processing_finished) {
+        return false;
+    }
+    if (this->processing_stage == FETCH_STAGE) {
+        if (stop_requested()) {
+            this->processing_finished = true;
+            return false;
+        }
+        fetch_step();
+        return !this->processing_finished;
+    }
+    if (stop_requested()) {
+        finish_processing();
+        return false;
+    }
+    if (!this->source_element->has_room()) {
+        // source_element wakes this task up when its output buffer is drained
+        return false;
+    }
+    auto db = AtomDBSingleton::get_instance();
+    if (!this->processing_done && (this->cursor < this->tagged_handles.size())) {
+        if (top_k_streaming()) {
+            stream_top_k(db);
+        } else {
+            process_handles(db);
+        }
+    } else if (this->processing_done || this->handles_exhausted || !read_chunk()) {
+        if (top_k_streaming()) {
+            // Every chunk has been consumed so the heap holds the (global) top k
+            report_top_k();
+        }
+        finish_processing();
+        return false;
+    }
+    return true;
+}
+
+bool LinkTemplate::thread_finished() { return this->processing_finished; }
+
+bool LinkTemplate::stop_requested() {
+    return this->processor->stopped() || this->source_element->is_cancelled();
+}
+
+void LinkTemplate::fetch_step() {
+    string link_schema_handle = this->link_schema.handle();
+    this->handles = fetch_handles(link_schema_handle);
+    if (this->handles == nullptr) {
+        LOG_INFO("No pattern index available for " + link_schema_handle);
+        finish_processing();
+        return;
+    }
+    LOG_DEBUG("Attention Focus Strictness: " + std::to_string(this->attention_focus_strictness));
+    LOG_DEBUG("Positive importance flag: " + string(this->positive_importance_flag ? "true" : "false"));
+    LOG_DEBUG("Disregard importance flag: " +
+              string(this->disregard_importance_flag ? "true" : "false"));
+    LOG_DEBUG("Unique value flag: " + string(this->unique_value_flag ? "true" : "false"));
+    LOG_INFO("Fetched " + std::to_string(this->handles->size()) + " atoms in " + link_schema_handle);
+    if (top_k_streaming()) {
+        LOG_INFO("Streaming top " + std::to_string(this->top_k) + " atoms in " + link_schema_handle);
     }
+    this->handles_iterator = this->handles->get_iterator();
+    this->handles_exhausted = (this->handles->size() == 0);
+    this->processing_stage = MATCH_STAGE;
+}
+
+void LinkTemplate::finish_processing() {
+    string link_schema_handle = this->link_schema.handle();
+    unsigned int reported = this->count_matched;
+    if ((this->attention_focus_strictness != 0.0) && (this->attention_focus_strictness != 1.0)) {
+        reported = report_attention_focus(this->attention_focus_candidates);
+        this->attention_focus_candidates.clear();
+    }
+    LOG_INFO("Matched " + std::to_string(this->count_matched) + " atoms in " + link_schema_handle);
     LOG_INFO("Reported " + std::to_string(reported) + " atoms in " + link_schema_handle);
-    Utils::sleep();
     this->source_element->query_answers_finished();
-    LOG_DEBUG("LinkTemplate " + link_schema_handle + " finished processing. It's going to sleep.");
-    while (!monitor->stopped()) {
-        // Keep stack variables (e.g. the handles which are passed as QueryAnswers
-        // to source_element)
-        Utils::sleep();
-    }
-    LOG_DEBUG("LinkTemplate " + link_schema_handle +
-              " woke up and is returning from processing thread.");
+    // The char* in tagged_handles point into handles so both are released together
+    this->tagged_handles.clear();
+    this->handles_iterator = nullptr;
+    this->handles = nullptr;
+    this->processing_finished = true;
+    LOG_DEBUG("LinkTemplate " + link_schema_handle + " finished processing.");
 }
 
 void LinkTemplate::start_thread() {
     if (this->inner_flag) {
         RAISE_ERROR("Can't start thread in inner LinkTemplates");
     } else {
-        this->processor = make_shared<StoppableThread>("processor_thread(" + this->id + ")");
-        this->processor->attach(new thread(&LinkTemplate::processor_method, this, this->processor));
+        // Steps block on AtomDB queries / fetches and AttentionBroker requests
+        this->processor = make_shared<PooledThread>(
+            "processor_thread(" + this->id + ")", this, nullptr, WorkStealingExecutor::get_shared_io());
+        {
+            lock_guard<mutex> semaphore(this->source_element->api_mutex);
+            this->source_element->processor = this->processor;
+        }
+        this->processor->setup();
+        this->processor->start();
     }
 }
 
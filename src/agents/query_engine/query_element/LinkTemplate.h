@@ -1,16 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <string>
 #include <vector>
 
 #include "Assignment.h"
 #include "AtomDB.h"
+#include "LRUCache.h"
 #include "LinkSchema.h"
+#include "PooledThread.h"
 #include "QueryElement.h"
 #include "Source.h"
-#include "StoppableThread.h"
-#include "ThreadSafeHashmap.h"
 
 using namespace std;
 using namespace query_engine;
@@ -23,7 +25,29 @@ namespace query_element {
 /**
  * A QueryElement which represents terminals (i.e. Nodes, Links and Variables) in the query tree.
  */
-class LinkTemplate : public QueryElement {
+class LinkTemplate : public QueryElement, public ThreadMethod {
+   public:
+    /**
+     * Entry of the global cache of fetched links. An entry is valid only while the AtomDB pattern
+     * generation (see AtomDB::pattern_generation()) of its LinkSchema is the same as the one read
+     * before querying the AtomDB.
+     */
+    class CachedHandles {
+       public:
+        shared_ptr<atomdb_api_types::HandleSet> handles;
+        unsigned long generation = 0;
+    };
+
+    // Default memory budget (in bytes, estimated) of the global cache of fetched links
+    static const size_t DEFAULT_CACHE_CAPACITY = 512 * 1024 * 1024;
+    // Estimated memory used by each cached handle and by each cache entry
+    static const size_t CACHE_BYTES_PER_HANDLE = 64;
+    static const size_t CACHE_BYTES_PER_ENTRY = 256;
+    // Default number of handles whose importance is requested at once in top-k streaming mode
+    static const unsigned int DEFAULT_IMPORTANCE_CHUNK_SIZE = 1000;
+    // Max number of handles matched at once when nested indexing is not allowed by the AtomDB
+    static const unsigned int MATCH_BATCH_SIZE = 1000;
+
    private:
     enum AttentionFocusStrategy { UNDEFINED = 0, PERCENTAGE };
     class AttentionFocusRecord {
@@ -48,6 +72,8 @@ class LinkTemplate : public QueryElement {
        public:
         bool buffers_set_up_flag;
         mutex api_mutex;
+        // Woken up when buffers are set up
+        shared_ptr<PooledThread> processor;
         SourceElement() { buffers_set_up_flag = false; }
         void add_handle(char* handle,
                         float importance,
@@ -59,10 +85,30 @@ class LinkTemplate : public QueryElement {
             this->output_buffer->add_query_answer(answer);
         }
         void query_answers_finished() { this->output_buffer->query_answers_finished(); }
+        // Same as QueryNode::has_room() waking up the processor when there's room again
+        bool has_room() {
+            shared_ptr<PooledThread> processor;
+            {
+                lock_guard<mutex> semaphore(this->api_mutex);
+                processor = this->processor;
+            }
+            return this->output_buffer->has_room([processor]() {
+                if (processor != nullptr) {
+                    processor->wake();
+                }
+            });
+        }
         void setup_buffers() override {
-            lock_guard<mutex> semaphore(this->api_mutex);
-            Source::setup_buffers();
-            this->buffers_set_up_flag = true;
+            shared_ptr<PooledThread> processor;
+            {
+                lock_guard<mutex> semaphore(this->api_mutex);
+                Source::setup_buffers();
+                this->buffers_set_up_flag = true;
+                processor = this->processor;
+            }
+            if (processor != nullptr) {
+                processor->wake();
+            }
         }
         bool buffers_set_up() {
             lock_guard<mutex> semaphore(this->api_mutex);
@@ -77,21 +123,71 @@ class LinkTemplate : public QueryElement {
     bool disregard_importance_flag;
     bool unique_value_flag;
     bool use_cache;
+    bool refresh_cache;
+    unsigned int max_cache_entry_size;
+    unsigned int top_k;
+    unsigned int importance_chunk_size;
+    unsigned int answer_limit;
     bool inner_flag;
     LinkSchema link_schema;
     shared_ptr<SourceElement> source_element;
-    shared_ptr<StoppableThread> processor;
+    shared_ptr<PooledThread> processor;
+    atomic<bool> processing_finished;
+    // Processing state, kept between steps (see thread_one_step())
+    enum ProcessingStage { FETCH_STAGE = 0, MATCH_STAGE };
+    ProcessingStage processing_stage;
+    shared_ptr<atomdb_api_types::HandleSet> handles;
+    shared_ptr<atomdb_api_types::HandleSetIterator> handles_iterator;
+    bool handles_exhausted;
+    // Current chunk of handles and the position of the next one to be processed
+    vector<pair<char*, float>> tagged_handles;
+    unsigned int cursor;
+    vector<AttentionFocusRecord> attention_focus_candidates;
+    // Best (matching) candidates seen so far in top-k streaming, as a min-heap by importance
+    vector<AttentionFocusRecord> top_k_heap;
+    unsigned int count_matched;
+    unsigned int count_processed;
+    // True when no more handles are supposed to be processed (e.g. the answer limit is reached)
+    bool processing_done;
     AttentionFocusStrategy attention_focus_strategy;
-    static ThreadSafeHashmap<string, shared_ptr<atomdb_api_types::HandleSet>> cache;
+    static LRUCache<string, CachedHandles> cache;
+    static atomic<unsigned long> stale_cache_entries;
 
     unsigned int report_attention_focus_by_percentage(
         vector<AttentionFocusRecord>& attention_focus_candidates);
     unsigned int report_attention_focus(vector<AttentionFocusRecord>& attention_focus_candidates);
 
     void recursive_build(shared_ptr<QueryElement> element, LinkSchema& link_schema);
+    void fetch_importance(vector<pair<char*, float>>& handles);
     void compute_importance(vector<pair<char*, float>>& handles);
-    void processor_method(shared_ptr<StoppableThread> monitor);
+    bool top_k_streaming();
+    // Matches link_schema against tagged_handles[begin, end) fetching the links in batches
+    vector<bool> match_handles(const vector<pair<char*, float>>& tagged_handles,
+                               unsigned int begin,
+                               unsigned int end,
+                               vector<Assignment>& assignments,
+                               shared_ptr<AtomDB> db);
+    bool ranked_globally();
+    // Reads the next chunk of handles (sorted by importance) into tagged_handles. Returns false
+    // iff there are no more handles.
+    bool read_chunk();
+    // Match and report (or collect as attention focus candidates) a slice of tagged_handles
+    // starting at cursor
+    void process_handles(shared_ptr<AtomDB> db);
+    // Match the candidates in tagged_handles (starting at cursor) which would make it into the
+    // top k and keep the ones which match in top_k_heap
+    void stream_top_k(shared_ptr<AtomDB> db);
+    static bool higher_importance(const AttentionFocusRecord& left, const AttentionFocusRecord& right);
+    void push_top_k(const AttentionFocusRecord& record);
+    // Report the contents of top_k_heap in decreasing order of importance
+    void report_top_k();
+    // Max number of links fetched from the AtomDB (0 means no limit)
+    unsigned int fetch_limit();
+    shared_ptr<atomdb_api_types::HandleSet> fetch_handles(const string& link_schema_handle);
+    void fetch_step();
+    void finish_processing();
     void start_thread();
+    bool stop_requested();
 
    public:
     ~LinkTemplate();
@@ -167,14 +263,92 @@ class LinkTemplate : public QueryElement {
      */
     static void clear_cache() { cache.clear(); }
 
+    /**
+     * Set the memory budget of the global LinkTemplate cache. All the current entries are
+     * discarded. Not supposed to be called while queries are being processed.
+     *
+     * @param max_bytes Max (estimated) memory used by the cache. 0 disables the cache.
+     */
+    static void set_cache_capacity(size_t max_bytes) { cache.resize(max_bytes); }
+
     /**
      * Return the global LinkTemplate cache.
      *
      * @return the global LinkTemplate cache.
      */
-    static ThreadSafeHashmap<string, shared_ptr<atomdb_api_types::HandleSet>>& fetched_links_cache() {
-        return cache;
-    }
+    static LRUCache<string, CachedHandles>& fetched_links_cache() { return cache; }
+
+    /**
+     * Return the number of cache lookups which found an entry invalidated by changes in the
+     * AtomDB (these lookups are also counted as hits by the LRUCache).
+     *
+     * @return the number of cache lookups which found a stale entry.
+     */
+    static unsigned long stale_cache_entries_count() { return stale_cache_entries.load(); }
+
+    /**
+     * Set how this LinkTemplate uses the global cache (only relevant when use_cache is true).
+     *
+     * @param refresh If true, cached results are disregarded (the AtomDB is always queried) but the
+     * fresh result still replaces the cached one.
+     * @param max_entry_size Results with more than this number of links are not cached (0 means
+     * no limit other than the cache capacity).
+     */
+    void set_cache_policy(bool refresh, unsigned int max_entry_size);
+
+    /**
+     * Return the number of links matching this LinkTemplate's LinkSchema in the AtomDB, as
+     * reported by AtomDB::count_for_pattern() (i.e. without fetching them). It's an upper bound
+     * of the number of answers of this LinkTemplate. Supposed to be called after build().
+     *
+     * @return the number of links matching this LinkTemplate's LinkSchema.
+     */
+    unsigned int count_matching_links();
+
+    /**
+     * Return true iff the number of answers of this LinkTemplate is exactly the number of links
+     * returned by count_matching_links(). That's the case when all the targets are nodes, atoms or
+     * distinct variables (so every indexed link matches the LinkSchema) and no answer is discarded
+     * because of its importance or by unique_value_flag.
+     *
+     * @return true iff the number of answers is exactly the number of matching links.
+     */
+    bool is_count_exact();
+
+    /**
+     * Enable top-k streaming. Instead of fetching the importance of all the matching links and
+     * sorting them, links are processed in chunks: importance is requested for one chunk at a
+     * time and a bounded heap keeps the best k links seen across all the chunks consumed so far.
+     * Only the links which would make it into the current top k are matched against the
+     * LinkSchema (i.e. fetched), so at most chunk_size + k links are kept in memory and links
+     * below the current k-th importance are never fetched. The answers (the true top k, in
+     * decreasing order of importance) are reported once all the chunks are consumed.
+     *
+     * Only relevant when importance is not disregarded and attention_focus_strictness is 0. Not
+     * supposed to be used in LinkTemplates whose answers are combined by operators (the reported
+     * links are not the whole set of links matching the LinkTemplate). Must be called before
+     * build().
+     *
+     * @param k Max number of links reported (0 disables top-k streaming).
+     * @param chunk_size Number of handles whose importance is requested at once. 0 means
+     * DEFAULT_IMPORTANCE_CHUNK_SIZE.
+     */
+    void set_top_k_streaming(unsigned int k, unsigned int chunk_size = 0);
+
+    /**
+     * Limits the number of links reported by this LinkTemplate. Processing stops as soon as the
+     * limit is reached, so the remaining links are never matched nor fetched from the AtomDB.
+     * Links are still ranked by importance globally before any of them is reported, unless
+     * importance is disregarded (in which case handles are read from the AtomDB in chunks and the
+     * first links which match are the answers) or top-k streaming is enabled.
+     *
+     * Only relevant when attention_focus_strictness is 0. Like set_top_k_streaming(), not supposed
+     * to be used in LinkTemplates whose answers are combined by operators. Must be called before
+     * build().
+     *
+     * @param limit Max number of links reported (0 means no limit).
+     */
+    void set_answer_limit(unsigned int limit);
 
     /**
      * Return the underlying LinkSchema type
@@ -194,5 +368,17 @@ class LinkTemplate : public QueryElement {
      * Empty implementation. There are no QueryNode element or local thread to shut down.
      */
     virtual void graceful_shutdown() {}
+
+    // ThreadMethod API
+
+    /**
+     * Processing starts as soon as the buffers of the source element are set up and it's split in
+     * short steps so the task doesn't hold a worker of the shared executor for long: the first
+     * step fetches the handles (see fetch_handles()), then each step either reads a chunk of them
+     * (computing their importance) or matches and reports a slice of the current chunk. The task
+     * yields while the output buffer is full (see QueryNode::has_room()).
+     */
+    virtual bool thread_one_step();
+    virtual bool thread_finished();
 };
 }  // namespace query_element
@@ -2,7 +2,9 @@
 
 #include <mutex>
 
+#include "EventSignal.h"
 #include "Logger.h"
+#include "PooledThread.h"
 #include "QueryAnswer.h"
 #include "QueryElement.h"
 
@@ -23,6 +25,9 @@ namespace query_element {
 template <unsigned int N>
 class Operator : public QueryElement {
    public:
+    // Max time (in milliseconds) given to the job to deliver its pending answers on shutdown
+    static constexpr unsigned int SHUTDOWN_DELIVERY_TIMEOUT = 500;
+
     // --------------------------------------------------------------------------------------------
     // Constructors and destructors
 
@@ -40,6 +45,8 @@ class Operator : public QueryElement {
             this->input_buffer[i] = nullptr;
         }
         this->output_buffer = nullptr;
+        this->input_signal = make_shared<EventSignal>();
+        this->operator_thread = nullptr;
     }
 
     /**
@@ -61,7 +68,9 @@ class Operator : public QueryElement {
      * Sets up buffers for communication between this operator and its upstream and downstream
      * QueryElements. Initializes a single QueryNodeClient for the upstream connection and
      * N QueryNodeServer elements for the downstream connections, each corresponding to a clause
-     * in the operation.
+     * in the operation. All the N QueryNodeServer elements notify the same EventSignal when new
+     * answers arrive so concrete operators have their operator_thread woken up (see
+     * start_operator_thread()). The query's CancellationToken is passed down to the clauses.
      */
     virtual void setup_buffers() {
         LOG_LOCAL_DEBUG("Setting up buffers for Operator: " + std::to_string((unsigned long) this));
@@ -77,7 +86,9 @@ class Operator : public QueryElement {
         for (unsigned int i = 0; i < N; i++) {
             server_node_id = this->id + "_" + std::to_string(i);
             this->input_buffer[i] = make_shared<QueryNodeServer>(server_node_id);
+            this->input_buffer[i]->set_query_answer_signal(this->input_signal);
             this->precedent[i]->subsequent_id = server_node_id;
+            this->precedent[i]->cancellation_token = this->cancellation_token;
             LOG_LOCAL_DEBUG("Setting up precedent[" + std::to_string(i) +
                             "] buffers for Operator: " + std::to_string((unsigned long) this) + "...");
             this->precedent[i]->setup_buffers();
@@ -88,7 +99,8 @@ class Operator : public QueryElement {
 
     /**
      * Gracefully shuts down the QueryNodes attached to the upstream and downstream communication
-     * in the query tree.
+     * in the query tree. Unless the query has been cancelled, the QueryNodes are shut down once the
+     * operator's job has delivered all its answers (or after SHUTDOWN_DELIVERY_TIMEOUT).
      */
     virtual void graceful_shutdown() {
         LOG_LOCAL_DEBUG("Gracefully shutting down Operator: " + std::to_string((unsigned long) this) +
@@ -106,7 +118,13 @@ class Operator : public QueryElement {
                             "] of Operator: " + std::to_string((unsigned long) this) + "... Done");
         }
         set_flow_finished();
-        Utils::sleep(500);
+        this->input_signal->notify();
+        if (is_cancelled()) {
+            // There's nothing left to be delivered downstream so the job is just retired
+            stop_operator_thread();
+        } else if (this->output_buffer != nullptr) {
+            this->output_buffer->wait_work_done(SHUTDOWN_DELIVERY_TIMEOUT);
+        }
         if (this->output_buffer != nullptr) {
             LOG_LOCAL_DEBUG("Gracefully shutting down output buffer of Operator: " +
                             std::to_string((unsigned long) this) + "...");
@@ -129,6 +147,52 @@ class Operator : public QueryElement {
     shared_ptr<QueryElement> precedent[N];
     shared_ptr<QueryNodeServer> input_buffer[N];
     shared_ptr<QueryNodeClient> output_buffer;
+    shared_ptr<EventSignal> input_signal;
+    shared_ptr<PooledThread> operator_thread;
+
+    /**
+     * Starts running the passed job in a WorkStealingExecutor. The job is woken up
+     * whenever input_signal is notified (i.e. when new answers arrive in any of the input buffers)
+     * and it's retired when the query is cancelled.
+     *
+     * @param job The operator's job. Its thread_one_step() is supposed to return false (rather
+     * than blocking) when there's no input to process.
+     * @param executor Executor where the job is run (nullptr means the shared one). Operators
+     * whose steps block on AtomDB calls are supposed to pass WorkStealingExecutor::get_shared_io().
+     */
+    void start_operator_thread(ThreadMethod* job, shared_ptr<WorkStealingExecutor> executor = nullptr) {
+        this->operator_thread = make_shared<PooledThread>(
+            this->id + ":operator_thread", job, this->cancellation_token, executor);
+        shared_ptr<PooledThread> operator_thread = this->operator_thread;
+        this->input_signal->set_listener([operator_thread]() { operator_thread->wake(); });
+        this->operator_thread->setup();
+        this->operator_thread->start();
+    }
+
+    /**
+     * Checks whether the output buffer can take more answers (see QueryNode::has_room()). If it
+     * can't, the job started by start_operator_thread() is woken up when it can, so the job is
+     * supposed to just yield (i.e. return false from thread_one_step()).
+     *
+     * @return true iff the output buffer can take more answers.
+     */
+    bool output_buffer_has_room() {
+        shared_ptr<PooledThread> operator_thread = this->operator_thread;
+        return this->output_buffer->has_room([operator_thread]() {
+            if (operator_thread != nullptr) {
+                operator_thread->wake();
+            }
+        });
+    }
+
+    /**
+     * Synchronously stops the job started by start_operator_thread() (if any).
+     */
+    void stop_operator_thread() {
+        if ((this->operator_thread != nullptr) && !this->operator_thread->is_finished()) {
+            this->operator_thread->stop();
+        }
+    }
 
    private:
     void initialize(const array<shared_ptr<QueryElement>, N>& clauses) {
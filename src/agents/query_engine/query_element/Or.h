@@ -17,7 +17,7 @@ namespace query_element {
  * Or operates on N clauses. Each clause can be either a Source or another Operator.
  */
 template <unsigned int N>
-class Or : public Operator<N> {
+class Or : public Operator<N>, public ThreadMethod {
    public:
     // --------------------------------------------------------------------------------------------
     // Constructors and destructors
@@ -47,16 +47,52 @@ class Or : public Operator<N> {
 
     virtual void setup_buffers() {
         Operator<N>::setup_buffers();
-        this->operator_thread = new thread(&Or::or_operator_method, this);
+        this->start_operator_thread(this);
     }
 
     virtual void graceful_shutdown() {
         Operator<N>::graceful_shutdown();
-        if (this->operator_thread != NULL) {
-            this->operator_thread->join();
-            delete this->operator_thread;
-            this->operator_thread = NULL;
+        this->stop_operator_thread();
+    }
+
+    // --------------------------------------------------------------------------------------------
+    // ThreadMethod API
+
+    virtual bool thread_one_step() {
+        if (!this->output_buffer_has_room()) {
+            // Woken up when the output buffer is drained
+            return false;
+        }
+        ingest_newly_arrived_answers();
+        if (!ready_to_process_candidate()) {
+            return false;
         }
+        if (processed_all_input()) {
+            bool all_finished_flag = true;
+            for (unsigned int i = 0; i < N; i++) {
+                if (!this->input_buffer[i]->is_query_answers_finished()) {
+                    all_finished_flag = false;
+                    break;
+                }
+            }
+            if (all_finished_flag && !this->output_buffer->is_query_answers_finished() &&
+                // processed_all_input() is double-checked on purpose to avoid race condition
+                processed_all_input()) {
+                this->output_buffer->query_answers_finished();
+                LOG_INFO(this->id << " processed " << this->answer_count << " answers.");
+            }
+            return false;
+        }
+        unsigned int selected_clause = select_answer();
+        QueryAnswer* selected_query_answer =
+            this->query_answer[selected_clause][this->next_input_to_process[selected_clause]++];
+        this->output_buffer->add_query_answer(selected_query_answer);
+        this->answer_count++;
+        return true;
+    }
+
+    virtual bool thread_finished() {
+        return QueryElement::is_flow_finished() || this->output_buffer->is_query_answers_finished();
     }
 
     // --------------------------------------------------------------------------------------------
@@ -67,12 +103,10 @@ class Or : public Operator<N> {
     unsigned int next_input_to_process[N];
     bool all_answers_arrived[N];
     bool no_more_answers_to_arrive;
-    thread* operator_thread;
     unsigned int answer_count;
     vector<shared_ptr<QueryElement>> link_templates;
 
     void initialize(const array<shared_ptr<QueryElement>, N>& clauses) {
-        this->operator_thread = NULL;
         for (unsigned int i = 0; i < N; i++) {
             this->next_input_to_process[i] = 0;
             this->all_answers_arrived[i] = false;
@@ -106,11 +140,9 @@ class Or : public Operator<N> {
         }
         QueryAnswer* answer;
         unsigned int all_arrived_count = 0;
-        bool no_new_answer = true;
         for (unsigned int i = 0; i < N; i++) {
             while ((answer = dynamic_cast<QueryAnswer*>(this->input_buffer[i]->pop_query_answer())) !=
                    NULL) {
-                no_new_answer = false;
                 this->query_answer[i].push_back(answer);
             }
             if (this->input_buffer[i]->is_query_answers_empty() &&
@@ -121,10 +153,6 @@ class Or : public Operator<N> {
         }
         if (all_arrived_count == N) {
             this->no_more_answers_to_arrive = true;
-        } else {
-            if (no_new_answer) {
-                Utils::sleep();
-            }
         }
     }
 
@@ -157,49 +185,6 @@ class Or : public Operator<N> {
         }
         return best_index;
     }
-
-    void or_operator_method() {
-        STOP_WATCH_START(or_operator);
-        do {
-            if (QueryElement::is_flow_finished() || this->output_buffer->is_query_answers_finished()) {
-                STOP_WATCH_FINISH(or_operator, "OR");
-                return;
-            }
-
-            do {
-                if (QueryElement::is_flow_finished()) {
-                    STOP_WATCH_FINISH(or_operator, "OR");
-                    return;
-                }
-                ingest_newly_arrived_answers();
-            } while (!ready_to_process_candidate());
-
-            if (processed_all_input()) {
-                bool all_finished_flag = true;
-                for (unsigned int i = 0; i < N; i++) {
-                    if (!this->input_buffer[i]->is_query_answers_finished()) {
-                        all_finished_flag = false;
-                        break;
-                    }
-                }
-                if (all_finished_flag && !this->output_buffer->is_query_answers_finished() &&
-                    // processed_all_input() is double-checked on purpose to avoid race condition
-                    processed_all_input()) {
-                    this->output_buffer->query_answers_finished();
-                    LOG_INFO(this->id << " processed " << this->answer_count << " answers.");
-                }
-                Utils::sleep();
-                continue;
-            }
-
-            unsigned int selected_clause = select_answer();
-            QueryAnswer* selected_query_answer =
-                this->query_answer[selected_clause][this->next_input_to_process[selected_clause]++];
-            this->output_buffer->add_query_answer(selected_query_answer);
-            this->answer_count++;
-        } while (true);
-        STOP_WATCH_FINISH(or_operator, "OR");
-    }
 };
 
 }  // namespace query_element
@@ -11,6 +11,7 @@ QueryElement::QueryElement() {
     this->is_operator = false;
     this->arity = 0;
     this->reverse_nesting_level = 0;
+    this->cancellation_token = nullptr;
 }
 
 QueryElement::~QueryElement() {}
@@ -20,6 +21,10 @@ QueryElement::~QueryElement() {}
 
 string QueryElement::to_string() { return ""; }
 
+bool QueryElement::is_cancelled() {
+    return (this->cancellation_token != nullptr) && this->cancellation_token->is_cancelled();
+}
+
 // ------------------------------------------------------------------------------------------------
 // Protected methods
 
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 
+#include "CancellationToken.h"
 #include "QueryNode.h"
 #include "Utils.h"
 
@@ -11,6 +12,7 @@
 using namespace std;
 using namespace query_node;
 using namespace commons;
+using namespace processor;
 
 namespace query_element {
 
@@ -39,8 +41,9 @@ namespace query_element {
  *
  * Links that reach the root of the tree are considered actual query answers.
  *
- * Each QueryElement is an element in a distributed algorithm, with one or more threads processing
- * its inputs and generating outputs according to the logic of each element. A communication
+ * Each QueryElement is an element in a distributed algorithm, with one or more tasks (run by the
+ * WorkStealingExecutor shared by all queries rather than by dedicated threads) processing its
+ * inputs and generating outputs according to the logic of each element. A communication
  * framework is used to flow the links up through the tree using our DistributedAlgorithmNode
  * which is essentially a framework to implement the basic functionalities required by a
  * distributed algorithm. Since this framework allows communication either intra-process and
@@ -55,6 +58,13 @@ class QueryElement {
     unsigned int arity;
     unsigned int reverse_nesting_level;
 
+    /**
+     * Token shared by all the QueryElements in the same query tree. It's created by the Sink and
+     * passed down the tree (just like subsequent_id) in setup_buffers(). Cancelling it makes all
+     * the elements of the query stop processing answers.
+     */
+    shared_ptr<CancellationToken> cancellation_token;
+
     /**
      * Basic constructor which solely initialize variables.
      */
@@ -91,6 +101,11 @@ class QueryElement {
 
     virtual string to_string();
 
+    /**
+     * Returns true iff the query this QueryElement belongs to has been cancelled.
+     */
+    bool is_cancelled();
+
    protected:
     /**
      * Return true iff this QueryElement have finished its work in the flow of links up through
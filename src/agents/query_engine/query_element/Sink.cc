@@ -38,8 +38,12 @@ void Sink::setup_buffers() {
     if (this->id == "") {
         RAISE_ERROR("Invalid empty id");
     }
+    if (this->cancellation_token == nullptr) {
+        this->cancellation_token = make_shared<CancellationToken>();
+    }
     this->input_buffer = make_shared<QueryNodeServer>(this->id);
     this->precedent->subsequent_id = this->id;
+    this->precedent->cancellation_token = this->cancellation_token;
     LOG_LOCAL_DEBUG("Setting up precedent buffers for Sink: " + std::to_string((unsigned long) this) +
                     "...");
     this->precedent->setup_buffers();
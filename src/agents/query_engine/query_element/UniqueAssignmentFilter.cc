@@ -18,7 +18,6 @@ UniqueAssignmentFilter::~UniqueAssignmentFilter() { graceful_shutdown(); }
 
 void UniqueAssignmentFilter::initialize(const shared_ptr<QueryElement>& input) {
     this->id = "UniqueAssignmentFilter(" + input->id + ")";
-    this->operator_thread = NULL;
     LOG_INFO(this->id);
 }
 
@@ -27,7 +26,7 @@ void UniqueAssignmentFilter::initialize(const shared_ptr<QueryElement>& input) {
 
 void UniqueAssignmentFilter::setup_buffers() {
     Operator<1>::setup_buffers();
-    this->operator_thread = new thread(&UniqueAssignmentFilter::thread_filter, this);
+    start_operator_thread(this);
 }
 
 void UniqueAssignmentFilter::graceful_shutdown() {
@@ -35,38 +34,38 @@ void UniqueAssignmentFilter::graceful_shutdown() {
         return;
     }
     Operator<1>::graceful_shutdown();
-    if (this->operator_thread != NULL) {
-        this->operator_thread->join();
-        delete this->operator_thread;
-        this->operator_thread = NULL;
-    }
+    stop_operator_thread();
 }
 
 // -------------------------------------------------------------------------------------------------
-// Private methods
-
-void UniqueAssignmentFilter::thread_filter() {
-    unordered_set<Assignment> already_used;
+// ThreadMethod API
 
-    while (true) {
-        if ((this->input_buffer[0]->is_query_answers_finished() &&
-             this->input_buffer[0]->is_query_answers_empty()) ||
-            Operator<1>::is_flow_finished()) {
-            this->output_buffer->query_answers_finished();
-            break;
-        }
-        QueryAnswer* answer = dynamic_cast<QueryAnswer*>(this->input_buffer[0]->pop_query_answer());
-        if (answer != NULL) {
-            if (already_used.find(answer->assignment) == already_used.end()) {
-                // New assignment. Let the QueryAnswer pass.
-                already_used.insert(answer->assignment);
-                this->output_buffer->add_query_answer(answer);
-            } else {
-                // Assignment has already been processed. Delete duplicate QueryAnswer.
-                delete answer;
-            }
-        } else {
-            Utils::sleep();
-        }
+bool UniqueAssignmentFilter::thread_one_step() {
+    if ((this->input_buffer[0]->is_query_answers_finished() &&
+         this->input_buffer[0]->is_query_answers_empty()) ||
+        Operator<1>::is_flow_finished()) {
+        this->output_buffer->query_answers_finished();
+        return false;
+    }
+    if (!output_buffer_has_room()) {
+        // Woken up when the output buffer is drained
+        return false;
+    }
+    QueryAnswer* answer = dynamic_cast<QueryAnswer*>(this->input_buffer[0]->pop_query_answer());
+    if (answer == NULL) {
+        return false;
     }
+    if (this->already_used.find(answer->assignment) == this->already_used.end()) {
+        // New assignment. Let the QueryAnswer pass.
+        this->already_used.insert(answer->assignment);
+        this->output_buffer->add_query_answer(answer);
+    } else {
+        // Assignment has already been processed. Delete duplicate QueryAnswer.
+        delete answer;
+    }
+    return true;
+}
+
+bool UniqueAssignmentFilter::thread_finished() {
+    return this->output_buffer->is_query_answers_finished();
 }
@@ -14,7 +14,7 @@ namespace query_element {
  * no tokens associated with it to explicitly put it in a query. The caller is supposed to
  * build a proxy object setting an unique assignment flag in proxy's constructor.
  */
-class UniqueAssignmentFilter : public Operator<1> {
+class UniqueAssignmentFilter : public Operator<1>, public ThreadMethod {
    public:
     // --------------------------------------------------------------------------------------------
     // Constructors and destructors
@@ -45,14 +45,19 @@ class UniqueAssignmentFilter : public Operator<1> {
      */
     virtual void graceful_shutdown();
 
+    // --------------------------------------------------------------------------------------------
+    // ThreadMethod API
+
+    virtual bool thread_one_step();
+    virtual bool thread_finished();
+
     // --------------------------------------------------------------------------------------------
     // Private stuff
 
    private:
-    thread* operator_thread;
+    unordered_set<Assignment> already_used;
 
     void initialize(const shared_ptr<QueryElement>& input);
-    void thread_filter();
 };
 
 }  // namespace query_element
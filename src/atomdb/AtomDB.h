@@ -1,11 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "AtomDBAPITypes.h"
+#include "Handle.h"
 #include "HandleDecoder.h"
 #include "LinkSchema.h"
 #include "Merger.h"
@@ -60,9 +63,39 @@ class AtomDB : public HandleDecoder {
     virtual vector<shared_ptr<Atom>> get_matching_atoms(bool is_toplevel, Atom& key) = 0;
 
     virtual shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema) = 0;
+
+    /**
+     * Same as query_for_pattern(link_schema) but backends are allowed to stop fetching after
+     * max_results handles (0 means no limit). The limit is a hint: backends which can't push it
+     * down return the whole set, so callers are still supposed to stop iterating by themselves.
+     */
+    virtual shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema,
+                                                                      unsigned int max_results) {
+        return query_for_pattern(link_schema);
+    }
+
+    /**
+     * Returns the number of links matching the passed LinkSchema, i.e. the size of the set which
+     * would be returned by query_for_pattern(), without fetching it. Used by QueryCostEstimator to
+     * estimate the cost of query elements. Backends which keep the pattern index in sets are
+     * supposed to override this with a cheaper implementation.
+     */
+    virtual unsigned int count_for_pattern(const LinkSchema& link_schema) {
+        auto handle_set = query_for_pattern(link_schema);
+        return (handle_set == nullptr ? 0 : handle_set->size());
+    }
+
     virtual shared_ptr<atomdb_api_types::HandleList> query_for_targets(const string& handle) = 0;
     virtual shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle) = 0;
 
+    /**
+     * Same as query_for_incoming_set(handle) with max_results as a hint (see query_for_pattern()).
+     */
+    virtual shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle,
+                                                                           unsigned int max_results) {
+        return query_for_incoming_set(handle);
+    }
+
     virtual bool atom_exists(const string& handle) = 0;
     virtual bool node_exists(const string& handle) = 0;
     virtual bool link_exists(const string& handle) = 0;
@@ -114,10 +147,95 @@ class AtomDB : public HandleDecoder {
 
     bool empty() const { return atom_count() == 0; }
 
+    // Convenience overloads taking fixed-width Handles. They convert the Handle to its hex
+    // representation at this boundary and forward the call to the std::string API above.
+
+    shared_ptr<Atom> get_atom(const Handle& handle) { return get_atom(handle.to_string()); }
+    shared_ptr<Node> get_node(const Handle& handle) { return get_node(handle.to_string()); }
+    shared_ptr<Link> get_link(const Handle& handle) { return get_link(handle.to_string()); }
+
+    shared_ptr<atomdb_api_types::HandleList> query_for_targets(const Handle& handle) {
+        return query_for_targets(handle.to_string());
+    }
+    shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const Handle& handle) {
+        return query_for_incoming_set(handle.to_string());
+    }
+
+    bool atom_exists(const Handle& handle) { return atom_exists(handle.to_string()); }
+    bool node_exists(const Handle& handle) { return node_exists(handle.to_string()); }
+    bool link_exists(const Handle& handle) { return link_exists(handle.to_string()); }
+
+    bool delete_atom(const Handle& handle, bool delete_link_targets = false) {
+        return delete_atom(handle.to_string(), delete_link_targets);
+    }
+    bool delete_node(const Handle& handle, bool delete_link_targets = false) {
+        return delete_node(handle.to_string(), delete_link_targets);
+    }
+    bool delete_link(const Handle& handle, bool delete_link_targets = false) {
+        return delete_link(handle.to_string(), delete_link_targets);
+    }
+
     virtual vector<atomdb_api_types::AccessPermissionDocument> get_access_permissions(
         const atomdb_api_types::PublicKey& public_key) const {
         return {};
     }
+
+    // ---------------------------------------------------------------------------------------------
+    // Pattern generations
+    //
+    // Process-wide counters used to invalidate caches of query_for_pattern() results (e.g. the one
+    // in LinkTemplate). Counters are kept in a fixed number of buckets keyed by (link type, arity,
+    // first target) so adding a link only changes the generation of the patterns it may match:
+    // patterns with the same (or a wildcard) type and first target. Deletions (which
+    // may cascade) and bulk changes of the pattern index change the generation of all patterns.
+    //
+    // Callers read the generation BEFORE querying the AtomDB; a cached result is valid as long as
+    // the generation of its pattern doesn't change. Writes made by other processes to a shared
+    // backend are not tracked.
+
+    /**
+     * Returns the current generation of the passed pattern.
+     *
+     * @param link_schema Pattern.
+     * @return the current generation of the passed pattern.
+     */
+    static unsigned long pattern_generation(const LinkSchema& link_schema) {
+        const auto& targets = link_schema.targets();
+        const string& first = targets.empty() ? Atom::WILDCARD_STRING : targets[0];
+        return global_generation.load() +
+               generation_bucket(link_schema.type, link_schema.arity(), first).load();
+    }
+
+   protected:
+    /**
+     * Must be called by AtomDB implementations after a new link is inserted (and indexed).
+     */
+    static void link_added(const string& type, const vector<string>& targets) {
+        if (targets.empty()) return;
+        const string& wildcard = Atom::WILDCARD_STRING;
+        generation_bucket(type, targets.size(), targets[0])++;
+        generation_bucket(type, targets.size(), wildcard)++;
+        generation_bucket(wildcard, targets.size(), targets[0])++;
+        generation_bucket(wildcard, targets.size(), wildcard)++;
+    }
+
+    /**
+     * Must be called by AtomDB implementations after atoms are deleted or the pattern index is
+     * changed by any operation other than link insertion.
+     */
+    static void pattern_index_changed() { global_generation++; }
+
+   private:
+    static const unsigned int GENERATION_BUCKETS = 4096;
+    inline static atomic<unsigned long> global_generation{0};
+    inline static atomic<unsigned long> generations[GENERATION_BUCKETS] = {};
+
+    static atomic<unsigned long>& generation_bucket(const string& type,
+                                                    unsigned int arity,
+                                                    const string& first_target) {
+        size_t key = hash<string>()(type) ^ (hash<string>()(first_target) * 31) ^ arity;
+        return generations[key % GENERATION_BUCKETS];
+    }
 };
 
 }  // namespace atomdb
@@ -57,6 +57,17 @@ class HandleSet {
 
     virtual map<string, string> get_metta_expressions_by_handle(const string& handle) = 0;
     virtual Assignment get_assignments_by_handle(const string& handle) = 0;
+
+    /**
+     * Returns true iff this set may be missing some of the handles in the answer of the query which
+     * built it (e.g. because some federated peer didn't answer in time). Partial sets must not be
+     * cached as if they were the whole answer.
+     */
+    bool is_partial() { return this->partial; }
+    void set_partial(bool flag) { this->partial = flag; }
+
+   private:
+    bool partial = false;
 };
 
 class AtomDocument {
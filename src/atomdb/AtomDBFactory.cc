@@ -88,7 +88,10 @@ shared_ptr<AtomDB> AtomDBFactory::create_composite_atomdb(const JsonConfig& conf
                 create_basic_atomdb(peer_config, peer_context), local_persistence, uid);
         }
 
-        atomdb = make_shared<RemoteAtomDB>(remote_peers);
+        auto remote_atomdb = make_shared<RemoteAtomDB>(remote_peers);
+        remote_atomdb->set_peer_timeout(config.at_path("peer_timeout_ms").get_or<unsigned int>(0));
+        remote_atomdb->set_parallel_fanout(config.at_path("parallel_fanout").get_or<bool>(true));
+        atomdb = remote_atomdb;
     } else if (type == AtomDBType::AdapterDB) {
         // The backend AtomDB in AdapterDB could be RemoteAtomDB ?
         auto atomdb_backend_config =
@@ -75,6 +75,11 @@ shared_ptr<Atom> AdapterDB::get_atom(const string& handle) {
     return this->atomdb_backend->get_atom(handle);
 }
 
+vector<shared_ptr<Atom>> AdapterDB::get_atoms(const vector<string>& handles) {
+    this->ensure_backend_ready();
+    return this->atomdb_backend->get_atoms(handles);
+}
+
 shared_ptr<Node> AdapterDB::get_node(const string& handle) {
     this->ensure_backend_ready();
     return this->atomdb_backend->get_node(handle);
@@ -95,6 +100,17 @@ shared_ptr<atomdb_api_types::HandleSet> AdapterDB::query_for_pattern(const LinkS
     return this->atomdb_backend->query_for_pattern(link_schema);
 }
 
+shared_ptr<atomdb_api_types::HandleSet> AdapterDB::query_for_pattern(const LinkSchema& link_schema,
+                                                                     unsigned int max_results) {
+    this->ensure_backend_ready();
+    return this->atomdb_backend->query_for_pattern(link_schema, max_results);
+}
+
+unsigned int AdapterDB::count_for_pattern(const LinkSchema& link_schema) {
+    this->ensure_backend_ready();
+    return this->atomdb_backend->count_for_pattern(link_schema);
+}
+
 shared_ptr<atomdb_api_types::HandleList> AdapterDB::query_for_targets(const string& handle) {
     this->ensure_backend_ready();
     return this->atomdb_backend->query_for_targets(handle);
@@ -105,6 +121,12 @@ shared_ptr<atomdb_api_types::HandleSet> AdapterDB::query_for_incoming_set(const
     return this->atomdb_backend->query_for_incoming_set(handle);
 }
 
+shared_ptr<atomdb_api_types::HandleSet> AdapterDB::query_for_incoming_set(const string& handle,
+                                                                          unsigned int max_results) {
+    this->ensure_backend_ready();
+    return this->atomdb_backend->query_for_incoming_set(handle, max_results);
+}
+
 bool AdapterDB::atom_exists(const string& handle) {
     this->ensure_backend_ready();
     return this->atomdb_backend->atom_exists(handle);
@@ -34,6 +34,19 @@ inline AdapterDbType parse_adapter_db_type(const string& value) {
 
 class AdapterDB : public AtomDB {
    public:
+    // Handle overloads from AtomDB (otherwise hidden by the overrides below)
+    using AtomDB::get_atom;
+    using AtomDB::get_node;
+    using AtomDB::get_link;
+    using AtomDB::query_for_targets;
+    using AtomDB::query_for_incoming_set;
+    using AtomDB::atom_exists;
+    using AtomDB::node_exists;
+    using AtomDB::link_exists;
+    using AtomDB::delete_atom;
+    using AtomDB::delete_node;
+    using AtomDB::delete_link;
+
     AdapterDB(const JsonConfig& config, shared_ptr<AtomDB> backend, const string& context = "");
     ~AdapterDB() override;
 
@@ -63,16 +76,22 @@ class AdapterDB : public AtomDB {
     bool composite_type_enabled() const override;
 
     shared_ptr<Atom> get_atom(const string& handle) override;
+    vector<shared_ptr<Atom>> get_atoms(const vector<string>& handles) override;
     shared_ptr<Node> get_node(const string& handle) override;
     shared_ptr<Link> get_link(const string& handle) override;
 
     vector<shared_ptr<Atom>> get_matching_atoms(bool is_toplevel, Atom& key) override;
 
     shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema) override;
+    shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema,
+                                                              unsigned int max_results) override;
+    unsigned int count_for_pattern(const LinkSchema& link_schema) override;
 
     shared_ptr<atomdb_api_types::HandleList> query_for_targets(const string& handle) override;
 
     shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle) override;
+    shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle,
+                                                                   unsigned int max_results) override;
 
     bool atom_exists(const string& handle) override;
     bool node_exists(const string& handle) override;
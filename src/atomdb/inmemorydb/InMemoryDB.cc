@@ -1,6 +1,13 @@
 #include "InMemoryDB.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <memory>
 #include <utility>
 
@@ -20,27 +27,100 @@ using namespace atomdb_api_types;
 using namespace atoms;
 using namespace commons;
 
+// Read-only memory mapping of a snapshot file. Atoms loaded from a snapshot keep a
+// reference to it until they are decoded, so the file is unmapped only when the last
+// pending atom is decoded (or dropped).
+class SnapshotFile {
+   public:
+    SnapshotFile(const string& file_name) : data_(NULL), size_(0) {
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) {
+            RAISE_ERROR("Couldn't open snapshot file: " + file_name);
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0) {
+            close(fd);
+            RAISE_ERROR("Couldn't stat snapshot file: " + file_name);
+        }
+        size_ = (size_t) file_stat.st_size;
+        if (size_ > 0) {
+            void* data = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                close(fd);
+                RAISE_ERROR("Couldn't mmap snapshot file: " + file_name);
+            }
+            data_ = (const char*) data;
+        }
+        close(fd);
+    }
+    ~SnapshotFile() {
+        if (data_ != NULL) {
+            munmap((void*) data_, size_);
+        }
+    }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+   private:
+    const char* data_;
+    size_t size_;
+};
+
 // Wraps an Atom in HandleTrie. The atom is held via shared_ptr and handed out with a
 // refcount bump taken under the trie node lock (get_stored_object), so readers keep it
 // alive while concurrent upserts/deletes replace or drop the trie's own reference.
 // Stored atoms are never mutated in place: merge() swaps the pointer wholesale.
+//
+// Atoms loaded from a snapshot are kept in their serialized form (pointing into the
+// mmapped file) and decoded only on first access.
 class AtomTrieValue : public HandleTrie::TrieValue {
    public:
-    AtomTrieValue(Atom* atom) : atom_(atom) {}
+    AtomTrieValue(Atom* atom) : atom_(atom), record_(NULL), record_size_(0) {}
+    AtomTrieValue(shared_ptr<SnapshotFile> snapshot, const char* record, uint32_t record_size)
+        : snapshot_(snapshot), record_(record), record_size_(record_size) {}
     ~AtomTrieValue() override = default;
     // Runs under the node lock (HandleTrie::insert on a duplicate key): replace the
     // stored atom. Readers holding a reference keep the previous atom alive.
     void merge(HandleTrie::TrieValue* other) override {
-        atom_ = std::move(dynamic_cast<AtomTrieValue*>(other)->atom_);
+        atom_ = std::move(dynamic_cast<AtomTrieValue*>(other)->get_atom_ref());
+        snapshot_.reset();
     }
     // Runs under the node lock (HandleTrie::lookup_stored_object): hand out an owning
     // reference. The caller takes ownership of the returned shared_ptr wrapper.
-    void* get_stored_object(bool /*clone*/) override { return new shared_ptr<Atom>(atom_); }
+    void* get_stored_object(bool /*clone*/) override { return new shared_ptr<Atom>(get_atom()); }
     // Writer-side accessor — safe only under InMemoryDB::write_mutex_ or the node lock.
-    const shared_ptr<Atom>& get_atom() const { return atom_; }
+    // Lazy decoding runs once even if a writer and a reader race for it.
+    const shared_ptr<Atom>& get_atom() const {
+        call_once(decoded_, [this]() {
+            if ((atom_ == nullptr) && (record_ != NULL)) {
+                atom_ = decode_snapshot_record(record_, record_size_);
+            }
+            snapshot_.reset();
+        });
+        return atom_;
+    }
+    // Serialized form of a not-yet-decoded atom (NULL otherwise). Safe under the node lock.
+    const char* pending_record(uint32_t& record_size) const {
+        if ((snapshot_ == nullptr) || (atom_ != nullptr)) {
+            return NULL;
+        }
+        record_size = record_size_;
+        return record_;
+    }
 
    private:
-    shared_ptr<Atom> atom_;
+    shared_ptr<Atom>& get_atom_ref() {
+        get_atom();
+        return atom_;
+    }
+
+    mutable shared_ptr<Atom> atom_;
+    mutable shared_ptr<SnapshotFile> snapshot_;
+    const char* record_;
+    uint32_t record_size_;
+    mutable once_flag decoded_;
+
+    static shared_ptr<Atom> decode_snapshot_record(const char* record, uint32_t record_size);
 };
 
 // Stores a set of atom handles in HandleTrie for pattern / incoming-set indexing.
@@ -50,6 +130,7 @@ class HandleSetTrieValue : public HandleTrie::TrieValue {
    public:
     HandleSetTrieValue() {}
     explicit HandleSetTrieValue(const string& handle) : handle_set_({handle}) {}
+    explicit HandleSetTrieValue(set<string>&& handles) : handle_set_(std::move(handles)) {}
     ~HandleSetTrieValue() override {}
     // Runs under the node lock (HandleTrie::insert on a duplicate key): union the sets.
     void merge(HandleTrie::TrieValue* other) override {
@@ -63,6 +144,7 @@ class HandleSetTrieValue : public HandleTrie::TrieValue {
     void* get_stored_object(bool /*clone*/) override { return new set<string>(handle_set_); }
     void remove_handle(const string& handle) { handle_set_.erase(handle); }
     bool empty() const { return handle_set_.empty(); }
+    size_t size() const { return handle_set_.size(); }
 
    private:
     set<string> handle_set_;
@@ -97,6 +179,20 @@ unique_ptr<set<string>> lookup_handle_set(HandleTrie& trie, const string& key) {
     return unique_ptr<set<string>>(static_cast<set<string>*>(trie.lookup_stored_object(key, false)));
 }
 
+// Size of the handle set stored at `key` (0 if absent). Read under the node lock via
+// HandleTrie::update without copying the set.
+size_t count_handle_set(HandleTrie& trie, const string& key) {
+    size_t count = 0;
+    trie.update(
+        key,
+        [](HandleTrie::TrieValue* value, void* data) -> bool {
+            *static_cast<size_t*>(data) = dynamic_cast<HandleSetTrieValue*>(value)->size();
+            return false;
+        },
+        &count);
+    return count;
+}
+
 // Inserts `handle` into the handle set stored at `key`, creating the entry if absent.
 // HandleTrie::insert runs HandleSetTrieValue::merge under the node lock, so the
 // mutation is safe against concurrent reader snapshots.
@@ -137,8 +233,212 @@ vector<vector<string>> index_entries_combinations(unsigned int arity) {
 
     return index_entries;
 }
+
+// ---------------------------------------------------------------------------
+// Snapshot format (all integers in host byte order):
+//
+//   SnapshotHeader
+//   atom_count x     [16-byte handle][uint32 record_size][record]
+//   pattern_count x  [16-byte key][uint32 n][n x 16-byte handle]
+//   incoming_count x [16-byte key][uint32 n][n x 16-byte handle]
+//
+// record: [uint8 ATOM_RECORD_NODE | ATOM_RECORD_LINK][uint32 token_count]
+//         token_count x [uint32 size][bytes]     (tokens as in Atom::tokenize())
+//
+// checksum is the 64-bit FNV-1a hash of everything after the header.
+// ---------------------------------------------------------------------------
+
+const char SNAPSHOT_MAGIC[8] = {'D', 'A', 'S', 'I', 'M', 'D', 'B', '\0'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint8_t ATOM_RECORD_NODE = 0;
+const uint8_t ATOM_RECORD_LINK = 1;
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t handle_size;
+    uint64_t atom_count;
+    uint64_t pattern_count;
+    uint64_t incoming_count;
+    uint64_t payload_size;
+    uint64_t checksum;
+};
+
+uint64_t fnv1a(uint64_t hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char) data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Buffered writer which keeps track of the payload size and checksum. Data is written to a
+// temporary file which is renamed to the actual file name in close(). So an existing snapshot
+// is never truncated (it may be mmapped by an InMemoryDB) and a partially written snapshot
+// never replaces a valid one.
+class SnapshotWriter {
+   public:
+    uint64_t payload_size;
+    uint64_t checksum;
+
+    SnapshotWriter(const string& file_name)
+        : payload_size(0), checksum(FNV_OFFSET_BASIS), file_name(file_name) {
+        this->temp_file_name = file_name + ".tmp";
+        this->file.open(this->temp_file_name, ios::binary | ios::trunc);
+        if (!this->file.is_open()) {
+            RAISE_ERROR("Couldn't open snapshot file for writing: " + this->temp_file_name);
+        }
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        this->file.write((const char*) &header, sizeof(header));
+    }
+
+    void write(const void* data, size_t size) {
+        this->file.write((const char*) data, size);
+        this->checksum = fnv1a(this->checksum, (const char*) data, size);
+        this->payload_size += size;
+    }
+
+    void write_uint32(uint32_t value) { write(&value, sizeof(value)); }
+
+    void write_handle(const string& handle) { write(Handle(handle).data(), Handle::SIZE); }
+
+    void write_record(const Atom* atom) {
+        vector<string> tokens;
+        uint8_t kind;
+        auto link = dynamic_cast<const Link*>(atom);
+        if (link != nullptr) {
+            kind = ATOM_RECORD_LINK;
+            Link(*link).tokenize(tokens);
+        } else {
+            kind = ATOM_RECORD_NODE;
+            Node(*dynamic_cast<const Node*>(atom)).tokenize(tokens);
+        }
+        uint32_t record_size = sizeof(kind) + sizeof(uint32_t);
+        for (const auto& token : tokens) {
+            record_size += sizeof(uint32_t) + token.size();
+        }
+        write_uint32(record_size);
+        write(&kind, sizeof(kind));
+        write_uint32((uint32_t) tokens.size());
+        for (const auto& token : tokens) {
+            write_uint32((uint32_t) token.size());
+            write(token.data(), token.size());
+        }
+    }
+
+    void close(SnapshotHeader& header) {
+        header.payload_size = this->payload_size;
+        header.checksum = this->checksum;
+        this->file.seekp(0);
+        this->file.write((const char*) &header, sizeof(header));
+        this->file.close();
+        if (this->file.fail()) {
+            std::remove(this->temp_file_name.c_str());
+            RAISE_ERROR("Error writing snapshot file: " + this->temp_file_name);
+        }
+        if (rename(this->temp_file_name.c_str(), this->file_name.c_str()) != 0) {
+            std::remove(this->temp_file_name.c_str());
+            RAISE_ERROR("Couldn't rename snapshot file to: " + this->file_name);
+        }
+    }
+
+   private:
+    ofstream file;
+    string file_name;
+    string temp_file_name;
+};
+
+// Bounds-checked cursor over the mmapped payload.
+class SnapshotReader {
+   public:
+    SnapshotReader(const char* data, size_t size) : cursor(data), end(data + size) {}
+
+    const char* read(size_t size) {
+        if ((size_t) (this->end - this->cursor) < size) {
+            RAISE_ERROR("Corrupted snapshot: unexpected end of data");
+        }
+        const char* answer = this->cursor;
+        this->cursor += size;
+        return answer;
+    }
+
+    uint32_t read_uint32() {
+        uint32_t value;
+        memcpy(&value, read(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    string read_handle() {
+        return Handle::from_bytes((const unsigned char*) read(Handle::SIZE)).to_string();
+    }
+
+    bool at_end() const { return this->cursor == this->end; }
+
+   private:
+    const char* cursor;
+    const char* end;
+};
+
+struct SnapshotHandleSetContext {
+    SnapshotWriter* writer;
+    uint64_t count;
+};
+
+// traverse() visitor which writes every (key, handle set) of a HandleSetTrieValue trie.
+bool write_handle_set(HandleTrie::TrieNode* node, void* data) {
+    auto handle_set_value = dynamic_cast<HandleSetTrieValue*>(node->value);
+    if (handle_set_value == nullptr) {
+        return false;
+    }
+    auto* ctx = static_cast<SnapshotHandleSetContext*>(data);
+    // Safe: traverse() runs this visitor under the node lock.
+    unique_ptr<set<string>> handles(
+        static_cast<set<string>*>(handle_set_value->get_stored_object(false)));
+    ctx->writer->write_handle(node->suffix);
+    ctx->writer->write_uint32((uint32_t) handles->size());
+    for (const auto& handle : *handles) {
+        ctx->writer->write_handle(handle);
+    }
+    ctx->count++;
+    return false;
+}
+
+void read_handle_sets(SnapshotReader& reader, uint64_t count, HandleTrie& trie) {
+    for (uint64_t i = 0; i < count; i++) {
+        string key = reader.read_handle();
+        uint32_t size = reader.read_uint32();
+        set<string> handles;
+        for (uint32_t j = 0; j < size; j++) {
+            handles.insert(handles.end(), reader.read_handle());
+        }
+        trie.insert(key, new HandleSetTrieValue(std::move(handles)));
+    }
+}
 }  // namespace
 
+shared_ptr<Atom> AtomTrieValue::decode_snapshot_record(const char* record, uint32_t record_size) {
+    SnapshotReader reader(record, record_size);
+    uint8_t kind = (uint8_t) *reader.read(1);
+    uint32_t token_count = reader.read_uint32();
+    vector<string> tokens;
+    tokens.reserve(token_count);
+    for (uint32_t i = 0; i < token_count; i++) {
+        uint32_t size = reader.read_uint32();
+        tokens.push_back(string(reader.read(size), size));
+    }
+    if (kind == ATOM_RECORD_LINK) {
+        return make_shared<Link>(tokens);
+    } else if (kind == ATOM_RECORD_NODE) {
+        return make_shared<Node>(tokens);
+    } else {
+        RAISE_ERROR("Corrupted snapshot: invalid atom record");
+        return nullptr;
+    }
+}
+
 shared_ptr<InMemoryDB::Tries> InMemoryDB::make_tries() {
     auto tries = make_shared<Tries>();
     tries->atoms = make_trie();
@@ -187,6 +487,10 @@ shared_ptr<HandleSet> InMemoryDB::query_for_pattern(const LinkSchema& link_schem
     return handle_set;
 }
 
+unsigned int InMemoryDB::count_for_pattern(const LinkSchema& link_schema) {
+    return count_handle_set(*load_tries()->patterns, link_schema.handle());
+}
+
 shared_ptr<HandleList> InMemoryDB::query_for_targets(const string& handle) {
     auto atom = lookup_atom(*load_tries()->atoms, handle);
     if (atom == nullptr || !Atom::is_link(*atom)) {
@@ -449,6 +753,7 @@ vector<string> InMemoryDB::add_links_unlocked(const Tries& tries,
             for (const auto& pattern_handle : pattern_handles) {
                 add_to_handle_set(*pattern_trie, pattern_handle, link_handle);
             }
+            AtomDB::link_added(link->type, link->targets);
         }
 
         handles.push_back(link_handle);
@@ -505,6 +810,7 @@ bool InMemoryDB::delete_node_unlocked(const Tries& tries,
 
     trie->remove(handle);
     incoming_trie->remove(handle);
+    AtomDB::pattern_index_changed();
 
     return true;
 }
@@ -548,6 +854,7 @@ bool InMemoryDB::delete_link_unlocked(const Tries& tries,
     }
 
     trie->remove(handle);
+    AtomDB::pattern_index_changed();
 
     for (const auto& target_handle : targets_to_delete) {
         this->delete_atom_unlocked(tries, target_handle, delete_link_targets);
@@ -597,6 +904,106 @@ void InMemoryDB::drop_all() {
     // Publish a fresh bundle instead of deleting in place: concurrent readers keep
     // their pre-swap snapshots alive until they finish.
     store_tries(make_tries());
+    AtomDB::pattern_index_changed();
+}
+
+void InMemoryDB::save_snapshot(const string& file_name) {
+    // Writers are blocked during the whole dump so the three tries are mutually consistent.
+    // Readers are not affected.
+    lock_guard<mutex> lock(write_mutex_);
+    auto tries = load_tries();
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.handle_size = Handle::SIZE;
+
+    SnapshotWriter writer(file_name);
+    SnapshotHandleSetContext ctx{&writer, 0};
+    tries->atoms->traverse(
+        false,
+        [](HandleTrie::TrieNode* node, void* data) -> bool {
+            auto atom_trie_value = dynamic_cast<AtomTrieValue*>(node->value);
+            if (atom_trie_value == nullptr) {
+                return false;
+            }
+            auto* ctx = static_cast<SnapshotHandleSetContext*>(data);
+            ctx->writer->write_handle(node->suffix);
+            // Safe: traverse() runs this visitor under the node lock. Atoms still pending
+            // decoding (loaded from a previous snapshot) are copied as they are.
+            uint32_t record_size;
+            const char* record = atom_trie_value->pending_record(record_size);
+            if (record != NULL) {
+                ctx->writer->write_uint32(record_size);
+                ctx->writer->write(record, record_size);
+            } else {
+                ctx->writer->write_record(atom_trie_value->get_atom().get());
+            }
+            ctx->count++;
+            return false;
+        },
+        &ctx);
+    header.atom_count = ctx.count;
+
+    ctx.count = 0;
+    tries->patterns->traverse(false, write_handle_set, &ctx);
+    header.pattern_count = ctx.count;
+
+    ctx.count = 0;
+    tries->incoming->traverse(false, write_handle_set, &ctx);
+    header.incoming_count = ctx.count;
+
+    writer.close(header);
+    LOG_INFO("Snapshot saved to " << file_name << " (" << header.atom_count << " atoms, "
+                                  << header.pattern_count << " patterns, " << header.incoming_count
+                                  << " incoming sets)");
+}
+
+void InMemoryDB::load_snapshot(const string& file_name) {
+    auto snapshot = make_shared<SnapshotFile>(file_name);
+    SnapshotHeader header;
+    if (snapshot->size() < sizeof(header)) {
+        RAISE_ERROR("Invalid snapshot file: " + file_name);
+    }
+    memcpy(&header, snapshot->data(), sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        RAISE_ERROR("Invalid snapshot file: " + file_name);
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        RAISE_ERROR("Unsupported snapshot version: " + std::to_string(header.version) +
+                    " (expected: " + std::to_string(SNAPSHOT_VERSION) + ")");
+    }
+    if ((header.handle_size != Handle::SIZE) ||
+        (header.payload_size != (snapshot->size() - sizeof(header)))) {
+        RAISE_ERROR("Corrupted snapshot file: " + file_name);
+    }
+    const char* payload = snapshot->data() + sizeof(header);
+    if (fnv1a(FNV_OFFSET_BASIS, payload, header.payload_size) != header.checksum) {
+        RAISE_ERROR("Snapshot checksum mismatch: " + file_name);
+    }
+
+    // Build a new bundle and publish it at once (see drop_all())
+    auto tries = make_tries();
+    SnapshotReader reader(payload, header.payload_size);
+    for (uint64_t i = 0; i < header.atom_count; i++) {
+        string handle = reader.read_handle();
+        uint32_t record_size = reader.read_uint32();
+        const char* record = reader.read(record_size);
+        tries->atoms->insert(handle, new AtomTrieValue(snapshot, record, record_size));
+    }
+    read_handle_sets(reader, header.pattern_count, *tries->patterns);
+    read_handle_sets(reader, header.incoming_count, *tries->incoming);
+    if (!reader.at_end()) {
+        RAISE_ERROR("Corrupted snapshot file: " + file_name);
+    }
+
+    lock_guard<mutex> lock(write_mutex_);
+    store_tries(tries);
+    AtomDB::pattern_index_changed();
+    LOG_INFO("Snapshot loaded from " << file_name << " (" << header.atom_count << " atoms, "
+                                     << header.pattern_count << " patterns, " << header.incoming_count
+                                     << " incoming sets)");
 }
 
 void InMemoryDB::re_index_patterns(bool flush_patterns) {
@@ -644,11 +1051,13 @@ void InMemoryDB::re_index_patterns(bool flush_patterns) {
         next->patterns = std::move(target);
         store_tries(std::move(next));
     }
+    AtomDB::pattern_index_changed();
 }
 
 void InMemoryDB::add_pattern(const string& pattern_handle, const string& atom_handle) {
     lock_guard<mutex> lock(write_mutex_);
     add_to_handle_set(*load_tries()->patterns, pattern_handle, atom_handle);
+    AtomDB::pattern_index_changed();
 }
 
 vector<string> InMemoryDB::match_pattern_index_schema(const Link* link) {
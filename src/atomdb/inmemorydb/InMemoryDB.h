@@ -44,6 +44,19 @@ namespace atomdb {
  */
 class InMemoryDB : public AtomDB {
    public:
+    // Handle overloads from AtomDB (otherwise hidden by the overrides below)
+    using AtomDB::get_atom;
+    using AtomDB::get_node;
+    using AtomDB::get_link;
+    using AtomDB::query_for_targets;
+    using AtomDB::query_for_incoming_set;
+    using AtomDB::atom_exists;
+    using AtomDB::node_exists;
+    using AtomDB::link_exists;
+    using AtomDB::delete_atom;
+    using AtomDB::delete_node;
+    using AtomDB::delete_link;
+
     InMemoryDB(const string& context = "");
     ~InMemoryDB();
 
@@ -58,6 +71,8 @@ class InMemoryDB : public AtomDB {
 
     shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema) override;
 
+    unsigned int count_for_pattern(const LinkSchema& link_schema) override;
+
     shared_ptr<atomdb_api_types::HandleList> query_for_targets(const string& handle) override;
 
     shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle) override;
@@ -105,6 +120,27 @@ class InMemoryDB : public AtomDB {
      *  not data. */
     void drop_all();
 
+    /**
+     * Writes a binary snapshot of this InMemoryDB (atoms, pattern index and incoming sets) to
+     * the passed file. The snapshot is versioned and checksummed. Writers are blocked while the
+     * snapshot is being written; readers are not.
+     *
+     * @param file_name Path of the snapshot file (overwritten if it exists).
+     */
+    void save_snapshot(const string& file_name);
+
+    /**
+     * Replaces the contents of this InMemoryDB by the ones in a snapshot written by
+     * save_snapshot(). The file is mmapped and atoms are decoded lazily (on first access) so
+     * loading cost is basically the index rebuild. An exception is thrown (and the current
+     * contents are kept) if the file is not a valid snapshot (bad magic, version or checksum).
+     *
+     * Pattern index schemas are not part of the snapshot (see drop_all()).
+     *
+     * @param file_name Path of the snapshot file.
+     */
+    void load_snapshot(const string& file_name);
+
     void add_pattern(const string& pattern_handle, const string& atom_handle);
     vector<string> match_pattern_index_schema(const Link* link);
 
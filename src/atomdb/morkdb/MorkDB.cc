@@ -338,6 +338,9 @@ vector<string> MorkDB::add_links(const vector<atoms::Link*>& links,
     if (!metta_expressions.empty()) {
         this->mork_client->post(metta_expressions, "$x", "$x");
     }
+    for (const auto* to_store : links_to_persist) {
+        AtomDB::link_added(to_store->type, to_store->targets);
+    }
 
     if (this->composite_type_enabled() && is_transactional) {
         lock_guard<mutex> composite_type_hashes_map_lock(this->composite_type_hashes_map_mutex);
@@ -352,7 +355,11 @@ bool MorkDB::delete_link(const string& handle, bool delete_targets) {
     return false;
 }
 
-string MorkDB::flush_pattern(const string& pattern) { return this->mork_client->clear(pattern); }
+string MorkDB::flush_pattern(const string& pattern) {
+    string answer = this->mork_client->clear(pattern);
+    AtomDB::pattern_index_changed();
+    return answer;
+}
 
 void MorkDB::re_index_patterns(bool flush_patterns) {
     vector<Link*> links;
@@ -393,6 +400,7 @@ void MorkDB::re_index_patterns(bool flush_patterns) {
             this->mork_client->clear(pattern);
         }
     }
+    AtomDB::pattern_index_changed();
 
     this->add_links(links, true);
 }
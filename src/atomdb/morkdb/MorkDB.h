@@ -40,6 +40,10 @@ class MorkClient {
 
 class MorkDB : public RedisMongoDB {
    public:
+    // Overloads from RedisMongoDB/AtomDB (otherwise hidden by the overrides below)
+    using RedisMongoDB::query_for_targets;
+    using RedisMongoDB::delete_link;
+
     MorkDB(const string& context, const JsonConfig& config);
     ~MorkDB();
 
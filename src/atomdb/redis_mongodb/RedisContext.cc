@@ -90,6 +90,63 @@ void RedisContext::flush_commands() {
     }
 }
 
+void RedisContext::flush_commands_checked(const string& caller) {
+    redisReply* reply;
+    unsigned int error_count = 0;
+    string first_error = "";
+    while (pending_commands_count > 0) {
+        pending_commands_count--;
+        int status = cluster_flag ? redisClusterGetReply(cluster_ctx, (void**) &reply)
+                                  : redisGetReply(single_ctx, (void**) &reply);
+        if (status == REDIS_ERR) {
+            // The connection is broken so the remaining replies can't be read
+            error_count += pending_commands_count + 1;
+            pending_commands_count = 0;
+            if (cluster_flag) {
+                redisClusterReset(cluster_ctx);
+            }
+            const char* error = get_error();
+            if (first_error == "") {
+                first_error = (error != nullptr) ? error : "connection error";
+            }
+            break;
+        }
+        if (reply == nullptr) {
+            continue;
+        }
+        if (reply->type == REDIS_REPLY_ERROR) {
+            error_count++;
+            if (first_error == "") {
+                first_error = string(reply->str, reply->len);
+            }
+        }
+        freeReplyObject(reply);
+    }
+    if (error_count > 0) {
+        RAISE_ERROR("Redis error at " + caller + ": " + std::to_string(error_count) +
+                    " command(s) failed. First error: " + first_error);
+    }
+}
+
+redisReply* RedisContext::get_reply() {
+    if (pending_commands_count == 0) {
+        return NULL;
+    }
+    pending_commands_count--;
+    redisReply* reply = NULL;
+    int status = cluster_flag ? redisClusterGetReply(cluster_ctx, (void**) &reply)
+                              : redisGetReply(single_ctx, (void**) &reply);
+    if (status == REDIS_ERR) {
+        // The connection is broken so the remaining replies can't be read
+        pending_commands_count = 0;
+        if (cluster_flag) {
+            redisClusterReset(cluster_ctx);
+        }
+        return NULL;
+    }
+    return reply;
+}
+
 bool RedisContext::has_error() const {
     if (cluster_flag) {
         return cluster_ctx && cluster_ctx->err;
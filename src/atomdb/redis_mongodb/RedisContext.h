@@ -20,6 +20,12 @@ class RedisContext {
     bool ping();
     void append_command(const char* command);
     void flush_commands();
+    // Same as flush_commands() but every reply is checked. Raises an error (after reading all
+    // the pending replies) if any of the appended commands failed.
+    void flush_commands_checked(const string& caller);
+    // Reads the reply of the oldest pending (appended) command. Returns NULL if there are no
+    // pending commands or the connection is broken (in which case the pending replies are lost).
+    redisReply* get_reply();
     int get_pending_commands_count() const { return pending_commands_count; }
     bool has_error() const;
     const char* get_error() const;
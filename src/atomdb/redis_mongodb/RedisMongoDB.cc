@@ -31,6 +31,7 @@ string RedisMongoDB::REDIS_PATTERNS_PREFIX;
 string RedisMongoDB::REDIS_OUTGOING_PREFIX;
 string RedisMongoDB::REDIS_INCOMING_PREFIX;
 uint RedisMongoDB::REDIS_CHUNK_SIZE;
+uint RedisMongoDB::REDIS_WRITE_BATCH_SIZE;
 string RedisMongoDB::MONGODB_DB_NAME;
 string RedisMongoDB::MONGODB_NODES_COLLECTION_NAME;
 string RedisMongoDB::MONGODB_LINKS_COLLECTION_NAME;
@@ -38,6 +39,7 @@ string RedisMongoDB::MONGODB_PATTERN_INDEX_SCHEMA_COLLECTION_NAME;
 string RedisMongoDB::MONGODB_ACCESS_PERMISSIONS_COLLECTION_NAME;
 string RedisMongoDB::MONGODB_FIELD_NAME[MONGODB_FIELD::size];
 uint RedisMongoDB::MONGODB_CHUNK_SIZE;
+uint RedisMongoDB::ATOM_CACHE_SIZE;
 
 RedisMongoDB::RedisMongoDB(const string& context, bool skip_redis, const JsonConfig& config)
     : context(context),
@@ -54,7 +56,6 @@ RedisMongoDB::RedisMongoDB(const string& context, bool skip_redis, const JsonCon
 
 RedisMongoDB::~RedisMongoDB() {
     delete this->mongodb_pool;
-    if (!skip_redis_) delete this->redis_pool;
 }
 
 bool RedisMongoDB::allow_nested_indexing() { return false; }
@@ -154,13 +155,17 @@ void RedisMongoDB::redis_setup(const JsonConfig& config) {
     string port = tokens[1];
 
     this->cluster_flag = config.at_path("redis.cluster").get_or<bool>(false);
+    uint write_batch_size = config.at_path("redis.write_batch_size").get_or<uint>(0);
+    if (write_batch_size > 0) {
+        REDIS_WRITE_BATCH_SIZE = write_batch_size;
+    }
 
     if (address.empty() || address == ":") {
         RAISE_ERROR(
             "Invalid Redis configuration: resolved address is empty. Check atomdb.redis in "
             "JsonConfig (endpoint or hostname/port).");
     }
-    this->redis_pool = new RedisContextPool(this->cluster_flag, host, port, address);
+    this->redis_pool = make_shared<RedisContextPool>(this->cluster_flag, host, port, address);
     LOG_INFO("Connected to (" << (this->cluster_flag ? "CLUSTER" : "NON-CLUSTER") << ") Redis at "
                               << address);
 }
@@ -173,6 +178,8 @@ void RedisMongoDB::mongodb_setup(const JsonConfig& config) {
     if (chunk_size > 0) {
         MONGODB_CHUNK_SIZE = chunk_size;
     }
+    ATOM_CACHE_SIZE = config.at_path("mongodb.atom_cache_size").get_or<uint>(ATOM_CACHE_SIZE);
+    this->atom_cache.resize(ATOM_CACHE_SIZE);
     if (address.empty() || address == ":" || user.empty() || password.empty()) {
         RAISE_ERROR(
             "Invalid MongoDB configuration: need non-empty address, username, and password. "
@@ -198,8 +205,72 @@ void RedisMongoDB::mongodb_setup(const JsonConfig& config) {
 }
 
 shared_ptr<Atom> RedisMongoDB::get_atom(const string& handle) {
-    auto atom_document =
-        dynamic_pointer_cast<atomdb_api_types::MongodbDocument>(get_atom_document(handle));
+    shared_ptr<Atom> atom;
+    if (!this->atom_cache.get(handle, atom)) {
+        unsigned long version = this->atom_cache.version(handle);
+        atom = decode_atom(handle);
+        if (atom == NULL) {
+            return atom;
+        }
+        this->atom_cache.set_if_unchanged(handle, atom, version);
+    }
+    return copy_atom(atom);
+}
+
+vector<shared_ptr<Atom>> RedisMongoDB::get_atoms(const vector<string>& handles) {
+    vector<shared_ptr<Atom>> atoms(handles.size());
+    map<string, vector<unsigned int>> missing;  // handle -> positions in handles
+    map<string, unsigned long> versions;        // handle -> cache version before the read
+    vector<string> missing_handles;
+    for (unsigned int i = 0; i < handles.size(); i++) {
+        shared_ptr<Atom> atom;
+        if (this->atom_cache.get(handles[i], atom)) {
+            atoms[i] = copy_atom(atom);
+        } else {
+            auto& positions = missing[handles[i]];
+            if (positions.empty()) {
+                missing_handles.push_back(handles[i]);
+                versions[handles[i]] = this->atom_cache.version(handles[i]);
+            }
+            positions.push_back(i);
+        }
+    }
+    if (!missing_handles.empty()) {
+        for (const auto& document : get_atom_documents(missing_handles, {})) {
+            auto atom =
+                decode_atom(dynamic_pointer_cast<atomdb_api_types::MongodbDocument>(document));
+            string handle = document->get(MONGODB_FIELD_NAME[MONGODB_FIELD::ID]);
+            this->atom_cache.set_if_unchanged(handle, atom, versions[handle]);
+            for (unsigned int position : missing[handle]) {
+                atoms[position] = copy_atom(atom);
+            }
+        }
+    }
+    return atoms;
+}
+
+void RedisMongoDB::invalidate_cached_atom(const string& handle) {
+    // Also makes reads of the same shard which started before it not cache their results
+    this->atom_cache.remove(handle);
+}
+
+shared_ptr<Atom> RedisMongoDB::copy_atom(shared_ptr<Atom> atom) {
+    // Callers are allowed to change the returned atom (e.g. mergers) so a copy of the cached
+    // object is returned.
+    auto node = dynamic_pointer_cast<Node>(atom);
+    if (node != NULL) {
+        return make_shared<Node>(*node);
+    } else {
+        return make_shared<Link>(*dynamic_pointer_cast<Link>(atom));
+    }
+}
+
+shared_ptr<Atom> RedisMongoDB::decode_atom(const string& handle) {
+    return decode_atom(
+        dynamic_pointer_cast<atomdb_api_types::MongodbDocument>(get_atom_document(handle)));
+}
+
+shared_ptr<Atom> RedisMongoDB::decode_atom(shared_ptr<atomdb_api_types::MongodbDocument> atom_document) {
     if (atom_document != NULL) {
         Properties custom_attributes;
         if (atom_document->contains("custom_attributes")) {
@@ -239,44 +310,33 @@ shared_ptr<Link> RedisMongoDB::get_link(const string& handle) {
 }
 
 shared_ptr<atomdb_api_types::HandleSet> RedisMongoDB::query_for_pattern(const LinkSchema& link_schema) {
+    return query_for_pattern(link_schema, 0);
+}
+
+shared_ptr<atomdb_api_types::HandleSet> RedisMongoDB::query_for_pattern(const LinkSchema& link_schema,
+                                                                        unsigned int max_results) {
     if (skip_redis_) return nullptr;
 
-    auto pattern_handle = link_schema.handle();
+    string key = REDIS_PATTERNS_PREFIX + ":" + link_schema.handle();
+    return make_shared<atomdb_api_types::HandleSetRedisStream>(
+        this->redis_pool, key, REDIS_CHUNK_SIZE, max_results);
+}
 
-    unsigned int redis_cursor = 0;
-    bool redis_has_more = true;
-    string command;
-    redisReply* reply;
+unsigned int RedisMongoDB::count_for_pattern(const LinkSchema& link_schema) {
+    if (skip_redis_) return 0;
 
     auto ctx = this->redis_pool->acquire();
-
-    auto handle_set = make_shared<atomdb_api_types::HandleSetRedis>();
-
-    while (redis_has_more) {
-        command = ("ZRANGE " + REDIS_PATTERNS_PREFIX + ":" + pattern_handle + " " +
-                   to_string(redis_cursor) + " " + to_string(redis_cursor + REDIS_CHUNK_SIZE - 1));
-
-        reply = ctx->execute(command.c_str());
-
-        if (reply == NULL) RAISE_ERROR("Redis error at query_for_pattern");
-
-        if (reply->type != REDIS_REPLY_SET && reply->type != REDIS_REPLY_ARRAY) {
-            auto error_type = std::to_string(reply->type);
-            freeReplyObject(reply);
-            RAISE_ERROR("Invalid Redis response at query_for_pattern: " + error_type);
-        }
-
-        redis_cursor += REDIS_CHUNK_SIZE;
-        redis_has_more = (reply->elements == REDIS_CHUNK_SIZE);
-
-        if (reply->elements == 0) {
-            freeReplyObject(reply);
-            break;
-        }
-        handle_set->append(make_shared<atomdb_api_types::HandleSetRedis>(reply, false));
+    string command = "ZCARD " + REDIS_PATTERNS_PREFIX + ":" + link_schema.handle();
+    redisReply* reply = ctx->execute(command.c_str());
+    if (reply == NULL) RAISE_ERROR("Redis error at count_for_pattern: <" + command + ">");
+    if (reply->type != REDIS_REPLY_INTEGER) {
+        auto error_type = std::to_string(reply->type);
+        freeReplyObject(reply);
+        RAISE_ERROR("Invalid Redis response at count_for_pattern: " + error_type);
     }
-
-    return handle_set;
+    unsigned int count = (unsigned int) reply->integer;
+    freeReplyObject(reply);
+    return count;
 }
 
 shared_ptr<atomdb_api_types::HandleList> RedisMongoDB::query_for_targets(const string& handle) {
@@ -311,58 +371,19 @@ shared_ptr<atomdb_api_types::HandleList> RedisMongoDB::query_for_targets(const s
 }
 
 shared_ptr<atomdb_api_types::HandleSet> RedisMongoDB::query_for_incoming_set(const string& handle) {
-    if (skip_redis_) return nullptr;
-
-    unsigned int redis_cursor = 0;
-    bool redis_has_more = true;
-    string command;
-    redisReply* reply;
-
-    auto ctx = this->redis_pool->acquire();
-
-    auto handle_set = make_shared<atomdb_api_types::HandleSetRedis>();
-
-    while (redis_has_more) {
-        command = ("ZRANGE " + REDIS_INCOMING_PREFIX + ":" + handle + " " + to_string(redis_cursor) +
-                   " " + to_string(redis_cursor + REDIS_CHUNK_SIZE - 1));
-
-        reply = ctx->execute(command.c_str());
-
-        if (reply == NULL) RAISE_ERROR("Redis error at query_for_incoming_set");
-
-        if (reply->type != REDIS_REPLY_SET && reply->type != REDIS_REPLY_ARRAY) {
-            auto error_type = std::to_string(reply->type);
-            freeReplyObject(reply);
-            RAISE_ERROR("Invalid Redis response at query_for_incoming_set: " + error_type);
-        }
-
-        redis_cursor += REDIS_CHUNK_SIZE;
-        redis_has_more = (reply->elements == REDIS_CHUNK_SIZE);
+    return query_for_incoming_set(handle, 0);
+}
 
-        if (reply->elements == 0) {
-            freeReplyObject(reply);
-            break;
-        }
-        handle_set->append(make_shared<atomdb_api_types::HandleSetRedis>(reply, false));
-    }
+shared_ptr<atomdb_api_types::HandleSet> RedisMongoDB::query_for_incoming_set(const string& handle,
+                                                                             unsigned int max_results) {
+    if (skip_redis_) return nullptr;
 
-    return handle_set;
+    return make_shared<atomdb_api_types::HandleSetRedisStream>(
+        this->redis_pool, REDIS_INCOMING_PREFIX + ":" + handle, REDIS_CHUNK_SIZE, max_results);
 }
 
 void RedisMongoDB::add_pattern(const string& pattern_handle, const string& handle) {
-    if (skip_redis_) return;
-
-    auto ctx = this->redis_pool->acquire();
-    string command = "ZADD " + REDIS_PATTERNS_PREFIX + ":" + pattern_handle + " " +
-                     to_string(this->patterns_next_score.load()) + " " + handle;
-    redisReply* reply = ctx->execute(command.c_str());
-    if (reply == NULL) RAISE_ERROR("Redis error at add_pattern: <" + command + ">");
-
-    if (reply->type != REDIS_REPLY_INTEGER) {
-        RAISE_ERROR("Invalid Redis response at add_pattern: " + std::to_string(reply->type));
-    }
-
-    set_next_score(REDIS_PATTERNS_PREFIX + ":next_score", this->patterns_next_score.fetch_add(1));
+    add_patterns({{pattern_handle, handle}});
 }
 
 void RedisMongoDB::add_patterns(const vector<pair<string, string>>& pattern_handles) {
@@ -370,34 +391,15 @@ void RedisMongoDB::add_patterns(const vector<pair<string, string>>& pattern_hand
 
     if (pattern_handles.empty()) return;
 
-    auto ctx = this->redis_pool->acquire();
-
-    // Group patterns by pattern_handle for efficient batching
+    // Group patterns by pattern_handle so a single multi-member ZADD is sent per pattern
     map<string, vector<string>> patterns_by_handle;
     for (const auto& pair : pattern_handles) {
         patterns_by_handle[pair.first].push_back(pair.second);
     }
 
-    // Use Redis pipeline for batch operations
-    for (const auto& pattern_group : patterns_by_handle) {
-        const string& pattern_handle = pattern_group.first;
-        const vector<string>& handles = pattern_group.second;
-
-        // Build ZADD command with multiple score-member pairs
-        string command = "ZADD " + REDIS_PATTERNS_PREFIX + ":" + pattern_handle;
-        for (const auto& handle : handles) {
-            command += " " + to_string(this->patterns_next_score.load()) + " " + handle;
-            this->patterns_next_score.fetch_add(1);
-        }
-
-        redisReply* reply = ctx->execute(command.c_str());
-        if (reply == NULL) RAISE_ERROR("Redis error at add_patterns");
-
-        if (reply->type != REDIS_REPLY_INTEGER) {
-            RAISE_ERROR("Invalid Redis response at add_patterns: " + std::to_string(reply->type));
-        }
-    }
-    set_next_score(REDIS_PATTERNS_PREFIX + ":next_score", this->patterns_next_score.load());
+    auto ctx = this->redis_pool->acquire();
+    add_to_sorted_sets(ctx, REDIS_PATTERNS_PREFIX, this->patterns_next_score, patterns_by_handle);
+    AtomDB::pattern_index_changed();
 }
 
 void RedisMongoDB::delete_pattern(const string& handle) {
@@ -412,6 +414,7 @@ void RedisMongoDB::delete_pattern(const string& handle) {
     if (reply->type != REDIS_REPLY_INTEGER) {
         RAISE_ERROR("Invalid Redis response at delete_pattern: " + std::to_string(reply->type));
     }
+    AtomDB::pattern_index_changed();
 }
 
 void RedisMongoDB::update_pattern(const string& key, const string& value) {
@@ -467,6 +470,52 @@ void RedisMongoDB::reset_scores() {
     this->incoming_set_next_score.store(get_next_score(REDIS_INCOMING_PREFIX + ":next_score"));
 }
 
+uint RedisMongoDB::reserve_scores(shared_ptr<RedisContext> ctx,
+                                  const string& key,
+                                  atomic<uint>& next_score,
+                                  uint count) {
+    string command = "INCRBY " + key + " " + to_string(count);
+    redisReply* reply = ctx->execute(command.c_str());
+    if (reply == NULL) RAISE_ERROR("Redis error at reserve_scores: <" + command + ">");
+
+    if (reply->type != REDIS_REPLY_INTEGER) {
+        int type = reply->type;
+        freeReplyObject(reply);
+        RAISE_ERROR("Invalid Redis response at reserve_scores: " + std::to_string(type));
+    }
+    uint last = (uint) reply->integer;
+    freeReplyObject(reply);
+    next_score.store(last);
+    return last - count;
+}
+
+void RedisMongoDB::add_to_sorted_sets(shared_ptr<RedisContext> ctx,
+                                      const string& prefix,
+                                      atomic<uint>& next_score,
+                                      const map<string, vector<string>>& members) {
+    uint count = 0;
+    for (const auto& pair : members) {
+        count += pair.second.size();
+    }
+    if (count == 0) return;
+
+    uint score = reserve_scores(ctx, prefix + ":next_score", next_score, count);
+    for (const auto& pair : members) {
+        uint cursor = 0;
+        while (cursor < pair.second.size()) {
+            string command = "ZADD " + prefix + ":" + pair.first;
+            for (uint i = 0; (i < REDIS_WRITE_BATCH_SIZE) && (cursor < pair.second.size()); i++) {
+                command += " " + to_string(score++) + " " + pair.second[cursor++];
+            }
+            ctx->append_command(command.c_str());
+            if (static_cast<uint>(ctx->get_pending_commands_count()) >= REDIS_WRITE_BATCH_SIZE) {
+                ctx->flush_commands_checked("add_to_sorted_sets");
+            }
+        }
+    }
+    ctx->flush_commands_checked("add_to_sorted_sets");
+}
+
 void RedisMongoDB::add_outgoing_set(const string& handle, const vector<string>& outgoing_handles) {
     if (skip_redis_) return;
 
@@ -496,16 +545,8 @@ void RedisMongoDB::add_incoming_set(const string& handle, const string& incoming
     if (skip_redis_) return;
 
     auto ctx = this->redis_pool->acquire();
-    string command = "ZADD " + REDIS_INCOMING_PREFIX + ":" + handle + " " +
-                     to_string(this->incoming_set_next_score.load()) + " " + incoming_handle;
-    redisReply* reply = ctx->execute(command.c_str());
-    if (reply == NULL) RAISE_ERROR("Redis error at add_incoming_set");
-
-    if (reply->type != REDIS_REPLY_INTEGER) {
-        RAISE_ERROR("Invalid Redis response at add_incoming_set: " + std::to_string(reply->type));
-    }
-
-    set_next_score(REDIS_INCOMING_PREFIX + ":next_score", this->incoming_set_next_score.fetch_add(1));
+    add_to_sorted_sets(
+        ctx, REDIS_INCOMING_PREFIX, this->incoming_set_next_score, {{handle, {incoming_handle}}});
 }
 
 void RedisMongoDB::delete_incoming_set(const string& handle) {
@@ -818,6 +859,9 @@ bool RedisMongoDB::upsert_document(const bsoncxx::v_noabi::document::value& docu
     auto mongodb_collection = (*conn)[MONGODB_DB_NAME][collection_name];
 
     auto document_id = document[MONGODB_FIELD_NAME[MONGODB_FIELD::ID]].get_string().value.data();
+    // Invalidated before (in case the write fails halfway) and after the write (see
+    // atom_cache_hits())
+    invalidate_cached_atom(document_id);
 
     bsoncxx::builder::stream::document filter_builder;
     filter_builder << MONGODB_FIELD_NAME[MONGODB_FIELD::ID] << document_id;
@@ -828,6 +872,7 @@ bool RedisMongoDB::upsert_document(const bsoncxx::v_noabi::document::value& docu
     // Insert or update depending if the document already exists
     auto reply = mongodb_collection.replace_one(filter_builder.view(), document.view(), opts);
 
+    invalidate_cached_atom(document_id);
     if (!reply) {
         RAISE_ERROR("Failed to upsert document into MongoDB");
     }
@@ -859,10 +904,13 @@ uint RedisMongoDB::upsert_documents(const std::vector<bsoncxx::document::value>&
 
         vector<mongocxx::model::write> operations;
         vector<bsoncxx::document::value> filter_values;
+        vector<string> document_ids;
 
         for (const auto& document : batch_documents) {
             auto id_element = document[MONGODB_FIELD_NAME[MONGODB_FIELD::ID]];
             string document_id = id_element.get_string().value.data();
+            invalidate_cached_atom(document_id);
+            document_ids.push_back(document_id);
 
             bsoncxx::builder::stream::document filter_builder{};
             filter_builder << MONGODB_FIELD_NAME[MONGODB_FIELD::ID] << document_id;
@@ -880,6 +928,9 @@ uint RedisMongoDB::upsert_documents(const std::vector<bsoncxx::document::value>&
             mongocxx::options::bulk_write opts;
             opts.ordered(false);
             auto reply = mongodb_collection.bulk_write(operations, opts);
+            for (const auto& document_id : document_ids) {
+                invalidate_cached_atom(document_id);
+            }
             if (!reply) {
                 RAISE_ERROR("Failed to upsert documents into MongoDB");
             } else {
@@ -1103,16 +1154,19 @@ vector<string> RedisMongoDB::add_links(const vector<atoms::Link*>& links,
 
     shared_ptr<RedisContext> ctx = this->redis_pool->acquire();
 
+    // Incoming sets and patterns are buffered so each key is written by a single multi-member
+    // ZADD and scores are reserved once per batch (see add_to_sorted_sets()).
+    map<string, vector<string>> incoming_set_members;
+    map<string, vector<string>> pattern_members;
+    uint buffered_members = 0;
+
     for (const auto* to_store : links_to_persist) {
         auto link_handle = to_store->handle();
         auto pattern_handles = match_pattern_index_schema(to_store);
 
         for (const auto& target : to_store->targets) {
-            string incomming_set_cmd = "ZADD " + REDIS_INCOMING_PREFIX + ":" + target + " " +
-                                       to_string(this->incoming_set_next_score.load()) + " " +
-                                       link_handle;
-            ctx->append_command(incomming_set_cmd.c_str());
-            this->incoming_set_next_score.fetch_add(1);
+            incoming_set_members[target].push_back(link_handle);
+            buffered_members++;
         }
 
         string outgoing_set_cmd = "SET " + REDIS_OUTGOING_PREFIX + ":" + link_handle + " ";
@@ -1122,10 +1176,8 @@ vector<string> RedisMongoDB::add_links(const vector<atoms::Link*>& links,
         ctx->append_command(outgoing_set_cmd.c_str());
 
         for (const auto& pattern_handle : pattern_handles) {
-            string patterns_cmd = "ZADD " + REDIS_PATTERNS_PREFIX + ":" + pattern_handle + " " +
-                                  to_string(this->patterns_next_score.load()) + " " + link_handle;
-            ctx->append_command(patterns_cmd.c_str());
-            this->patterns_next_score.fetch_add(1);
+            pattern_members[pattern_handle].push_back(link_handle);
+            buffered_members++;
         }
 
         optional<atomdb_api_types::MongodbDocument> mongodb_doc;
@@ -1140,9 +1192,15 @@ vector<string> RedisMongoDB::add_links(const vector<atoms::Link*>& links,
             mongodb_doc.emplace(to_store, *this);
         }
 
-        if (static_cast<uint>(ctx->get_pending_commands_count()) >= REDIS_CHUNK_SIZE) {
+        if ((buffered_members + (uint) ctx->get_pending_commands_count()) >= REDIS_WRITE_BATCH_SIZE) {
             LOG_DEBUG("Flushing Redis commands batch START");
-            ctx->flush_commands();
+            ctx->flush_commands_checked("add_links");
+            add_to_sorted_sets(
+                ctx, REDIS_INCOMING_PREFIX, this->incoming_set_next_score, incoming_set_members);
+            add_to_sorted_sets(ctx, REDIS_PATTERNS_PREFIX, this->patterns_next_score, pattern_members);
+            incoming_set_members.clear();
+            pattern_members.clear();
+            buffered_members = 0;
             LOG_DEBUG("Flushing Redis commands batch END");
         }
 
@@ -1153,20 +1211,18 @@ vector<string> RedisMongoDB::add_links(const vector<atoms::Link*>& links,
         upsert_documents(documents, MONGODB_LINKS_COLLECTION_NAME);
     }
 
-    if (ctx->get_pending_commands_count() > 0) {
-        LOG_DEBUG("Flushing remaining Redis commands");
-        ctx->flush_commands();
-        LOG_DEBUG("Flushing remaining Redis commands END");
+    LOG_DEBUG("Flushing remaining Redis commands");
+    ctx->flush_commands_checked("add_links");
+    add_to_sorted_sets(ctx, REDIS_INCOMING_PREFIX, this->incoming_set_next_score, incoming_set_members);
+    add_to_sorted_sets(ctx, REDIS_PATTERNS_PREFIX, this->patterns_next_score, pattern_members);
+    LOG_DEBUG("Flushing remaining Redis commands END");
+    for (const auto* to_store : links_to_persist) {
+        AtomDB::link_added(to_store->type, to_store->targets);
     }
 
-    LOG_DEBUG("Setting next scores: patterns=" + to_string(this->patterns_next_score.load()) +
+    LOG_DEBUG("Next scores: patterns=" + to_string(this->patterns_next_score.load()) +
               ", incoming=" + to_string(this->incoming_set_next_score.load()));
 
-    set_next_score_with_context(
-        ctx, REDIS_PATTERNS_PREFIX + ":next_score", this->patterns_next_score.load());
-    set_next_score_with_context(
-        ctx, REDIS_INCOMING_PREFIX + ":next_score", this->incoming_set_next_score.load());
-
     if (this->composite_type_enabled() && is_transactional) {
         lock_guard<mutex> composite_type_hashes_map_lock(this->composite_type_hashes_map_mutex);
         this->composite_type_hashes_map.clear();
@@ -1177,10 +1233,12 @@ vector<string> RedisMongoDB::add_links(const vector<atoms::Link*>& links,
 bool RedisMongoDB::delete_document(const string& handle,
                                    const string& collection_name,
                                    bool delete_targets) {
+    invalidate_cached_atom(handle);
     auto conn = this->mongodb_pool->acquire();
     auto mongodb_collection = (*conn)[MONGODB_DB_NAME][collection_name];
     auto reply = mongodb_collection.delete_one(bsoncxx::v_noabi::builder::basic::make_document(
         bsoncxx::v_noabi::builder::basic::kvp(MONGODB_FIELD_NAME[MONGODB_FIELD::ID], handle)));
+    invalidate_cached_atom(handle);
 
     if (!skip_redis_) {
         auto incoming_set = query_for_incoming_set(handle);
@@ -1195,6 +1253,8 @@ bool RedisMongoDB::delete_document(const string& handle,
         delete_outgoing_set(handle);
     }
 
+    AtomDB::pattern_index_changed();
+
     // NOTE: the initial handle might be already deleted due the recursive delete_atom() calls.
     return reply->deleted_count() > 0 || !document_exists(handle, collection_name);
 }
@@ -1448,6 +1508,7 @@ void RedisMongoDB::re_index_patterns(bool flush_patterns) {
 
     // Flush Redis patterns indexes
     if (flush_patterns) flush_redis_by_prefix(REDIS_PATTERNS_PREFIX);
+    AtomDB::pattern_index_changed();
 
     // Reset patterns next score
     this->patterns_next_score.store(1);
@@ -1511,6 +1572,8 @@ void RedisMongoDB::drop_all() {
     // Drop MongoDB database
     auto conn = this->mongodb_pool->acquire();
     (*conn)[MONGODB_DB_NAME].drop();
+    this->atom_cache.clear();
+    AtomDB::pattern_index_changed();
 
     // Drop Redis database (by prefixes)
     if (!skip_redis_) {
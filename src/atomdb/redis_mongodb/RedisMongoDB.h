@@ -16,6 +16,7 @@
 
 #include "AtomDB.h"
 #include "JsonConfig.h"
+#include "LRUCache.h"
 #include "RedisContext.h"
 #include "RedisContextPool.h"
 #include "RedisMongoDBAPITypes.h"
@@ -29,6 +30,19 @@ enum MONGODB_FIELD { ID = 0, NAME, TARGETS, NAMED_TYPE, size };
 
 class RedisMongoDB : public AtomDB {
    public:
+    // Handle overloads from AtomDB (otherwise hidden by the overrides below)
+    using AtomDB::get_atom;
+    using AtomDB::get_node;
+    using AtomDB::get_link;
+    using AtomDB::query_for_targets;
+    using AtomDB::query_for_incoming_set;
+    using AtomDB::atom_exists;
+    using AtomDB::node_exists;
+    using AtomDB::link_exists;
+    using AtomDB::delete_atom;
+    using AtomDB::delete_node;
+    using AtomDB::delete_link;
+
     ~RedisMongoDB();
 
     bool allow_nested_indexing() override;
@@ -44,6 +58,7 @@ class RedisMongoDB : public AtomDB {
     static string REDIS_OUTGOING_PREFIX;
     static string REDIS_INCOMING_PREFIX;
     static uint REDIS_CHUNK_SIZE;
+    static uint REDIS_WRITE_BATCH_SIZE;
     static string MONGODB_DB_NAME;
     static string MONGODB_NODES_COLLECTION_NAME;
     static string MONGODB_LINKS_COLLECTION_NAME;
@@ -51,12 +66,14 @@ class RedisMongoDB : public AtomDB {
     static string MONGODB_ACCESS_PERMISSIONS_COLLECTION_NAME;
     static string MONGODB_FIELD_NAME[MONGODB_FIELD::size];
     static uint MONGODB_CHUNK_SIZE;
+    static uint ATOM_CACHE_SIZE;
 
     static void initialize_statics(const string& context = "") {
         REDIS_PATTERNS_PREFIX = context + "patterns";
         REDIS_OUTGOING_PREFIX = context + "outgoing_set";
         REDIS_INCOMING_PREFIX = context + "incoming_set";
         REDIS_CHUNK_SIZE = 10000;
+        REDIS_WRITE_BATCH_SIZE = 10000;
         MONGODB_DB_NAME = context + "das";
         MONGODB_NODES_COLLECTION_NAME = context + "nodes";
         MONGODB_LINKS_COLLECTION_NAME = context + "links";
@@ -67,21 +84,47 @@ class RedisMongoDB : public AtomDB {
         MONGODB_FIELD_NAME[MONGODB_FIELD::NAME] = "name";
         MONGODB_FIELD_NAME[MONGODB_FIELD::NAMED_TYPE] = "named_type";
         MONGODB_CHUNK_SIZE = 1000;
+        ATOM_CACHE_SIZE = 100000;
     }
 
     // HandleDecoder interface
     shared_ptr<Atom> get_atom(const string& handle);
     shared_ptr<Node> get_node(const string& handle);
+
+    /**
+     * Same as get_atom() for each handle but atoms missing in the atom cache are fetched from
+     * MongoDB in batches (see get_atom_documents()) instead of one document at a time.
+     */
+    vector<shared_ptr<Atom>> get_atoms(const vector<string>& handles);
     shared_ptr<Link> get_link(const string& handle);
 
     vector<shared_ptr<Atom>> get_matching_atoms(bool is_toplevel, Atom& key);
 
     shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema);
 
+    /**
+     * Same as query_for_pattern(link_schema) but the returned set has at most max_results
+     * handles (0 means no limit). Handles are streamed from Redis in chunks of REDIS_CHUNK_SIZE.
+     */
+    shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema,
+                                                              unsigned int max_results) override;
+
+    /**
+     * Returns the cardinality (ZCARD) of the pattern index entry of the passed LinkSchema.
+     */
+    unsigned int count_for_pattern(const LinkSchema& link_schema) override;
+
     shared_ptr<atomdb_api_types::HandleList> query_for_targets(const string& handle);
 
     shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle);
 
+    /**
+     * Same as query_for_incoming_set(handle) but the returned set has at most max_results
+     * handles (0 means no limit). Handles are streamed from Redis in chunks of REDIS_CHUNK_SIZE.
+     */
+    shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle,
+                                                                   unsigned int max_results) override;
+
     shared_ptr<atomdb_api_types::AtomDocument> get_atom_document(const string& handle);
     shared_ptr<atomdb_api_types::AtomDocument> get_node_document(const string& handle);
     shared_ptr<atomdb_api_types::AtomDocument> get_link_document(const string& handle);
@@ -146,6 +189,23 @@ class RedisMongoDB : public AtomDB {
 
     mongocxx::pool* get_mongo_pool() const { return mongodb_pool; }
 
+    /**
+     * Number of get_atom() calls answered by (hits) or missed in (misses) the atom cache.
+     *
+     * Decoded atoms are kept in a sharded LRU cache (ATOM_CACHE_SIZE entries, configurable by
+     * mongodb.atom_cache_size, 0 disables it). Entries are invalidated when atoms are added,
+     * replaced or deleted through this RedisMongoDB object. Changes made in MongoDB by other
+     * processes are NOT seen while the respective atoms remain in the cache.
+     *
+     * Entries are invalidated after MongoDB is written and atoms read from MongoDB are only cached
+     * if no entry of the same cache shard has been invalidated since the read started (see
+     * LRUCache::set_if_unchanged()), so a concurrent get_atom() can't put an outdated (or deleted)
+     * atom back in the cache. Invalidations only delay caching in the shard they hit and no lock
+     * is shared by the whole cache.
+     */
+    unsigned long atom_cache_hits() const { return this->atom_cache.hits(); }
+    unsigned long atom_cache_misses() const { return this->atom_cache.misses(); }
+
     void check_existing_targets(const vector<atoms::Link*>& links);
 
     mutex composite_type_hashes_map_mutex;
@@ -162,14 +222,19 @@ class RedisMongoDB : public AtomDB {
     bool skip_redis_;
     bool composite_type_enabled_;
     bool cluster_flag;
-    RedisContextPool* redis_pool;
+    shared_ptr<RedisContextPool> redis_pool;
     mongocxx::pool* mongodb_pool;
     atomic<uint> patterns_next_score{0};
     atomic<uint> incoming_set_next_score{0};
+    LRUCache<string, shared_ptr<Atom>> atom_cache;
 
     map<int, tuple<vector<string>, vector<vector<string>>>> pattern_index_schema_map;
     int pattern_index_schema_next_priority{1};
 
+    shared_ptr<Atom> decode_atom(const string& handle);
+    void invalidate_cached_atom(const string& handle);
+    static shared_ptr<Atom> copy_atom(shared_ptr<Atom> atom);
+    shared_ptr<Atom> decode_atom(shared_ptr<atomdb_api_types::MongodbDocument> atom_document);
     shared_ptr<atomdb_api_types::AtomDocument> get_document(const string& handle,
                                                             const string& collection_name) const;
     /**
@@ -198,6 +263,37 @@ class RedisMongoDB : public AtomDB {
     void set_next_score_with_context(shared_ptr<RedisContext> ctx, const string& key, uint score);
     void reset_scores();
 
+    /**
+     * Atomically reserves a range of scores by incrementing the counter stored in the passed
+     * Redis key. Since the reservation is made in Redis (INCRBY), concurrent writers (in this or
+     * in any other process) always get disjoint ranges.
+     *
+     * @param ctx Redis context used to send the INCRBY command.
+     * @param key Redis key of the score counter.
+     * @param next_score Local copy of the counter (updated with the new value).
+     * @param count Number of scores being reserved.
+     * @return The first score of the reserved range [first, first + count).
+     */
+    uint reserve_scores(shared_ptr<RedisContext> ctx,
+                        const string& key,
+                        atomic<uint>& next_score,
+                        uint count);
+
+    /**
+     * Adds the passed members to Redis sorted sets using one multi-member ZADD per key. A single
+     * range of scores is reserved for all the members and commands are pipelined (flushed every
+     * REDIS_WRITE_BATCH_SIZE commands). Members of the same key keep their relative order.
+     *
+     * @param ctx Redis context used to send the commands.
+     * @param prefix Prefix of the sorted set keys (e.g. REDIS_PATTERNS_PREFIX).
+     * @param next_score Local copy of the score counter of the passed prefix.
+     * @param members Map from key suffix to the members being added to the respective set.
+     */
+    void add_to_sorted_sets(shared_ptr<RedisContext> ctx,
+                            const string& prefix,
+                            atomic<uint>& next_score,
+                            const map<string, vector<string>>& members);
+
     void add_pattern(const string& handle, const string& pattern_handle);
     void add_patterns(const vector<pair<string, string>>& pattern_handles);
     void delete_pattern(const string& handle);
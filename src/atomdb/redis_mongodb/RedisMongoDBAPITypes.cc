@@ -91,6 +91,132 @@ char* HandleSetRedisIterator::next() {
     return nullptr;
 }
 
+HandleSetRedisStream::HandleSetRedisStream(shared_ptr<RedisContextPool> redis_pool,
+                                           const string& key,
+                                           unsigned int chunk_size,
+                                           unsigned int max_results)
+    : HandleSet() {
+    this->redis_pool = redis_pool;
+    this->key = key;
+    this->chunk_size = chunk_size;
+    this->next_offset = 0;
+
+    auto ctx = this->redis_pool->acquire();
+    string command = "ZCARD " + key;
+    redisReply* reply = ctx->execute(command.c_str());
+    if (reply == NULL) RAISE_ERROR("Redis error at HandleSetRedisStream: <" + command + ">");
+    if (reply->type != REDIS_REPLY_INTEGER) {
+        auto error_type = std::to_string(reply->type);
+        freeReplyObject(reply);
+        RAISE_ERROR("Invalid Redis response at HandleSetRedisStream: " + error_type);
+    }
+    this->handles_size = (unsigned int) reply->integer;
+    freeReplyObject(reply);
+    if ((max_results > 0) && (max_results < this->handles_size)) {
+        this->handles_size = max_results;
+    }
+    this->exhausted = (this->handles_size == 0);
+    // The first chunk is only requested when the set is iterated (see get_chunk())
+}
+
+HandleSetRedisStream::~HandleSetRedisStream() {
+    for (auto reply : this->chunks) {
+        freeReplyObject(reply);
+    }
+}
+
+unsigned int HandleSetRedisStream::size() { return this->handles_size; }
+
+void HandleSetRedisStream::append(shared_ptr<HandleSet> other) {
+    RAISE_ERROR("HandleSetRedisStream does not support append");
+}
+
+shared_ptr<HandleSetIterator> HandleSetRedisStream::get_iterator() {
+    return make_shared<HandleSetRedisStreamIterator>(this);
+}
+
+map<string, string> HandleSetRedisStream::get_metta_expressions_by_handle(const string& handle) {
+    RAISE_ERROR("HandleSetRedisStream does not support get_metta_expressions_by_handle");
+    return {};
+}
+
+Assignment HandleSetRedisStream::get_assignments_by_handle(const string& handle) {
+    RAISE_ERROR("HandleSetRedisStream does not support get_assignments_by_handle");
+    return {};
+}
+
+void HandleSetRedisStream::fetch_chunks() {
+    // Caller is supposed to hold api_mutex
+    auto ctx = this->redis_pool->acquire();
+    unsigned int requested = 0;
+    while ((requested < CHUNKS_PER_ROUND_TRIP) && (this->next_offset < this->handles_size)) {
+        unsigned int first = this->next_offset;
+        unsigned int last = min(first + this->chunk_size, this->handles_size) - 1;
+        this->next_offset = last + 1;
+        string command = "ZRANGE " + this->key + " " + to_string(first) + " " + to_string(last);
+        ctx->append_command(command.c_str());
+        requested++;
+    }
+    // All the replies are read (even after an error) so the context can be reused
+    string error = "";
+    for (unsigned int i = 0; i < requested; i++) {
+        redisReply* reply = ctx->get_reply();
+        if (reply == NULL) {
+            if (error == "") error = "Redis error at HandleSetRedisStream: <ZRANGE " + this->key + ">";
+        } else if ((reply->type != REDIS_REPLY_SET) && (reply->type != REDIS_REPLY_ARRAY)) {
+            if (error == "") {
+                error = "Invalid Redis response at HandleSetRedisStream: " + to_string(reply->type);
+            }
+            freeReplyObject(reply);
+        } else if (this->exhausted || (error != "") || (reply->elements == 0)) {
+            freeReplyObject(reply);
+            this->exhausted = true;
+        } else {
+            this->chunks.push_back(reply);
+            // A short chunk means members have been removed after ZCARD
+            this->exhausted = (reply->elements < this->chunk_size);
+        }
+    }
+    if (this->next_offset >= this->handles_size) {
+        this->exhausted = true;
+    }
+    if (error != "") {
+        this->exhausted = true;
+        RAISE_ERROR(error);
+    }
+}
+
+redisReply* HandleSetRedisStream::get_chunk(unsigned int index) {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    while ((index >= this->chunks.size()) && !this->exhausted) {
+        fetch_chunks();
+    }
+    return (index < this->chunks.size()) ? this->chunks[index] : NULL;
+}
+
+HandleSetRedisStreamIterator::HandleSetRedisStreamIterator(HandleSetRedisStream* handle_set) {
+    this->handle_set = handle_set;
+    this->chunk = NULL;
+    this->outer_idx = 0;
+    this->inner_idx = 0;
+}
+
+HandleSetRedisStreamIterator::~HandleSetRedisStreamIterator() {}
+
+char* HandleSetRedisStreamIterator::next() {
+    if ((this->chunk == NULL) || (this->inner_idx >= this->chunk->elements)) {
+        if (this->chunk != NULL) {
+            this->outer_idx++;
+            this->inner_idx = 0;
+        }
+        this->chunk = this->handle_set->get_chunk(this->outer_idx);
+        if (this->chunk == NULL) {
+            return nullptr;
+        }
+    }
+    return this->chunk->element[this->inner_idx++]->str;
+}
+
 RedisStringBundle::RedisStringBundle(redisReply* reply) : HandleList() {
     unsigned int handle_length = (HANDLE_HASH_SIZE - 1);
     this->redis_reply = reply;
@@ -4,9 +4,11 @@
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/json.hpp>
+#include <memory>
 #include <mongocxx/client.hpp>
 #include <mongocxx/exception/exception.hpp>
 #include <mongocxx/uri.hpp>
+#include <mutex>
 #include <vector>
 
 #include "Atom.h"
@@ -14,6 +16,7 @@
 #include "HandleDecoder.h"
 #include "Node.h"
 #include "Properties.h"
+#include "RedisContextPool.h"
 #include "Utils.h"
 
 using namespace std;
@@ -59,6 +62,75 @@ class HandleSetRedisIterator : public HandleSetIterator {
     unsigned int inner_idx;
 };
 
+/**
+ * HandleSet which streams the members of a Redis sorted set.
+ *
+ * Members are fetched in chunks (ZRANGE) on demand while the set is iterated. Nothing is fetched
+ * before the first chunk is requested (so sets which are never iterated, e.g. the ones only used
+ * for size(), cost a single ZCARD); after that, CHUNKS_PER_ROUND_TRIP chunks are requested at a
+ * time (pipelined in a single round trip) so the consumer waits for Redis once every
+ * CHUNKS_PER_ROUND_TRIP chunks. No threads are used. size() is computed (ZCARD) when the set is
+ * created so it's available before any chunk is fetched.
+ *
+ * Fetched chunks are kept until the set is destroyed so char* returned by its iterators remain
+ * valid (as in HandleSetRedis). Several iterators may be used concurrently on the same set.
+ */
+class HandleSetRedisStream : public HandleSet {
+    friend class HandleSetRedisStreamIterator;
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param redis_pool Pool of Redis contexts used to fetch the chunks.
+     * @param key Redis key of the sorted set.
+     * @param chunk_size Max number of members fetched in each ZRANGE.
+     * @param max_results Max number of members in this set (0 means no limit).
+     */
+    HandleSetRedisStream(shared_ptr<RedisContextPool> redis_pool,
+                         const string& key,
+                         unsigned int chunk_size,
+                         unsigned int max_results = 0);
+    ~HandleSetRedisStream();
+
+    unsigned int size();
+    void append(shared_ptr<HandleSet> other);
+    shared_ptr<HandleSetIterator> get_iterator();
+
+    map<string, string> get_metta_expressions_by_handle(const string& handle);
+    Assignment get_assignments_by_handle(const string& handle);
+
+    // Number of chunks requested in each round trip to Redis
+    static constexpr unsigned int CHUNKS_PER_ROUND_TRIP = 2;
+
+   private:
+    shared_ptr<RedisContextPool> redis_pool;
+    string key;
+    unsigned int chunk_size;
+    unsigned int handles_size;
+    unsigned int next_offset;
+    bool exhausted;
+    vector<redisReply*> chunks;
+    mutex api_mutex;
+
+    void fetch_chunks();
+    redisReply* get_chunk(unsigned int index);
+};
+
+class HandleSetRedisStreamIterator : public HandleSetIterator {
+   public:
+    HandleSetRedisStreamIterator(HandleSetRedisStream* handle_set);
+    ~HandleSetRedisStreamIterator();
+
+    char* next();
+
+   private:
+    HandleSetRedisStream* handle_set;
+    redisReply* chunk;
+    unsigned int outer_idx;
+    unsigned int inner_idx;
+};
+
 class RedisStringBundle : public HandleList {
    public:
     RedisStringBundle(redisReply* reply);
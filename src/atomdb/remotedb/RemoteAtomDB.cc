@@ -2,10 +2,16 @@
 #include "RemoteAtomDB.h"
 
 #include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <sstream>
+#include <thread>
 #include <utility>
 
 #include "InMemoryDB.h"
@@ -22,6 +28,218 @@ using namespace atoms;
 using namespace commons;
 
 using json = nlohmann::json;
+using atomdb_api_types::HandleSet;
+
+// -------------------------------------------------------------------------------------------------
+// Fan-out of peer calls
+
+struct RemoteAtomDB::LatencyRecorder {
+    mutex api_mutex;
+    PeerLatencyStats stats;
+
+    void record(unsigned long latency_us, bool error) {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        this->stats.calls++;
+        if (error) this->stats.errors++;
+        this->stats.total_latency_us += latency_us;
+        this->stats.last_latency_us = latency_us;
+        this->stats.max_latency_us = max(this->stats.max_latency_us, latency_us);
+    }
+
+    void record_timeout() {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        this->stats.timeouts++;
+    }
+};
+
+// Queue of the fan-out calls to one peer. Calls are run by up to FANOUT_THREADS_PER_PEER workers
+// which are started on demand (when no worker is idle) and finish after being idle for
+// FANOUT_WORKER_IDLE_TIMEOUT.
+struct RemoteAtomDB::PeerLane : public enable_shared_from_this<PeerLane> {
+    mutex api_mutex;
+    condition_variable call_queued;
+    deque<function<void()>> calls;
+    unsigned int workers = 0;
+    unsigned int idle_workers = 0;
+
+    void enqueue(function<void()> call) {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        this->calls.push_back(std::move(call));
+        if ((this->calls.size() > this->idle_workers) && (this->workers < FANOUT_THREADS_PER_PEER)) {
+            this->workers++;
+            // Detached: the lane is kept alive by its workers, not by the RemoteAtomDB
+            thread([lane = shared_from_this()]() { lane->run(); }).detach();
+        } else {
+            this->call_queued.notify_one();
+        }
+    }
+
+    void run() {
+        unique_lock<mutex> lock(this->api_mutex);
+        while (true) {
+            if (this->calls.empty()) {
+                this->idle_workers++;
+                bool queued = this->call_queued.wait_for(
+                    lock, chrono::milliseconds(FANOUT_WORKER_IDLE_TIMEOUT), [this] {
+                        return !this->calls.empty();
+                    });
+                this->idle_workers--;
+                if (!queued) {
+                    this->workers--;
+                    return;
+                }
+            }
+            function<void()> call = std::move(this->calls.front());
+            this->calls.pop_front();
+            lock.unlock();
+            call();
+            lock.lock();
+        }
+    }
+};
+
+namespace {
+
+using steady = chrono::steady_clock;
+
+unsigned long elapsed_us(steady::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(steady::now() - start).count();
+}
+
+// State shared by the caller of fan_out() and the peer calls it dispatched. Owned jointly so
+// calls which outlive fan_out() (timeouts / early stops) can still deliver (and drop) results.
+template <typename T>
+struct FanOutState {
+    struct Outcome {
+        unsigned int peer_index;
+        T value;
+        exception_ptr error;
+    };
+    mutex api_mutex;
+    condition_variable outcome_arrived;
+    deque<Outcome> outcomes;
+    bool abandoned = false;
+};
+
+}  // namespace
+
+template <typename T>
+bool RemoteAtomDB::fan_out(const PeerList& peers,
+                           const string& operation,
+                           function<T(RemoteAtomDBPeer&)> peer_call,
+                           function<bool(const string&, RemoteAtomDBPeer&, T&)> consume,
+                           bool allow_timeout) {
+    if (!parallel_fanout_ || peers.size() <= 1) {
+        for (auto& [uid, peer] : peers) {
+            auto start = steady::now();
+            T value;
+            try {
+                value = peer_call(*peer);
+            } catch (...) {
+                latency_.at(uid)->record(elapsed_us(start), true);
+                throw;
+            }
+            latency_.at(uid)->record(elapsed_us(start), false);
+            if (consume(uid, *peer, value)) return true;
+        }
+        return true;
+    }
+
+    bool use_timeout = allow_timeout && (peer_timeout_ms_ > 0);
+    auto deadline = steady::now() + chrono::milliseconds(peer_timeout_ms_);
+    auto state = make_shared<FanOutState<T>>();
+    for (unsigned int i = 0; i < peers.size(); i++) {
+        auto peer = peers[i].second;
+        auto recorder = latency_.at(peers[i].first);
+        auto lane = lanes_.at(peers[i].first);
+        lane->enqueue([state, peer, recorder, peer_call, i, use_timeout, deadline]() {
+            {
+                lock_guard<mutex> semaphore(state->api_mutex);
+                // Nobody is waiting for this call anymore (or won't be when it finishes)
+                if (state->abandoned || (use_timeout && steady::now() >= deadline)) return;
+            }
+            auto start = steady::now();
+            typename FanOutState<T>::Outcome outcome{i, T(), nullptr};
+            try {
+                outcome.value = peer_call(*peer);
+            } catch (...) {
+                outcome.error = current_exception();
+            }
+            recorder->record(elapsed_us(start), outcome.error != nullptr);
+            {
+                lock_guard<mutex> semaphore(state->api_mutex);
+                if (state->abandoned) return;
+                state->outcomes.push_back(std::move(outcome));
+            }
+            state->outcome_arrived.notify_one();
+        });
+    }
+
+    vector<bool> answered(peers.size(), false);
+    unsigned int pending = peers.size();
+    exception_ptr first_error = nullptr;
+    bool done = false;
+
+    unique_lock<mutex> lock(state->api_mutex);
+    while (pending > 0 && !done) {
+        auto ready = [&state] { return !state->outcomes.empty(); };
+        if (use_timeout) {
+            if (!state->outcome_arrived.wait_until(lock, deadline, ready)) break;
+        } else {
+            state->outcome_arrived.wait(lock, ready);
+        }
+        auto outcome = std::move(state->outcomes.front());
+        state->outcomes.pop_front();
+        pending--;
+        answered[outcome.peer_index] = true;
+        // Results are merged without holding the lock so peers keep delivering meanwhile
+        lock.unlock();
+        auto& [uid, peer] = peers[outcome.peer_index];
+        if (outcome.error) {
+            if (!first_error) first_error = outcome.error;
+        } else {
+            done = consume(uid, *peer, outcome.value);
+        }
+        lock.lock();
+    }
+    state->abandoned = true;
+    state->outcomes.clear();
+    lock.unlock();
+
+    if (!done && pending > 0) {
+        for (unsigned int i = 0; i < peers.size(); i++) {
+            if (!answered[i]) {
+                latency_.at(peers[i].first)->record_timeout();
+                LOG_INFO("WARNING: " << operation << " timed out on peer [" << peers[i].first
+                                     << "] after " << peer_timeout_ms_ << " ms");
+            }
+        }
+    }
+    if (!done && first_error) rethrow_exception(first_error);
+    return done || (pending == 0);
+}
+
+void RemoteAtomDB::set_peer_timeout(unsigned int milliseconds) { peer_timeout_ms_ = milliseconds; }
+
+void RemoteAtomDB::set_parallel_fanout(bool flag) { parallel_fanout_ = flag; }
+
+map<string, PeerLatencyStats> RemoteAtomDB::get_peer_latency_stats() const {
+    map<string, PeerLatencyStats> answer;
+    for (auto& [uid, recorder] : latency_) {
+        lock_guard<mutex> semaphore(recorder->api_mutex);
+        answer[uid] = recorder->stats;
+    }
+    return answer;
+}
+
+void RemoteAtomDB::reset_peer_latency_stats() {
+    for (auto& [uid, recorder] : latency_) {
+        lock_guard<mutex> semaphore(recorder->api_mutex);
+        recorder->stats = PeerLatencyStats();
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
 
 RemoteAtomDB::RemoteAtomDB(map<string, shared_ptr<RemoteAtomDBPeer>> peers)
     : remote_db_(std::move(peers)) {
@@ -32,13 +250,18 @@ RemoteAtomDB::RemoteAtomDB(map<string, shared_ptr<RemoteAtomDBPeer>> peers)
 RemoteAtomDB::~RemoteAtomDB() = default;
 
 void RemoteAtomDB::finalize_peer_lists() {
+    all_peers_.clear();
     writable_peers_.clear();
     readonly_peers_.clear();
+    latency_.clear();
+    all_peers_.reserve(remote_db_.size());
     writable_peers_.reserve(remote_db_.size());
     readonly_peers_.reserve(remote_db_.size());
 
     unsigned int nested_peers = 0;
     for (auto& [uid, peer] : remote_db_) {
+        all_peers_.emplace_back(uid, peer);
+        latency_[uid] = make_shared<LatencyRecorder>();
         if (peer->is_readonly()) {
             readonly_peers_.emplace_back(uid, peer);
         } else {
@@ -62,6 +285,11 @@ void RemoteAtomDB::finalize_peer_lists() {
                    "be re-matched locally by the query engine.");
         }
     }
+
+    lanes_.clear();
+    for (auto& [uid, peer] : remote_db_) {
+        lanes_[uid] = make_shared<PeerLane>();
+    }
 }
 
 bool RemoteAtomDB::composite_type_enabled() const {
@@ -78,14 +306,19 @@ bool RemoteAtomDB::composite_type_enabled() const {
 bool RemoteAtomDB::allow_nested_indexing() { return nested_indexing_; }
 
 shared_ptr<Atom> RemoteAtomDB::get_atom(const string& handle) {
+    shared_ptr<Atom> answer;
+    auto first_hit = [&answer](const string& uid, RemoteAtomDBPeer&, shared_ptr<Atom>& atom) {
+        if (atom) answer = atom;
+        return atom != nullptr;
+    };
+    auto peer_get_atom = [handle](RemoteAtomDBPeer& peer) { return peer.get_atom(handle); };
+
     // Writable peers first: their write buffer / local_persistence are the source of truth
     // for updated custom attributes (strength) that share a content-addressed handle.
-    for (auto& [uid, peer] : writable_peers_) {
-        auto atom = peer->get_atom(handle);
-        if (atom) {
-            LOG_DEBUG("get_atom(" << handle << ") fetched from writable peer [" << uid << "]");
-            return atom;
-        }
+    fan_out<shared_ptr<Atom>>(writable_peers_, "get_atom", peer_get_atom, first_hit);
+    if (answer) {
+        LOG_DEBUG("get_atom(" << handle << ") fetched from a writable peer");
+        return answer;
     }
 
     // Readonly peers: cache probe then escalate to remote backends (base KB hot path).
@@ -93,17 +326,59 @@ shared_ptr<Atom> RemoteAtomDB::get_atom(const string& handle) {
         auto atom = peer->get_cached_atom(handle);
         if (atom) return atom;
     }
-    for (auto& [uid, peer] : readonly_peers_) {
-        auto atom = peer->get_atom(handle);
-        if (atom) {
-            LOG_DEBUG("get_atom(" << handle << ") fetched from [" << uid << "]");
-            return atom;
-        }
+    fan_out<shared_ptr<Atom>>(readonly_peers_, "get_atom", peer_get_atom, first_hit);
+    if (answer) {
+        LOG_DEBUG("get_atom(" << handle << ") fetched from a readonly peer");
+        return answer;
     }
     LOG_DEBUG("get_atom(" << handle << ") not found in any peer");
     return nullptr;
 }
 
+vector<shared_ptr<Atom>> RemoteAtomDB::get_atoms(const vector<string>& handles) {
+    vector<shared_ptr<Atom>> answer(handles.size());
+    unsigned int missing = handles.size();
+    auto fetch_missing = [&](const PeerList& peers) {
+        if (missing == 0) return;
+        vector<string> request;
+        vector<unsigned int> request_index;
+        for (unsigned int i = 0; i < handles.size(); i++) {
+            if (!answer[i]) {
+                request.push_back(handles[i]);
+                request_index.push_back(i);
+            }
+        }
+        fan_out<vector<shared_ptr<Atom>>>(
+            peers,
+            "get_atoms",
+            [request](RemoteAtomDBPeer& peer) { return peer.get_atoms(request); },
+            [&](const string& uid, RemoteAtomDBPeer&, vector<shared_ptr<Atom>>& atoms) {
+                for (unsigned int j = 0; j < atoms.size() && j < request_index.size(); j++) {
+                    if (atoms[j] && !answer[request_index[j]]) {
+                        answer[request_index[j]] = atoms[j];
+                        missing--;
+                    }
+                }
+                return missing == 0;
+            });
+    };
+
+    // Same order as get_atom(): writable peers, then readonly peers' caches, then their backends
+    fetch_missing(writable_peers_);
+    for (unsigned int i = 0; (i < handles.size()) && (missing > 0); i++) {
+        if (answer[i]) continue;
+        for (auto& [uid, peer] : readonly_peers_) {
+            if ((answer[i] = peer->get_cached_atom(handles[i]))) {
+                missing--;
+                break;
+            }
+        }
+    }
+    fetch_missing(readonly_peers_);
+    LOG_DEBUG("get_atoms(" << handles.size() << ") " << missing << " not found in any peer");
+    return answer;
+}
+
 shared_ptr<Node> RemoteAtomDB::get_node(const string& handle) {
     auto atom = get_atom(handle);
     return dynamic_pointer_cast<Node>(atom);
@@ -118,15 +393,23 @@ vector<shared_ptr<Atom>> RemoteAtomDB::get_matching_atoms(bool is_toplevel, Atom
     vector<shared_ptr<Atom>> result;
     set<string> seen;
 
-    for (auto& [uid, peer] : remote_db_) {
-        auto atoms = peer->get_matching_atoms(is_toplevel, key);
-        for (const auto& atom : atoms) {
-            string h = atom->handle();
-            if (seen.insert(h).second) {
-                result.push_back(atom);
+    // key can't be copied (Atom is abstract) so the calls are always waited for (no timeout)
+    fan_out<vector<shared_ptr<Atom>>>(
+        all_peers_,
+        "get_matching_atoms",
+        [is_toplevel, &key](RemoteAtomDBPeer& peer) {
+            return peer.get_matching_atoms(is_toplevel, key);
+        },
+        [&](const string& uid, RemoteAtomDBPeer&, vector<shared_ptr<Atom>>& atoms) {
+            for (const auto& atom : atoms) {
+                string h = atom->handle();
+                if (seen.insert(h).second) {
+                    result.push_back(atom);
+                }
             }
-        }
-    }
+            return false;
+        },
+        false);
     return result;
 }
 
@@ -136,49 +419,77 @@ shared_ptr<atomdb_api_types::HandleSet> RemoteAtomDB::query_for_pattern(const Li
 
     LOG_DEBUG("query_for_pattern(" << link_schema.handle() << ") fan-out to " << remote_db_.size()
                                    << " peers");
-    for (auto& [uid, peer] : remote_db_) {
-        auto handle_set = peer->query_for_pattern(link_schema);
-        if (!handle_set) continue;
-
-        // Preserve per-handle assignments / metta expressions for nested-indexing peers so the
-        // aggregated result stays faithful instead of silently dropping the backend's match data.
-        bool copy_metadata = peer->allow_nested_indexing();
-        LOG_DEBUG("  [" << uid << "] returned " << handle_set->size() << " handles"
-                        << (copy_metadata ? " (with metadata)" : ""));
-
-        auto it = handle_set->get_iterator();
-        if (!it) continue;
-
-        while (true) {
-            char* h = it->next();
-            if (!h) break;
-            string handle(h);
-            if (seen.insert(handle).second) {
-                if (copy_metadata) {
-                    result->add_handle(handle,
-                                       handle_set->get_metta_expressions_by_handle(handle),
-                                       handle_set->get_assignments_by_handle(handle));
-                } else {
-                    result->add_handle(handle);
+    auto schema = make_shared<LinkSchema>(link_schema);
+    bool complete = fan_out<shared_ptr<HandleSet>>(
+        all_peers_,
+        "query_for_pattern",
+        [schema](RemoteAtomDBPeer& peer) { return peer.query_for_pattern(*schema); },
+        [&](const string& uid, RemoteAtomDBPeer& peer, shared_ptr<HandleSet>& handle_set) {
+            if (!handle_set) return false;
+
+            // Preserve per-handle assignments / metta expressions for nested-indexing peers so the
+            // aggregated result stays faithful instead of silently dropping the backend's match data.
+            bool copy_metadata = peer.allow_nested_indexing();
+            LOG_DEBUG("  [" << uid << "] returned " << handle_set->size() << " handles"
+                            << (copy_metadata ? " (with metadata)" : ""));
+
+            auto it = handle_set->get_iterator();
+            if (!it) return false;
+
+            while (true) {
+                char* h = it->next();
+                if (!h) break;
+                string handle(h);
+                if (seen.insert(handle).second) {
+                    if (copy_metadata) {
+                        result->add_handle(handle,
+                                           handle_set->get_metta_expressions_by_handle(handle),
+                                           handle_set->get_assignments_by_handle(handle));
+                    } else {
+                        result->add_handle(handle);
+                    }
                 }
             }
-        }
-    }
+            return false;
+        });
     LOG_DEBUG("query_for_pattern(" << link_schema.handle() << ") aggregated " << result->size()
                                    << " unique handles");
+    result->set_partial(!complete);
     return result;
 }
 
+unsigned int RemoteAtomDB::count_for_pattern(const LinkSchema& link_schema) {
+    unsigned int count = 0;
+    auto schema = make_shared<LinkSchema>(link_schema);
+    fan_out<unsigned int>(
+        all_peers_,
+        "count_for_pattern",
+        [schema](RemoteAtomDBPeer& peer) { return peer.count_for_pattern(*schema); },
+        [&](const string& uid, RemoteAtomDBPeer& peer, unsigned int& peer_count) {
+            LOG_DEBUG("  [" << uid << "] counted " << peer_count << " links");
+            count = (peer_count > (UINT_MAX - count) ? UINT_MAX : count + peer_count);
+            return false;
+        });
+    LOG_DEBUG("count_for_pattern(" << link_schema.handle() << ") -> " << count);
+    return count;
+}
+
 shared_ptr<atomdb_api_types::HandleList> RemoteAtomDB::query_for_targets(const string& handle) {
-    for (auto& [uid, peer] : remote_db_) {
-        auto list = peer->query_for_targets(handle);
-        if (list) {
+    shared_ptr<atomdb_api_types::HandleList> answer;
+    fan_out<shared_ptr<atomdb_api_types::HandleList>>(
+        all_peers_,
+        "query_for_targets",
+        [handle](RemoteAtomDBPeer& peer) { return peer.query_for_targets(handle); },
+        [&](const string& uid, RemoteAtomDBPeer&, shared_ptr<atomdb_api_types::HandleList>& list) {
+            if (!list) return false;
             LOG_DEBUG("query_for_targets(" << handle << ") served by peer [" << uid << "]");
-            return list;
-        }
+            answer = list;
+            return true;
+        });
+    if (!answer) {
+        LOG_DEBUG("query_for_targets(" << handle << ") not found in any peer");
     }
-    LOG_DEBUG("query_for_targets(" << handle << ") not found in any peer");
-    return nullptr;
+    return answer;
 }
 
 shared_ptr<atomdb_api_types::HandleSet> RemoteAtomDB::query_for_incoming_set(const string& handle) {
@@ -186,85 +497,94 @@ shared_ptr<atomdb_api_types::HandleSet> RemoteAtomDB::query_for_incoming_set(con
     set<string> seen;
 
     LOG_DEBUG("query_for_incoming_set(" << handle << ") fan-out to " << remote_db_.size() << " peers");
-    for (auto& [uid, peer] : remote_db_) {
-        auto handle_set = peer->query_for_incoming_set(handle);
-        if (!handle_set) continue;
-
-        auto it = handle_set->get_iterator();
-        if (!it) continue;
-
-        while (true) {
-            char* h = it->next();
-            if (!h) break;
-            string member(h);
-            if (seen.insert(member).second) {
-                result->add_handle(member);
+    bool complete = fan_out<shared_ptr<HandleSet>>(
+        all_peers_,
+        "query_for_incoming_set",
+        [handle](RemoteAtomDBPeer& peer) { return peer.query_for_incoming_set(handle); },
+        [&](const string& uid, RemoteAtomDBPeer&, shared_ptr<HandleSet>& handle_set) {
+            if (!handle_set) return false;
+            auto it = handle_set->get_iterator();
+            if (!it) return false;
+
+            while (true) {
+                char* h = it->next();
+                if (!h) break;
+                string member(h);
+                if (seen.insert(member).second) {
+                    result->add_handle(member);
+                }
             }
-        }
-    }
+            return false;
+        });
     LOG_DEBUG("query_for_incoming_set(" << handle << ") aggregated " << result->size()
                                         << " unique handles");
+    result->set_partial(!complete);
     return result;
 }
 
 bool RemoteAtomDB::atom_exists(const string& handle) {
-    for (auto& [uid, peer] : remote_db_) {
-        if (peer->atom_exists(handle)) return true;
-    }
-    return false;
+    bool exists = false;
+    fan_out<bool>(
+        all_peers_,
+        "atom_exists",
+        [handle](RemoteAtomDBPeer& peer) { return peer.atom_exists(handle); },
+        [&exists](const string&, RemoteAtomDBPeer&, bool& flag) { return exists = flag; });
+    return exists;
 }
 
 bool RemoteAtomDB::node_exists(const string& handle) {
-    for (auto& [uid, peer] : remote_db_) {
-        if (peer->node_exists(handle)) return true;
-    }
-    return false;
+    bool exists = false;
+    fan_out<bool>(
+        all_peers_,
+        "node_exists",
+        [handle](RemoteAtomDBPeer& peer) { return peer.node_exists(handle); },
+        [&exists](const string&, RemoteAtomDBPeer&, bool& flag) { return exists = flag; });
+    return exists;
 }
 
 bool RemoteAtomDB::link_exists(const string& handle) {
-    for (auto& [uid, peer] : remote_db_) {
-        if (peer->link_exists(handle)) return true;
-    }
-    return false;
-}
-
-namespace {
-
-template <typename PeerExistFn>
-set<string> fanout_exist(const map<string, shared_ptr<RemoteAtomDBPeer>>& peers,
-                         const vector<string>& handles,
-                         PeerExistFn peer_exist) {
+    bool exists = false;
+    fan_out<bool>(
+        all_peers_,
+        "link_exists",
+        [handle](RemoteAtomDBPeer& peer) { return peer.link_exists(handle); },
+        [&exists](const string&, RemoteAtomDBPeer&, bool& flag) { return exists = flag; });
+    return exists;
+}
+
+// Every peer checks all the handles (concurrently) and the results are merged. Stops as soon as all
+// the handles have been found.
+set<string> RemoteAtomDB::fan_out_exist(const string& operation,
+                                        const vector<string>& handles,
+                                        PeerExistCall peer_exist) {
     set<string> result;
-    set<string> remaining(handles.begin(), handles.end());
-
-    for (auto& [uid, peer] : peers) {
-        if (remaining.empty()) break;
-        vector<string> to_check(remaining.begin(), remaining.end());
-        auto found = peer_exist(*peer, to_check);
-        for (const auto& h : found) {
-            result.insert(h);
-            remaining.erase(h);
-        }
-    }
+    size_t unique_handles = set<string>(handles.begin(), handles.end()).size();
+    if (unique_handles == 0) return result;
+    fan_out<set<string>>(
+        all_peers_,
+        operation,
+        [handles, peer_exist](RemoteAtomDBPeer& peer) { return peer_exist(peer, handles); },
+        [&](const string&, RemoteAtomDBPeer&, set<string>& found) {
+            result.insert(found.begin(), found.end());
+            return result.size() == unique_handles;
+        });
     return result;
 }
 
-}  // namespace
-
 set<string> RemoteAtomDB::atoms_exist(const vector<string>& handles) {
-    return fanout_exist(remote_db_, handles, [](RemoteAtomDBPeer& p, const vector<string>& h) {
+    return fan_out_exist("atoms_exist", handles, [](RemoteAtomDBPeer& p, const vector<string>& h) {
         return p.atoms_exist(h);
     });
 }
 
 set<string> RemoteAtomDB::nodes_exist(const vector<string>& handles) {
-    return fanout_exist(remote_db_, handles, [](RemoteAtomDBPeer& p, const vector<string>& h) {
+    return fan_out_exist("nodes_exist", handles, [](RemoteAtomDBPeer& p, const vector<string>& h) {
         return p.nodes_exist(h);
     });
 }
 
 set<string> RemoteAtomDB::links_exist(const vector<string>& handles) {
-    return fanout_exist(remote_db_, handles, [](RemoteAtomDBPeer& p, const vector<string>& h) {
+    return fan_out_exist("links_exist", handles, [](RemoteAtomDBPeer& p, const vector<string>& h) {
         return p.links_exist(h);
     });
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -13,12 +14,54 @@ using namespace std;
 
 namespace atomdb {
 
+/**
+ * Latency statistics of the calls RemoteAtomDB made to one of its peers.
+ */
+struct PeerLatencyStats {
+    unsigned long calls = 0;     ///< Calls which finished (successfully or not).
+    unsigned long errors = 0;    ///< Calls which raised an exception.
+    unsigned long timeouts = 0;  ///< Calls abandoned because they exceeded the peer timeout.
+    unsigned long total_latency_us = 0;
+    unsigned long max_latency_us = 0;
+    unsigned long last_latency_us = 0;
+
+    double mean_latency_us() const { return calls == 0 ? 0.0 : (double) total_latency_us / calls; }
+};
+
 /**
  * RemoteAtomDB connects to multiple remote AtomDBs via RemoteAtomDBPeer instances.
  * Each peer maintains its own cache, remote connection, and local persistence.
+ *
+ * Reads are fanned out to all the relevant peers concurrently so a query takes (roughly) the
+ * latency of the slowest peer rather than the sum of all peers' latencies. Set queries
+ * (query_for_pattern(), query_for_incoming_set(), ...) merge peer results as they arrive and point
+ * lookups (get_atom(), query_for_targets(), atom_exists(), ...) return the first hit without
+ * waiting for the other peers. Writes are still applied to peers one after another.
+ *
+ * Each peer has its own queue of calls and runs at most FANOUT_THREADS_PER_PEER of them at a time,
+ * so a hung peer only delays the calls made to itself.
+ *
+ * When a peer timeout is set, peers which don't answer in time are left out of the result (their
+ * running calls keep going in background and are accounted in the latency stats; their queued
+ * calls are dropped without being started). Set queries which left a peer out return a partial
+ * HandleSet (see HandleSet::is_partial()). Errors raised by peers are re-thrown to the caller
+ * unless another peer had already provided the answer.
  */
 class RemoteAtomDB : public AtomDB {
    public:
+    // Handle overloads from AtomDB (otherwise hidden by the overrides below)
+    using AtomDB::get_atom;
+    using AtomDB::get_node;
+    using AtomDB::get_link;
+    using AtomDB::query_for_targets;
+    using AtomDB::query_for_incoming_set;
+    using AtomDB::atom_exists;
+    using AtomDB::node_exists;
+    using AtomDB::link_exists;
+    using AtomDB::delete_atom;
+    using AtomDB::delete_node;
+    using AtomDB::delete_link;
+
     /**
      * Dependency-injection constructor for pre-built peers.
      * Primarily used by tests to federate controllable backends without live config/connection.
@@ -33,9 +76,23 @@ class RemoteAtomDB : public AtomDB {
     shared_ptr<Node> get_node(const string& handle) override;
     shared_ptr<Link> get_link(const string& handle) override;
 
+    /**
+     * Batched get_atom(): peers are probed in the same order as in get_atom() but each peer is
+     * asked (with a single call) for all the handles not found in the previous ones.
+     */
+    vector<shared_ptr<Atom>> get_atoms(const vector<string>& handles) override;
+
     vector<shared_ptr<Atom>> get_matching_atoms(bool is_toplevel, Atom& key) override;
 
     shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema) override;
+
+    /**
+     * Sum of the counts of all the peers (see RemoteAtomDBPeer::count_for_pattern()), fanned out
+     * like query_for_pattern() but without fetching the links. Links stored in more than one peer
+     * are counted more than once and peers which time out are left out, so it's an estimate.
+     */
+    unsigned int count_for_pattern(const LinkSchema& link_schema) override;
+
     shared_ptr<atomdb_api_types::HandleList> query_for_targets(const string& handle) override;
     shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle) override;
 
@@ -80,18 +137,71 @@ class RemoteAtomDB : public AtomDB {
 
     void release_caches(const LinkSchema& link_schema, bool persist = true, bool force = false);
 
+    /**
+     * Sets the max time (in milliseconds) a read waits for a peer. 0 (default) means no timeout.
+     */
+    void set_peer_timeout(unsigned int milliseconds);
+    unsigned int get_peer_timeout() const { return peer_timeout_ms_; }
+
+    /**
+     * Enables/disables concurrent fan-out of reads (enabled by default). When disabled, peers are
+     * called one after another in the calling thread (and the peer timeout is ignored).
+     */
+    void set_parallel_fanout(bool flag);
+
+    /**
+     * Returns a snapshot of the latency stats of each peer (keyed by peer uid).
+     */
+    map<string, PeerLatencyStats> get_peer_latency_stats() const;
+    void reset_peer_latency_stats();
+
    private:
+    struct LatencyRecorder;
+    struct PeerLane;
+    using PeerList = vector<pair<string, shared_ptr<RemoteAtomDBPeer>>>;
+
+    // Calls peer_call on each of the passed peers (concurrently, unless parallel fan-out is
+    // disabled) and passes each result to consume() in the calling thread as soon as it's
+    // available. Stops as soon as consume() returns true. Peer calls may outlive this method
+    // (timeouts and early stops) so peer_call must not capture anything by reference unless
+    // allow_timeout is false (in which case all the calls are waited for, unless consume()
+    // returns true). Returns false iff some peer was given up on (timeout) before consume()
+    // returned true.
+    template <typename T>
+    bool fan_out(const PeerList& peers,
+                 const string& operation,
+                 function<T(RemoteAtomDBPeer&)> peer_call,
+                 function<bool(const string&, RemoteAtomDBPeer&, T&)> consume,
+                 bool allow_timeout = true);
+
+    using PeerExistCall = function<set<string>(RemoteAtomDBPeer&, const vector<string>&)>;
+    set<string> fan_out_exist(const string& operation,
+                              const vector<string>& handles,
+                              PeerExistCall peer_exist);
+
     // Derives the aggregated nested-indexing capability and writable/readonly peer lists.
     // Shared by both constructors so the config and DI paths stay consistent.
     void finalize_peer_lists();
 
     map<string, shared_ptr<RemoteAtomDBPeer>> remote_db_;
     // Immutable after construction (peer map never changes).
-    vector<pair<string, shared_ptr<RemoteAtomDBPeer>>> writable_peers_;
-    vector<pair<string, shared_ptr<RemoteAtomDBPeer>>> readonly_peers_;
+    PeerList all_peers_;
+    PeerList writable_peers_;
+    PeerList readonly_peers_;
+    map<string, shared_ptr<LatencyRecorder>> latency_;
+    // Run the fan-out calls to each peer. Their workers are detached so destroying the RemoteAtomDB
+    // doesn't wait for calls to hung peers.
+    map<string, shared_ptr<PeerLane>> lanes_;
+    unsigned int peer_timeout_ms_ = 0;
+    bool parallel_fanout_ = true;
     // Aggregated nested-indexing capability, derived from peers at construction. True only when
     // every peer supports nested indexing; mixed configurations are normalized to false.
     bool nested_indexing_ = false;
+
+    // Max number of concurrent fan-out calls to each peer.
+    static constexpr unsigned int FANOUT_THREADS_PER_PEER = 4;
+    // Time (in milliseconds) an idle fan-out worker waits for new calls before finishing.
+    static constexpr unsigned int FANOUT_WORKER_IDLE_TIMEOUT = 10000;
 };
 
 }  // namespace atomdb
@@ -96,6 +96,45 @@ shared_ptr<Atom> RemoteAtomDBPeer::get_atom(const string& handle) {
     return nullptr;
 }
 
+vector<shared_ptr<Atom>> RemoteAtomDBPeer::get_atoms(const vector<string>& handles) {
+    auto wb = write_buffer();
+    auto rc = read_cache();
+
+    vector<shared_ptr<Atom>> atoms(handles.size());
+    vector<string> missing;
+    vector<unsigned int> missing_index;
+    for (unsigned int i = 0; i < handles.size(); i++) {
+        auto atom = wb->get_atom(handles[i]);
+        if (!atom && local_persistence_) {
+            if ((atom = local_persistence_->get_atom(handles[i]))) {
+                rc->add_atom(atom.get());
+            }
+        }
+        if (!atom) {
+            atom = rc->get_atom(handles[i]);
+        }
+        if (atom) {
+            atoms[i] = atom;
+        } else {
+            missing.push_back(handles[i]);
+            missing_index.push_back(i);
+        }
+    }
+
+    if (!missing.empty()) {
+        auto fetched = atomdb_->get_atoms(missing);
+        for (unsigned int j = 0; j < fetched.size() && j < missing.size(); j++) {
+            if (fetched[j]) {
+                rc->add_atom(fetched[j].get());
+                atoms[missing_index[j]] = fetched[j];
+            }
+        }
+        LOG_DEBUG("[RemoteDB(" << uid_ << ")] get_atoms(" << handles.size() << ") fetched "
+                               << missing.size() << " from remote atomdb");
+    }
+    return atoms;
+}
+
 shared_ptr<Node> RemoteAtomDBPeer::get_node(const string& handle) {
     auto atom = get_atom(handle);
     return dynamic_pointer_cast<Node>(atom);
@@ -252,6 +291,25 @@ shared_ptr<HandleSet> RemoteAtomDBPeer::query_for_pattern(const LinkSchema& link
     return result;
 }
 
+unsigned int RemoteAtomDBPeer::count_for_pattern(const LinkSchema& link_schema) {
+    bool cache_hit;
+    {
+        lock_guard<mutex> lock(peer_mutex_);
+        cache_hit = fetched_link_templates_.count(link_schema.handle()) > 0;
+    }
+    if (cache_hit) {
+        return query_for_pattern(link_schema)->size();
+    }
+    unsigned int count = atomdb_->count_for_pattern(link_schema);
+    if (local_persistence_) {
+        count += local_persistence_->count_for_pattern(link_schema);
+    }
+    count += write_buffer()->count_for_pattern(link_schema);
+    LOG_DEBUG("[RemoteDB(" << uid_ << ")] count_for_pattern(" << link_schema.handle() << ") -> "
+                           << count);
+    return count;
+}
+
 shared_ptr<HandleList> RemoteAtomDBPeer::query_for_targets(const string& handle) {
     if (auto result = write_buffer()->query_for_targets(handle)) {
         return result;
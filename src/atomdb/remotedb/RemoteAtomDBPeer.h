@@ -36,6 +36,19 @@ namespace atomdb {
  */
 class RemoteAtomDBPeer : public AtomDB, public processor::ThreadMethod {
    public:
+    // Handle overloads from AtomDB (otherwise hidden by the overrides below)
+    using AtomDB::get_atom;
+    using AtomDB::get_node;
+    using AtomDB::get_link;
+    using AtomDB::query_for_targets;
+    using AtomDB::query_for_incoming_set;
+    using AtomDB::atom_exists;
+    using AtomDB::node_exists;
+    using AtomDB::link_exists;
+    using AtomDB::delete_atom;
+    using AtomDB::delete_node;
+    using AtomDB::delete_link;
+
     RemoteAtomDBPeer(shared_ptr<AtomDB> remote_atomdb,
                      shared_ptr<AtomDB> local_persistence = nullptr,
                      const string& uid = "");
@@ -48,6 +61,10 @@ class RemoteAtomDBPeer : public AtomDB, public processor::ThreadMethod {
     shared_ptr<Node> get_node(const string& handle) override;
     shared_ptr<Link> get_link(const string& handle) override;
 
+    // Same lookup order as get_atom() but all the atoms missing in the local layers are fetched
+    // from the remote atomdb with a single (batched) call.
+    vector<shared_ptr<Atom>> get_atoms(const vector<string>& handles) override;
+
     // In-memory lookups only (write_buffer + read_cache). Used by the RemoteAtomDB facade
     // to probe every peer's cache before escalating any peer to its backend.
     shared_ptr<Atom> get_cached_atom(const string& handle);
@@ -58,6 +75,13 @@ class RemoteAtomDBPeer : public AtomDB, public processor::ThreadMethod {
     vector<shared_ptr<Atom>> get_matching_atoms(bool is_toplevel, Atom& key, bool local_only);
 
     shared_ptr<atomdb_api_types::HandleSet> query_for_pattern(const LinkSchema& link_schema) override;
+
+    // Exact (in-memory) count if the pattern has already been fetched from the remote atomdb.
+    // Otherwise the counts of the remote atomdb, local_persistence and write_buffer are added up
+    // without fetching the links, so links stored in more than one of them are counted more than
+    // once (it's an upper bound).
+    unsigned int count_for_pattern(const LinkSchema& link_schema) override;
+
     shared_ptr<atomdb_api_types::HandleList> query_for_targets(const string& handle) override;
     shared_ptr<atomdb_api_types::HandleSet> query_for_incoming_set(const string& handle) override;
 
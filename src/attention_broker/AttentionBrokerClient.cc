@@ -14,17 +14,31 @@ mutex AttentionBrokerClient::api_mutex;
 string AttentionBrokerClient::SERVER_ADDRESS = DEFAULT_ATTENTION_BROKER_ADDRESS;
 unsigned int AttentionBrokerClient::MAX_GET_IMPORTANCE_BUNDLE_SIZE = 100000;
 unsigned int AttentionBrokerClient::MAX_SET_DETERMINERS_HANDLE_COUNT = 100000;
+unsigned int AttentionBrokerClient::GET_IMPORTANCE_FLUSH_DEADLINE = 1;
+shared_ptr<grpc::Channel> AttentionBrokerClient::channel;
+string AttentionBrokerClient::channel_address;
+map<string, shared_ptr<AttentionBrokerClient::ImportanceBatch>>
+    AttentionBrokerClient::pending_importance_batches;
+mutex AttentionBrokerClient::importance_batch_mutex;
+condition_variable AttentionBrokerClient::importance_batch_condition;
 
 // -------------------------------------------------------------------------------------------------
 // Public methods
 
-void AttentionBrokerClient::set_server_address(const string& ip_port) { SERVER_ADDRESS = ip_port; }
+void AttentionBrokerClient::set_server_address(const string& ip_port) {
+    lock_guard<mutex> semaphore(api_mutex);
+    SERVER_ADDRESS = ip_port;
+}
+
+void AttentionBrokerClient::set_get_importance_flush_deadline(unsigned int millis) {
+    lock_guard<mutex> semaphore(importance_batch_mutex);
+    GET_IMPORTANCE_FLUSH_DEADLINE = millis;
+}
 
 void AttentionBrokerClient::correlate(const set<string>& handles, const string& context) {
     dasproto::HandleList handle_list;  // GRPC command parameter
     dasproto::Ack ack;                 // GRPC command return
-    auto stub = dasproto::AttentionBroker::NewStub(
-        grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials()));
+    auto stub = dasproto::AttentionBroker::NewStub(get_channel());
 
     handle_list.set_context(context);
     for (string handle : handles) {
@@ -32,7 +46,8 @@ void AttentionBrokerClient::correlate(const set<string>& handles, const string&
     }
     if (handle_list.list_size() > 0) {
         LOG_DEBUG("Calling AttentionBroker GRPC. Correlating " << handle_list.list_size() << " handles");
-        stub->correlate(new grpc::ClientContext(), handle_list, &ack);
+        grpc::ClientContext grpc_context;
+        stub->correlate(&grpc_context, handle_list, &ack);
         if (ack.msg() != "CORRELATE") {
             RAISE_ERROR("Failed GRPC command: AttentionBroker::correlate()");
         }
@@ -44,8 +59,7 @@ void AttentionBrokerClient::correlate(const set<string>& handles, const string&
 void AttentionBrokerClient::asymmetric_correlate(const vector<string>& handles, const string& context) {
     dasproto::HandleList handle_list;  // GRPC command parameter
     dasproto::Ack ack;                 // GRPC command return
-    auto stub = dasproto::AttentionBroker::NewStub(
-        grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials()));
+    auto stub = dasproto::AttentionBroker::NewStub(get_channel());
 
     handle_list.set_context(context);
     for (string handle : handles) {
@@ -54,7 +68,8 @@ void AttentionBrokerClient::asymmetric_correlate(const vector<string>& handles,
     if (handle_list.list_size() > 0) {
         LOG_DEBUG("Calling AttentionBroker GRPC. Correlating (asymmetric) " << handle_list.list_size()
                                                                             << " handles");
-        stub->asymmetric_correlate(new grpc::ClientContext(), handle_list, &ack);
+        grpc::ClientContext grpc_context;
+        stub->asymmetric_correlate(&grpc_context, handle_list, &ack);
         if (ack.msg() != "ASYMMETRIC_CORRELATE") {
             RAISE_ERROR("Failed GRPC command: AttentionBroker::asymmetric_correlate()");
         }
@@ -67,8 +82,7 @@ void AttentionBrokerClient::stimulate(const map<string, unsigned int>& handle_ma
                                       const string& context) {
     dasproto::HandleCount handle_count;  // GRPC command parameter
     dasproto::Ack ack;                   // GRPC command return
-    auto stub = dasproto::AttentionBroker::NewStub(
-        grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials()));
+    auto stub = dasproto::AttentionBroker::NewStub(get_channel());
 
     handle_count.set_context(context);
     unsigned int sum = 0;
@@ -79,7 +93,8 @@ void AttentionBrokerClient::stimulate(const map<string, unsigned int>& handle_ma
     (*handle_count.mutable_map())["SUM"] = sum;
     LOG_DEBUG("Calling AttentionBroker GRPC. Stimulating " << handle_count.mutable_map()->size() - 1
                                                            << " handles");
-    stub->stimulate(new grpc::ClientContext(), handle_count, &ack);
+    grpc::ClientContext grpc_context;
+    stub->stimulate(&grpc_context, handle_count, &ack);
     if (ack.msg() != "STIMULATE") {
         RAISE_ERROR("Failed GRPC command: AttentionBroker::stimulate()");
     }
@@ -89,8 +104,7 @@ void AttentionBrokerClient::set_determiners(const vector<vector<string>>& handle
                                             const string& context) {
     dasproto::HandleListList request;  // GRPC command parameter
     dasproto::Ack ack;                 // GRPC command return
-    auto stub = dasproto::AttentionBroker::NewStub(
-        grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials()));
+    auto stub = dasproto::AttentionBroker::NewStub(get_channel());
 
     unsigned int pending_count = handle_lists.size();
     unsigned int cursor = 0;
@@ -111,7 +125,8 @@ void AttentionBrokerClient::set_determiners(const vector<vector<string>>& handle
         }
         LOG_DEBUG("Calling AttentionBroker GRPC. Setting determiners for " << request.list_size()
                                                                            << " handles");
-        stub->set_determiners(new grpc::ClientContext(), request, &ack);
+        grpc::ClientContext grpc_context;
+        stub->set_determiners(&grpc_context, request, &ack);
         if (ack.msg() != "SET_DETERMINERS") {
             RAISE_ERROR("Failed GRPC command: AttentionBroker::set_determiners()");
         }
@@ -123,28 +138,59 @@ void AttentionBrokerClient::set_determiners(const vector<vector<string>>& handle
 void AttentionBrokerClient::get_importance(const vector<string>& handles,
                                            const string& context,
                                            vector<float>& importances) {
-    unsigned int pending_count = handles.size();
-    unsigned int cursor = 0;
-    unsigned int bundle_count = 0;
-    dasproto::HandleList handle_list;
-    dasproto::ImportanceList importance_list;
-    while (pending_count > 0) {
-        handle_list.set_context(context);
-        while ((pending_count > 0) && (bundle_count < MAX_GET_IMPORTANCE_BUNDLE_SIZE)) {
-            handle_list.add_list(handles[cursor++]);
-            pending_count--;
-            bundle_count++;
+    if (handles.size() == 0) {
+        return;
+    }
+    unique_lock<mutex> lock(importance_batch_mutex);
+    if ((GET_IMPORTANCE_FLUSH_DEADLINE == 0) || (handles.size() >= MAX_GET_IMPORTANCE_BUNDLE_SIZE)) {
+        lock.unlock();
+        fetch_importance(handles, context, importances);
+        return;
+    }
+
+    ImportanceRequest request;
+    request.handles = &handles;
+    request.importances = &importances;
+    request.done = false;
+
+    shared_ptr<ImportanceBatch> batch;
+    auto iterator = pending_importance_batches.find(context);
+    if (iterator != pending_importance_batches.end()) {
+        batch = iterator->second;
+        if ((batch->handle_count + handles.size()) > MAX_GET_IMPORTANCE_BUNDLE_SIZE) {
+            // No room for this request in the pending batch so it's flushed right away
+            pending_importance_batches.erase(iterator);
+            flush_importance_batch(lock, batch, context);
+            batch.reset();
         }
-        auto stub = dasproto::AttentionBroker::NewStub(
-            grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials()));
-        LOG_DEBUG("Querying AttentionBroker for importance of " << handle_list.list_size() << " atoms.");
-        stub->get_importance(new grpc::ClientContext(), handle_list, &importance_list);
-        for (unsigned int i = 0; i < bundle_count; i++) {
-            importances.push_back(importance_list.list(i));
+    }
+    if (!batch) {
+        batch = make_shared<ImportanceBatch>();
+        batch->deadline =
+            chrono::steady_clock::now() + chrono::milliseconds(GET_IMPORTANCE_FLUSH_DEADLINE);
+        pending_importance_batches[context] = batch;
+    }
+    batch->requests.push_back(&request);
+    batch->handle_count += handles.size();
+
+    while (!request.done) {
+        iterator = pending_importance_batches.find(context);
+        bool still_pending =
+            ((iterator != pending_importance_batches.end()) && (iterator->second == batch));
+        if (still_pending && ((batch->handle_count >= MAX_GET_IMPORTANCE_BUNDLE_SIZE) ||
+                              (chrono::steady_clock::now() >= batch->deadline))) {
+            pending_importance_batches.erase(iterator);
+            flush_importance_batch(lock, batch, context);
+        } else if (still_pending) {
+            importance_batch_condition.wait_until(lock, batch->deadline);
+        } else {
+            // Batch is being flushed by another thread
+            importance_batch_condition.wait(lock);
         }
-        bundle_count = 0;
-        handle_list.clear_list();
-        importance_list.clear_list();
+    }
+    if (request.error != "") {
+        lock.unlock();
+        RAISE_ERROR(request.error);
     }
 }
 
@@ -158,14 +204,14 @@ void AttentionBrokerClient::set_parameters(float rent_rate,
     request.set_spreading_rate_lowerbound(spreading_rate_lowerbound);
     request.set_spreading_rate_upperbound(spreading_rate_upperbound);
 
-    auto stub = dasproto::AttentionBroker::NewStub(
-        grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials()));
+    auto stub = dasproto::AttentionBroker::NewStub(get_channel());
 
     LOG_DEBUG("Calling AttentionBroker GRPC. Setting dynamics parameters. RENT_RATE: "
               << request.rent_rate()
               << " SPREADING_RATE_LOWERBOUND: " << request.spreading_rate_lowerbound()
               << " SPREADING_RATE_UPPERBOUND: " << request.spreading_rate_upperbound());
-    stub->set_parameters(new grpc::ClientContext(), request, &ack);
+    grpc::ClientContext grpc_context;
+    stub->set_parameters(&grpc_context, request, &ack);
     if (ack.msg() != "SET_PARAMETERS") {
         RAISE_ERROR("Failed GRPC command: AttentionBroker::set_parameters()");
     }
@@ -175,11 +221,11 @@ bool AttentionBrokerClient::health_check(bool throw_on_error) {
     dasproto::Empty request;  // GRPC command parameter
     dasproto::Ack ack;        // GRPC command return
 
-    auto stub = dasproto::AttentionBroker::NewStub(
-        grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials()));
+    auto stub = dasproto::AttentionBroker::NewStub(get_channel());
 
     LOG_DEBUG("Calling AttentionBroker GRPC. Ping");
-    stub->ping(new grpc::ClientContext(), request, &ack);
+    grpc::ClientContext grpc_context;
+    stub->ping(&grpc_context, request, &ack);
     if (ack.msg() == "PING") {
         return true;
     } else {
@@ -199,14 +245,93 @@ void AttentionBrokerClient::drop_and_load_context(const string& context, const s
     request.set_context(context);
     request.set_file_name(file_name);
 
-    auto stub = dasproto::AttentionBroker::NewStub(
-        grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials()));
+    auto stub = dasproto::AttentionBroker::NewStub(get_channel());
 
     LOG_DEBUG(
         "Calling AttentionBroker GRPC. Dropping context info and loading contents from file. Context: " +
         context + " File name: " + file_name);
-    stub->drop_and_load_context(new grpc::ClientContext(), request, &ack);
+    grpc::ClientContext grpc_context;
+    stub->drop_and_load_context(&grpc_context, request, &ack);
     if (ack.msg() != "DROP_AND_LOAD_CONTEXT") {
         RAISE_ERROR("Failed GRPC command: AttentionBroker::drop_and_load_context()");
     }
 }
+
+// -------------------------------------------------------------------------------------------------
+// Private methods
+
+shared_ptr<grpc::Channel> AttentionBrokerClient::get_channel() {
+    lock_guard<mutex> semaphore(api_mutex);
+    if ((!channel) || (channel_address != SERVER_ADDRESS) ||
+        (channel->GetState(false) == GRPC_CHANNEL_SHUTDOWN)) {
+        channel = grpc::CreateChannel(SERVER_ADDRESS, grpc::InsecureChannelCredentials());
+        channel_address = SERVER_ADDRESS;
+    }
+    return channel;
+}
+
+void AttentionBrokerClient::fetch_importance(const vector<string>& handles,
+                                             const string& context,
+                                             vector<float>& importances) {
+    unsigned int pending_count = handles.size();
+    unsigned int cursor = 0;
+    unsigned int bundle_count = 0;
+    dasproto::HandleList handle_list;
+    dasproto::ImportanceList importance_list;
+    auto stub = dasproto::AttentionBroker::NewStub(get_channel());
+    while (pending_count > 0) {
+        handle_list.set_context(context);
+        while ((pending_count > 0) && (bundle_count < MAX_GET_IMPORTANCE_BUNDLE_SIZE)) {
+            handle_list.add_list(handles[cursor++]);
+            pending_count--;
+            bundle_count++;
+        }
+        LOG_DEBUG("Querying AttentionBroker for importance of " << handle_list.list_size() << " atoms.");
+        grpc::ClientContext grpc_context;
+        grpc::Status status = stub->get_importance(&grpc_context, handle_list, &importance_list);
+        if ((!status.ok()) || ((unsigned int) importance_list.list_size() != bundle_count)) {
+            RAISE_ERROR("Failed GRPC command: AttentionBroker::get_importance()");
+        }
+        for (unsigned int i = 0; i < bundle_count; i++) {
+            importances.push_back(importance_list.list(i));
+        }
+        bundle_count = 0;
+        handle_list.clear_list();
+        importance_list.clear_list();
+    }
+}
+
+void AttentionBrokerClient::flush_importance_batch(unique_lock<mutex>& lock,
+                                                   shared_ptr<ImportanceBatch> batch,
+                                                   const string& context) {
+    // The batch is not reachable by other threads anymore so it's safe to release the lock
+    // while the GRPC call is made.
+    lock.unlock();
+    vector<string> handles;
+    vector<float> importances;
+    string error = "";
+    handles.reserve(batch->handle_count);
+    for (auto request : batch->requests) {
+        handles.insert(handles.end(), request->handles->begin(), request->handles->end());
+    }
+    try {
+        LOG_DEBUG("Flushing " << batch->requests.size() << " coalesced get_importance() requests");
+        fetch_importance(handles, context, importances);
+    } catch (const std::exception& exception) {
+        error = exception.what();
+    }
+    lock.lock();
+    unsigned int cursor = 0;
+    for (auto request : batch->requests) {
+        if (error == "") {
+            request->importances->insert(request->importances->end(),
+                                         importances.begin() + cursor,
+                                         importances.begin() + cursor + request->handles->size());
+            cursor += request->handles->size();
+        } else {
+            request->error = error;
+        }
+        request->done = true;
+    }
+    importance_batch_condition.notify_all();
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
@@ -10,10 +13,25 @@ using namespace std;
 
 #define DEFAULT_ATTENTION_BROKER_ADDRESS "localhost:40001"
 
+namespace grpc {
+class Channel;
+}
+
 namespace attention_broker {
 
 /**
+ * Client API to the AttentionBroker.
+ *
+ * A single GRPC channel to SERVER_ADDRESS is shared by all the calls (it's re-created only when
+ * the server address changes or when the channel is shut down).
  *
+ * Concurrent get_importance() calls for the same context are coalesced: requests are appended
+ * to a pending batch which is sent in a single GRPC call when it reaches
+ * MAX_GET_IMPORTANCE_BUNDLE_SIZE handles or when its flush deadline expires (whatever happens
+ * first). Each caller gets back exactly the importance values of the handles it asked for.
+ *
+ * correlate() and stimulate() are never merged because the AttentionBroker treats each call as a
+ * separate set of handles (e.g. in stimulate() the passed counts are normalized by their sum).
  */
 class AttentionBrokerClient {
    public:
@@ -36,10 +54,48 @@ class AttentionBrokerClient {
     static void save_context(const string& context, const string& file_name);
     static void drop_and_load_context(const string& context, const string& file_name);
 
+    /**
+     * Sets the max time (in milliseconds) a get_importance() request waits for other requests
+     * in the same context before being sent to the AttentionBroker. 0 disables coalescing.
+     *
+     * @param millis Flush deadline in milliseconds.
+     */
+    static void set_get_importance_flush_deadline(unsigned int millis);
+
    private:
+    class ImportanceRequest {
+       public:
+        const vector<string>* handles;
+        vector<float>* importances;
+        bool done;
+        string error;
+    };
+
+    class ImportanceBatch {
+       public:
+        vector<ImportanceRequest*> requests;
+        unsigned int handle_count;
+        chrono::steady_clock::time_point deadline;
+        ImportanceBatch() : handle_count(0) {}
+    };
+
     static mutex api_mutex;
     static unsigned int MAX_GET_IMPORTANCE_BUNDLE_SIZE;
     static unsigned int MAX_SET_DETERMINERS_HANDLE_COUNT;
+    static unsigned int GET_IMPORTANCE_FLUSH_DEADLINE;
+    static shared_ptr<grpc::Channel> channel;
+    static string channel_address;
+    static map<string, shared_ptr<ImportanceBatch>> pending_importance_batches;
+    static mutex importance_batch_mutex;
+    static condition_variable importance_batch_condition;
+
+    static shared_ptr<grpc::Channel> get_channel();
+    static void fetch_importance(const vector<string>& handles,
+                                 const string& context,
+                                 vector<float>& importances);
+    static void flush_importance_batch(unique_lock<mutex>& lock,
+                                       shared_ptr<ImportanceBatch> batch,
+                                       const string& context);
     AttentionBrokerClient() {}
 };
 
@@ -140,7 +140,7 @@ static bool visit_find_handle(HandleTrie::TrieNode* trie_node, void* data) {
     VisitData* visit_data = (VisitData*) data;
     HebbianNetwork::Node* node = (HebbianNetwork::Node*) trie_node->value;
     if (node == visit_data->node) {
-        visit_data->handle = trie_node->suffix;
+        visit_data->handle = trie_node->suffix.to_string();
         return true;
     } else {
         return false;
@@ -150,7 +150,7 @@ static bool visit_find_handle(HandleTrie::TrieNode* trie_node, void* data) {
 static bool visit_serialize_node(HandleTrie::TrieNode* trie_node, void* data) {
     HebbianNetwork::Node* node = (HebbianNetwork::Node*) trie_node->value;
     VisitData* visit_data = (VisitData*) data;
-    visit_data->stream->write(trie_node->suffix.c_str(), HANDLE_HASH_SIZE - 1);
+    visit_data->stream->write(trie_node->suffix.to_string().c_str(), HANDLE_HASH_SIZE - 1);
     visit_data->stream->write(reinterpret_cast<const char*>(&node->count), sizeof(node->count));
     visit_data->stream->write(reinterpret_cast<const char*>(&node->importance),
                               sizeof(node->importance));
@@ -168,7 +168,7 @@ static bool visit_serialize_determiners(HandleTrie::TrieNode* trie_node, void* d
     HebbianNetwork::Node* node = (HebbianNetwork::Node*) trie_node->value;
     VisitData* visit_data = (VisitData*) data;
     for (auto determiner : node->determiners) {
-        visit_data->stream->write(trie_node->suffix.c_str(), HANDLE_HASH_SIZE - 1);
+        visit_data->stream->write(trie_node->suffix.to_string().c_str(), HANDLE_HASH_SIZE - 1);
         visit_data->handle = "";
         visit_data->node = determiner;
         trie_node->trie_node_mutex.unlock();
@@ -192,7 +192,7 @@ static bool visit_serialize_edge(HandleTrie::TrieNode* trie_node, void* data) {
         RAISE_ERROR("Invalid neighbor");
     }
     visit_data->stream->write(visit_data->handle.c_str(), HANDLE_HASH_SIZE - 1);
-    visit_data->stream->write(trie_node->suffix.c_str(), HANDLE_HASH_SIZE - 1);
+    visit_data->stream->write(trie_node->suffix.to_string().c_str(), HANDLE_HASH_SIZE - 1);
     visit_data->stream->write(reinterpret_cast<const char*>(&edge->count), sizeof(edge->count));
     return false;
 }
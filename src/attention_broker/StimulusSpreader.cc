@@ -39,10 +39,30 @@ TokenSpreader::~TokenSpreader() {}
 
 typedef TokenSpreader::StimuliData DATA;
 
+// Trie keys are used as Handles when possible so no string is built for each visited node
+static inline void insert_changes(HandleTrie* trie,
+                                  const CompactHandle& key,
+                                  TokenSpreader::ImportanceChanges* changes) {
+    if (key.is_handle()) {
+        trie->insert(key.get_handle(), changes);
+    } else {
+        trie->insert(key.to_string(), changes);
+    }
+}
+
+static inline TokenSpreader::ImportanceChanges* lookup_changes(HandleTrie* trie,
+                                                               const CompactHandle& key) {
+    if (key.is_handle()) {
+        return (TokenSpreader::ImportanceChanges*) trie->lookup(key.get_handle());
+    } else {
+        return (TokenSpreader::ImportanceChanges*) trie->lookup(key.to_string());
+    }
+}
+
 #if LOG_LEVEL >= LOCAL_DEBUG_LEVEL
 static bool print_importance(HandleTrie::TrieNode* node, void* data) {
     HebbianNetwork::Node* value = (HebbianNetwork::Node*) node->value;
-    LOG_INFO("Importance of " + node->suffix + " :" + std::to_string(value->importance));
+    LOG_INFO("Importance of " + node->suffix.to_string() + " :" + std::to_string(value->importance));
     return false;
 }
 #endif
@@ -51,8 +71,9 @@ static bool collect_rent(HandleTrie::TrieNode* node, void* data) {
     ImportanceType rent = ((DATA*) data)->rent_rate * ((HebbianNetwork::Node*) node->value)->importance;
     ((DATA*) data)->total_rent += rent;
     ImportanceType wages = 0.0;
-    ((DATA*) data)
-        ->importance_changes->insert(node->suffix, new TokenSpreader::ImportanceChanges(rent, wages));
+    insert_changes(((DATA*) data)->importance_changes,
+                   node->suffix,
+                   new TokenSpreader::ImportanceChanges(rent, wages));
     return false;
 }
 
@@ -63,7 +84,7 @@ static bool consolidate_rent_and_wages(HandleTrie::TrieNode* node, void* data) {
 #endif
 
     TokenSpreader::ImportanceChanges* changes =
-        (TokenSpreader::ImportanceChanges*) ((DATA*) data)->importance_changes->lookup(node->suffix);
+        lookup_changes(((DATA*) data)->importance_changes, node->suffix);
     value->importance -= changes->rent;
     value->importance += changes->wages;
 
@@ -78,7 +99,7 @@ static bool consolidate_rent_and_wages(HandleTrie::TrieNode* node, void* data) {
     value->stimuli_to_spread = to_spread;
     // clang-format off
     LOG_LOCAL_DEBUG(\
-        "Update " + node->suffix + ":" + \
+        "Update " + node->suffix.to_string() + ":" + \
         " " + std::to_string(original_importance) + \
         " - " + std::to_string(changes->rent) + " (rent)"  + \
         " + " + std::to_string(changes->wages) + " (wages)" + \
@@ -105,7 +126,7 @@ static bool deliver_stimulus(HandleTrie::TrieNode* node, void* data) {
     edge->node2->importance += stimulus;
     // clang-format off
     LOG_LOCAL_DEBUG(\
-        "Update " + node->suffix + ":" + \
+        "Update " + node->suffix.to_string() + ":" + \
         " " + std::to_string(original_importance) + \
         " + ((" + std::to_string(edge->count) + " / "  + std::to_string(edge->node1->count) + ")" + \
         " / " + std::to_string(((DATA*) data)->sum_weights) + ") * " + std::to_string(((DATA*) data)->to_spread) + \
@@ -121,7 +142,7 @@ static bool consolidate_stimulus(HandleTrie::TrieNode* node, void* data) {
     value->neighbors->traverse(true, &sum_weights, data);
     // clang-format off
     LOG_LOCAL_DEBUG(\
-        "Consolidating stimulus for " + node->suffix + ":" + \
+        "Consolidating stimulus for " + node->suffix.to_string() + ":" + \
         " To spread: " + std::to_string(((DATA*) data)->to_spread) + \
         " Summed weights: " + std::to_string(((DATA*) data)->sum_weights));
     // clang-format on
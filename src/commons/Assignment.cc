@@ -1,13 +1,106 @@
 #include "Assignment.h"
 
+#include <algorithm>
 #include <cstring>
+#include <mutex>
 
 #include "Hasher.h"
 #include "Utils.h"
 
 using namespace commons;
 
-string Assignment::EMPTY_VALUE = "";
+// -------------------------------------------------------------------------------------------------
+// VariableDictionary
+
+shared_mutex VariableDictionary::api_mutex;
+unordered_map<string, unsigned int> VariableDictionary::ids;
+
+// Per-thread copy of the (immutable) entries already read from the dictionary so the shared lock
+// is taken only the first time a thread sees each label.
+static thread_local unordered_map<string, VariableDictionary::Variable> variable_cache;
+
+bool VariableDictionary::find(const string& label, Variable& variable) {
+    auto cached = variable_cache.find(label);
+    if (cached != variable_cache.end()) {
+        variable = cached->second;
+        return true;
+    }
+    shared_lock<shared_mutex> semaphore(api_mutex);
+    auto iterator = ids.find(label);
+    if (iterator == ids.end()) {
+        return false;
+    }
+    variable = {iterator->second, &iterator->first};
+    variable_cache[label] = variable;
+    return true;
+}
+
+VariableDictionary::Variable VariableDictionary::get(const string& label) {
+    Variable variable;
+    if (!find(label, variable)) {
+        unique_lock<shared_mutex> semaphore(api_mutex);
+        auto iterator = ids.emplace(label, (unsigned int) ids.size()).first;
+        variable = {iterator->second, &iterator->first};
+        semaphore.unlock();
+        variable_cache[label] = variable;
+    }
+    return variable;
+}
+
+unsigned int VariableDictionary::size() {
+    shared_lock<shared_mutex> semaphore(api_mutex);
+    return ids.size();
+}
+
+// -------------------------------------------------------------------------------------------------
+// Assignment::Table
+
+int Assignment::Table::index_of(unsigned int id) const {
+    if ((this->id_mask & mask_bit(id)) != 0) {
+        for (unsigned int i = 0; i < this->entries.size(); i++) {
+            if (this->entries[i].id == id) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+Assignment::Table::const_iterator Assignment::Table::find(const string& label) const {
+    VariableDictionary::Variable variable;
+    if (VariableDictionary::find(label, variable)) {
+        int index = index_of(variable.id);
+        if (index >= 0) {
+            return const_iterator(this->entries.begin() + index);
+        }
+    }
+    return end();
+}
+
+bool Assignment::Table::operator==(const Table& other) const {
+    if ((this->hash_value != other.hash_value) || (this->id_mask != other.id_mask) ||
+        (this->entries.size() != other.entries.size())) {
+        return false;
+    }
+    // Both are sorted by label
+    for (unsigned int i = 0; i < this->entries.size(); i++) {
+        if ((this->entries[i].id != other.entries[i].id) ||
+            (this->entries[i].value != other.entries[i].value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Assignment
+
+CompactHandle Assignment::EMPTY_VALUE;
+
+static inline size_t entry_hash(unsigned int id, const CompactHandle& value) {
+    // Combined by addition so the hash doesn't depend on the order of the assignments
+    return value.hash() * (2 * ((size_t) id) + 1);
+}
 
 Assignment::Assignment(bool unique_assignment_flag) {
     this->unique_assignment_flag = unique_assignment_flag;
@@ -15,37 +108,62 @@ Assignment::Assignment(bool unique_assignment_flag) {
 
 Assignment::~Assignment() {}
 
+void Assignment::insert(const VariableDictionary::Variable& variable, const CompactHandle& value) {
+    if (this->table.entries.size() == MAX_NUMBER_OF_VARIABLES_IN_QUERY) {
+        RAISE_ERROR("Assignment size exceeds the maximal number of allowed variables in a query: " +
+                    std::to_string(MAX_NUMBER_OF_VARIABLES_IN_QUERY));
+    }
+    auto position = lower_bound(
+        this->table.entries.begin(),
+        this->table.entries.end(),
+        *variable.label,
+        [](const Entry& entry, const string& label) { return *entry.label < label; });
+    this->table.entries.insert(position, {variable.id, variable.label, value});
+    this->table.id_mask |= Table::mask_bit(variable.id);
+    this->table.hash_value += entry_hash(variable.id, value);
+}
+
 bool Assignment::assign(const string& label, const string& value) {
-    auto iterator = this->table.find(label);
-    if (iterator == this->table.end()) {
-        // label is not present, so makes the assignment and return true
+    return assign_value(label, CompactHandle(value));
+}
+
+bool Assignment::assign(const string& label, const Handle& value) {
+    return assign_value(label, CompactHandle(value));
+}
+
+bool Assignment::assign_value(const string& label, const CompactHandle& value) {
+    VariableDictionary::Variable variable;
+    if (VariableDictionary::find(label, variable)) {
+        int index = this->table.index_of(variable.id);
+        if (index >= 0) {
+            // if label is already present, return true iff its value is the same
+            return (this->table.entries[index].value == value);
+        }
+    } else {
         if (label.size() > MAX_VARIABLE_NAME_SIZE) {
             RAISE_ERROR("Invalid assignment. Label size (" + std::to_string(label.size()) +
                         ") is too large (> " + std::to_string(MAX_VARIABLE_NAME_SIZE) + ").");
         }
-        this->table[label] = value;
-        if (this->table.size() > MAX_NUMBER_OF_VARIABLES_IN_QUERY) {
-            RAISE_ERROR("Assignment size exceeds the maximal number of allowed variables in a query: " +
-                        std::to_string(MAX_NUMBER_OF_VARIABLES_IN_QUERY));
-        }
-        return true;
-    } else {
-        // if label is already present, return true iff its value is the same
-        return (iterator->second == value);
+        variable = VariableDictionary::get(label);
     }
+    // label is not present, so makes the assignment and return true
+    insert(variable, value);
+    return true;
 }
 
 bool Assignment::is_compatible(const Assignment& other) {
-    for (auto pair : this->table) {
-        auto iterator = other.table.find(pair.first);
-        if (iterator != other.table.end()) {
-            if (iterator->second != pair.second) {
-                return false;
-            }
+    if (!this->unique_assignment_flag && ((this->table.id_mask & other.table.id_mask) == 0)) {
+        // No common variables
+        return true;
+    }
+    for (const Entry& entry : this->table.entries) {
+        int index = other.table.index_of(entry.id);
+        if ((index >= 0) && (other.table.entries[index].value != entry.value)) {
+            return false;
         }
         if (this->unique_assignment_flag) {
-            for (auto other_pair : other.table) {
-                if ((pair.second == other_pair.second) && (pair.first != other_pair.first)) {
+            for (const Entry& other_entry : other.table.entries) {
+                if ((entry.value == other_entry.value) && (entry.id != other_entry.id)) {
                     return false;
                 }
             }
@@ -60,20 +178,22 @@ void Assignment::copy_from(const Assignment& other) {
 }
 
 void Assignment::add_assignments(const Assignment& other) {
-    for (auto pair : other.table) {
-        if (this->table.find(pair.first) == this->table.end()) {
-            this->table[pair.first] = pair.second;
+    for (const Entry& entry : other.table.entries) {
+        if (this->table.index_of(entry.id) < 0) {
+            insert({entry.id, entry.label}, entry.value);
         }
     }
 }
 
-const string& Assignment::get(const string& label) {
-    auto iterator = this->table.find(label);
-    if (iterator != this->table.end()) {
-        return iterator->second;
-    } else {
-        return EMPTY_VALUE;
+const CompactHandle& Assignment::get(const string& label) {
+    VariableDictionary::Variable variable;
+    if (VariableDictionary::find(label, variable)) {
+        int index = this->table.index_of(variable.id);
+        if (index >= 0) {
+            return this->table.entries[index].value;
+        }
     }
+    return EMPTY_VALUE;
 }
 
 unsigned int Assignment::variable_count() { return this->table.size(); }
@@ -82,7 +202,9 @@ string Assignment::to_string() {
     string answer = "{";
     bool empty_flag = true;
     for (auto pair : this->table) {
-        answer += "(" + pair.first + ": " + pair.second + ")";
+        answer += "(" + pair.first + ": ";
+        pair.second.append_to(answer);
+        answer += ")";
         answer += ", ";
         empty_flag = false;
     }
@@ -94,7 +216,11 @@ string Assignment::to_string() {
     return answer;
 }
 
-void Assignment::clear() { this->table.clear(); }
+void Assignment::clear() {
+    this->table.entries.clear();
+    this->table.id_mask = 0;
+    this->table.hash_value = 0;
+}
 
 bool Assignment::operator==(const Assignment& other) const {
     return (this->table == other.table) &&
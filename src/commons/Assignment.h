@@ -1,7 +1,12 @@
 #pragma once
 
-#include <map>
+#include <cstdint>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Handle.h"
 
 // If any of these constants are set to numbers greater than 999, we need
 // to fix QueryAnswer.tokenize() properly
@@ -12,6 +17,51 @@ using namespace std;
 
 namespace commons {
 
+/**
+ * Process-wide dictionary of variable labels.
+ *
+ * Each label is interned once and gets a small integer id so Assignments can compare and look up
+ * variables by id instead of by name. Interned labels are never released (they're drawn from the
+ * variables in the queries, which are a small vocabulary) so the returned label pointers are
+ * valid for the lifetime of the process. Ids are local to the process (they are never sent to
+ * remote peers).
+ */
+class VariableDictionary {
+   public:
+    struct Variable {
+        unsigned int id;
+        const string* label;
+    };
+
+    /**
+     * Returns the id and the interned copy of the passed label, interning it if required.
+     *
+     * @param label Variable label.
+     * @return The id and the interned copy of the passed label.
+     */
+    static Variable get(const string& label);
+
+    /**
+     * Looks up the passed label without interning it.
+     *
+     * @param label Variable label.
+     * @param variable Id and interned copy of the label (only set if the method returns true).
+     * @return true iff the passed label has been interned.
+     */
+    static bool find(const string& label, Variable& variable);
+
+    /**
+     * Returns the number of interned labels.
+     *
+     * @return The number of interned labels.
+     */
+    static unsigned int size();
+
+   private:
+    static shared_mutex api_mutex;
+    static unordered_map<string, unsigned int> ids;  // Keys are never moved by rehashing
+};
+
 /**
  * This class is the representation of a set of variable assignments. It's a set because each
  * variable can be assigned to exactly one value and the order of assignments is irrelevant.
@@ -20,9 +70,70 @@ namespace commons {
  *     "label2" -> "value2"
  *     ...
  *     "labelN" -> "valueN"
+ *
+ * Assignments are backed by a small flat array of (variable id, value) pairs (see
+ * VariableDictionary) sorted by label, a bitmask of the variable ids in the array (so most failed
+ * lookups and the compatibility check of assignments with no common variables take constant time)
+ * and a hash value which is updated incrementally as variables are assigned.
  */
 class Assignment {
    public:
+    struct Entry {
+        unsigned int id;
+        const string* label;
+        CompactHandle value;  // Handles are kept in 16 bytes so copying entries doesn't allocate
+    };
+
+    /**
+     * Read-only view of the assignments, iterated in label order as (label, value) pairs through
+     * the "first" and "second" fields, like a map<string, string>.
+     */
+    class Table {
+       public:
+        struct Binding {
+            const string& first;          // label
+            const CompactHandle& second;  // value
+        };
+
+        class const_iterator {
+           public:
+            const_iterator(vector<Entry>::const_iterator cursor) : cursor(cursor) {}
+            Binding operator*() const { return {*this->cursor->label, this->cursor->value}; }
+            const_iterator& operator++() {
+                ++this->cursor;
+                return *this;
+            }
+            bool operator==(const const_iterator& other) const { return this->cursor == other.cursor; }
+            bool operator!=(const const_iterator& other) const { return this->cursor != other.cursor; }
+
+           private:
+            vector<Entry>::const_iterator cursor;
+        };
+
+        const_iterator begin() const { return const_iterator(this->entries.begin()); }
+        const_iterator end() const { return const_iterator(this->entries.end()); }
+        unsigned int size() const { return this->entries.size(); }
+        bool empty() const { return this->entries.empty(); }
+
+        /**
+         * Returns an iterator pointing to the passed label or end() if it's not assigned.
+         */
+        const_iterator find(const string& label) const;
+
+        bool operator==(const Table& other) const;
+
+       private:
+        friend class Assignment;
+
+        // Index in entries of the variable with the passed id or -1 if it's not assigned
+        int index_of(unsigned int id) const;
+        static inline uint64_t mask_bit(unsigned int id) { return ((uint64_t) 1) << (id % 64); }
+
+        vector<Entry> entries;
+        uint64_t id_mask = 0;
+        size_t hash_value = 0;
+    };
+
     /**
      * Basic constructor.
      *
@@ -50,13 +161,18 @@ class Assignment {
      */
     bool assign(const string& label, const string& value);
 
+    /**
+     * Same as assign(const string&, const string&) but taking a fixed-width Handle as value.
+     */
+    bool assign(const string& label, const Handle& value);
+
     /**
      * Returns the value assigned to a given label or "" if no value is assigned to it.
      *
      * @param label Label to be search for.
      * @return The value assigned to a given label or "" if no value is assigned to it.
      */
-    const string& get(const string& label);
+    const CompactHandle& get(const string& label);
 
     /**
      * Returns true if the passed Assignment is compatible with this one or false otherwise.
@@ -129,10 +245,19 @@ class Assignment {
      */
     void clear();
 
-    map<string, string> table;
+    /**
+     * Returns a hash value of the assignments (labels and values). It's kept up to date as
+     * variables are assigned so this method takes constant time.
+     */
+    size_t hash() const { return this->table.hash_value; }
+
+    Table table;
 
    private:
-    static string EMPTY_VALUE;
+    bool assign_value(const string& label, const CompactHandle& value);
+    void insert(const VariableDictionary::Variable& variable, const CompactHandle& value);
+
+    static CompactHandle EMPTY_VALUE;
     bool unique_assignment_flag;
 };
 
@@ -140,18 +265,5 @@ class Assignment {
 
 template <>
 struct std::hash<commons::Assignment> {
-    std::size_t operator()(const commons::Assignment& k) const {
-        if (k.table.size() == 0) {
-            return 0;
-        }
-
-        std::size_t hash_value = 1;
-        for (auto pair : k.table) {
-            hash_value =
-                hash_value ^
-                ((std::hash<string>()(pair.first) ^ (std::hash<string>()(pair.second) << 1)) >> 1);
-        }
-
-        return hash_value;
-    }
+    std::size_t operator()(const commons::Assignment& k) const { return k.hash(); }
 };
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
+#include "Utils.h"
+
+namespace commons {
+
+/**
+ * Thread-safe FIFO queue with a fixed capacity, used to connect producer and consumer threads
+ * with backpressure: push() blocks while the queue is full and pop() blocks while it's empty.
+ *
+ * Once close() is called, push() fails and pop() keeps returning the remaining elements until the
+ * queue is drained, failing afterwards. This is the way producers signal the end of the stream.
+ */
+template <typename T>
+class BoundedQueue {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param capacity Max number of elements in the queue.
+     */
+    BoundedQueue(unsigned int capacity) {
+        if (capacity == 0) {
+            RAISE_ERROR("Invalid BoundedQueue capacity: 0");
+        }
+        this->capacity = capacity;
+        this->closed = false;
+    }
+
+    ~BoundedQueue() {}
+
+    /**
+     * Inserts an element in the queue, blocking the caller while the queue is full.
+     *
+     * @param element Element being inserted.
+     * @return false iff the queue was closed (and the element was discarded).
+     */
+    bool push(T element) {
+        unique_lock<mutex> lock(this->api_mutex);
+        this->not_full.wait(lock,
+                            [this] { return this->closed || (this->elements.size() < this->capacity); });
+        if (this->closed) {
+            return false;
+        }
+        this->elements.push(std::move(element));
+        lock.unlock();
+        this->not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * Removes the first element of the queue, blocking the caller while the queue is empty.
+     *
+     * @param element Removed element (only assigned if the method returns true).
+     * @return false iff the queue is closed and there are no remaining elements.
+     */
+    bool pop(T& element) {
+        unique_lock<mutex> lock(this->api_mutex);
+        this->not_empty.wait(lock, [this] { return this->closed || !this->elements.empty(); });
+        if (this->elements.empty()) {
+            return false;
+        }
+        element = std::move(this->elements.front());
+        this->elements.pop();
+        lock.unlock();
+        this->not_full.notify_one();
+        return true;
+    }
+
+    /**
+     * Closes the queue, waking up all blocked threads.
+     */
+    void close() {
+        {
+            lock_guard<mutex> semaphore(this->api_mutex);
+            this->closed = true;
+        }
+        this->not_full.notify_all();
+        this->not_empty.notify_all();
+    }
+
+    /**
+     * Returns the number of elements currently in the queue.
+     *
+     * @return the number of elements currently in the queue.
+     */
+    unsigned int size() {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        return this->elements.size();
+    }
+
+    bool is_closed() {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        return this->closed;
+    }
+
+   private:
+    mutex api_mutex;
+    condition_variable not_full;
+    condition_variable not_empty;
+    queue<T> elements;
+    unsigned int capacity;
+    bool closed;
+};
+
+}  // namespace commons
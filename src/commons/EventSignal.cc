@@ -0,0 +1,41 @@
+#include "EventSignal.h"
+
+#include <chrono>
+
+using namespace commons;
+
+// -------------------------------------------------------------------------------------------------
+// Constructors and destructors
+
+EventSignal::EventSignal() { this->pending_flag = false; }
+
+EventSignal::~EventSignal() {}
+
+// -------------------------------------------------------------------------------------------------
+// Public methods
+
+void EventSignal::notify() {
+    function<void()> listener;
+    {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        this->pending_flag = true;
+        listener = this->listener;
+    }
+    this->condition.notify_all();
+    if (listener) {
+        listener();
+    }
+}
+
+bool EventSignal::wait(unsigned int timeout_millis) {
+    unique_lock<mutex> semaphore(this->api_mutex);
+    bool answer = this->condition.wait_for(
+        semaphore, chrono::milliseconds(timeout_millis), [this] { return this->pending_flag; });
+    this->pending_flag = false;
+    return answer;
+}
+
+void EventSignal::set_listener(function<void()> listener) {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    this->listener = listener;
+}
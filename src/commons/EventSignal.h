@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+using namespace std;
+
+namespace commons {
+
+/**
+ * Auto-reset event used by threads that would otherwise poll some state using Utils::sleep().
+ *
+ * Producers call notify() whenever something a consumer may be waiting for has happened (e.g. a
+ * new element has been inserted in a queue or a flag has been set). Consumers call wait(), which
+ * returns as soon as notify() is called or when the passed timeout expires.
+ *
+ * Notifications are sticky: if notify() is called while no thread is waiting, the next call to
+ * wait() returns immediately (and resets the event). So a notification issued between the moment
+ * the consumer checks its state and the moment it calls wait() is never lost. The timeout is just
+ * a safety net for state changes which are not notified.
+ *
+ * An EventSignal is supposed to have a single consumer but any number of producers. Consumers
+ * which are tasks in a processor::WorkStealingExecutor (rather than threads blocked in wait())
+ * use set_listener() to be woken up.
+ */
+class EventSignal {
+   public:
+    EventSignal();
+    ~EventSignal();
+
+    /**
+     * Wakes up the consumer (or makes the next call to wait() return immediately).
+     */
+    void notify();
+
+    /**
+     * Blocks the caller until notify() is called or the timeout expires.
+     *
+     * @param timeout_millis Max time (in milliseconds) to wait for a notification.
+     * @return true iff the method returned because of a notification.
+     */
+    bool wait(unsigned int timeout_millis = 100);
+
+    /**
+     * Sets a function which is called (in the producer's thread) by every notify() after the
+     * event is set.
+     *
+     * @param listener The function to be called or nullptr to remove the current listener.
+     */
+    void set_listener(function<void()> listener);
+
+   private:
+    mutex api_mutex;
+    condition_variable condition;
+    bool pending_flag;
+    function<void()> listener;
+};
+
+}  // namespace commons
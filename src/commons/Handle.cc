@@ -0,0 +1,245 @@
+#include "Handle.h"
+
+#include "Logger.h"
+
+using namespace commons;
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+static inline int hex_value(char c) {
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    } else if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    } else if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    } else {
+        return -1;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Constructors and destructors
+
+Handle::Handle() { memset(this->bytes, 0, SIZE); }
+
+Handle::Handle(const string& hex) { from_hex(hex.c_str(), hex.size()); }
+
+Handle::Handle(const char* hex) { from_hex(hex, strlen(hex)); }
+
+Handle Handle::from_bytes(const unsigned char* bytes) {
+    Handle handle;
+    memcpy(handle.bytes, bytes, SIZE);
+    return handle;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Public methods
+
+bool Handle::is_canonical(const string& hex) {
+    if (hex.size() != HEX_SIZE) {
+        return false;
+    }
+    for (char c : hex) {
+        if (!(((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f')))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Handle::is_valid(const string& hex) {
+    if (hex.size() != HEX_SIZE) {
+        return false;
+    }
+    for (char c : hex) {
+        if (hex_value(c) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Handle::to_hex(char* output) const {
+    for (unsigned int i = 0; i < SIZE; i++) {
+        output[2 * i] = HEX_DIGITS[this->bytes[i] >> 4];
+        output[2 * i + 1] = HEX_DIGITS[this->bytes[i] & 0x0F];
+    }
+    output[HEX_SIZE] = '\0';
+}
+
+string Handle::to_string() const {
+    char buffer[HEX_SIZE + 1];
+    to_hex(buffer);
+    return string(buffer, HEX_SIZE);
+}
+
+bool Handle::is_null() const {
+    for (unsigned int i = 0; i < SIZE; i++) {
+        if (this->bytes[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Private methods
+
+void Handle::from_hex(const char* hex, size_t size) {
+    if (size != HEX_SIZE) {
+        RAISE_ERROR("Invalid handle: <" + string(hex, size) + ">");
+    }
+    for (unsigned int i = 0; i < SIZE; i++) {
+        int high = hex_value(hex[2 * i]);
+        int low = hex_value(hex[2 * i + 1]);
+        if ((high < 0) || (low < 0)) {
+            RAISE_ERROR("Invalid handle: <" + string(hex, size) + ">");
+        }
+        this->bytes[i] = (unsigned char) ((high << 4) | low);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// CompactHandle
+
+static inline bool is_canonical_hex(const char* value, size_t size) {
+    if (size != Handle::HEX_SIZE) {
+        return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+        char c = value[i];
+        if (!(((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f')))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CompactHandle::CompactHandle() : handle_flag(false) {}
+
+CompactHandle::CompactHandle(const string& value) { set(value.c_str(), value.size()); }
+
+CompactHandle::CompactHandle(const char* value) { set(value, strlen(value)); }
+
+CompactHandle::CompactHandle(const char* value, size_t size) { set(value, size); }
+
+CompactHandle::CompactHandle(const Handle& handle) : handle(handle), handle_flag(true) {}
+
+CompactHandle::CompactHandle(const CompactHandle& other)
+    : handle(other.handle), handle_flag(other.handle_flag) {
+    if (other.other != nullptr) {
+        this->other = make_unique<string>(*other.other);
+    }
+}
+
+CompactHandle::~CompactHandle() {}
+
+CompactHandle& CompactHandle::operator=(const CompactHandle& other) {
+    if (this != &other) {
+        this->handle = other.handle;
+        this->handle_flag = other.handle_flag;
+        if (other.other == nullptr) {
+            this->other.reset();
+        } else if (this->other == nullptr) {
+            this->other = make_unique<string>(*other.other);
+        } else {
+            *this->other = *other.other;
+        }
+    }
+    return *this;
+}
+
+void CompactHandle::set(const char* value, size_t size) {
+    if (is_canonical_hex(value, size)) {
+        this->handle = Handle(value);
+        this->handle_flag = true;
+    } else {
+        this->handle_flag = false;
+        if (size > 0) {
+            this->other = make_unique<string>(value, size);
+        }
+    }
+}
+
+string CompactHandle::to_string() const {
+    if (this->handle_flag) {
+        return this->handle.to_string();
+    } else {
+        return (this->other == nullptr) ? string() : *this->other;
+    }
+}
+
+void CompactHandle::append_to(string& output) const {
+    if (this->handle_flag) {
+        char buffer[Handle::HEX_SIZE + 1];
+        this->handle.to_hex(buffer);
+        output.append(buffer, Handle::HEX_SIZE);
+    } else if (this->other != nullptr) {
+        output.append(*this->other);
+    }
+}
+
+size_t CompactHandle::size() const {
+    if (this->handle_flag) {
+        return Handle::HEX_SIZE;
+    } else {
+        return (this->other == nullptr) ? 0 : this->other->size();
+    }
+}
+
+size_t CompactHandle::hash() const {
+    if (this->handle_flag) {
+        return std::hash<Handle>()(this->handle);
+    } else {
+        return std::hash<string>()((this->other == nullptr) ? string() : *this->other);
+    }
+}
+
+bool CompactHandle::operator==(const CompactHandle& other) const {
+    // A given string is always stored the same way so values stored differently are different
+    if (this->handle_flag != other.handle_flag) {
+        return false;
+    } else if (this->handle_flag) {
+        return this->handle == other.handle;
+    } else if ((this->other == nullptr) || (other.other == nullptr)) {
+        // Empty values are the only ones without a fallback string
+        return (this->other == nullptr) && (other.other == nullptr);
+    } else {
+        return *this->other == *other.other;
+    }
+}
+
+bool CompactHandle::operator==(const string& other) const {
+    if (this->handle_flag) {
+        char buffer[Handle::HEX_SIZE + 1];
+        this->handle.to_hex(buffer);
+        return other.compare(0, string::npos, buffer, Handle::HEX_SIZE) == 0;
+    } else {
+        return (this->other == nullptr) ? other.empty() : (*this->other == other);
+    }
+}
+
+bool CompactHandle::operator==(const char* other) const {
+    if (this->handle_flag) {
+        char buffer[Handle::HEX_SIZE + 1];
+        this->handle.to_hex(buffer);
+        return strcmp(buffer, other) == 0;
+    } else {
+        return (this->other == nullptr) ? (other[0] == '\0') : (*this->other == other);
+    }
+}
+
+bool CompactHandle::operator<(const CompactHandle& other) const {
+    if (this->handle_flag && other.handle_flag) {
+        return this->handle < other.handle;
+    } else {
+        return to_string() < other.to_string();
+    }
+}
+
+namespace commons {
+ostream& operator<<(ostream& stream, const CompactHandle& compact) {
+    return stream << compact.to_string();
+}
+}  // namespace commons
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+namespace commons {
+
+/**
+ * Fixed-width binary representation of an atom handle.
+ *
+ * Handles are 128-bit MD5 hashes which are represented everywhere else in DAS as 32-char hex
+ * strings. A Handle object stores the same value in 16 raw bytes so it can be copied, compared
+ * and hashed without any heap allocation. Conversion to/from the hex representation is supposed
+ * to happen only at the boundaries (e.g. AtomDB, wire protocol, logs).
+ */
+class Handle {
+   public:
+    static const unsigned int SIZE = 16;      // Number of raw bytes in a handle
+    static const unsigned int HEX_SIZE = 32;  // Number of chars in the hex representation
+
+    /**
+     * Empty constructor. Builds a null handle (all bytes set to 0).
+     */
+    Handle();
+
+    /**
+     * Builds a Handle from its hex representation. Both lower and upper case hex digits are
+     * accepted. An exception is thrown if the passed string is not a valid handle.
+     *
+     * @param hex A 32-char hex string.
+     */
+    explicit Handle(const string& hex);
+
+    /**
+     * Builds a Handle from its hex representation. Both lower and upper case hex digits are
+     * accepted. An exception is thrown if the passed string is not a valid handle.
+     *
+     * @param hex A NULL-terminated 32-char hex string.
+     */
+    explicit Handle(const char* hex);
+
+    /**
+     * Builds a Handle from its raw bytes.
+     *
+     * @param bytes A buffer with (at least) Handle::SIZE bytes.
+     * @return A Handle with the passed raw bytes.
+     */
+    static Handle from_bytes(const unsigned char* bytes);
+
+    /**
+     * Returns true iff the passed string is a valid hex representation of a handle.
+     *
+     * @param hex String being checked.
+     * @return true iff the passed string is a valid hex representation of a handle.
+     */
+    static bool is_valid(const string& hex);
+
+    /**
+     * Returns true iff the passed string is exactly what to_string() returns for some Handle (i.e.
+     * a valid hex representation of a handle using only lower case hex digits).
+     *
+     * @param hex String being checked.
+     * @return true iff the passed string is a lower case hex representation of a handle.
+     */
+    static bool is_canonical(const string& hex);
+
+    /**
+     * Writes the (lower case) hex representation of this Handle in the passed buffer.
+     *
+     * No allocation is made. The buffer is supposed to have room for Handle::HEX_SIZE + 1 chars
+     * (a NULL char is written after the hex digits).
+     *
+     * @param output Buffer where the hex representation is written.
+     */
+    void to_hex(char* output) const;
+
+    /**
+     * Returns the (lower case) hex representation of this Handle.
+     *
+     * @return The (lower case) hex representation of this Handle.
+     */
+    string to_string() const;
+
+    /**
+     * Returns a pointer to the Handle::SIZE raw bytes of this Handle.
+     *
+     * @return A pointer to the Handle::SIZE raw bytes of this Handle.
+     */
+    inline const unsigned char* data() const { return this->bytes; }
+
+    /**
+     * Returns true iff this is a null handle (all bytes set to 0).
+     *
+     * @return true iff this is a null handle (all bytes set to 0).
+     */
+    bool is_null() const;
+
+    inline bool operator==(const Handle& other) const {
+        return memcmp(this->bytes, other.bytes, SIZE) == 0;
+    }
+    inline bool operator!=(const Handle& other) const {
+        return memcmp(this->bytes, other.bytes, SIZE) != 0;
+    }
+    inline bool operator<(const Handle& other) const {
+        // Same ordering as the one of the hex representation
+        return memcmp(this->bytes, other.bytes, SIZE) < 0;
+    }
+
+   private:
+    alignas(8) unsigned char bytes[SIZE];
+
+    void from_hex(const char* hex, size_t size);
+};
+
+/**
+ * A value which is (almost always) a handle.
+ *
+ * Values which are lower case hex handles (see Handle::is_canonical()) are stored as a Handle, so
+ * they are copied, compared and hashed without touching the heap. Any other string (e.g. the
+ * fake handles used in tests or the values assigned by non-handle sources) is kept as is in a
+ * fallback string. Either way, to_string() returns exactly the string the object was built from.
+ *
+ * Conversions from/to std::string are implicit so CompactHandle can replace std::string in
+ * containers of handles without changing the code which reads them as strings.
+ */
+class CompactHandle {
+   public:
+    /**
+     * Empty constructor. Builds an empty value (to_string() returns "").
+     */
+    CompactHandle();
+
+    CompactHandle(const string& value);
+    CompactHandle(const char* value);
+    CompactHandle(const char* value, size_t size);
+    CompactHandle(const Handle& handle);
+    CompactHandle(const CompactHandle& other);
+    CompactHandle(CompactHandle&& other) = default;
+    ~CompactHandle();
+
+    CompactHandle& operator=(const CompactHandle& other);
+    CompactHandle& operator=(CompactHandle&& other) = default;
+
+    /**
+     * Returns true iff this value is stored as a Handle.
+     */
+    inline bool is_handle() const { return this->handle_flag; }
+
+    /**
+     * Returns the Handle this value is stored as (only meaningful if is_handle() is true).
+     */
+    inline const Handle& get_handle() const { return this->handle; }
+
+    /**
+     * Returns the string this value was built from.
+     */
+    string to_string() const;
+
+    /**
+     * Appends the string this value was built from to the passed one (no temporary string is
+     * allocated).
+     */
+    void append_to(string& output) const;
+
+    /**
+     * Returns the number of chars in the string this value was built from.
+     */
+    size_t size() const;
+
+    /**
+     * Returns the char at the passed position of the string this value was built from (no bound
+     * checking is made).
+     */
+    inline char operator[](size_t index) const {
+        if (this->handle_flag) {
+            unsigned char byte = this->handle.data()[index >> 1];
+            return HEX_DIGITS[(index & 1) ? (byte & 0x0F) : (byte >> 4)];
+        } else {
+            return (*this->other)[index];
+        }
+    }
+
+    inline operator string() const { return to_string(); }
+
+    size_t hash() const;
+
+    bool operator==(const CompactHandle& other) const;
+    bool operator==(const string& other) const;
+    bool operator==(const char* other) const;
+    bool operator<(const CompactHandle& other) const;
+    inline bool operator!=(const CompactHandle& other) const { return !(*this == other); }
+    inline bool operator!=(const string& other) const { return !(*this == other); }
+    inline bool operator!=(const char* other) const { return !(*this == other); }
+
+   private:
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    Handle handle;
+    unique_ptr<string> other;  // Non-handle values (NULL for "")
+    bool handle_flag;
+
+    void set(const char* value, size_t size);
+};
+
+inline bool operator==(const string& value, const CompactHandle& compact) { return compact == value; }
+inline bool operator!=(const string& value, const CompactHandle& compact) { return compact != value; }
+inline bool operator==(const char* value, const CompactHandle& compact) { return compact == value; }
+inline bool operator!=(const char* value, const CompactHandle& compact) { return compact != value; }
+ostream& operator<<(ostream& stream, const CompactHandle& compact);
+
+}  // namespace commons
+
+namespace std {
+template <>
+struct hash<commons::Handle> {
+    size_t operator()(const commons::Handle& handle) const noexcept {
+        // Handles are MD5 hashes so any slice of their bits is already evenly distributed
+        uint64_t high, low;
+        memcpy(&high, handle.data(), sizeof(uint64_t));
+        memcpy(&low, handle.data() + sizeof(uint64_t), sizeof(uint64_t));
+        return (size_t) (high ^ low);
+    }
+};
+template <>
+struct hash<commons::CompactHandle> {
+    size_t operator()(const commons::CompactHandle& compact) const noexcept { return compact.hash(); }
+};
+}  // namespace std
@@ -12,19 +12,15 @@ HandleTrie::TrieValue::TrieValue() {}
 HandleTrie::TrieValue::~TrieValue() {}
 
 HandleTrie::TrieNode::TrieNode() {
-    children = new TrieNode*[TRIE_ALPHABET_SIZE];
     for (unsigned int i = 0; i < TRIE_ALPHABET_SIZE; i++) {
-        children[i] = NULL;
+        children[i].store(NULL, memory_order_relaxed);
     }
     this->value = NULL;
-    this->suffix_start = 0;
+    this->suffix_start.store(0, memory_order_relaxed);
 }
 
 HandleTrie::TrieNode::~TrieNode() {
-    for (unsigned int i = 0; i < TRIE_ALPHABET_SIZE; i++) {
-        delete children[i];
-    }
-    delete[] children;
+    // Children are released by the NodePool
     // TODO: Remove this check once improve insert()
     if (value != NULL) {
         delete value;
@@ -32,6 +28,30 @@ HandleTrie::TrieNode::~TrieNode() {
     }
 }
 
+HandleTrie::NodePool::NodePool() { this->block_size = FIRST_BLOCK_SIZE; }
+
+HandleTrie::NodePool::~NodePool() {
+    for (auto& block : this->blocks) {
+        for (unsigned int i = 0; i < block.second; i++) {
+            block.first[i].~TrieNode();
+        }
+        ::operator delete(block.first);
+    }
+}
+
+HandleTrie::TrieNode* HandleTrie::NodePool::allocate() {
+    lock_guard<mutex> semaphore(this->pool_mutex);
+    if (this->blocks.empty() || (this->blocks.back().second == this->block_size)) {
+        if (!this->blocks.empty() && (this->block_size < MAX_BLOCK_SIZE)) {
+            this->block_size *= 2;
+        }
+        TrieNode* block = (TrieNode*) ::operator new(this->block_size * sizeof(TrieNode));
+        this->blocks.push_back({block, 0});
+    }
+    auto& block = this->blocks.back();
+    return new (&block.first[block.second++]) TrieNode();
+}
+
 string HandleTrie::TrieValue::to_string() { return ""; }
 
 bool HandleTrie::TLB_INITIALIZED = false;
@@ -45,8 +65,9 @@ string HandleTrie::TrieNode::to_string() {
     if (suffix_start == 0) {
         answer = "''";
     } else {
-        int n = suffix.size() - suffix_start;
-        answer = suffix.substr(0, suffix_start) + "." + suffix.substr(suffix_start, n);
+        string key = suffix.to_string();
+        int n = key.size() - suffix_start;
+        answer = key.substr(0, suffix_start) + "." + key.substr(suffix_start, n);
     }
     answer += " [";
     for (unsigned int i = 0; i < TRIE_ALPHABET_SIZE; i++) {
@@ -69,17 +90,115 @@ HandleTrie::HandleTrie(unsigned int key_size) {
     if (!HandleTrie::TLB_INITIALIZED) {
         HandleTrie::TLB_INIT();
     }
-    this->root = new TrieNode();
+    this->root = this->node_pool.allocate();
     this->_size = 0;
 }
 
-HandleTrie::~HandleTrie() { delete root; }
+HandleTrie::~HandleTrie() {}
 
 HandleTrie::TrieValue* HandleTrie::insert(const string& key, TrieValue* value) {
-    if (key.size() != key_size) {
-        RAISE_ERROR("Invalid key size: " + to_string(key.size()) + " != " + to_string(key_size));
+    check_key_size(key.size());
+    return insert_key(key.c_str(), value);
+}
+
+HandleTrie::TrieValue* HandleTrie::insert(const Handle& key, TrieValue* value) {
+    char hex[Handle::HEX_SIZE + 1];
+    handle_key(key, hex);
+    return insert_key(hex, value);
+}
+
+bool HandleTrie::remove(const string& key, bool delete_value) {
+    check_key_size(key.size());
+    return remove_key(key.c_str(), delete_value);
+}
+
+bool HandleTrie::remove(const Handle& key, bool delete_value) {
+    char hex[Handle::HEX_SIZE + 1];
+    handle_key(key, hex);
+    return remove_key(hex, delete_value);
+}
+
+bool HandleTrie::update(const string& key,
+                        bool (*visit_function)(TrieValue* value, void* data),
+                        void* data) {
+    check_key_size(key.size());
+    return update_key(key.c_str(), visit_function, data);
+}
+
+bool HandleTrie::update(const Handle& key,
+                        bool (*visit_function)(TrieValue* value, void* data),
+                        void* data) {
+    char hex[Handle::HEX_SIZE + 1];
+    handle_key(key, hex);
+    return update_key(hex, visit_function, data);
+}
+
+bool HandleTrie::exists(const string& key) {
+    check_key_size(key.size());
+    return (find_leaf(key.c_str()) != NULL);
+}
+
+bool HandleTrie::exists(const Handle& key) {
+    char hex[Handle::HEX_SIZE + 1];
+    handle_key(key, hex);
+    return (find_leaf(hex) != NULL);
+}
+
+void HandleTrie::traverse(bool keep_root_locked,
+                          bool (*visit_function)(TrieNode* node, void* data),
+                          void* data) {
+    stack<TrieNode*> node_stack;
+    TrieNode* cursor;
+    node_stack.push(root);
+
+    while (!node_stack.empty()) {
+        cursor = node_stack.top();
+        node_stack.pop();
+        cursor->trie_node_mutex.lock();
+        if (cursor->suffix_start > 0) {
+            if (visit_function(cursor, data)) {
+                if (keep_root_locked && (root != cursor)) {
+                    root->trie_node_mutex.unlock();
+                }
+                cursor->trie_node_mutex.unlock();
+                return;
+            }
+        } else {
+            for (unsigned int i = TRIE_ALPHABET_SIZE - 1;; i--) {
+                if (cursor->children[i] != NULL) {
+                    node_stack.push(cursor->children[i]);
+                }
+                if (i == 0) {
+                    break;
+                }
+            }
+        }
+        if ((!keep_root_locked) || (cursor != root)) {
+            cursor->trie_node_mutex.unlock();
+        }
+    }
+    if (keep_root_locked) {
+        root->trie_node_mutex.unlock();
+    }
+}
+
+// --------------------------------------------------------------------------------
+// Private methods
+
+void* HandleTrie::fetch_stored_object(const char* key, bool clone) {
+    TrieNode* node = find_and_lock_leaf(key);
+    if (node == NULL) {
+        return NULL;
     }
+    void* answer = NULL;
+    if (node->value != NULL) {
+        answer = node->value->get_stored_object(clone);
+    }
+    node->trie_node_mutex.unlock();
+    return answer;
+}
 
+HandleTrie::TrieValue* HandleTrie::insert_key(const char* key, TrieValue* value) {
     if (value == NULL) {
         RAISE_ERROR("Value cannot be NULL");
     }
@@ -97,26 +216,26 @@ HandleTrie::TrieValue* HandleTrie::insert(const string& key, TrieValue* value) {
             if (tree_cursor->suffix_start > 0) {
                 unsigned char c_key_pred = TLB[(unsigned char) key[key_cursor - 1]];
                 if (key[key_cursor] == tree_cursor->suffix[key_cursor]) {
-                    child = new TrieNode();
+                    child = this->node_pool.allocate();
                     child->trie_node_mutex.lock();
-                    child->children[c] = tree_cursor;
+                    child->children[c].store(tree_cursor, memory_order_relaxed);
                     tree_cursor->suffix_start++;
-                    parent->children[c_key_pred] = child;
+                    parent->children[c_key_pred].store(child, memory_order_release);
                     parent->trie_node_mutex.unlock();
                     parent = child;
                     key_cursor++;
                 } else {
-                    child = new TrieNode();
-                    child->suffix = key;
+                    child = this->node_pool.allocate();
+                    child->suffix = CompactHandle(key, key_size);
                     child->suffix_start = key_cursor + 1;
                     child->value = value;
                     unsigned char c_tree_cursor =
                         TLB[(unsigned char) tree_cursor->suffix[tree_cursor->suffix_start]];
                     tree_cursor->suffix_start++;
-                    split = new TrieNode();
-                    split->children[c] = child;
-                    split->children[c_tree_cursor] = tree_cursor;
-                    parent->children[c_key_pred] = split;
+                    split = this->node_pool.allocate();
+                    split->children[c].store(child, memory_order_relaxed);
+                    split->children[c_tree_cursor].store(tree_cursor, memory_order_relaxed);
+                    parent->children[c_key_pred].store(split, memory_order_release);
                     parent->trie_node_mutex.unlock();
                     if (tree_cursor != parent) {
                         tree_cursor->trie_node_mutex.unlock();
@@ -124,11 +243,11 @@ HandleTrie::TrieValue* HandleTrie::insert(const string& key, TrieValue* value) {
                     return child->value;
                 }
             } else {
-                child = new TrieNode();
-                child->suffix = key;
+                child = this->node_pool.allocate();
+                child->suffix = CompactHandle(key, key_size);
                 child->suffix_start = key_cursor + 1;
                 child->value = value;
-                tree_cursor->children[c] = child;
+                tree_cursor->children[c].store(child, memory_order_release);
                 parent->trie_node_mutex.unlock();
                 if (tree_cursor != parent) {
                     tree_cursor->trie_node_mutex.unlock();
@@ -144,7 +263,7 @@ HandleTrie::TrieValue* HandleTrie::insert(const string& key, TrieValue* value) {
             tree_cursor->trie_node_mutex.lock();
             if (tree_cursor->suffix_start > 0) {
                 bool match = true;
-                unsigned int n = key.size();
+                unsigned int n = key_size;
                 for (unsigned int i = key_cursor; i < n; i++) {
                     if (key[i] != tree_cursor->suffix[i]) {
                         match = false;
@@ -163,7 +282,7 @@ HandleTrie::TrieValue* HandleTrie::insert(const string& key, TrieValue* value) {
                         return tree_cursor->value;
                     } else {
                         // Value was removed, set it to the new value
-                        tree_cursor->value = value;
+                        tree_cursor->store_value(value);
                         if (tree_cursor != parent) {
                             parent->trie_node_mutex.unlock();
                         }
@@ -177,8 +296,8 @@ HandleTrie::TrieValue* HandleTrie::insert(const string& key, TrieValue* value) {
     }
 }
 
-bool HandleTrie::remove(const string& key, bool delete_value) {
-    TrieNode* node = fetch<TrieNode>(key, false, false);
+bool HandleTrie::remove_key(const char* key, bool delete_value) {
+    TrieNode* node = find_and_lock_leaf(key);
     if (node == NULL) {
         return false;
     }
@@ -186,19 +305,20 @@ bool HandleTrie::remove(const string& key, bool delete_value) {
         node->trie_node_mutex.unlock();
         return false;
     }
+    TrieValue* value = node->value;
+    node->store_value(NULL);
     if (delete_value) {
-        delete node->value;
+        delete value;
     }
-    node->value = NULL;
     this->_size--;
     node->trie_node_mutex.unlock();
     return true;
 }
 
-bool HandleTrie::update(const string& key,
-                        bool (*visit_function)(TrieValue* value, void* data),
-                        void* data) {
-    TrieNode* node = fetch<TrieNode>(key, false, false);
+bool HandleTrie::update_key(const char* key,
+                            bool (*visit_function)(TrieValue* value, void* data),
+                            void* data) {
+    TrieNode* node = find_and_lock_leaf(key);
     if (node == NULL) {
         return false;
     }
@@ -207,50 +327,11 @@ bool HandleTrie::update(const string& key,
         return false;
     }
     if (visit_function(node->value, data)) {
-        delete node->value;
-        node->value = NULL;
+        TrieValue* value = node->value;
+        node->store_value(NULL);
+        delete value;
         this->_size--;
     }
     node->trie_node_mutex.unlock();
     return true;
 }
-
-void HandleTrie::traverse(bool keep_root_locked,
-                          bool (*visit_function)(TrieNode* node, void* data),
-                          void* data) {
-    stack<TrieNode*> node_stack;
-    TrieNode* cursor;
-    node_stack.push(root);
-
-    while (!node_stack.empty()) {
-        cursor = node_stack.top();
-        node_stack.pop();
-        cursor->trie_node_mutex.lock();
-        if (cursor->suffix_start > 0) {
-            if (visit_function(cursor, data)) {
-                if (keep_root_locked && (root != cursor)) {
-                    root->trie_node_mutex.unlock();
-                }
-                cursor->trie_node_mutex.unlock();
-                return;
-            }
-        } else {
-            for (unsigned int i = TRIE_ALPHABET_SIZE - 1;; i--) {
-                if (cursor->children[i] != NULL) {
-                    node_stack.push(cursor->children[i]);
-                }
-                if (i == 0) {
-                    break;
-                }
-            }
-        }
-        if ((!keep_root_locked) || (cursor != root)) {
-            cursor->trie_node_mutex.unlock();
-        }
-    }
-    if (keep_root_locked) {
-        root->trie_node_mutex.unlock();
-    }
-}
-
-bool HandleTrie::exists(const string& key) { return (fetch<TrieNode>(key, true, false) != NULL); }
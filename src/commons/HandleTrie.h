@@ -3,7 +3,9 @@
 #include <atomic>
 #include <mutex>
 #include <string>
+#include <vector>
 
+#include "Handle.h"
 #include "Utils.h"
 
 #define TRIE_ALPHABET_SIZE ((unsigned int) 16)
@@ -20,6 +22,18 @@ namespace commons {
  *
  * When a (key, value) pair is inserted and key is already present, the method merge()
  * in value is called passing the newly inserted value.
+ *
+ * Concurrency: writers (insert(), remove(), update() and traverse()) lock the nodes they touch
+ * but lookups (lookup() and exists()) don't take any lock. This is safe because TrieNodes are
+ * never unlinked or released before the HandleTrie itself is destroyed and a new TrieNode is
+ * always fully initialized before being linked to the tree (with release/acquire semantics on
+ * the children pointers). So a reader either sees the tree before or after a concurrent insertion
+ * and never a half-built node. A given key is always attached to the same leaf TrieNode, even
+ * when the leaf is pushed down by later insertions. lookup_stored_object() locks only the leaf
+ * node while the stored object is read.
+ *
+ * TrieNodes are allocated in blocks (of increasing size) owned by the HandleTrie rather than
+ * one by one.
  */
 class HandleTrie {
    public:
@@ -45,18 +59,25 @@ class HandleTrie {
      */
     class TrieNode {
        public:
-        TrieNode();           /// Basic empty constructor.
-        ~TrieNode();          /// Destructor.
-
-        TrieNode** children;  /// Array with children of this node.
-        TrieValue* value;     /// Value attached to this node or NULL if none.
-        string
-            suffix;  /// The key (handle) attached to this node (leafs) or NULL if none (internal nodes).
-        unsigned char suffix_start;  /// The point in the suffix from which this node (leaf) differs from
-                                     /// its siblings.
+        TrieNode();   /// Basic empty constructor.
+        ~TrieNode();  /// Destructor (deletes the value but not the children).
+
+        atomic<TrieNode*> children[TRIE_ALPHABET_SIZE];  /// Children of this node.
+        TrieValue* value;  /// Value attached to this node or NULL if none.
+        CompactHandle suffix;  /// The key (handle) attached to this node (leafs) or empty if none
+                               /// (internal nodes). Hex handles are stored in 16 bytes.
+        atomic<unsigned char> suffix_start;  /// The point in the suffix from which this node (leaf)
+                                             /// differs from its siblings.
         mutex trie_node_mutex;
 
         string to_string();  /// Returns a string representation of this node.
+
+        /// Reads value without holding trie_node_mutex.
+        inline TrieValue* load_value() const { return __atomic_load_n(&this->value, __ATOMIC_ACQUIRE); }
+        /// Sets value (trie_node_mutex is supposed to be held by the caller).
+        inline void store_value(TrieValue* value) {
+            __atomic_store_n(&this->value, value, __ATOMIC_RELEASE);
+        }
     };
 
     HandleTrie(unsigned int key_size);  /// Basic constructor.
@@ -73,6 +94,19 @@ class HandleTrie {
      */
     TrieValue* insert(const string& key, TrieValue* value);
 
+    /**
+     * Same as insert(const string&, TrieValue*) but using a fixed-width Handle as key. No
+     * intermediate std::string is allocated. This HandleTrie is supposed to have key_size ==
+     * Handle::HEX_SIZE.
+     *
+     * @param key Handle being inserted.
+     * @param value HandleTrie::TrieValue object being inserted.
+     *
+     * @return The resulting HandleTrie::TrieValue object after insertion (and eventually the merge) is
+     * processed.
+     */
+    TrieValue* insert(const Handle& key, TrieValue* value);
+
     /**
      * Lookup for a given handle.
      *
@@ -80,7 +114,25 @@ class HandleTrie {
      *
      * @return The HandleTrie::TrieValue object attached to the passed key or NULL if none.
      */
-    inline TrieValue* lookup(const string& key) { return fetch<TrieValue>(key, true, false); }
+    inline TrieValue* lookup(const string& key) {
+        check_key_size(key.size());
+        TrieNode* node = find_leaf(key.c_str());
+        return (node == NULL) ? NULL : node->load_value();
+    }
+
+    /**
+     * Lookup for a given (fixed-width) Handle.
+     *
+     * @param key Handle being searched.
+     *
+     * @return The HandleTrie::TrieValue object attached to the passed key or NULL if none.
+     */
+    inline TrieValue* lookup(const Handle& key) {
+        char hex[Handle::HEX_SIZE + 1];
+        handle_key(key, hex);
+        TrieNode* node = find_leaf(hex);
+        return (node == NULL) ? NULL : node->load_value();
+    }
 
     /**
      * Lookup for a given handle and return the corresponding object stored in TrieValue.
@@ -94,10 +146,21 @@ class HandleTrie {
      * passed key.
      */
     inline void* lookup_stored_object(const string& key, bool clone = true) {
-        return fetch<void>(key, true, clone);
+        check_key_size(key.size());
+        return fetch_stored_object(key.c_str(), clone);
+    }
+
+    /**
+     * Same as lookup_stored_object(const string&, bool) but using a fixed-width Handle as key.
+     */
+    inline void* lookup_stored_object(const Handle& key, bool clone = true) {
+        char hex[Handle::HEX_SIZE + 1];
+        handle_key(key, hex);
+        return fetch_stored_object(hex, clone);
     }
 
     bool exists(const string& key);
+    bool exists(const Handle& key);
 
     /**
      * Remove a key from this HandleTrie and its associated value.
@@ -108,6 +171,7 @@ class HandleTrie {
      * @return true if the key was found and removed, false otherwise.
      */
     bool remove(const string& key, bool delete_value = true);
+    bool remove(const Handle& key, bool delete_value = true);
 
     /**
      * Run visit_function on the value stored at key while holding the node lock.
@@ -125,6 +189,7 @@ class HandleTrie {
      * @return true if the key existed with a value, false otherwise.
      */
     bool update(const string& key, bool (*visit_function)(TrieValue* value, void* data), void* data);
+    bool update(const Handle& key, bool (*visit_function)(TrieValue* value, void* data), void* data);
 
     /**
      * Traverse all keys (in-order) calling the passed visit_function once per stored value.
@@ -146,63 +211,69 @@ class HandleTrie {
     TrieNode* root;
 
    private:
-    template <typename T>
-    T* fetch(const string& key, bool unlock_node, bool clone_stored_object) {
-        if (key.size() != key_size) {
-            RAISE_ERROR("Invalid key size: " + to_string(key.size()) + " != " + to_string(key_size));
+    inline void check_key_size(unsigned int size) {
+        if (size != key_size) {
+            RAISE_ERROR("Invalid key size: " + to_string(size) + " != " + to_string(key_size));
         }
+    }
 
-        TrieNode* tree_cursor = root;
-        unsigned char key_cursor = 0;
-        tree_cursor->trie_node_mutex.lock();
-        while (tree_cursor != NULL) {
-            if (tree_cursor->suffix_start > 0) {
-                bool match = true;
-                unsigned int n = key.size();
-                for (unsigned int i = key_cursor; i < n; i++) {
-                    if (key[i] != tree_cursor->suffix[i]) {
-                        match = false;
-                        break;
-                    }
-                }
-                TrieNode* node = match ? tree_cursor : NULL;
-                T* answer = NULL;
-                bool forced_lock_release = false;
-                if (node != NULL) {
-                    if constexpr (is_same_v<T, TrieNode>) {
-                        answer = node;
-                    } else if constexpr (is_same_v<T, TrieValue>) {
-                        forced_lock_release = true;
-                        answer = node->value;
-                    } else if constexpr (is_same_v<T, void>) {
-                        forced_lock_release = true;
-                        if (node->value != NULL) {
-                            answer = node->value->get_stored_object(clone_stored_object);
-                        }
-                    } else {
-                        RAISE_ERROR("Invalid fetch() attempt with unexpected type");
+    inline void handle_key(const Handle& handle, char* hex) {
+        check_key_size(Handle::HEX_SIZE);
+        handle.to_hex(hex);
+    }
+
+    TrieValue* insert_key(const char* key, TrieValue* value);
+    bool remove_key(const char* key, bool delete_value);
+    bool update_key(const char* key, bool (*visit_function)(TrieValue* value, void* data), void* data);
+
+    // Lock-free search for the leaf attached to key (which is supposed to have exactly key_size
+    // chars). Returns NULL if key is not in the trie.
+    inline TrieNode* find_leaf(const char* key) {
+        TrieNode* cursor = this->root;
+        unsigned int key_cursor = 0;
+        while (cursor != NULL) {
+            if (cursor->suffix_start.load(memory_order_acquire) > 0) {
+                // Leaf's suffix is never changed after the node is linked to the tree
+                for (unsigned int i = key_cursor; i < this->key_size; i++) {
+                    if (key[i] != cursor->suffix[i]) {
+                        return NULL;
                     }
-                } else {
-                    forced_lock_release = true;
-                }
-                if (unlock_node || forced_lock_release) {
-                    tree_cursor->trie_node_mutex.unlock();
-                }
-                return answer;
-            } else {
-                unsigned char c = TLB[(unsigned char) key[key_cursor]];
-                TrieNode* child = tree_cursor->children[c];
-                tree_cursor->trie_node_mutex.unlock();
-                tree_cursor = child;
-                key_cursor++;
-                if (tree_cursor != NULL) {
-                    tree_cursor->trie_node_mutex.lock();
                 }
+                return cursor;
             }
+            cursor = cursor->children[TLB[(unsigned char) key[key_cursor++]]].load(memory_order_acquire);
         }
         return NULL;
     }
 
+    // Same as find_leaf() but the returned node (if any) is locked.
+    inline TrieNode* find_and_lock_leaf(const char* key) {
+        TrieNode* node = find_leaf(key);
+        if (node != NULL) {
+            node->trie_node_mutex.lock();
+        }
+        return node;
+    }
+
+    void* fetch_stored_object(const char* key, bool clone);
+
+    /**
+     * Block allocator for TrieNodes. Nodes are released only when the pool is destroyed.
+     */
+    class NodePool {
+       public:
+        NodePool();
+        ~NodePool();
+        TrieNode* allocate();
+
+       private:
+        static const unsigned int FIRST_BLOCK_SIZE = 4;
+        static const unsigned int MAX_BLOCK_SIZE = 1024;
+        mutex pool_mutex;
+        vector<pair<TrieNode*, unsigned int>> blocks;  // (block, number of used nodes in block)
+        unsigned int block_size;
+    };
+
     static unsigned char TLB[256];
     static bool TLB_INITIALIZED;
     static void TLB_INIT() {
@@ -225,6 +296,7 @@ class HandleTrie {
         TLB_INITIALIZED = true;
     }
 
+    NodePool node_pool;
     unsigned int key_size;
     atomic<unsigned int> _size;
 };
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils.h"
+
+namespace commons {
+
+/**
+ * Thread-safe, bounded LRU cache.
+ *
+ * Keys are spread among a fixed number of shards (each one with its own mutex and LRU list) so
+ * concurrent lookups of different keys rarely contend on the same lock. Each entry has a weight
+ * (1 by default, so the capacity is a number of entries unless the caller passes explicit weights
+ * to set(), e.g. estimated sizes in bytes). Each shard holds entries with a total weight of at most
+ * capacity / shard_count; least recently used entries of a shard are evicted until a new one fits.
+ * Entries heavier than the capacity of a shard are not stored.
+ *
+ * Each shard also has a version, incremented whenever one of its entries is removed (or the whole
+ * cache is cleared). Callers which compute a value outside the cache (e.g. reading it from a
+ * database) can read version() before computing it and store it with set_if_unchanged() so a
+ * concurrent removal of the same key can't be undone by an outdated value.
+ *
+ * Hit, miss and eviction counters are kept for monitoring purposes.
+ */
+template <typename KEY_TYPE, typename VALUE_TYPE>
+class LRUCache {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param capacity Max total weight of the entries in the cache. 0 disables the cache (every
+     * lookup is a miss and nothing is stored).
+     * @param shard_count Number of shards.
+     */
+    LRUCache(size_t capacity = 0, unsigned int shard_count = 16) {
+        this->hit_count = 0;
+        this->miss_count = 0;
+        this->eviction_count = 0;
+        resize(capacity, shard_count);
+    }
+
+    ~LRUCache() {}
+
+    /**
+     * Changes the capacity of the cache. All the current entries are discarded.
+     *
+     * This method is not supposed to be called concurrently with any other method.
+     *
+     * @param capacity Max total weight of the entries in the cache (0 disables the cache).
+     * @param shard_count Number of shards.
+     */
+    void resize(size_t capacity, unsigned int shard_count = 16) {
+        if (shard_count == 0) {
+            RAISE_ERROR("Invalid LRUCache shard count: 0");
+        }
+        if ((capacity > 0) && (capacity < shard_count)) {
+            shard_count = capacity;
+        }
+        this->capacity = capacity;
+        this->shards = vector<Shard>(shard_count);
+        for (auto& shard : this->shards) {
+            shard.capacity = capacity / shard_count;
+        }
+    }
+
+    /**
+     * Looks up for a key and updates its position in the LRU list.
+     *
+     * @param key Key being looked up.
+     * @param value Value associated to the key (only assigned in case of a hit).
+     * @return true iff the key is in the cache.
+     */
+    bool get(const KEY_TYPE& key, VALUE_TYPE& value) {
+        if (this->capacity == 0) {
+            this->miss_count++;
+            return false;
+        }
+        Shard& shard = get_shard(key);
+        lock_guard<mutex> semaphore(shard.api_mutex);
+        auto iterator = shard.index.find(key);
+        if (iterator == shard.index.end()) {
+            this->miss_count++;
+            return false;
+        }
+        shard.entries.splice(shard.entries.begin(), shard.entries, iterator->second);
+        value = iterator->second->value;
+        this->hit_count++;
+        return true;
+    }
+
+    /**
+     * Inserts (or replaces) a key in the cache, evicting least recently used entries of the
+     * respective shard until the new one fits.
+     *
+     * @param key Key being inserted.
+     * @param value Value associated to the key.
+     * @param weight Weight of the entry.
+     * @return true iff the entry has been stored (i.e. it isn't heavier than a whole shard).
+     */
+    bool set(const KEY_TYPE& key, const VALUE_TYPE& value, size_t weight = 1) {
+        if (this->capacity == 0) {
+            return false;
+        }
+        Shard& shard = get_shard(key);
+        lock_guard<mutex> semaphore(shard.api_mutex);
+        return insert(shard, key, value, weight);
+    }
+
+    /**
+     * Returns the current version of the shard of the passed key (see set_if_unchanged()).
+     *
+     * @param key Key whose shard version is returned.
+     * @return the current version of the shard of the passed key.
+     */
+    unsigned long version(const KEY_TYPE& key) {
+        if (this->capacity == 0) {
+            return 0;
+        }
+        Shard& shard = get_shard(key);
+        lock_guard<mutex> semaphore(shard.api_mutex);
+        return shard.version;
+    }
+
+    /**
+     * Same as set() but the entry is only stored if no entry of the respective shard has been
+     * removed since the passed version was read (see version()).
+     *
+     * @param key Key being inserted.
+     * @param value Value associated to the key.
+     * @param version Version of the shard of the key read before computing the value.
+     * @param weight Weight of the entry.
+     * @return true iff the entry has been stored.
+     */
+    bool set_if_unchanged(const KEY_TYPE& key,
+                          const VALUE_TYPE& value,
+                          unsigned long version,
+                          size_t weight = 1) {
+        if (this->capacity == 0) {
+            return false;
+        }
+        Shard& shard = get_shard(key);
+        lock_guard<mutex> semaphore(shard.api_mutex);
+        if (shard.version != version) {
+            return false;
+        }
+        return insert(shard, key, value, weight);
+    }
+
+    /**
+     * Removes a key from the cache (if present) and increments the version of its shard.
+     *
+     * @param key Key being removed.
+     */
+    void remove(const KEY_TYPE& key) {
+        if (this->capacity == 0) {
+            return;
+        }
+        Shard& shard = get_shard(key);
+        lock_guard<mutex> semaphore(shard.api_mutex);
+        shard.version++;
+        auto iterator = shard.index.find(key);
+        if (iterator != shard.index.end()) {
+            shard.weight -= iterator->second->weight;
+            shard.entries.erase(iterator->second);
+            shard.index.erase(iterator);
+        }
+    }
+
+    /**
+     * Removes all the entries from the cache and increments the version of every shard.
+     * Hit/miss/eviction counters are not reset.
+     */
+    void clear() {
+        for (auto& shard : this->shards) {
+            lock_guard<mutex> semaphore(shard.api_mutex);
+            shard.version++;
+            shard.entries.clear();
+            shard.index.clear();
+            shard.weight = 0;
+        }
+    }
+
+    /**
+     * Returns the number of entries currently in the cache.
+     *
+     * @return the number of entries currently in the cache.
+     */
+    unsigned int size() {
+        unsigned int count = 0;
+        for (auto& shard : this->shards) {
+            lock_guard<mutex> semaphore(shard.api_mutex);
+            count += shard.index.size();
+        }
+        return count;
+    }
+
+    /**
+     * Returns the total weight of the entries currently in the cache.
+     *
+     * @return the total weight of the entries currently in the cache.
+     */
+    size_t weight() {
+        size_t total = 0;
+        for (auto& shard : this->shards) {
+            lock_guard<mutex> semaphore(shard.api_mutex);
+            total += shard.weight;
+        }
+        return total;
+    }
+
+    size_t get_capacity() const { return this->capacity; }
+    unsigned long hits() const { return this->hit_count.load(); }
+    unsigned long misses() const { return this->miss_count.load(); }
+    unsigned long evictions() const { return this->eviction_count.load(); }
+
+   private:
+    struct Entry {
+        KEY_TYPE key;
+        VALUE_TYPE value;
+        size_t weight;
+    };
+
+    class Shard {
+       public:
+        mutex api_mutex;
+        size_t capacity;
+        size_t weight;
+        // Incremented whenever an entry is removed (see set_if_unchanged())
+        unsigned long version;
+        list<Entry> entries;
+        unordered_map<KEY_TYPE, typename list<Entry>::iterator> index;
+        Shard() : capacity(0), weight(0), version(0) {}
+        Shard(const Shard& other) : capacity(other.capacity), weight(0), version(0) {}
+    };
+
+    size_t capacity;
+    vector<Shard> shards;
+    atomic<unsigned long> hit_count;
+    atomic<unsigned long> miss_count;
+    atomic<unsigned long> eviction_count;
+
+    Shard& get_shard(const KEY_TYPE& key) {
+        return this->shards[hash<KEY_TYPE>()(key) % this->shards.size()];
+    }
+
+    // Inserts (or replaces) a key in the passed shard (whose api_mutex is supposed to be locked)
+    bool insert(Shard& shard, const KEY_TYPE& key, const VALUE_TYPE& value, size_t weight) {
+        auto iterator = shard.index.find(key);
+        if (iterator != shard.index.end()) {
+            shard.weight -= iterator->second->weight;
+            shard.entries.erase(iterator->second);
+            shard.index.erase(iterator);
+        }
+        if (weight > shard.capacity) {
+            return false;
+        }
+        while (shard.weight + weight > shard.capacity) {
+            shard.weight -= shard.entries.back().weight;
+            shard.index.erase(shard.entries.back().key);
+            shard.entries.pop_back();
+            this->eviction_count++;
+        }
+        shard.entries.push_front({key, value, weight});
+        shard.index[key] = shard.entries.begin();
+        shard.weight += weight;
+        return true;
+    }
+};
+
+}  // namespace commons
@@ -1,5 +1,7 @@
 #include "SharedQueue.h"
 
+#include <chrono>
+
 using namespace commons;
 
 // --------------------------------------------------------------------------------
@@ -40,6 +42,7 @@ void SharedQueue::enqueue(void* request) {
     end = (end + 1) % allocated_size;
     count++;
     shared_queue_mutex.unlock();
+    not_empty_condition.notify_one();
 }
 
 void* SharedQueue::dequeue() {
@@ -54,6 +57,12 @@ void* SharedQueue::dequeue() {
     return answer;
 }
 
+bool SharedQueue::wait(unsigned int timeout_millis) {
+    std::unique_lock<std::mutex> semaphore(shared_queue_mutex);
+    return not_empty_condition.wait_for(
+        semaphore, std::chrono::milliseconds(timeout_millis), [this] { return count > 0; });
+}
+
 // --------------------------------------------------------------------------------
 // Protected methods
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <condition_variable>
 #include <mutex>
 
 namespace commons {
@@ -46,6 +47,17 @@ class SharedQueue {
      */
     unsigned int size();
 
+    /**
+     * Blocks the caller until the queue is non-empty or the timeout expires.
+     *
+     * This is meant to be used by consumer threads instead of polling the queue with a
+     * sleep between empty dequeue()s.
+     *
+     * @param timeout_millis Max time (in milliseconds) to wait for a request.
+     * @return true iff the queue is non-empty when the method returns.
+     */
+    bool wait(unsigned int timeout_millis = 100);
+
    protected:
     unsigned int current_size();
     unsigned int current_start();
@@ -54,6 +66,7 @@ class SharedQueue {
 
    private:
     std::mutex shared_queue_mutex;
+    std::condition_variable not_empty_condition;
 
     void** requests;  // GRPC documentation states that request types should not be inherited
     unsigned int allocated_size;
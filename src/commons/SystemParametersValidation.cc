@@ -28,12 +28,23 @@ const AgentParamsSchema& params_schema() {
           {"use_link_template_cache", "bool"},
           {"populate_metta_mapping", "bool"},
           {"use_metta_as_query_tokens", "bool"},
-          {"allow_incomplete_chain_path", "bool"}}},
+          {"allow_incomplete_chain_path", "bool"},
+          {"answer_format_version", "unsigned_int"}}},
         {"query",
          {{"positive_importance_flag", "bool"},
           {"disregard_importance_flag", "bool"},
           {"unique_value_flag", "bool"},
-          {"count_flag", "bool"}}},
+          {"count_flag", "bool"},
+          {"exists_flag", "bool"},
+          {"offset", "unsigned_int"},
+          {"hash_join_flag", "bool"},
+          {"link_template_cache_refresh", "bool"},
+          {"link_template_cache_max_entry_size", "unsigned_int"},
+          {"importance_streaming_flag", "bool"},
+          {"importance_chunk_size", "unsigned_int"},
+          {"cost_based_join_flag", "bool"},
+          {"explain_flag", "bool"},
+          {"chain_expansion_workers", "unsigned_int"}}},
         {"link_creation",
          {{"max_answers", "unsigned_int"},
           {"repeat_count", "unsigned_int"},
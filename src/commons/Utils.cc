@@ -432,6 +432,82 @@ bool Utils::starts_with(const string& s, const string& prefix) {
     return s.compare(0, prefix.size(), prefix) == 0;
 }
 
+static const char BASE64_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+string Utils::base64_encode(const string& bytes) {
+    string output;
+    output.reserve(((bytes.size() + 2) / 3) * 4);
+    size_t cursor = 0;
+    while (cursor + 3 <= bytes.size()) {
+        uint32_t group = ((unsigned char) bytes[cursor] << 16) |
+                         ((unsigned char) bytes[cursor + 1] << 8) | (unsigned char) bytes[cursor + 2];
+        output.push_back(BASE64_CHARS[(group >> 18) & 0x3F]);
+        output.push_back(BASE64_CHARS[(group >> 12) & 0x3F]);
+        output.push_back(BASE64_CHARS[(group >> 6) & 0x3F]);
+        output.push_back(BASE64_CHARS[group & 0x3F]);
+        cursor += 3;
+    }
+    size_t remaining = bytes.size() - cursor;
+    if (remaining > 0) {
+        uint32_t group = (unsigned char) bytes[cursor] << 16;
+        if (remaining == 2) {
+            group |= (unsigned char) bytes[cursor + 1] << 8;
+        }
+        output.push_back(BASE64_CHARS[(group >> 18) & 0x3F]);
+        output.push_back(BASE64_CHARS[(group >> 12) & 0x3F]);
+        output.push_back((remaining == 2) ? BASE64_CHARS[(group >> 6) & 0x3F] : '=');
+        output.push_back('=');
+    }
+    return output;
+}
+
+static inline int base64_value(char c) {
+    if ((c >= 'A') && (c <= 'Z')) {
+        return c - 'A';
+    } else if ((c >= 'a') && (c <= 'z')) {
+        return c - 'a' + 26;
+    } else if ((c >= '0') && (c <= '9')) {
+        return c - '0' + 52;
+    } else if (c == '+') {
+        return 62;
+    } else if (c == '/') {
+        return 63;
+    } else {
+        return -1;
+    }
+}
+
+string Utils::base64_decode(const string& text) {
+    if ((text.size() % 4) != 0) {
+        RAISE_ERROR("Invalid base64 string size: " + std::to_string(text.size()));
+    }
+    string output;
+    output.reserve((text.size() / 4) * 3);
+    for (size_t cursor = 0; cursor < text.size(); cursor += 4) {
+        bool last = (cursor + 4 == text.size());
+        unsigned int padding = 0;
+        uint32_t group = 0;
+        for (unsigned int i = 0; i < 4; i++) {
+            char c = text[cursor + i];
+            int value = 0;
+            if (last && (c == '=') && (i >= 2) && ((i == 3) || (text[cursor + 3] == '='))) {
+                padding++;
+            } else if ((padding > 0) || ((value = base64_value(c)) < 0)) {
+                RAISE_ERROR("Invalid base64 string");
+            }
+            group = (group << 6) | value;
+        }
+        output.push_back((char) ((group >> 16) & 0xFF));
+        if (padding < 2) {
+            output.push_back((char) ((group >> 8) & 0xFF));
+        }
+        if (padding < 1) {
+            output.push_back((char) (group & 0xFF));
+        }
+    }
+    return output;
+}
+
 // --------------------------------------------------------------------------------
 // MemoryFootprint
 
@@ -176,6 +176,8 @@ class Utils {
                                const string& function_name = "");
     static bool read_and_split(vector<string>& output, ifstream& file, char delimiter = ' ');
     static bool starts_with(const string& s, const string& prefix);
+    static string base64_encode(const string& bytes);
+    static string base64_decode(const string& text);  // Throws on invalid input
 
     template <class C>
     static bool intersects(const C& set1, const C& set2) {
@@ -16,6 +16,22 @@ class HandleDecoder {
    public:
     virtual ~HandleDecoder() {}
     virtual shared_ptr<Atom> get_atom(const string& handle) = 0;
+
+    /**
+     * Batched version of get_atom(). Decoders backed by remote storage are supposed to override
+     * it in order to fetch all the atoms at once.
+     *
+     * @param handles Handles being decoded.
+     * @return one atom per handle, in the same order (nullptr for unknown handles).
+     */
+    virtual vector<shared_ptr<Atom>> get_atoms(const vector<string>& handles) {
+        vector<shared_ptr<Atom>> atoms;
+        atoms.reserve(handles.size());
+        for (const string& handle : handles) {
+            atoms.push_back(get_atom(handle));
+        }
+        return atoms;
+    }
 };
 
 }  // namespace atoms
@@ -68,21 +68,7 @@ string Link::to_string() const {
 string Link::handle() const { return Hasher::link_handle(this->type, this->targets); }
 
 string Link::composite_type_hash(HandleDecoder& decoder) const {
-    unsigned int arity = this->targets.size();
-    unsigned int cursor = 0;
-    char** handles = new char*[arity + 1];
-    for (string handle : this->composite_type(decoder)) {
-        handles[cursor++] = strdup(handle.c_str());
-    }
-    char* hash_cstr = ::composite_hash(handles, arity + 1);
-
-    string hash_string(hash_cstr);
-    free(hash_cstr);
-    for (int i = arity; i >= 0; i--) {
-        free(handles[i]);
-    }
-    delete[] handles;
-    return hash_string;
+    return Hasher::composite_handle(this->composite_type(decoder));
 }
 
 vector<string> Link::composite_type(HandleDecoder& decoder) const {
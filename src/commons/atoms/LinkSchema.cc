@@ -203,6 +203,75 @@ bool LinkSchema::match(const string& handle, Assignment& assignment, HandleDecod
     return this->_schema_element.match(handle, assignment, decoder, NULL);
 }
 
+// HandleDecoder which only knows the atoms fetched in advance by the batched match()
+class PrefetchedAtoms : public HandleDecoder {
+   public:
+    map<string, shared_ptr<Atom>> atoms;
+    shared_ptr<Atom> get_atom(const string& handle) override {
+        auto iterator = this->atoms.find(handle);
+        return (iterator == this->atoms.end() ? nullptr : iterator->second);
+    }
+};
+
+vector<bool> LinkSchema::match(const vector<string>& handles,
+                               vector<Assignment>& assignments,
+                               HandleDecoder& decoder) {
+    if (assignments.size() != handles.size()) {
+        RAISE_ERROR("Invalid number of assignments: " + std::to_string(assignments.size()) +
+                    ". Expected: " + std::to_string(handles.size()));
+    }
+    PrefetchedAtoms prefetched;
+    vector<pair<string, const SchemaElement*>> pending;
+    for (const string& handle : handles) {
+        pending.push_back({handle, &this->_schema_element});
+    }
+    while (!pending.empty()) {
+        vector<string> missing;
+        for (const auto& pair : pending) {
+            if (prefetched.atoms.find(pair.first) == prefetched.atoms.end()) {
+                prefetched.atoms[pair.first] = nullptr;
+                missing.push_back(pair.first);
+            }
+        }
+        LOG_DEBUG("Prefetching " + std::to_string(missing.size()) + " atoms");
+        vector<shared_ptr<Atom>> atoms = decoder.get_atoms(missing);
+        for (unsigned int i = 0; i < atoms.size(); i++) {
+            prefetched.atoms[missing[i]] = atoms[i];
+        }
+        // Nested links are fetched in the next iteration
+        vector<pair<string, const SchemaElement*>> next;
+        for (const auto& pair : pending) {
+            const SchemaElement* element = pair.second;
+            Link* link = dynamic_cast<Link*>(prefetched.atoms[pair.first].get());
+            if ((link == NULL) || (link->targets.size() != element->targets.size())) {
+                continue;
+            }
+            bool node_mismatch = false;
+            for (unsigned int i = 0; i < element->targets.size(); i++) {
+                const SchemaElement& target = element->targets[i];
+                if (!target.is_link && !target.is_wildcard && (target.handle != link->targets[i])) {
+                    node_mismatch = true;
+                    break;
+                }
+            }
+            if (node_mismatch) {
+                continue;
+            }
+            for (unsigned int i = 0; i < element->targets.size(); i++) {
+                if (element->targets[i].is_link) {
+                    next.push_back({link->targets[i], &element->targets[i]});
+                }
+            }
+        }
+        pending.swap(next);
+    }
+    vector<bool> answer(handles.size());
+    for (unsigned int i = 0; i < handles.size(); i++) {
+        answer[i] = this->_schema_element.match(handles[i], assignments[i], prefetched, NULL);
+    }
+    return answer;
+}
+
 // -------------------------------------------------------------------------------------------------
 // Public API to build LinkSchema objects
 
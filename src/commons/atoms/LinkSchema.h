@@ -165,6 +165,23 @@ class LinkSchema : public Wildcard {
     bool match(Link& link, Assignment& assignment, HandleDecoder& decoder);
     bool match(const string& handle, Assignment& assignment, HandleDecoder& decoder) override;
 
+    /**
+     * @brief Batched version of match(handle, assignment, decoder).
+     *
+     * All the atoms required to evaluate the schema against the passed handles are fetched with
+     * one HandleDecoder::get_atoms() call per nesting level of the schema (instead of one
+     * get_atom() call per link) and the schema is then evaluated in memory. Links whose node
+     * targets already mismatch the schema are not expanded any further.
+     *
+     * @param handles Handles being matched.
+     * @param assignments One Assignment per handle (assigned iff the respective handle matches).
+     * @param decoder HandleDecoder used to fetch the atoms.
+     * @return one flag per handle, true iff the respective handle matches this schema.
+     */
+    vector<bool> match(const vector<string>& handles,
+                       vector<Assignment>& assignments,
+                       HandleDecoder& decoder);
+
     // ---------------------------------------------------------------------------------------------
     // Public API to build LinkSchema objects
 
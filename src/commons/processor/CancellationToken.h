@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+
+using namespace std;
+
+namespace processor {
+
+/**
+ * Flag shared by all the tasks working on behalf of the same request (e.g. all the elements in the
+ * query tree of a given query) so they can be told to abort at once.
+ *
+ * Cancellation is cooperative: cancel() just flips the flag. Tasks run by a WorkStealingExecutor
+ * are retired by the executor as soon as their token is cancelled. Long running steps are
+ * supposed to check is_cancelled() themselves.
+ */
+class CancellationToken {
+   public:
+    CancellationToken() { this->cancelled = false; }
+    ~CancellationToken() {}
+
+    /**
+     * Requests all the tasks sharing this token to abort.
+     */
+    void cancel() { this->cancelled = true; }
+
+    /**
+     * Returns true iff cancel() has been called.
+     *
+     * @return true iff cancel() has been called.
+     */
+    bool is_cancelled() { return this->cancelled; }
+
+   private:
+    atomic<bool> cancelled;
+};
+
+}  // namespace processor
@@ -70,5 +70,5 @@ void DedicatedThread::thread_method() {
         if (!this->job->thread_one_step()) {
             Utils::sleep();
         };
-    } while (!stopped());
+    } while (!stopped() && !this->job->thread_finished());
 }
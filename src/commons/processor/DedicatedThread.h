@@ -13,6 +13,12 @@ class ThreadMethod {
    public:
     virtual ~ThreadMethod(){};
     virtual bool thread_one_step() = 0;
+
+    /**
+     * Returns true when the job has nothing else to do so the thread running it can be released
+     * before being explicitly stopped.
+     */
+    virtual bool thread_finished() { return false; }
 };
 
 /**
@@ -0,0 +1,47 @@
+#include "PooledThread.h"
+
+using namespace processor;
+
+// -------------------------------------------------------------------------------------------------
+// Constructors and destructors
+
+PooledThread::PooledThread(const string& id,
+                           ThreadMethod* job,
+                           shared_ptr<CancellationToken> token,
+                           shared_ptr<WorkStealingExecutor> executor)
+    : Processor(id) {
+    this->executor = (executor != nullptr) ? executor : WorkStealingExecutor::get_shared();
+    this->task = make_shared<WorkStealingExecutor::Task>(job, token);
+}
+
+PooledThread::~PooledThread() {
+    // Makes sure the job (which may be deleted next) is not called anymore
+    this->executor->retire(this->task);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Public methods
+
+void PooledThread::setup() { Processor::setup(); }
+
+void PooledThread::start() {
+    Processor::start();
+    this->executor->schedule(this->task);
+}
+
+void PooledThread::stop() {
+    this->executor->retire(this->task);
+    Processor::stop();
+}
+
+void PooledThread::wake() { this->executor->wake(this->task); }
+
+bool PooledThread::stopped() {
+    {
+        lock_guard<mutex> semaphore(this->task->api_mutex);
+        if (this->task->stop_flag) {
+            return true;
+        }
+    }
+    return (this->task->token != nullptr) && this->task->token->is_cancelled();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "CancellationToken.h"
+#include "DedicatedThread.h"
+#include "WorkStealingExecutor.h"
+
+using namespace std;
+
+namespace processor {
+
+/**
+ * Same as DedicatedThread but the job is run as a task in a WorkStealingExecutor (by default, the
+ * one shared by the whole process) instead of in its own thread.
+ *
+ * Jobs must not block in thread_one_step() waiting for other jobs. Instead, they are supposed to
+ * return false when they have nothing to do (e.g. their input is empty) and whoever provides them
+ * with new work should call wake() so the task is run again right away rather than when the
+ * executor's idle timeout expires. Jobs whose steps block on I/O (e.g. AtomDB or AttentionBroker
+ * calls) are supposed to run in WorkStealingExecutor::get_shared_io().
+ */
+class PooledThread : public Processor {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param id ID of this Processor.
+     * @param job The job being run.
+     * @param token Optional CancellationToken. The task is retired as soon as it's cancelled.
+     * @param executor Executor where the job is run. If nullptr, the shared executor is used.
+     */
+    PooledThread(const string& id,
+                 ThreadMethod* job,
+                 shared_ptr<CancellationToken> token = nullptr,
+                 shared_ptr<WorkStealingExecutor> executor = nullptr);
+    virtual ~PooledThread();
+
+    virtual void setup();
+    virtual void start();
+
+    /**
+     * Retires the task. When this method returns, the job's thread_one_step() is not being
+     * executed and it won't be called anymore (unless this method is called by the job itself,
+     * in which case the task is retired as soon as the current step returns).
+     */
+    virtual void stop();
+
+    /**
+     * Makes the task run again as soon as possible if it's idle.
+     */
+    void wake();
+
+    /**
+     * Returns true iff stop() has been called or the CancellationToken has been cancelled. Jobs
+     * with long steps are supposed to check this to abort them.
+     *
+     * @return true iff stop() has been called or the CancellationToken has been cancelled.
+     */
+    bool stopped();
+
+   private:
+    shared_ptr<WorkStealingExecutor> executor;
+    shared_ptr<WorkStealingExecutor::Task> task;
+};
+
+}  // namespace processor
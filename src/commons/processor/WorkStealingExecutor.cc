@@ -0,0 +1,301 @@
+#include "WorkStealingExecutor.h"
+
+#define LOG_LEVEL INFO_LEVEL
+#include "Logger.h"
+#include "Utils.h"
+
+using namespace processor;
+using namespace commons;
+
+// Worker (of which executor) running in the current thread
+static thread_local WorkStealingExecutor* current_executor = NULL;
+static thread_local unsigned int current_worker = 0;
+// Task whose step is being run in the current thread
+static thread_local WorkStealingExecutor::Task* current_task = NULL;
+
+// -------------------------------------------------------------------------------------------------
+// Constructors and destructors
+
+WorkStealingExecutor::Task::Task(ThreadMethod* job, shared_ptr<CancellationToken> token) {
+    this->job = job;
+    this->token = token;
+    this->state = WAITING_START;
+    this->wake_pending = false;
+    this->stop_flag = false;
+    this->park_count = 0;
+}
+
+WorkStealingExecutor::WorkStealingExecutor(const string& id, unsigned int num_threads)
+    : Processor(id) {
+    if (num_threads == 0) {
+        RAISE_ERROR("Invalid number of threads for WorkStealingExecutor: 0");
+    }
+    this->num_threads = num_threads;
+    this->next_worker = 0;
+    this->queued_count = 0;
+    this->stop_flag = false;
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    if (is_running()) {
+        stop();
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Public methods
+
+shared_ptr<WorkStealingExecutor> WorkStealingExecutor::get_shared() {
+    static shared_ptr<WorkStealingExecutor> shared = create_shared(
+        "shared_executor", max(MIN_SHARED_THREADS, thread::hardware_concurrency()));
+    return shared;
+}
+
+shared_ptr<WorkStealingExecutor> WorkStealingExecutor::get_shared_io() {
+    static shared_ptr<WorkStealingExecutor> shared =
+        create_shared("shared_io_executor",
+                      max(MIN_SHARED_IO_THREADS,
+                          SHARED_IO_THREADS_PER_CORE * thread::hardware_concurrency()));
+    return shared;
+}
+
+void WorkStealingExecutor::setup() {
+    for (unsigned int i = 0; i < this->num_threads; i++) {
+        this->workers.push_back(make_unique<Worker>());
+    }
+    Processor::setup();
+}
+
+void WorkStealingExecutor::start() {
+    for (unsigned int i = 0; i < this->num_threads; i++) {
+        this->workers[i]->thread_object = new thread(&WorkStealingExecutor::worker_method, this, i);
+    }
+    Processor::start();
+}
+
+void WorkStealingExecutor::stop() {
+    {
+        lock_guard<mutex> semaphore(this->sleep_mutex);
+        this->stop_flag = true;
+    }
+    this->sleep_condition.notify_all();
+    for (auto& worker : this->workers) {
+        if (worker->thread_object != NULL) {
+            worker->thread_object->join();
+            delete worker->thread_object;
+            worker->thread_object = NULL;
+        }
+    }
+    Processor::stop();
+}
+
+unsigned int WorkStealingExecutor::size() { return this->num_threads; }
+
+void WorkStealingExecutor::schedule(shared_ptr<Task> task) {
+    {
+        lock_guard<mutex> semaphore(task->api_mutex);
+        if (task->state != Task::WAITING_START) {
+            return;
+        }
+        task->state = Task::QUEUED;
+    }
+    push(task);
+}
+
+void WorkStealingExecutor::wake(shared_ptr<Task> task) {
+    {
+        lock_guard<mutex> semaphore(task->api_mutex);
+        if (task->state == Task::RUNNING) {
+            // The task will run again right after the current slice
+            task->wake_pending = true;
+            return;
+        }
+        if (task->state != Task::PARKED) {
+            return;
+        }
+        task->state = Task::QUEUED;
+    }
+    push(task);
+}
+
+void WorkStealingExecutor::retire(shared_ptr<Task> task) {
+    unique_lock<mutex> semaphore(task->api_mutex);
+    task->stop_flag = true;
+    if (current_task == task.get()) {
+        return;
+    }
+    task->state_condition.wait(semaphore, [task] { return task->state != Task::RUNNING; });
+    // Any copy of the task left in a deque or in the parked set is discarded when popped
+    task->state = Task::DONE;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Private methods
+
+shared_ptr<WorkStealingExecutor> WorkStealingExecutor::create_shared(const string& id,
+                                                                     unsigned int num_threads) {
+    auto executor = make_shared<WorkStealingExecutor>(id, num_threads);
+    executor->setup();
+    executor->start();
+    return executor;
+}
+
+void WorkStealingExecutor::worker_method(unsigned int worker_index) {
+    current_executor = this;
+    current_worker = worker_index;
+    while (true) {
+        shared_ptr<Task> task = pop(worker_index);
+        if (task != nullptr) {
+            run_slice(task);
+            continue;
+        }
+        auto deadline = next_deadline();
+        unique_lock<mutex> semaphore(this->sleep_mutex);
+        if (this->stop_flag) {
+            break;
+        }
+        this->sleep_condition.wait_until(
+            semaphore, deadline, [this] { return this->stop_flag || (this->queued_count > 0); });
+    }
+}
+
+void WorkStealingExecutor::push(shared_ptr<Task> task) {
+    unsigned int index;
+    if (current_executor == this) {
+        index = current_worker;
+    } else {
+        index = this->next_worker++ % this->num_threads;
+    }
+    {
+        lock_guard<mutex> semaphore(this->workers[index]->api_mutex);
+        this->workers[index]->tasks.push_back(task);
+    }
+    {
+        lock_guard<mutex> semaphore(this->sleep_mutex);
+        this->queued_count++;
+    }
+    this->sleep_condition.notify_one();
+}
+
+shared_ptr<WorkStealingExecutor::Task> WorkStealingExecutor::pop(unsigned int worker_index) {
+    release_expired_parked_tasks();
+    // Own deque is consumed FIFO (so yielding tasks don't starve the others) and the other ones
+    // are stolen from the back.
+    for (unsigned int i = 0; i < this->num_threads; i++) {
+        Worker* worker = this->workers[(worker_index + i) % this->num_threads].get();
+        lock_guard<mutex> semaphore(worker->api_mutex);
+        if (!worker->tasks.empty()) {
+            shared_ptr<Task> task;
+            if (i == 0) {
+                task = worker->tasks.front();
+                worker->tasks.pop_front();
+            } else {
+                task = worker->tasks.back();
+                worker->tasks.pop_back();
+            }
+            this->queued_count--;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void WorkStealingExecutor::run_slice(shared_ptr<Task> task) {
+    {
+        lock_guard<mutex> semaphore(task->api_mutex);
+        if (task->state != Task::QUEUED) {
+            // Retired while in the run queue
+            return;
+        }
+        task->state = Task::RUNNING;
+        task->wake_pending = false;
+    }
+    bool idle = false;
+    bool finished = false;
+    current_task = task.get();
+    for (unsigned int i = 0; i < STEPS_PER_SLICE; i++) {
+        if (((task->token != nullptr) && task->token->is_cancelled()) ||
+            task->job->thread_finished()) {
+            finished = true;
+            break;
+        }
+        try {
+            if (!task->job->thread_one_step()) {
+                idle = true;
+                break;
+            }
+        } catch (const exception& exception) {
+            LOG_ERROR("Exception in task of executor " + this->to_string() + ": " +
+                      string(exception.what()));
+            finished = true;
+            break;
+        }
+    }
+    current_task = NULL;
+    if (!finished) {
+        finished = ((task->token != nullptr) && task->token->is_cancelled()) ||
+                   task->job->thread_finished();
+    }
+    bool requeue = false;
+    bool parked = false;
+    unsigned long park_count;
+    {
+        lock_guard<mutex> semaphore(task->api_mutex);
+        if (finished || task->stop_flag) {
+            task->state = Task::DONE;
+        } else if (idle && !task->wake_pending) {
+            task->state = Task::PARKED;
+            park_count = ++task->park_count;
+            parked = true;
+        } else {
+            task->state = Task::QUEUED;
+            requeue = true;
+        }
+    }
+    task->state_condition.notify_all();
+    if (requeue) {
+        push(task);
+    } else if (parked) {
+        park(task, park_count);
+    }
+}
+
+void WorkStealingExecutor::park(shared_ptr<Task> task, unsigned long park_count) {
+    ParkedTask parked;
+    parked.deadline = chrono::steady_clock::now() + chrono::milliseconds(IDLE_TIMEOUT);
+    parked.park_count = park_count;
+    parked.task = task;
+    lock_guard<mutex> semaphore(this->parked_tasks_mutex);
+    this->parked_tasks.push(parked);
+}
+
+void WorkStealingExecutor::release_expired_parked_tasks() {
+    vector<shared_ptr<Task>> expired;
+    {
+        lock_guard<mutex> semaphore(this->parked_tasks_mutex);
+        auto now = chrono::steady_clock::now();
+        while (!this->parked_tasks.empty() && (this->parked_tasks.top().deadline <= now)) {
+            const ParkedTask& parked = this->parked_tasks.top();
+            lock_guard<mutex> task_semaphore(parked.task->api_mutex);
+            // Entries of tasks which have been woken up (and maybe parked again) since they were
+            // inserted here are discarded
+            if ((parked.task->state == Task::PARKED) && (parked.task->park_count == parked.park_count)) {
+                parked.task->state = Task::QUEUED;
+                expired.push_back(parked.task);
+            }
+            this->parked_tasks.pop();
+        }
+    }
+    for (auto task : expired) {
+        push(task);
+    }
+}
+
+chrono::steady_clock::time_point WorkStealingExecutor::next_deadline() {
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(IDLE_TIMEOUT);
+    lock_guard<mutex> semaphore(this->parked_tasks_mutex);
+    if (!this->parked_tasks.empty() && (this->parked_tasks.top().deadline < deadline)) {
+        deadline = this->parked_tasks.top().deadline;
+    }
+    return deadline;
+}
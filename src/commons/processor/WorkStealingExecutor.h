@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "CancellationToken.h"
+#include "DedicatedThread.h"
+#include "Processor.h"
+
+using namespace std;
+
+namespace processor {
+
+/**
+ * Fixed set of worker threads running a (potentially much larger) set of step-based tasks.
+ *
+ * Tasks are ThreadMethod objects, i.e. the same jobs run by DedicatedThread, attached to the
+ * executor by PooledThread objects. Instead of having one thread per job, each worker repeatedly
+ * picks a task and calls its thread_one_step() a few times (up to STEPS_PER_SLICE) before putting
+ * it back in the queue, so tasks cooperatively yield the worker to each other:
+ *
+ * - When thread_one_step() returns true (progress has been made) the task is re-queued as soon
+ *   as its slice is over.
+ * - When thread_one_step() returns false (nothing to do, e.g. the task's input buffers are empty)
+ *   the task is parked until someone calls PooledThread::wake() or IDLE_TIMEOUT expires (the same
+ *   safety net DedicatedThread implements with a sleep()).
+ * - When ThreadMethod::thread_finished() returns true, the task is stopped, its
+ *   CancellationToken is cancelled or its PooledThread is stopped, the task is retired.
+ *
+ * Each worker has its own deque of runnable tasks. Tasks re-queued (or woken up) by a worker go to
+ * its own deque (so they tend to keep running in the same core) and idle workers steal tasks from
+ * the opposite end of the other workers' deques.
+ *
+ * Steps are supposed to be short and must not block waiting for another task: a step like that
+ * may deadlock the executor when all the workers are blocked.
+ *
+ * There are two executors shared by the whole process:
+ *
+ * - get_shared() is for CPU-bound tasks (e.g. operators combining answers) whose steps never
+ *   block. It has roughly one worker per core.
+ * - get_shared_io() is for tasks whose steps block on remote calls, e.g. AtomDB queries and
+ *   fetches or AttentionBroker requests. It has many more workers than cores because they spend
+ *   most of their time waiting for replies. It is sized so that a burst of slow calls doesn't
+ *   starve the other I/O tasks, and it never delays the CPU-bound tasks.
+ */
+class WorkStealingExecutor : public Processor {
+   public:
+    // Max number of consecutive steps of a task before it yields the worker to other tasks
+    static constexpr unsigned int STEPS_PER_SLICE = 64;
+    // Max time (in milliseconds) an idle task is kept parked without being woken up
+    static constexpr unsigned int IDLE_TIMEOUT = 100;
+    // Min number of workers of the executors returned by get_shared() and get_shared_io()
+    static constexpr unsigned int MIN_SHARED_THREADS = 4;
+    static constexpr unsigned int MIN_SHARED_IO_THREADS = 32;
+    // Workers per core of the executor returned by get_shared_io()
+    static constexpr unsigned int SHARED_IO_THREADS_PER_CORE = 4;
+
+    /**
+     * State of each task attached to the executor. It's managed by PooledThread and the
+     * executor's workers and is not supposed to be used directly.
+     */
+    class Task {
+       public:
+        enum State { WAITING_START = 0, QUEUED, RUNNING, PARKED, DONE };
+        Task(ThreadMethod* job, shared_ptr<CancellationToken> token);
+        ThreadMethod* job;
+        shared_ptr<CancellationToken> token;
+        State state;
+        bool wake_pending;
+        bool stop_flag;
+        unsigned long park_count;
+        mutex api_mutex;
+        condition_variable state_condition;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param id ID of this Processor.
+     * @param num_threads Number of worker threads.
+     */
+    WorkStealingExecutor(const string& id, unsigned int num_threads);
+    virtual ~WorkStealingExecutor();
+
+    /**
+     * Returns the executor shared by all the components of this process (it's set up and started
+     * on the first call).
+     *
+     * @return the executor shared by all the components of this process.
+     */
+    static shared_ptr<WorkStealingExecutor> get_shared();
+
+    /**
+     * Returns the executor shared by all the tasks of this process whose steps block on I/O
+     * (it's set up and started on the first call).
+     *
+     * @return the executor shared by all the I/O-bound tasks of this process.
+     */
+    static shared_ptr<WorkStealingExecutor> get_shared_io();
+
+    virtual void setup();
+    virtual void start();
+    virtual void stop();
+
+    /**
+     * Returns the number of worker threads.
+     *
+     * @return the number of worker threads.
+     */
+    unsigned int size();
+
+    /**
+     * Puts a task in the run queue. Used by PooledThread.
+     */
+    void schedule(shared_ptr<Task> task);
+
+    /**
+     * Moves a parked task back to the run queue (or makes sure it runs once more if it's
+     * currently running). Used by PooledThread.
+     */
+    void wake(shared_ptr<Task> task);
+
+    /**
+     * Blocks the caller until the task is not running any step and retires it so it doesn't run
+     * anymore. If called by the task itself (i.e. in its thread_one_step()) it doesn't block and
+     * the task is retired as soon as the current step returns. Used by PooledThread.
+     */
+    void retire(shared_ptr<Task> task);
+
+   private:
+    static shared_ptr<WorkStealingExecutor> create_shared(const string& id, unsigned int num_threads);
+
+    class Worker {
+       public:
+        mutex api_mutex;
+        deque<shared_ptr<Task>> tasks;
+        thread* thread_object = NULL;
+    };
+
+    class ParkedTask {
+       public:
+        chrono::steady_clock::time_point deadline;
+        unsigned long park_count;
+        shared_ptr<Task> task;
+        bool operator>(const ParkedTask& other) const { return this->deadline > other.deadline; }
+    };
+
+    void worker_method(unsigned int worker_index);
+    void push(shared_ptr<Task> task);
+    shared_ptr<Task> pop(unsigned int worker_index);
+    void run_slice(shared_ptr<Task> task);
+    void park(shared_ptr<Task> task, unsigned long park_count);
+    void release_expired_parked_tasks();
+    chrono::steady_clock::time_point next_deadline();
+
+    unsigned int num_threads;
+    vector<unique_ptr<Worker>> workers;
+    atomic<unsigned int> next_worker;
+    atomic<unsigned int> queued_count;
+    priority_queue<ParkedTask, vector<ParkedTask>, greater<ParkedTask>> parked_tasks;
+    mutex parked_tasks_mutex;
+    mutex sleep_mutex;
+    condition_variable sleep_condition;
+    bool stop_flag;
+};
+
+}  // namespace processor
@@ -21,6 +21,8 @@ BusNode::BusNode(const string& node_id,
                  const string& known_peer,
                  MessageBrokerType messaging_backend)
     : DistributedAlgorithmNode(node_id, LeadershipBrokerType::TRUSTED_BUS_PEER, messaging_backend) {
+    // Setting the owner of a command again is harmless so it can be re-sent by the MessageBroker
+    MessageBroker::add_idempotent_command(BusNode::SET_COMMAND_OWNERSHIP);
     this->bus = bus;
     this->trusted_known_peer_id = known_peer;
     this->my_commands = node_commands;
@@ -12,6 +12,8 @@ DistributedAlgorithmNode::DistributedAlgorithmNode(const string& node_id,
                                                    LeadershipBrokerType leadership_algorithm,
                                                    MessageBrokerType messaging_backend) {
     this->my_node_id = node_id;
+    // Adding a peer twice is harmless so it can be re-sent by the MessageBroker
+    MessageBroker::add_idempotent_command(this->known_commands.NODE_JOINED_NETWORK);
     this->leadership_broker = LeadershipBroker::factory(leadership_algorithm);
     this->message_broker =
         MessageBroker::factory(messaging_backend,
@@ -1,5 +1,6 @@
 #include "MessageBroker.h"
 
+#include <chrono>
 #include <grpcpp/channel.h>
 #include <grpcpp/client_context.h>
 #include <grpcpp/create_channel.h>
@@ -19,7 +20,11 @@
 using namespace distributed_algorithm_node;
 
 unsigned int SynchronousGRPC::MESSAGE_THREAD_COUNT = 10;
+unsigned int SynchronousGRPC::MAX_IN_FLIGHT_RPCS_PER_PEER = 32;
+unsigned int SynchronousGRPC::RPC_TIMEOUT = GRPCPeerChannel::DEFAULT_RPC_TIMEOUT;
 mutex SynchronousGRPC::GRPC_BUILDER_MUTEX;
+unordered_set<string> MessageBroker::IDEMPOTENT_COMMANDS;
+mutex MessageBroker::IDEMPOTENT_COMMANDS_MUTEX;
 unsigned int SynchronousSharedRAM::MESSAGE_THREAD_COUNT = 1;
 unordered_map<string, SharedQueue*> SynchronousSharedRAM::NODE_QUEUE;
 mutex SynchronousSharedRAM::NODE_QUEUE_MUTEX;
@@ -176,7 +181,7 @@ void SynchronousSharedRAM::inbox_thread_method(shared_ptr<StoppableThread> monit
             if (monitor->stopped()) {
                 stop_thread_loop = true;
             } else {
-                Utils::sleep();
+                this->incoming_messages.wait();
             }
         }
     } while (!stop_thread_loop);
@@ -194,9 +199,6 @@ void SynchronousGRPC::inbox_thread_method(shared_ptr<StoppableThread> monitor) {
                 unsigned int num_peers = this->peers.size();
                 this->peers_mutex.unlock();
                 if (num_peers > 0) {
-                    dasproto::Empty reply[num_peers];
-                    grpc::ClientContext context[num_peers];
-                    unsigned int cursor = 0;
                     unordered_set<string> visited;
                     int num_visited = message_data->visited_recipients_size();
                     for (int i = 0; i < num_visited; i++) {
@@ -207,16 +209,17 @@ void SynchronousGRPC::inbox_thread_method(shared_ptr<StoppableThread> monitor) {
                         continue;
                     }
                     message_data->add_visited_recipients(this->node_id);
+                    vector<string> targets;
                     this->peers_mutex.lock();
                     for (auto target : this->peers) {
                         if (visited.find(target) == visited.end()) {
-                            auto stub = dasproto::DistributedAlgorithmNode::NewStub(
-                                grpc::CreateChannel(target, grpc::InsecureChannelCredentials()));
-                            stub->execute_message(&(context[cursor]), *message_data, &(reply[cursor]));
-                            cursor++;
+                            targets.push_back(target);
                         }
                     }
                     this->peers_mutex.unlock();
+                    for (auto target : targets) {
+                        get_peer_channel(target)->execute_message(*message_data);
+                    }
                 }
             }
             string command = message_data->command();
@@ -237,7 +240,7 @@ void SynchronousGRPC::inbox_thread_method(shared_ptr<StoppableThread> monitor) {
             if (monitor->stopped()) {
                 stop_thread_loop = true;
             } else {
-                Utils::sleep();
+                this->incoming_messages.wait();
             }
         }
     } while (!stop_thread_loop);
@@ -268,6 +271,16 @@ void MessageBroker::stop() {
     this->stop_flag = true;
 }
 
+void MessageBroker::add_idempotent_command(const string& command) {
+    lock_guard<mutex> semaphore(IDEMPOTENT_COMMANDS_MUTEX);
+    IDEMPOTENT_COMMANDS.insert(command);
+}
+
+bool MessageBroker::is_idempotent_command(const string& command) {
+    lock_guard<mutex> semaphore(IDEMPOTENT_COMMANDS_MUTEX);
+    return IDEMPOTENT_COMMANDS.find(command) != IDEMPOTENT_COMMANDS.end();
+}
+
 bool MessageBroker::stopped() {
     lock_guard<mutex> semaphore(this->stop_flag_mutex);
     return this->stop_flag;
@@ -354,7 +367,23 @@ void SynchronousGRPC::join_network() {
     }
 }
 
-void SynchronousGRPC::add_peer(const string& peer_id) { MessageBroker::add_peer(peer_id); }
+void SynchronousGRPC::add_peer(const string& peer_id) {
+    MessageBroker::add_peer(peer_id);
+    get_peer_channel(peer_id);
+}
+
+shared_ptr<GRPCPeerChannel> SynchronousGRPC::get_peer_channel(const string& peer_id) {
+    lock_guard<mutex> semaphore(this->peer_channels_mutex);
+    auto iterator = this->peer_channels.find(peer_id);
+    if (iterator == this->peer_channels.end()) {
+        auto peer_channel =
+            make_shared<GRPCPeerChannel>(peer_id, MAX_IN_FLIGHT_RPCS_PER_PEER, RPC_TIMEOUT);
+        this->peer_channels[peer_id] = peer_channel;
+        return peer_channel;
+    } else {
+        return iterator->second;
+    }
+}
 
 void SynchronousGRPC::send(const string& command, const vector<string>& args, const string& recipient) {
     if (!is_peer(recipient)) {
@@ -367,38 +396,27 @@ void SynchronousGRPC::send(const string& command, const vector<string>& args, co
     }
     message_data.set_sender(this->node_id);
     message_data.set_is_broadcast(false);
-    dasproto::Empty reply;
-    grpc::ClientContext context;
-    auto stub = dasproto::DistributedAlgorithmNode::NewStub(
-        grpc::CreateChannel(recipient, grpc::InsecureChannelCredentials()));
-    stub->execute_message(&context, message_data, &reply);
+    get_peer_channel(recipient)->execute_message(message_data);
 }
 
 void SynchronousGRPC::broadcast(const string& command, const vector<string>& args) {
     this->peers_mutex.lock();
-    unsigned int num_peers = this->peers.size();
-    if (num_peers == 0) {
-        this->peers_mutex.unlock();
+    vector<string> targets(this->peers.begin(), this->peers.end());
+    this->peers_mutex.unlock();
+    if (targets.size() == 0) {
         return;
     }
-    dasproto::Empty reply[num_peers];
-    grpc::ClientContext context[num_peers];
-    unsigned int cursor = 0;
-    for (auto peer_id : this->peers) {
-        dasproto::MessageData message_data;
-        message_data.set_command(command);
-        for (auto arg : args) {
-            message_data.add_args(arg);
-        }
-        message_data.set_sender(this->node_id);
-        message_data.set_is_broadcast(true);
-        message_data.add_visited_recipients(this->node_id);
-        auto stub = dasproto::DistributedAlgorithmNode::NewStub(
-            grpc::CreateChannel(peer_id, grpc::InsecureChannelCredentials()));
-        stub->execute_message(&(context[cursor]), message_data, &(reply[cursor]));
-        cursor++;
+    dasproto::MessageData message_data;
+    message_data.set_command(command);
+    for (auto arg : args) {
+        message_data.add_args(arg);
+    }
+    message_data.set_sender(this->node_id);
+    message_data.set_is_broadcast(true);
+    message_data.add_visited_recipients(this->node_id);
+    for (auto peer_id : targets) {
+        get_peer_channel(peer_id)->execute_message(message_data);
     }
-    this->peers_mutex.unlock();
 }
 
 void SynchronousGRPC::set_grpc_server_started() {
@@ -439,6 +457,8 @@ void SynchronousGRPC::stop() {
         thread->stop();
     }
     grpc_thread->stop(true);
+    lock_guard<mutex> semaphore(this->peer_channels_mutex);
+    this->peer_channels.clear();
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -469,6 +489,119 @@ grpc::Status SynchronousGRPC::execute_message(grpc::ServerContext* grpc_context,
 // -------------------------------------------------------------------------------------------------
 // Common utility classes
 
+GRPCPeerChannel::GRPCPeerChannel(const string& peer_id,
+                                 unsigned int max_in_flight_rpcs,
+                                 unsigned int rpc_timeout) {
+    if (max_in_flight_rpcs == 0) {
+        RAISE_ERROR("Invalid max_in_flight_rpcs: 0");
+    }
+    if (rpc_timeout == 0) {
+        RAISE_ERROR("Invalid rpc_timeout: 0");
+    }
+    this->peer_id = peer_id;
+    this->max_in_flight_rpcs = max_in_flight_rpcs;
+    this->rpc_timeout = rpc_timeout;
+    this->in_flight_rpcs = 0;
+    this->connections = 0;
+    reconnect(nullptr);
+}
+
+GRPCPeerChannel::~GRPCPeerChannel() {}
+
+grpc::Status GRPCPeerChannel::execute_message(const dasproto::MessageData& message_data) {
+    acquire_rpc_slot();
+    auto stub = get_stub();
+    // If the channel isn't connected when the call is made, UNAVAILABLE means the connection
+    // attempt failed so the message hasn't reached the peer
+    bool connected = is_connected();
+    grpc::Status status = call(stub, message_data);
+    if (status.error_code() == grpc::StatusCode::UNAVAILABLE) {
+        reconnect(stub);
+        if (!connected || MessageBroker::is_idempotent_command(message_data.command())) {
+            LOG_DEBUG("Peer " + this->peer_id + " is unavailable. Reconnecting and retrying...");
+            status = call(get_stub(), message_data);
+        } else {
+            // The peer may have received the message so it's not sent again
+            LOG_DEBUG("Peer " + this->peer_id + " is unavailable. Reconnecting without retrying " +
+                      message_data.command());
+        }
+    }
+    release_rpc_slot();
+    if (!status.ok()) {
+        LOG_ERROR("Failed rpc to " + this->peer_id + ": " + status.error_message());
+    }
+    return status;
+}
+
+bool GRPCPeerChannel::is_healthy() {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    grpc_connectivity_state state = this->channel->GetState(false);
+    return ((state != GRPC_CHANNEL_TRANSIENT_FAILURE) && (state != GRPC_CHANNEL_SHUTDOWN));
+}
+
+unsigned int GRPCPeerChannel::connection_count() {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    return this->connections;
+}
+
+bool GRPCPeerChannel::is_connected() {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    return this->channel->GetState(false) == GRPC_CHANNEL_READY;
+}
+
+grpc::Status GRPCPeerChannel::call(shared_ptr<dasproto::DistributedAlgorithmNode::Stub> stub,
+                                   const dasproto::MessageData& message_data) {
+    grpc::ClientContext context;
+    context.set_deadline(chrono::system_clock::now() + chrono::milliseconds(this->rpc_timeout));
+    dasproto::Empty reply;
+    return stub->execute_message(&context, message_data, &reply);
+}
+
+void GRPCPeerChannel::acquire_rpc_slot() {
+    unique_lock<mutex> semaphore(this->api_mutex);
+    this->in_flight_condition.wait(semaphore,
+                                   [this] { return this->in_flight_rpcs < this->max_in_flight_rpcs; });
+    this->in_flight_rpcs++;
+}
+
+void GRPCPeerChannel::release_rpc_slot() {
+    {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        this->in_flight_rpcs--;
+    }
+    this->in_flight_condition.notify_one();
+}
+
+shared_ptr<dasproto::DistributedAlgorithmNode::Stub> GRPCPeerChannel::get_stub() {
+    shared_ptr<dasproto::DistributedAlgorithmNode::Stub> stub;
+    {
+        lock_guard<mutex> semaphore(this->api_mutex);
+        // GetState(true) also makes an idle channel try to connect
+        if (this->channel->GetState(true) != GRPC_CHANNEL_SHUTDOWN) {
+            return this->stub;
+        }
+        stub = this->stub;
+    }
+    reconnect(stub);
+    lock_guard<mutex> semaphore(this->api_mutex);
+    return this->stub;
+}
+
+void GRPCPeerChannel::reconnect(shared_ptr<dasproto::DistributedAlgorithmNode::Stub> broken_stub) {
+    lock_guard<mutex> semaphore(this->api_mutex);
+    if (this->stub != broken_stub) {
+        // Another thread has already re-created the channel
+        return;
+    }
+    grpc::ChannelArguments arguments;
+    arguments.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, 30000);
+    arguments.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, 10000);
+    this->channel =
+        grpc::CreateCustomChannel(this->peer_id, grpc::InsecureChannelCredentials(), arguments);
+    this->stub = dasproto::DistributedAlgorithmNode::NewStub(this->channel);
+    this->connections++;
+}
+
 CommandLinePackage::CommandLinePackage(const string& command, const vector<string>& args) {
     this->command = command;
     this->args = args;
@@ -1,8 +1,10 @@
 #ifndef _DISTRIBUTED_ALGORITHM_NODE_MESSAGEBROKER_H
 #define _DISTRIBUTED_ALGORITHM_NODE_MESSAGEBROKER_H
 
+#include <condition_variable>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -20,6 +22,7 @@ namespace distributed_algorithm_node {
 enum class MessageBrokerType { RAM, GRPC };
 
 class DistributedAlgorithmNode;
+class GRPCPeerChannel;
 
 // -------------------------------------------------------------------------------------------------
 // Abstract superclass
@@ -90,6 +93,21 @@ class MessageBroker : public Stoppable {
      */
     bool stopped();
 
+    /**
+     * Declares that executing the passed command more than once has the same effect as executing
+     * it once, so the MessageBroker is allowed to re-send it when it's not sure it has been
+     * delivered (see GRPCPeerChannel).
+     *
+     * @param command The idempotent command.
+     */
+    static void add_idempotent_command(const string& command);
+
+    /**
+     * Returns true iff the passed command has been declared idempotent (see
+     * add_idempotent_command()).
+     */
+    static bool is_idempotent_command(const string& command);
+
     // ----------------------------------------------------------------
     // Public abstract API
 
@@ -127,6 +145,10 @@ class MessageBroker : public Stoppable {
     bool stop_flag;
     mutex stop_flag_mutex;
     bool joined_network;
+
+   private:
+    static unordered_set<string> IDEMPOTENT_COMMANDS;
+    static mutex IDEMPOTENT_COMMANDS_MUTEX;
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -217,7 +239,11 @@ class SynchronousSharedRAM : public MessageBroker {
  * In addition to this, another queue is initialized for outgoing Messages and another thread is
  * started to observe this queue.
  *
- * A Client GRPC channel is created for each the newly inserted peer.
+ * A Client GRPC channel is created for each the newly inserted peer. Channels (and the stubs
+ * built on them) are kept in a per-peer cache and reused by all the subsequent rpc calls to the
+ * same peer. A channel found to be broken (shut down or failed rpc due to unavailability of the
+ * peer) is transparently re-created. The number of simultaneous in-flight rpc calls to each peer
+ * is bounded (see GRPCPeerChannel).
  *
  * So the SynchronousGRPC MessageBroker have:
  *
@@ -330,12 +356,18 @@ class SynchronousGRPC : public MessageBroker, public dasproto::DistributedAlgori
 
    private:
     static unsigned int MESSAGE_THREAD_COUNT;
+    static unsigned int MAX_IN_FLIGHT_RPCS_PER_PEER;
+    static unsigned int RPC_TIMEOUT;
     static mutex GRPC_BUILDER_MUTEX;
     unique_ptr<grpc::Server> grpc_server;
     shared_ptr<StoppableThread> grpc_thread;
     vector<shared_ptr<StoppableThread>> inbox_threads;
     SharedQueue incoming_messages;  // Thread safe container
     SharedQueue outgoing_messages;  // Thread safe container
+    unordered_map<string, shared_ptr<GRPCPeerChannel>> peer_channels;
+    mutex peer_channels_mutex;
+
+    shared_ptr<GRPCPeerChannel> get_peer_channel(const string& peer_id);
 
     bool grpc_server_started_flag;
     mutex grpc_server_started_flag_mutex;
@@ -355,6 +387,85 @@ class SynchronousGRPC : public MessageBroker, public dasproto::DistributedAlgori
 // -------------------------------------------------------------------------------------------------
 // Common utility classes
 
+/**
+ * Client side of the GRPC communication with a single peer.
+ *
+ * Keeps a GRPC channel and a stub which are reused by all rpc calls to the peer. Before each
+ * call, the state of the channel is checked and a new channel is created if the current one
+ * has been shut down. Each call has a deadline so a hung peer can't hold a caller (nor an rpc
+ * slot) forever.
+ *
+ * If an rpc fails because the peer is unavailable, the channel is re-created and the call is
+ * retried once, but only if the message is known not to have reached the peer (i.e. the channel
+ * wasn't connected when the call was made, so it's the connection attempt which failed) or its
+ * command is idempotent (see MessageBroker::add_idempotent_command()).
+ *
+ * The number of simultaneous in-flight rpc calls is bounded. Callers block in
+ * execute_message() until a slot is available.
+ */
+class GRPCPeerChannel {
+   public:
+    // Default max time (in milliseconds) of each rpc call
+    static constexpr unsigned int DEFAULT_RPC_TIMEOUT = 10000;
+
+    /**
+     * Constructor.
+     *
+     * @param peer_id Address (host:port) of the peer.
+     * @param max_in_flight_rpcs Max number of simultaneous rpc calls to the peer.
+     * @param rpc_timeout Max time (in milliseconds) of each rpc call.
+     */
+    GRPCPeerChannel(const string& peer_id,
+                    unsigned int max_in_flight_rpcs,
+                    unsigned int rpc_timeout = DEFAULT_RPC_TIMEOUT);
+
+    /**
+     * Destructor.
+     */
+    ~GRPCPeerChannel();
+
+    /**
+     * Sends a Message to the peer (blocking call).
+     *
+     * @param message_data The message being sent.
+     * @return The GRPC status of the rpc call.
+     */
+    grpc::Status execute_message(const dasproto::MessageData& message_data);
+
+    /**
+     * Returns true iff the underlying channel is not in a failure state.
+     *
+     * @return true iff the underlying channel is not in a failure state.
+     */
+    bool is_healthy();
+
+    /**
+     * Returns the number of times the underlying channel has been (re)created.
+     *
+     * @return The number of times the underlying channel has been (re)created.
+     */
+    unsigned int connection_count();
+
+   private:
+    string peer_id;
+    unsigned int max_in_flight_rpcs;
+    unsigned int rpc_timeout;
+    unsigned int in_flight_rpcs;
+    unsigned int connections;
+    shared_ptr<grpc::Channel> channel;
+    shared_ptr<dasproto::DistributedAlgorithmNode::Stub> stub;
+    mutex api_mutex;
+    condition_variable in_flight_condition;
+
+    void acquire_rpc_slot();
+    void release_rpc_slot();
+    shared_ptr<dasproto::DistributedAlgorithmNode::Stub> get_stub();
+    bool is_connected();
+    grpc::Status call(shared_ptr<dasproto::DistributedAlgorithmNode::Stub> stub,
+                      const dasproto::MessageData& message_data);
+    void reconnect(shared_ptr<dasproto::DistributedAlgorithmNode::Stub> broken_stub);
+};
+
 class CommandLinePackage {
    public:
     CommandLinePackage(const string& command, const vector<string>& args);
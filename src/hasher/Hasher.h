@@ -8,52 +8,130 @@
 using namespace std;
 namespace commons {
 
+/**
+ * Computation of DAS handles.
+ *
+ * Methods returning a string allocate only the returned string. Overloads writing in a caller
+ * provided buffer (with room for HANDLE_HASH_SIZE chars) don't allocate at all. Methods whose
+ * names end with "_digest" write the HANDLE_DIGEST_SIZE raw bytes of the handle instead (which
+ * is what commons::Handle::from_bytes() expects).
+ */
 class Hasher {
    public:
+    static inline void plain_string_hash(const string& str, char* output) {
+        compute_hash_into(str.data(), str.size(), output);
+    }
+
     static inline string plain_string_hash(const string& str) {
-        char* h = named_type_hash((char*) str.c_str());
-        string handle(h);
-        free(h);
-        return handle;
+        char handle[HANDLE_HASH_SIZE];
+        plain_string_hash(str, handle);
+        return string(handle, HANDLE_HASH_SIZE - 1);
     }
 
     static inline string context_handle(const string& name) { return plain_string_hash(name); }
 
     static inline string type_handle(const string& type) { return plain_string_hash(type); }
 
+    static inline void node_handle(const string& type, const string& name, char* output) {
+        terminal_hash_into(type.data(), type.size(), name.data(), name.size(), output);
+    }
+
+    static inline void node_digest(const string& type, const string& name, unsigned char* digest) {
+        HashBuilder builder;
+        builder.add(type.data(), type.size());
+        builder.add(name.data(), name.size());
+        builder.finish(digest);
+    }
+
     static inline string node_handle(const string& type, const string& name) {
-        char* h = terminal_hash((char*) type.c_str(), (char*) name.c_str());
-        string handle(h);
-        free(h);
-        return handle;
+        char handle[HANDLE_HASH_SIZE];
+        node_handle(type, name, handle);
+        return string(handle, HANDLE_HASH_SIZE - 1);
+    }
+
+    static inline void link_handle(const string& type, const vector<string>& targets, char* output) {
+        HashBuilder builder;
+        add_link_elements(builder, type, targets);
+        builder.finish_hex(output);
+    }
+
+    static inline void link_digest(const string& type,
+                                   const vector<string>& targets,
+                                   unsigned char* digest) {
+        HashBuilder builder;
+        add_link_elements(builder, type, targets);
+        builder.finish(digest);
     }
 
     static inline string link_handle(const string& type, const vector<string>& targets) {
-        unsigned int arity = targets.size();
-        char* type_hash = named_type_hash((char*) type.c_str());
-        char** t = new char*[arity];
-        for (unsigned int i = 0; i < arity; i++) {
-            t[i] = (char*) targets[i].c_str();
+        char handle[HANDLE_HASH_SIZE];
+        link_handle(type, targets, handle);
+        return string(handle, HANDLE_HASH_SIZE - 1);
+    }
+
+    static inline void composite_handle(const vector<string>& elements, char* output) {
+        HashBuilder builder;
+        for (const auto& element : elements) {
+            builder.add(element.data(), element.size());
         }
-        char* s = expression_hash(type_hash, t, arity);
-        string handle(s);
-        delete[] t;
-        free(type_hash);
-        free(s);
-        return handle;
+        builder.finish_hex(output);
     }
 
     static inline string composite_handle(const vector<string>& elements) {
-        unsigned int n = elements.size();
-        char** t = new char*[n];
-        for (unsigned int i = 0; i < n; i++) {
-            t[i] = (char*) elements[i].c_str();
+        char handle[HANDLE_HASH_SIZE];
+        composite_handle(elements, handle);
+        return string(handle, HANDLE_HASH_SIZE - 1);
+    }
+
+    /**
+     * Computes many composite handles at once using the multi-lane MD5 implementation (see
+     * compute_hash_batch()). Results are the same as calling composite_handle() for each entry.
+     *
+     * @param batch Elements of each composite handle being computed.
+     * @return The composite handles (in the same order as batch).
+     */
+    static inline vector<string> composite_handles(const vector<vector<string>>& batch) {
+        // All the joined inputs are laid out in a single buffer
+        string buffer;
+        vector<size_t> offsets;
+        vector<size_t> sizes;
+        offsets.reserve(batch.size());
+        sizes.reserve(batch.size());
+        for (const auto& elements : batch) {
+            size_t offset = buffer.size();
+            for (unsigned int i = 0; i < elements.size(); i++) {
+                if (i > 0) {
+                    buffer.push_back(JOINING_CHAR);
+                }
+                buffer.append(elements[i]);
+            }
+            offsets.push_back(offset);
+            sizes.push_back(buffer.size() - offset);
+        }
+        vector<const char*> inputs(batch.size());
+        for (unsigned int i = 0; i < batch.size(); i++) {
+            inputs[i] = buffer.data() + offsets[i];
+        }
+        vector<char> hashes(batch.size() * HANDLE_HASH_SIZE);
+        compute_hash_batch(inputs.data(), sizes.data(), batch.size(), hashes.data());
+        vector<string> handles;
+        handles.reserve(batch.size());
+        for (unsigned int i = 0; i < batch.size(); i++) {
+            handles.emplace_back(hashes.data() + i * HANDLE_HASH_SIZE, HANDLE_HASH_SIZE - 1);
+        }
+        return handles;
+    }
+
+   private:
+    static inline void add_link_elements(HashBuilder& builder,
+                                         const string& type,
+                                         const vector<string>& targets) {
+        char type_hash[HANDLE_HASH_SIZE];
+        plain_string_hash(type, type_hash);
+        builder.add(type_hash, HANDLE_HASH_SIZE - 1);
+        for (const auto& target : targets) {
+            builder.add(target.data(), target.size());
         }
-        char* s = composite_hash(t, n);
-        string handle(s);
-        delete[] t;
-        free(s);
-        return handle;
     }
 };
 
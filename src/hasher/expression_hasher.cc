@@ -1,79 +1,303 @@
 #include "expression_hasher.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include "mbedtls/md5.h"
+#include <algorithm>
+#include <vector>
+
+// -------------------------------------------------------------------------------------------------
+// Legacy API
 
 char* compute_hash(char* input) {
-    unsigned char md5_buffer[16];
     char* hash = new char[HANDLE_HASH_SIZE];
-
-    mbedtls_md5_context context;
-    mbedtls_md5_init(&context);
-    mbedtls_md5_starts(&context);
-    mbedtls_md5_update(&context, (const unsigned char*) input, strlen(input));
-    mbedtls_md5_finish(&context, md5_buffer);
-    mbedtls_md5_free(&context);
-    for (unsigned int i = 0; i < 16; i++) {
-        sprintf((char*) ((unsigned long) hash + 2 * i), "%02x", md5_buffer[i]);
-    }
-    hash[32] = '\0';
+    compute_hash_into(input, strlen(input), hash);
     return hash;
 }
 
 char* named_type_hash(char* name) { return compute_hash(name); }
 
 char* terminal_hash(char* type, char* name) {
-    char hashable_string[MAX_HASHABLE_STRING_SIZE];
-
-    if (strlen(type) + strlen(name) >= MAX_HASHABLE_STRING_SIZE) {
-        fprintf(stderr, "Invalid (too large) terminal name");
-        exit(1);
-    }
-    sprintf(hashable_string, "%s%c%s", type, JOINING_CHAR, name);
-    return compute_hash(hashable_string);
+    char* hash = new char[HANDLE_HASH_SIZE];
+    terminal_hash_into(type, strlen(type), name, strlen(name), hash);
+    return hash;
 }
 
 char* composite_hash(char** elements, unsigned int nelements) {
-    char hashable_string[MAX_HASHABLE_STRING_SIZE];
-    unsigned int total_size = 0;
-    unsigned int element_size[nelements];
+    HashBuilder builder;
+    for (unsigned int i = 0; i < nelements; i++) {
+        builder.add(elements[i], strlen(elements[i]));
+    }
+    char* hash = new char[HANDLE_HASH_SIZE];
+    builder.finish_hex(hash);
+    return hash;
+}
 
+char* expression_hash(char* type_hash, char** elements, unsigned int nelements) {
+    HashBuilder builder;
+    builder.add(type_hash, strlen(type_hash));
     for (unsigned int i = 0; i < nelements; i++) {
-        unsigned int size = strlen(elements[i]);
-        if (size > MAX_LITERAL_OR_SYMBOL_SIZE) {
-            fprintf(stderr, "Invalid (too large) composite elements");
-            exit(1);
-        }
-        element_size[i] = size;
-        total_size += size;
+        builder.add(elements[i], strlen(elements[i]));
     }
-    if (total_size >= MAX_HASHABLE_STRING_SIZE) {
-        fprintf(stderr, "Invalid (too large) composite elements");
-        exit(1);
+    char* hash = new char[HANDLE_HASH_SIZE];
+    builder.finish_hex(hash);
+    return hash;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Allocation-free API
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+void digest_to_hex(const unsigned char* digest, char* output) {
+    for (unsigned int i = 0; i < HANDLE_DIGEST_SIZE; i++) {
+        output[2 * i] = HEX_DIGITS[digest[i] >> 4];
+        output[2 * i + 1] = HEX_DIGITS[digest[i] & 0x0F];
     }
+    output[2 * HANDLE_DIGEST_SIZE] = '\0';
+}
+
+HashBuilder::HashBuilder() {
+    this->empty = true;
+    mbedtls_md5_init(&this->context);
+    mbedtls_md5_starts(&this->context);
+}
+
+HashBuilder::~HashBuilder() { mbedtls_md5_free(&this->context); }
+
+void HashBuilder::add(const char* element, size_t size) {
+    if (this->empty) {
+        this->empty = false;
+    } else {
+        const unsigned char joining_char = (unsigned char) JOINING_CHAR;
+        mbedtls_md5_update(&this->context, &joining_char, 1);
+    }
+    mbedtls_md5_update(&this->context, (const unsigned char*) element, size);
+}
 
-    unsigned long cursor = 0;
+void HashBuilder::finish(unsigned char* digest) { mbedtls_md5_finish(&this->context, digest); }
+
+void HashBuilder::finish_hex(char* output) {
+    unsigned char digest[HANDLE_DIGEST_SIZE];
+    finish(digest);
+    digest_to_hex(digest, output);
+}
+
+void compute_digest(const char* input, size_t size, unsigned char* digest) {
+    HashBuilder builder;
+    builder.add(input, size);
+    builder.finish(digest);
+}
+
+void compute_hash_into(const char* input, size_t size, char* output) {
+    HashBuilder builder;
+    builder.add(input, size);
+    builder.finish_hex(output);
+}
+
+void terminal_hash_into(
+    const char* type, size_t type_size, const char* name, size_t name_size, char* output) {
+    HashBuilder builder;
+    builder.add(type, type_size);
+    builder.add(name, name_size);
+    builder.finish_hex(output);
+}
+
+void composite_hash_into(const char* const* elements,
+                         const size_t* sizes,
+                         unsigned int nelements,
+                         char* output) {
+    HashBuilder builder;
     for (unsigned int i = 0; i < nelements; i++) {
-        if (i == (nelements - 1)) {
-            strcpy((char*) (hashable_string + cursor), elements[i]);
+        builder.add(elements[i], sizes[i]);
+    }
+    builder.finish_hex(output);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Batch (multi-lane) MD5
+
+namespace {
+
+const uint32_t MD5_K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+const unsigned int MD5_S[64] = {7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22,
+                                5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20,
+                                4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23,
+                                6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21};
+
+const uint32_t MD5_INITIAL_STATE[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
+const unsigned int MD5_BLOCK_SIZE = 64;
+
+// One input message seen as a sequence of 64-byte blocks. All the blocks but the last one or two
+// are read in place. The last ones (remaining bytes + MD5 padding + message length) are built
+// in the tail buffer.
+class Md5Message {
+   public:
+    void init(const char* input, size_t size) {
+        this->data = (const unsigned char*) input;
+        this->full_blocks = size / MD5_BLOCK_SIZE;
+        size_t remaining = size % MD5_BLOCK_SIZE;
+        this->tail_blocks = (remaining + 1 + 8 > MD5_BLOCK_SIZE) ? 2 : 1;
+        memset(this->tail, 0, sizeof(this->tail));
+        memcpy(this->tail, this->data + this->full_blocks * MD5_BLOCK_SIZE, remaining);
+        this->tail[remaining] = 0x80;
+        uint64_t bit_count = ((uint64_t) size) << 3;
+        unsigned char* length = this->tail + this->tail_blocks * MD5_BLOCK_SIZE - 8;
+        for (unsigned int i = 0; i < 8; i++) {
+            length[i] = (unsigned char) (bit_count >> (8 * i));
+        }
+    }
+
+    inline size_t block_count() const { return this->full_blocks + this->tail_blocks; }
+
+    inline const unsigned char* block(size_t index) const {
+        if (index < this->full_blocks) {
+            return this->data + index * MD5_BLOCK_SIZE;
         } else {
-            sprintf((char*) (hashable_string + cursor), "%s%c", elements[i], JOINING_CHAR);
-            cursor += 1;
+            return this->tail + (index - this->full_blocks) * MD5_BLOCK_SIZE;
+        }
+    }
+
+   private:
+    const unsigned char* data;
+    size_t full_blocks;
+    unsigned int tail_blocks;
+    unsigned char tail[2 * MD5_BLOCK_SIZE];
+};
+
+inline uint32_t rotate_left(uint32_t x, unsigned int n) { return (x << n) | (x >> (32 - n)); }
+
+// Hashes up to HASH_BATCH_LANES messages in lockstep. Lanes without a message (or whose message
+// has already been consumed) are computed anyway but their results are discarded.
+void md5_lanes(Md5Message* messages, unsigned int count, unsigned char** digests) {
+    const unsigned int L = HASH_BATCH_LANES;
+    uint32_t state[4][L];
+    size_t block_count[L];
+    size_t max_block_count = 0;
+    for (unsigned int lane = 0; lane < L; lane++) {
+        for (unsigned int i = 0; i < 4; i++) {
+            state[i][lane] = MD5_INITIAL_STATE[i];
         }
-        cursor += element_size[i];
+        block_count[lane] = (lane < count) ? messages[lane].block_count() : 0;
+        max_block_count = std::max(max_block_count, block_count[lane]);
     }
 
-    return compute_hash(hashable_string);
+    uint32_t words[16][L];
+    uint32_t a[L], b[L], c[L], d[L];
+    for (size_t block = 0; block < max_block_count; block++) {
+        for (unsigned int lane = 0; lane < L; lane++) {
+            if (block < block_count[lane]) {
+                const unsigned char* p = messages[lane].block(block);
+                for (unsigned int i = 0; i < 16; i++, p += 4) {
+                    words[i][lane] = ((uint32_t) p[0]) | (((uint32_t) p[1]) << 8) |
+                                     (((uint32_t) p[2]) << 16) | (((uint32_t) p[3]) << 24);
+                }
+            } else {
+                for (unsigned int i = 0; i < 16; i++) {
+                    words[i][lane] = 0;
+                }
+            }
+            a[lane] = state[0][lane];
+            b[lane] = state[1][lane];
+            c[lane] = state[2][lane];
+            d[lane] = state[3][lane];
+        }
+        for (unsigned int step = 0; step < 64; step++) {
+            unsigned int round = step / 16;
+            unsigned int g;
+            if (round == 0) {
+                g = step;
+            } else if (round == 1) {
+                g = (5 * step + 1) % 16;
+            } else if (round == 2) {
+                g = (3 * step + 5) % 16;
+            } else {
+                g = (7 * step) % 16;
+            }
+            for (unsigned int lane = 0; lane < L; lane++) {
+                uint32_t f;
+                if (round == 0) {
+                    f = (b[lane] & c[lane]) | (~b[lane] & d[lane]);
+                } else if (round == 1) {
+                    f = (d[lane] & b[lane]) | (~d[lane] & c[lane]);
+                } else if (round == 2) {
+                    f = b[lane] ^ c[lane] ^ d[lane];
+                } else {
+                    f = c[lane] ^ (b[lane] | ~d[lane]);
+                }
+                f += a[lane] + MD5_K[step] + words[g][lane];
+                a[lane] = d[lane];
+                d[lane] = c[lane];
+                c[lane] = b[lane];
+                b[lane] += rotate_left(f, MD5_S[step]);
+            }
+        }
+        for (unsigned int lane = 0; lane < L; lane++) {
+            if (block < block_count[lane]) {
+                state[0][lane] += a[lane];
+                state[1][lane] += b[lane];
+                state[2][lane] += c[lane];
+                state[3][lane] += d[lane];
+            }
+        }
+    }
+
+    for (unsigned int lane = 0; lane < count; lane++) {
+        for (unsigned int i = 0; i < 4; i++) {
+            for (unsigned int j = 0; j < 4; j++) {
+                digests[lane][4 * i + j] = (unsigned char) (state[i][lane] >> (8 * j));
+            }
+        }
+    }
 }
 
-char* expression_hash(char* type_hash, char** elements, unsigned int nelements) {
-    char* composite[nelements + 1];
-    composite[0] = type_hash;
-    for (unsigned int i = 0; i < nelements; i++) {
-        composite[i + 1] = elements[i];
+}  // namespace
+
+void compute_digest_batch(const char* const* inputs,
+                          const size_t* sizes,
+                          unsigned int count,
+                          unsigned char* digests) {
+    // Inputs are grouped by size so lanes hashed together have (nearly) the same number of
+    // blocks and few lane cycles are wasted.
+    std::vector<unsigned int> order(count);
+    for (unsigned int i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [sizes](unsigned int i, unsigned int j) {
+        return (sizes[i] / MD5_BLOCK_SIZE) < (sizes[j] / MD5_BLOCK_SIZE);
+    });
+    Md5Message messages[HASH_BATCH_LANES];
+    unsigned char* lane_digests[HASH_BATCH_LANES];
+    for (unsigned int cursor = 0; cursor < count; cursor += HASH_BATCH_LANES) {
+        unsigned int n = std::min(HASH_BATCH_LANES, count - cursor);
+        for (unsigned int lane = 0; lane < n; lane++) {
+            unsigned int index = order[cursor + lane];
+            messages[lane].init(inputs[index], sizes[index]);
+            lane_digests[lane] = digests + index * HANDLE_DIGEST_SIZE;
+        }
+        md5_lanes(messages, n, lane_digests);
+    }
+}
+
+void compute_hash_batch(const char* const* inputs,
+                        const size_t* sizes,
+                        unsigned int count,
+                        char* outputs) {
+    std::vector<unsigned char> digests(count * HANDLE_DIGEST_SIZE);
+    compute_digest_batch(inputs, sizes, count, digests.data());
+    for (unsigned int i = 0; i < count; i++) {
+        digest_to_hex(digests.data() + i * HANDLE_DIGEST_SIZE, outputs + i * HANDLE_HASH_SIZE);
     }
-    return composite_hash(composite, nelements + 1);
 }
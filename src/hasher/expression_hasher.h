@@ -1,12 +1,94 @@
 #pragma once
 
+#include <stddef.h>
+
+#include "mbedtls/md5.h"
+
 #define JOINING_CHAR ((char) ' ')
 #define MAX_LITERAL_OR_SYMBOL_SIZE ((size_t) 10000)
 #define MAX_HASHABLE_STRING_SIZE ((size_t) 100000)
 #define HANDLE_HASH_SIZE ((unsigned int) 33)
+#define HANDLE_DIGEST_SIZE ((unsigned int) 16)
+#define HASH_BATCH_LANES ((unsigned int) 4)
+
+// Legacy API. Returned hashes are allocated with new[] and are supposed to be released by the caller
+// with delete[].
 
 char* compute_hash(char* input);
 char* named_type_hash(char* name);
 char* terminal_hash(char* type, char* name);
 char* expression_hash(char* type_hash, char** elements, unsigned int nelements);
 char* composite_hash(char** elements, unsigned int nelements);
+
+// Allocation-free API. Hex hashes are written in caller-provided buffers with (at least)
+// HANDLE_HASH_SIZE chars (32 hex digits + NULL char). Digests are the HANDLE_DIGEST_SIZE raw bytes
+// of the same hashes (see commons::Handle::from_bytes()). Element sizes are passed explicitly so
+// there's no strlen() or concatenation of the hashed strings.
+
+/**
+ * Incremental computation of a composite hash, i.e. the hash of the passed elements joined by
+ * JOINING_CHAR. No concatenated copy of the elements is built.
+ */
+class HashBuilder {
+   public:
+    HashBuilder();
+    ~HashBuilder();
+
+    /**
+     * Appends an element (a JOINING_CHAR is hashed before every element but the first one).
+     */
+    void add(const char* element, size_t size);
+
+    /**
+     * Finishes the computation writing the HANDLE_DIGEST_SIZE bytes of the hash in digest.
+     * The builder can't be used after this call.
+     */
+    void finish(unsigned char* digest);
+
+    /**
+     * Finishes the computation writing the NULL-terminated hex representation of the hash in
+     * output. The builder can't be used after this call.
+     */
+    void finish_hex(char* output);
+
+   private:
+    mbedtls_md5_context context;
+    bool empty;
+};
+
+void digest_to_hex(const unsigned char* digest, char* output);
+void compute_digest(const char* input, size_t size, unsigned char* digest);
+void compute_hash_into(const char* input, size_t size, char* output);
+void terminal_hash_into(
+    const char* type, size_t type_size, const char* name, size_t name_size, char* output);
+void composite_hash_into(const char* const* elements,
+                         const size_t* sizes,
+                         unsigned int nelements,
+                         char* output);
+
+/**
+ * Computes the digests of count independent inputs. Inputs are hashed HASH_BATCH_LANES at a time
+ * by an interleaved MD5 implementation (each step of the MD5 compression function is computed for
+ * all lanes before moving to the next one) which allows the compiler to use SIMD instructions and
+ * keeps the CPU pipeline busy. Results are the same as compute_digest().
+ *
+ * @param inputs Inputs being hashed.
+ * @param sizes Size of each input.
+ * @param count Number of inputs.
+ * @param digests Output buffer with room for count * HANDLE_DIGEST_SIZE bytes. Digest of the i-th
+ * input is written at digests + i * HANDLE_DIGEST_SIZE.
+ */
+void compute_digest_batch(const char* const* inputs,
+                          const size_t* sizes,
+                          unsigned int count,
+                          unsigned char* digests);
+
+/**
+ * Same as compute_digest_batch() but writing the hex representations of the hashes. outputs is
+ * supposed to have room for count * HANDLE_HASH_SIZE chars. Hash of the i-th input is written
+ * (NULL-terminated) at outputs + i * HANDLE_HASH_SIZE.
+ */
+void compute_hash_batch(const char* const* inputs,
+                        const size_t* sizes,
+                        unsigned int count,
+                        char* outputs);
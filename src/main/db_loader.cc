@@ -10,6 +10,7 @@
 #include "AtomDBFactory.h"
 #include "JsonConfig.h"
 #include "JsonConfigParser.h"
+#include "MettaFileLoader.h"
 #include "MettaParser.h"
 #include "MettaParserActions.h"
 #include "RedisMongoDB.h"
@@ -23,6 +24,7 @@ using namespace atomdb;
 using namespace metta;
 using namespace atoms;
 using namespace commons;
+using namespace mains;
 
 static string flag_from_argv_or(int argc,
                                 char* argv[],
@@ -50,7 +52,10 @@ int main(int argc, char* argv[]) {
     // --links=1000000 --arity=3 --chunk=5000"
     //
     // make run-db-loader OPTIONS="--config=config/das.json --context=test_1m_ --file=/path/to/file.metta
-    // --threads=8 --chunk=5000"
+    // --threads=8 --writers=4 --queue=8 --chunk=5000"
+    //
+    // Files are loaded in streaming mode by default (multi-line expressions are allowed). Use
+    // --mode=lines to load files with exactly one toplevel expression per line.
 
     string config_path = flag_from_argv_or(argc, argv, "--config=", "");
     if (config_path.empty()) {
@@ -65,6 +70,13 @@ int main(int argc, char* argv[]) {
     int num_links = Utils::string_to_int(flag_from_argv_or(argc, argv, "--links=", "1000000"));
     int arity = Utils::string_to_int(flag_from_argv_or(argc, argv, "--arity=", "3"));
     int chunk_size = Utils::string_to_int(flag_from_argv_or(argc, argv, "--chunk=", "5000"));
+    string mode = flag_from_argv_or(argc, argv, "--mode=", "stream");
+    int num_writers = Utils::string_to_int(flag_from_argv_or(argc, argv, "--writers=", "4"));
+    int queue_size = Utils::string_to_int(flag_from_argv_or(argc, argv, "--queue=", "8"));
+    if ((mode != "stream") && (mode != "lines")) {
+        RAISE_ERROR("Invalid --mode: " + mode + " (expected stream or lines)");
+        return 1;
+    }
 
     JsonConfig json_config = JsonConfigParser::load(config_path);
     auto atomdb_config = json_config.at_path("atomdb").get_or<JsonConfig>(JsonConfig());
@@ -74,7 +86,12 @@ int main(int argc, char* argv[]) {
     signal(SIGINT, &ctrl_c_handler);
     signal(SIGTERM, &ctrl_c_handler);
 
-    if (!file_path.empty()) {
+    if (!file_path.empty() && (mode == "stream")) {
+        STOP_WATCH_START(db_loader_from_file);
+        MettaFileLoader loader(atomdb, num_threads, num_writers, chunk_size, queue_size);
+        loader.load(file_path);
+        STOP_WATCH_FINISH(db_loader_from_file, "DBLoaderFromFile");
+    } else if (!file_path.empty()) {
         STOP_WATCH_START(db_loader_from_file);
 
         ifstream file(file_path);
@@ -0,0 +1,312 @@
+#include "MettaFileLoader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MettaParser.h"
+#include "Utils.h"
+
+#define LOG_LEVEL INFO_LEVEL
+#include "Logger.h"
+
+using namespace mains;
+using namespace atomdb;
+using namespace atoms;
+using namespace metta;
+
+static inline bool is_blank(char c) { return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t'); }
+
+static inline bool is_token_end(char c) { return is_blank(c) || (c == '(') || (c == ')'); }
+
+// Returns the position right after the string literal starting at cursor (same rules as
+// MettaLexer: a '\' escapes the following char).
+static size_t string_literal_end(const char* data, size_t size, size_t cursor) {
+    bool escape_flag = false;
+    for (cursor++; cursor < size; cursor++) {
+        if (escape_flag) {
+            escape_flag = false;
+        } else if (data[cursor] == '\\') {
+            escape_flag = true;
+        } else if (data[cursor] == '"') {
+            return cursor + 1;
+        }
+    }
+    return size;
+}
+
+// Returns the position right after the toplevel expression (or token) starting at cursor. String
+// literals are only recognized at the start of a token, exactly as in MettaLexer. Unbalanced
+// expressions go up to the end of the input (the parser will report the error).
+static size_t expression_end(const char* data, size_t size, size_t cursor) {
+    if (data[cursor] == ')') {
+        return cursor + 1;
+    }
+    if (data[cursor] != '(') {
+        if (data[cursor] == '"') {
+            return string_literal_end(data, size, cursor);
+        }
+        while ((cursor < size) && !is_token_end(data[cursor])) {
+            cursor++;
+        }
+        return cursor;
+    }
+    unsigned int depth = 0;
+    while (cursor < size) {
+        char c = data[cursor];
+        if ((c == '"') && is_token_end(data[cursor - 1])) {
+            cursor = string_literal_end(data, size, cursor);
+            continue;
+        }
+        if (c == '(') {
+            depth++;
+        } else if (c == ')') {
+            if (--depth == 0) {
+                return cursor + 1;
+            }
+        }
+        cursor++;
+    }
+    return size;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Constructors and destructors
+
+MettaFileLoader::MettaFileLoader(shared_ptr<AtomDB> atomdb,
+                                 unsigned int parser_threads,
+                                 unsigned int writer_threads,
+                                 unsigned int chunk_size,
+                                 unsigned int queue_size)
+    : chunk_queue(queue_size), batch_queue(queue_size) {
+    if ((parser_threads == 0) || (writer_threads == 0) || (chunk_size == 0)) {
+        RAISE_ERROR("Invalid MettaFileLoader parameters: threads and chunk size must be > 0");
+    }
+    this->atomdb = atomdb;
+    this->parser_threads = parser_threads;
+    this->writer_threads = writer_threads;
+    this->chunk_size = chunk_size;
+    this->progress_interval = 10;
+    this->file_size = 0;
+    this->start_time = 0;
+    this->bytes_scanned = 0;
+    this->expressions_parsed = 0;
+    this->atoms_committed = 0;
+    this->parse_errors = 0;
+    this->write_errors = 0;
+    this->loading = false;
+}
+
+MettaFileLoader::~MettaFileLoader() {}
+
+// -------------------------------------------------------------------------------------------------
+// Public methods
+
+void MettaFileLoader::set_progress_interval(unsigned int seconds) { this->progress_interval = seconds; }
+
+void MettaFileLoader::load(const string& file_name) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        RAISE_ERROR("Couldn't open file: " + file_name);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        RAISE_ERROR("Couldn't stat file: " + file_name);
+    }
+    this->file_size = file_stat.st_size;
+    if (this->file_size == 0) {
+        close(fd);
+        LOG_INFO("File is empty: " + file_name);
+        return;
+    }
+    void* data = mmap(NULL, this->file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        RAISE_ERROR("Couldn't mmap file: " + file_name);
+    }
+    madvise(data, this->file_size, MADV_SEQUENTIAL);
+
+    LOG_INFO("Loading " + file_name + " (" + std::to_string(this->file_size) + " bytes) with " +
+             std::to_string(this->parser_threads) + " parser threads and " +
+             std::to_string(this->writer_threads) + " writer threads (chunk size: " +
+             std::to_string(this->chunk_size) + " expressions)");
+    this->start_time = Utils::get_current_time_millis();
+    this->loading = true;
+    vector<thread> parsers;
+    vector<thread> writers;
+    for (unsigned int i = 0; i < this->parser_threads; i++) {
+        parsers.emplace_back(&MettaFileLoader::parser_loop, this);
+    }
+    for (unsigned int i = 0; i < this->writer_threads; i++) {
+        writers.emplace_back(&MettaFileLoader::writer_loop, this);
+    }
+    thread progress(&MettaFileLoader::progress_loop, this);
+
+    scan((const char*) data, this->file_size);
+    this->chunk_queue.close();
+    for (auto& parser : parsers) {
+        parser.join();
+    }
+    this->batch_queue.close();
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    {
+        lock_guard<mutex> semaphore(this->progress_mutex);
+        this->loading = false;
+    }
+    this->progress_condition.notify_all();
+    progress.join();
+    munmap(data, this->file_size);
+    log_progress(true);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Private methods
+
+void MettaFileLoader::scan(const char* data, size_t size) {
+    Chunk chunk;
+    size_t cursor = 0;
+    while (cursor < size) {
+        if (is_blank(data[cursor])) {
+            cursor++;
+            continue;
+        }
+        size_t start = cursor;
+        cursor = expression_end(data, size, cursor);
+        if (chunk.begin == NULL) {
+            chunk.begin = data + start;
+        }
+        chunk.expressions.push_back({(data + start) - chunk.begin, cursor - start});
+        chunk.size = (data + cursor) - chunk.begin;
+        if ((chunk.expressions.size() >= this->chunk_size) || (chunk.size >= MAX_CHUNK_BYTES)) {
+            this->chunk_queue.push(std::move(chunk));
+            chunk = Chunk();
+            this->bytes_scanned = cursor;
+        }
+    }
+    if (chunk.begin != NULL) {
+        this->chunk_queue.push(std::move(chunk));
+    }
+    this->bytes_scanned = size;
+}
+
+bool MettaFileLoader::parse(shared_ptr<MettaLexer> lexer,
+                            const char* text,
+                            size_t size,
+                            AtomBatch& batch) {
+    auto parser_actions = make_shared<MettaParserActions>();
+    lexer->reset();
+    try {
+        lexer->attach_string(string(text, size));
+        MettaParser parser(lexer, parser_actions);
+        if (parser.parse(false)) {
+            return false;
+        }
+    } catch (const exception& exception) {
+        LOG_ERROR("Error parsing MeTTa expression(s): " + string(exception.what()));
+        return false;
+    }
+    for (const auto& pair : parser_actions->handle_to_atom) {
+        if (!batch.handles.insert(pair.first).second) {
+            continue;
+        }
+        Atom* atom = pair.second.get();
+        if (atom->arity() > 0) {
+            auto iterator = parser_actions->handle_to_metta_expression.find(pair.first);
+            if (iterator != parser_actions->handle_to_metta_expression.end()) {
+                atom->custom_attributes["metta_expression"] = iterator->second;
+            }
+        }
+        batch.atoms.push_back(atom);
+    }
+    // Not needed anymore (only atoms are kept until the batch is committed)
+    parser_actions->handle_to_metta_expression.clear();
+    parser_actions->metta_expressions.clear();
+    batch.parser_actions.push_back(parser_actions);
+    return true;
+}
+
+void MettaFileLoader::parser_loop() {
+    size_t lexer_buffer_size = MAX_CHUNK_BYTES;
+    auto lexer = make_shared<MettaLexer>(lexer_buffer_size);
+    Chunk chunk;
+    while (this->chunk_queue.pop(chunk)) {
+        if (chunk.size > lexer_buffer_size) {
+            lexer_buffer_size = chunk.size;
+            lexer = make_shared<MettaLexer>(lexer_buffer_size);
+        }
+        AtomBatch batch;
+        if (!parse(lexer, chunk.begin, chunk.size, batch)) {
+            // Parse expressions one by one to discard only the invalid ones
+            batch = AtomBatch();
+            for (const auto& expression : chunk.expressions) {
+                if (!parse(lexer, chunk.begin + expression.first, expression.second, batch)) {
+                    this->parse_errors++;
+                    LOG_ERROR("Discarding invalid MeTTa expression: " +
+                              string(chunk.begin + expression.first, expression.second));
+                }
+            }
+        }
+        this->expressions_parsed += chunk.expressions.size();
+        batch.handles.clear();
+        if (!batch.atoms.empty()) {
+            this->batch_queue.push(std::move(batch));
+        }
+    }
+}
+
+void MettaFileLoader::writer_loop() {
+    AtomBatch batch;
+    while (this->batch_queue.pop(batch)) {
+        try {
+            this->atomdb->add_atoms(batch.atoms, true);
+            this->atoms_committed += batch.atoms.size();
+        } catch (const exception& exception) {
+            this->write_errors += batch.atoms.size();
+            LOG_ERROR("Failed to commit " + std::to_string(batch.atoms.size()) +
+                      " atoms: " + string(exception.what()));
+        }
+        batch = AtomBatch();
+    }
+}
+
+void MettaFileLoader::progress_loop() {
+    unique_lock<mutex> lock(this->progress_mutex);
+    while (this->loading) {
+        if (this->progress_interval == 0) {
+            this->progress_condition.wait(lock, [this] { return !this->loading; });
+        } else {
+            this->progress_condition.wait_for(lock, chrono::seconds(this->progress_interval), [this] {
+                return !this->loading;
+            });
+            if (this->loading) {
+                log_progress(false);
+            }
+        }
+    }
+}
+
+void MettaFileLoader::log_progress(bool final_report) {
+    unsigned long elapsed = Utils::get_current_time_millis() - this->start_time;
+    unsigned long atoms = this->atoms_committed.load();
+    unsigned long throughput = (elapsed > 0) ? (atoms * 1000) / elapsed : atoms;
+    string message = final_report ? "Done. " : "Progress: ";
+    if (!final_report) {
+        size_t percentage = (100 * this->bytes_scanned.load()) / this->file_size;
+        message += std::to_string(percentage) + "% of input scanned | ";
+    }
+    message += std::to_string(this->expressions_parsed.load()) + " expressions parsed | " +
+               std::to_string(atoms) + " atoms committed | " + std::to_string(throughput) +
+               " atoms/s | " + std::to_string(this->parse_errors.load()) + " parse errors | " +
+               std::to_string(this->write_errors.load()) + " atoms failed to commit";
+    if (final_report) {
+        message += " | " + std::to_string(elapsed / 1000.0) + " s";
+    } else {
+        message += " | queued chunks: " + std::to_string(this->chunk_queue.size()) +
+                   " | queued batches: " + std::to_string(this->batch_queue.size());
+    }
+    LOG_INFO(message);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AtomDB.h"
+#include "BoundedQueue.h"
+#include "MettaLexer.h"
+#include "MettaParserActions.h"
+
+using namespace std;
+using namespace commons;
+
+namespace mains {
+
+/**
+ * Parallel streaming loader of MeTTa files into an AtomDB.
+ *
+ * The input file is mmapped and scanned by the thread calling load(), which splits it in chunks
+ * of toplevel expressions (chunks are never split in the middle of an expression, regardless of
+ * line breaks). Chunks are parsed by a pool of parser threads (each one reusing a single lexer
+ * and its input buffer) into batches of atoms which are committed to the AtomDB by a pool of
+ * writer threads. Chunks and atom batches are passed along through bounded queues so memory usage
+ * is limited by the number of chunks/batches in flight rather than by the size of the input file.
+ *
+ * Each atom batch has all the atoms referred by the expressions in the respective chunk (nodes,
+ * nested links, etc) so batches can be committed in any order. When a chunk has syntax errors,
+ * its expressions are parsed one by one so only the invalid ones are discarded.
+ */
+class MettaFileLoader {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param atomdb AtomDB where atoms are inserted.
+     * @param parser_threads Number of threads parsing MeTTa expressions.
+     * @param writer_threads Number of threads committing atoms to the AtomDB.
+     * @param chunk_size Max number of toplevel expressions per chunk (and so per add_atoms() call).
+     * @param queue_size Max number of chunks (and atom batches) waiting to be processed.
+     */
+    MettaFileLoader(shared_ptr<atomdb::AtomDB> atomdb,
+                    unsigned int parser_threads = 4,
+                    unsigned int writer_threads = 4,
+                    unsigned int chunk_size = 5000,
+                    unsigned int queue_size = 8);
+    ~MettaFileLoader();
+
+    /**
+     * Loads all the toplevel expressions in the passed file. Blocks until all the atoms are
+     * committed.
+     *
+     * @param file_name MeTTa file.
+     */
+    void load(const string& file_name);
+
+    /**
+     * Sets the interval between progress reports (in seconds) logged while a file is being
+     * loaded. 0 disables progress reports.
+     */
+    void set_progress_interval(unsigned int seconds);
+
+    unsigned long expression_count() { return this->expressions_parsed.load(); }
+    unsigned long atom_count() { return this->atoms_committed.load(); }
+    unsigned long parse_error_count() { return this->parse_errors.load(); }
+    unsigned long write_error_count() { return this->write_errors.load(); }
+
+   private:
+    // Max size (in bytes) of a chunk (unless a single expression is larger than this)
+    static const size_t MAX_CHUNK_BYTES = 4 * 1024 * 1024;
+
+    // A sequence of toplevel expressions (pointing into the mmapped file)
+    struct Chunk {
+        const char* begin = NULL;
+        size_t size = 0;
+        vector<pair<size_t, size_t>> expressions;  // (offset from begin, size)
+    };
+
+    struct AtomBatch {
+        vector<shared_ptr<atoms::MettaParserActions>> parser_actions;  // Owners of the atoms
+        vector<atoms::Atom*> atoms;
+        set<string> handles;
+    };
+
+    void scan(const char* data, size_t size);
+    void parser_loop();
+    void writer_loop();
+    void progress_loop();
+    bool parse(shared_ptr<metta::MettaLexer> lexer, const char* text, size_t size, AtomBatch& batch);
+    void log_progress(bool final_report);
+
+    shared_ptr<atomdb::AtomDB> atomdb;
+    unsigned int parser_threads;
+    unsigned int writer_threads;
+    unsigned int chunk_size;
+    unsigned int progress_interval;
+    BoundedQueue<Chunk> chunk_queue;
+    BoundedQueue<AtomBatch> batch_queue;
+
+    size_t file_size;
+    unsigned long start_time;
+    atomic<size_t> bytes_scanned;
+    atomic<unsigned long> expressions_parsed;
+    atomic<unsigned long> atoms_committed;
+    atomic<unsigned long> parse_errors;
+    atomic<unsigned long> write_errors;
+
+    mutex progress_mutex;
+    condition_variable progress_condition;
+    bool loading;
+};
+
+}  // namespace mains
@@ -219,6 +219,18 @@ unique_ptr<Token> MettaLexer::next() {
     }
 }
 
+void MettaLexer::reset() {
+    this->reading_cursor = 0;
+    this->writing_cursor = 0;
+    this->input_buffer[0] = '\0';
+    this->line_number = 1;
+    this->current_metta_string.clear();
+    this->attached_strings = queue<string>();
+    this->attached_file_names = queue<string>();
+    this->current_offset.clear();
+    this->metta_string_stack = stack<string>();
+}
+
 void MettaLexer::stack_metta_string() {
     this->current_metta_string.pop_back();
     this->metta_string_stack.push(this->current_metta_string);
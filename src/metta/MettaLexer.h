@@ -70,6 +70,13 @@ class MettaLexer {
      */
     unique_ptr<Token> next();
 
+    /**
+     * Discards all pending input (attached strings or files and chars still in the input buffer)
+     * so the lexer (and its input buffer) can be reused to scan new input. E.g. after a parse
+     * error in the middle of the input.
+     */
+    void reset();
+
     void stack_metta_string();
     void pop_metta_string();
 
@@ -52,6 +52,11 @@ bool MettaParser::parse(bool throw_on_parse_error) {
             token_stack.pop();
             this->actions->expression_end(token_stack.size() == 0, this->lexer->current_metta_string);
             this->lexer->pop_metta_string();
+            if (token_stack.size() == 0) {
+                // Text of a toplevel expression isn't needed anymore. Without this, the text of
+                // all the toplevel expressions would be accumulated when the input has many of them.
+                this->lexer->current_metta_string.clear();
+            }
         } else if (token->type == MettaTokens::SYMBOL) {
             this->actions->symbol(token->text);
             token_stack.push(move(token));
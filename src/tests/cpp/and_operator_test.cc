@@ -1,5 +1,6 @@
 #include <cstdlib>
 #include <cstring>
+#include <set>
 
 #include "And.h"
 #include "QueryAnswer.h"
@@ -485,6 +486,148 @@ TEST(AndOperator, not_operator_5) {
     EXPECT_TRUE(sink.finished());
 }
 
+static multiset<string> run_and_operator(bool hash_join_flag, bool not_operator_flag) {
+    array<shared_ptr<TestSource>, 3> source;
+    for (unsigned int i = 0; i < 3; i++) {
+        source[i] = make_shared<TestSource>();
+    }
+    vector<shared_ptr<QueryElement>> dummy;
+    auto and_operator =
+        make_shared<And<3>>(array<shared_ptr<QueryElement>, 3>({source[0], source[1], source[2]}),
+                            dummy,
+                            not_operator_flag,
+                            hash_join_flag);
+    TestSink sink(and_operator);
+
+    // Chain-like join: (x, y) AND (y, z) AND (x)
+    for (unsigned int i = 0; i < 40; i++) {
+        string x = std::to_string(i % 5);
+        string y = std::to_string(i % 7);
+        string z = std::to_string(i % 3);
+        source[0]->add(("S0_" + std::to_string(i)).c_str(), 0.5, {"x", "y"}, {x, y}, false);
+        source[1]->add(("S1_" + std::to_string(i)).c_str(), 0.3, {"y", "z"}, {y, z}, false);
+        if (i < 4) {
+            source[2]->add(("S2_" + std::to_string(i)).c_str(), 0.1, {"x"}, {x}, false);
+        }
+    }
+    for (unsigned int i = 0; i < 3; i++) {
+        source[i]->query_answers_finished();
+    }
+
+    multiset<string> answers;
+    QueryAnswer* query_answer;
+    while (!(sink.finished() && sink.empty())) {
+        if (sink.empty()) {
+            Utils::sleep();
+            continue;
+        }
+        EXPECT_FALSE((query_answer = dynamic_cast<QueryAnswer*>(sink.pop())) == NULL);
+        vector<string> handles(query_answer->get_handles_vector().begin(),
+                               query_answer->get_handles_vector().end());
+        std::sort(handles.begin(), handles.end());
+        answers.insert(Utils::join(handles, ' ') + " " + query_answer->assignment.to_string());
+    }
+    return answers;
+}
+
+TEST(AndOperator, hash_join) {
+    multiset<string> expected = run_and_operator(false, false);
+    multiset<string> actual = run_and_operator(true, false);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(actual, expected);
+
+    expected = run_and_operator(false, true);
+    actual = run_and_operator(true, true);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(AndOperator, hash_join_importance_order) {
+    array<shared_ptr<TestSource>, 3> source;
+    source[0] = make_shared<TestSource>();
+    source[1] = make_shared<TestSource>();
+    source[2] = make_shared<TestSource>();
+    vector<shared_ptr<QueryElement>> dummy;
+    // AndNot holds all the combinations until the NOT clause is finished so they are all
+    // reported in a single round
+    auto and_operator = make_shared<And<3>>(
+        array<shared_ptr<QueryElement>, 3>({source[0], source[1], source[2]}), dummy, true, true);
+    TestSink sink(and_operator);
+    QueryAnswer* query_answer;
+
+    source[0]->add("S0_1", 0.2, {"v1"}, {"1"}, false);
+    source[0]->add("S0_2", 0.9, {"v1"}, {"2"}, false);
+    source[0]->add("S0_3", 0.5, {"v1"}, {"3"}, false);
+    source[1]->add("S1_1", 0.3, {"v1", "v2"}, {"1", "1"}, false);
+    source[1]->add("S1_2", 0.4, {"v1", "v2"}, {"2", "1"}, false);
+    source[1]->add("S1_3", 0.1, {"v1", "v2"}, {"3", "1"}, false);
+    source[1]->add("S1_4", 0.1, {"v1", "v2"}, {"4", "1"}, false);
+    source[2]->add("S2_1", 1.0, {"v1"}, {"3"});
+    source[0]->query_answers_finished();
+    source[1]->query_answers_finished();
+    source[2]->query_answers_finished();
+
+    vector<string> handles;
+    while (!(sink.finished() && sink.empty())) {
+        if (sink.empty()) {
+            Utils::sleep();
+            continue;
+        }
+        EXPECT_FALSE((query_answer = dynamic_cast<QueryAnswer*>(sink.pop())) == NULL);
+        EXPECT_EQ(query_answer->get_handles_size(), 2);
+        handles.push_back(Utils::join(query_answer->get_all(QueryAnswerElement::ALL_HANDLES), ' '));
+    }
+    EXPECT_EQ(handles, vector<string>({"S0_2 S1_2", "S0_1 S1_1"}));
+}
+
+static unsigned int run_anti_join(bool hash_join_flag) {
+    array<shared_ptr<TestSource>, 3> source;
+    for (unsigned int i = 0; i < 3; i++) {
+        source[i] = make_shared<TestSource>();
+    }
+    vector<shared_ptr<QueryElement>> dummy;
+    auto and_operator =
+        make_shared<And<3>>(array<shared_ptr<QueryElement>, 3>({source[0], source[1], source[2]}),
+                            dummy,
+                            true,
+                            hash_join_flag);
+    TestSink sink(and_operator);
+
+    // (x) AND (y) AND NOT ((x, w) OR (y)): even values of x and y == 1 are negated
+    for (unsigned int i = 0; i < 100; i++) {
+        string x = std::to_string(i);
+        source[0]->add(("S0_" + x).c_str(), 0.5, {"x"}, {x}, false);
+        if ((i % 2) == 0) {
+            source[2]->add(("S2_" + x).c_str(), 0.5, {"x", "w"}, {x, "w"}, false);
+        }
+    }
+    source[1]->add("S1_0", 0.5, {"y"}, {"0"}, false);
+    source[1]->add("S1_1", 0.5, {"y"}, {"1"}, false);
+    source[2]->add("S2_y", 0.5, {"y"}, {"1"}, false);
+    for (unsigned int i = 0; i < 3; i++) {
+        source[i]->query_answers_finished();
+    }
+
+    unsigned int count = 0;
+    QueryAnswer* query_answer;
+    while (!(sink.finished() && sink.empty())) {
+        if (sink.empty()) {
+            Utils::sleep();
+            continue;
+        }
+        EXPECT_FALSE((query_answer = dynamic_cast<QueryAnswer*>(sink.pop())) == NULL);
+        EXPECT_EQ(stoi(query_answer->assignment.get("x")) % 2, 1);
+        EXPECT_EQ(string(query_answer->assignment.get("y")), "0");
+        count++;
+    }
+    return count;
+}
+
+TEST(AndOperator, anti_join) {
+    EXPECT_EQ(run_anti_join(false), 50);
+    EXPECT_EQ(run_anti_join(true), 50);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     Utils::init_random(0);
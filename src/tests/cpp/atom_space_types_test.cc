@@ -17,7 +17,16 @@ using namespace atoms;
 class TestDecoder : public HandleDecoder {
    public:
     map<string, shared_ptr<Atom>> atoms;
-    shared_ptr<Atom> get_atom(const string& handle) { return this->atoms[handle]; }
+    unsigned int get_atom_count = 0;
+    unsigned int get_atoms_count = 0;
+    shared_ptr<Atom> get_atom(const string& handle) {
+        this->get_atom_count++;
+        return this->atoms[handle];
+    }
+    vector<shared_ptr<Atom>> get_atoms(const vector<string>& handles) {
+        this->get_atoms_count++;
+        return HandleDecoder::get_atoms(handles);
+    }
     shared_ptr<Atom> add_atom(shared_ptr<Atom> atom) {
         this->atoms[atom->handle()] = atom;
         return atom;
@@ -325,6 +334,8 @@ void check_match(const string& test_tag,
     }
     auto link = db.add_atom(make_shared<Link>(expression, v));
     EXPECT_EQ(link_schema.match(*((Link*) (link.get())), assignment, db), test_flag);
+    vector<Assignment> assignments(1);
+    EXPECT_EQ(link_schema.match(vector<string>({link->handle()}), assignments, db)[0], test_flag);
 }
 
 TEST(LinkTest, Match) {
@@ -420,6 +431,56 @@ TEST(LinkTest, Match) {
     // clang-format on
 }
 
+TEST(LinkTest, BatchedMatch) {
+    TestDecoder db;
+    string symbol = MettaMapping::SYMBOL_NODE_TYPE;
+    string expression = MettaMapping::EXPRESSION_LINK_TYPE;
+
+    auto node1 = db.add_atom(make_shared<Node>(symbol, string("n1")));
+    auto node2 = db.add_atom(make_shared<Node>(symbol, string("n2")));
+    auto node3 = db.add_atom(make_shared<Node>(symbol, string("n3")));
+    auto add_link = [&](shared_ptr<Atom> target1, shared_ptr<Atom> target2) {
+        return db.add_atom(
+            make_shared<Link>(expression, vector<string>({target1->handle(), target2->handle()})));
+    };
+    auto inner1 = add_link(node1, node2);
+    auto inner2 = add_link(node2, node3);
+    auto inner3 = add_link(node1, node3);
+    auto outer1 = add_link(node3, inner1);
+    auto outer2 = add_link(node3, inner2);
+    auto outer3 = add_link(node1, inner1);
+    auto outer4 = add_link(node3, inner3);
+
+    // clang-format off
+    LinkSchema schema({
+    "LINK_TEMPLATE", "Expression", "2",
+        "NODE", "Symbol", "n3",
+        "LINK_TEMPLATE", "Expression", "2",
+            "NODE", "Symbol", "n1",
+            "VARIABLE", "v1"});
+    // clang-format on
+
+    vector<string> handles = {outer1->handle(),
+                              outer2->handle(),
+                              outer3->handle(),
+                              outer4->handle(),
+                              node1->handle(),
+                              "unknown_handle"};
+    vector<Assignment> assignments(handles.size());
+    db.get_atom_count = 0;
+    vector<bool> matched = schema.match(handles, assignments, db);
+    EXPECT_EQ(matched, vector<bool>({true, false, false, true, false, false}));
+    EXPECT_EQ(assignments[0].get("v1"), node2->handle());
+    EXPECT_EQ(assignments[3].get("v1"), node3->handle());
+    EXPECT_EQ(assignments[1].variable_count(), 0);
+    // One get_atoms() per nesting level. outer3 is not expanded because "n1" != "n3"
+    EXPECT_EQ(db.get_atoms_count, 2);
+    EXPECT_EQ(db.get_atom_count, handles.size() + 3);
+
+    vector<Assignment> wrong_size(1);
+    EXPECT_THROW(schema.match(handles, wrong_size, db), runtime_error);
+}
+
 TEST(LinkTest, CompositeTypes) {
     TestDecoder db;
     string symbol = MettaMapping::SYMBOL_NODE_TYPE;
@@ -0,0 +1,108 @@
+#include <grpcpp/grpcpp.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AttentionBrokerClient.h"
+#include "Utils.h"
+#include "attention_broker.grpc.pb.h"
+#include "attention_broker.pb.h"
+#include "common.pb.h"
+#include "gtest/gtest.h"
+
+using namespace attention_broker;
+using namespace commons;
+
+// Fake AttentionBroker which answers get_importance() with the size of each handle string so the
+// client can check that each caller got its own importance values.
+class FakeAttentionBroker final : public dasproto::AttentionBroker::Service {
+   public:
+    atomic<unsigned int> get_importance_count;
+    atomic<unsigned int> ping_count;
+
+    FakeAttentionBroker() : get_importance_count(0), ping_count(0) {}
+
+    grpc::Status ping(grpc::ServerContext* grpc_context,
+                      const dasproto::Empty* request,
+                      dasproto::Ack* reply) override {
+        this->ping_count++;
+        reply->set_msg("PING");
+        return grpc::Status::OK;
+    }
+
+    grpc::Status get_importance(grpc::ServerContext* grpc_context,
+                                const dasproto::HandleList* request,
+                                dasproto::ImportanceList* reply) override {
+        this->get_importance_count++;
+        for (int i = 0; i < request->list_size(); i++) {
+            reply->add_list((float) request->list(i).size());
+        }
+        return grpc::Status::OK;
+    }
+};
+
+static string SERVER_ADDRESS = "localhost:40053";
+
+static unique_ptr<grpc::Server> start_server(FakeAttentionBroker* service) {
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(SERVER_ADDRESS, grpc::InsecureServerCredentials());
+    builder.RegisterService(service);
+    return builder.BuildAndStart();
+}
+
+TEST(AttentionBrokerClient, channel_reuse) {
+    FakeAttentionBroker service;
+    auto server = start_server(&service);
+    AttentionBrokerClient::set_server_address(SERVER_ADDRESS);
+
+    for (unsigned int i = 0; i < 10; i++) {
+        EXPECT_TRUE(AttentionBrokerClient::health_check());
+    }
+    EXPECT_EQ(service.ping_count, 10);
+
+    AttentionBrokerClient::set_get_importance_flush_deadline(0);
+    vector<string> handles = {"a", "bb", "ccc"};
+    vector<float> importances;
+    AttentionBrokerClient::get_importance(handles, "context", importances);
+    EXPECT_EQ(importances, vector<float>({1.0, 2.0, 3.0}));
+    EXPECT_EQ(service.get_importance_count, 1);
+
+    server->Shutdown();
+}
+
+TEST(AttentionBrokerClient, get_importance_coalescing) {
+    FakeAttentionBroker service;
+    auto server = start_server(&service);
+    AttentionBrokerClient::set_server_address(SERVER_ADDRESS);
+    AttentionBrokerClient::set_get_importance_flush_deadline(200);
+
+    unsigned int thread_count = 16;
+    vector<thread> threads;
+    vector<char> ok(thread_count, false);
+    for (unsigned int t = 0; t < thread_count; t++) {
+        threads.push_back(thread([t, &ok]() {
+            vector<string> handles;
+            vector<float> expected;
+            for (unsigned int i = 1; i <= t + 1; i++) {
+                handles.push_back(string(i + t, 'x'));
+                expected.push_back((float) (i + t));
+            }
+            vector<float> importances;
+            AttentionBrokerClient::get_importance(handles, "context", importances);
+            ok[t] = (importances == expected);
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (unsigned int t = 0; t < thread_count; t++) {
+        EXPECT_TRUE(ok[t]) << "Thread " << t;
+    }
+    EXPECT_GE(service.get_importance_count, 1);
+    EXPECT_LT(service.get_importance_count, thread_count);
+
+    AttentionBrokerClient::set_get_importance_flush_deadline(1);
+    server->Shutdown();
+}
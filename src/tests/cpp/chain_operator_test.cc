@@ -33,6 +33,8 @@ using namespace commons;
 #define RUN_back_after_dead_end         ((bool) true)
 #define RUN_basics                      ((bool) true)
 #define RUN_complete_only               ((bool) true)
+#define RUN_parallel_expansion          ((bool) true)
+#define RUN_long_path                   ((bool) true)
 // clang-format on
 
 static string EVALUATION_HANDLE = Hasher::node_handle(NODE_TYPE, EVALUATION);
@@ -686,6 +688,85 @@ TEST(ChainOperatorTest, basics) {
     EXPECT_TRUE(sink.finished());
 }
 
+TEST(ChainOperatorTest, parallel_expansion) {
+    if (!RUN_parallel_expansion) return;
+    auto source = make_shared<TestSource>();
+    auto chain_operator = make_shared<Chain>(array<shared_ptr<QueryElement>, 1>({source}),
+                                             Hasher::node_handle(NODE_TYPE, "S"),
+                                             Hasher::node_handle(NODE_TYPE, "T"),
+                                             false,
+                                             4);
+    TestSink sink(chain_operator);
+
+    unsigned int S = 0;
+    unsigned int T = NODE_COUNT + 1;
+
+    // clang-format off
+    //
+    //  S -- 1 -- 2 -- 3 -- T     (plus 3 -> 1, 2 -> 5, S -> 4, 1 -> 4 and 4 -> T)
+    //
+    source->add(link(S, 1), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(S, 4), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(S, T), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(1, 2), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(1, 4), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(2, 3), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(2, 5), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(3, 1), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(3, T), 0.5, {"v1"}, {"h1"}, false);
+    source->add(link(4, T), 0.5, {"v1"}, {"h1"}, false);
+    // clang-format on
+    source->query_answers_finished();
+
+    // S -> T, S -> 4 -> T, S -> 1 -> 4 -> T and S -> 1 -> 2 -> 3 -> T
+    QueryAnswer* answer;
+    set<string> paths;
+    while (!sink.empty() || !sink.finished()) {
+        while ((answer = sink.pop()) != NULL) {
+            string path = answer_path_to_string(answer);
+            LOG_INFO("[" + std::to_string(answer->importance) + "]: " + path);
+            EXPECT_TRUE(check_answer(answer));
+            EXPECT_TRUE(paths.find(path) == paths.end());
+            paths.insert(path);
+        }
+        Utils::sleep(500);
+    }
+    EXPECT_EQ(paths.size(), 4);
+    EXPECT_TRUE(sink.empty());
+    EXPECT_TRUE(sink.finished());
+}
+
+TEST(ChainOperatorTest, long_path) {
+    if (!RUN_long_path) return;
+    auto source = make_shared<TestSource>();
+    auto chain_operator = make_shared<Chain>(array<shared_ptr<QueryElement>, 1>({source}),
+                                             Hasher::node_handle(NODE_TYPE, "S"),
+                                             Hasher::node_handle(NODE_TYPE, "T"),
+                                             false);
+    TestSink sink(chain_operator);
+
+    // S -> 1 -> 2 -> ... -> 17 -> T is longer than 2 * Chain::MAX_MEETING_DEPTH
+    unsigned int T = NODE_COUNT + 1;
+    unsigned int length = 2 * Chain::MAX_MEETING_DEPTH + 1;
+    for (unsigned int cursor = 0; cursor < length; cursor++) {
+        source->add(link(cursor, cursor + 1), 0.5, {"v1"}, {"h1"}, false);
+    }
+    source->add(link(length, T), 0.5, {"v1"}, {"h1"}, false);
+    source->query_answers_finished();
+
+    QueryAnswer* answer;
+    unsigned int complete_path = 0;
+    while (!sink.empty() || !sink.finished()) {
+        while ((answer = sink.pop()) != NULL) {
+            EXPECT_TRUE(check_answer(answer));
+            EXPECT_EQ(answer->get_path_vector(0).size(), length + 1);
+            complete_path++;
+        }
+        Utils::sleep(500);
+    }
+    EXPECT_EQ(complete_path, 1);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     ::testing::AddGlobalTestEnvironment(new ChainOperatorTestEnvironment());
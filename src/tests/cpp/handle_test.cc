@@ -0,0 +1,132 @@
+#include <map>
+#include <set>
+#include <unordered_set>
+
+#include "Handle.h"
+#include "Utils.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace commons;
+using namespace std;
+
+TEST(HandleTest, basics) {
+    Handle null_handle;
+    EXPECT_TRUE(null_handle.is_null());
+    EXPECT_EQ(null_handle.to_string(), string(Handle::HEX_SIZE, '0'));
+
+    string hex = "0123456789abcdef0123456789ABCDEF";
+    Handle handle(hex);
+    EXPECT_FALSE(handle.is_null());
+    EXPECT_EQ(handle.to_string(), "0123456789abcdef0123456789abcdef");
+    EXPECT_EQ(handle.data()[0], 0x01);
+    EXPECT_EQ(handle.data()[15], 0xEF);
+    EXPECT_EQ(handle, Handle("0123456789ABCDEF0123456789abcdef"));
+    EXPECT_NE(handle, null_handle);
+    EXPECT_EQ(Handle::from_bytes(handle.data()), handle);
+
+    char buffer[Handle::HEX_SIZE + 1];
+    handle.to_hex(buffer);
+    EXPECT_EQ(string(buffer), handle.to_string());
+}
+
+TEST(HandleTest, invalid_handles) {
+    EXPECT_TRUE(Handle::is_valid("0123456789abcdef0123456789abcdef"));
+    EXPECT_FALSE(Handle::is_valid(""));
+    EXPECT_FALSE(Handle::is_valid("0123456789abcdef"));
+    EXPECT_FALSE(Handle::is_valid("0123456789abcdef0123456789abcdeg"));
+    EXPECT_FALSE(Handle::is_valid("0123456789abcdef0123456789abcdef0"));
+    EXPECT_THROW(Handle("0123456789abcdef"), runtime_error);
+    EXPECT_THROW(Handle("0123456789abcdef0123456789abcdeg"), runtime_error);
+}
+
+TEST(HandleTest, containers) {
+    set<string> string_set;
+    set<Handle> handle_set;
+    unordered_set<Handle> handle_hash_set;
+    map<Handle, string> handle_map;
+    for (unsigned int i = 0; i < 10000; i++) {
+        string hex = random_handle();
+        string_set.insert(hex);
+        handle_set.insert(Handle(hex));
+        handle_hash_set.insert(Handle(hex));
+        handle_map[Handle(hex)] = hex;
+    }
+    EXPECT_EQ(handle_set.size(), string_set.size());
+    EXPECT_EQ(handle_hash_set.size(), string_set.size());
+    // Handle ordering is the same as the ordering of the hex representation
+    auto cursor = handle_set.begin();
+    for (const string& hex : string_set) {
+        EXPECT_EQ(cursor->to_string(), hex);
+        EXPECT_TRUE(handle_hash_set.find(Handle(hex)) != handle_hash_set.end());
+        EXPECT_EQ(handle_map[Handle(hex)], hex);
+        cursor++;
+    }
+}
+
+TEST(HandleTest, compact_handle) {
+    string hex = random_handle();
+    string upper = hex;
+    for (char& c : upper) {
+        c = toupper(c);
+    }
+    EXPECT_TRUE(Handle::is_canonical(hex));
+    EXPECT_FALSE(Handle::is_canonical(upper));
+    CompactHandle compact(hex);
+    EXPECT_TRUE(compact.is_handle());
+    EXPECT_EQ(compact.get_handle(), Handle(hex));
+    EXPECT_EQ(compact.to_string(), hex);
+    EXPECT_TRUE(compact == hex);
+    EXPECT_TRUE(hex == compact);
+    EXPECT_TRUE(compact == hex.c_str());
+    EXPECT_TRUE(compact == CompactHandle(Handle(hex)));
+
+    // Anything else is kept as is so it's rebuilt exactly
+    for (string value : {string(""), string("h1"), upper, hex + "0"}) {
+        CompactHandle other(value);
+        EXPECT_FALSE(other.is_handle());
+        EXPECT_EQ(other.to_string(), value);
+        EXPECT_TRUE(other == value);
+        EXPECT_TRUE(other != compact);
+        EXPECT_TRUE(other == CompactHandle(value));
+        EXPECT_EQ(other.hash(), CompactHandle(value).hash());
+        string appended = "x";
+        other.append_to(appended);
+        EXPECT_EQ(appended, "x" + value);
+    }
+    EXPECT_TRUE(CompactHandle() == "");
+    EXPECT_TRUE(CompactHandle() != CompactHandle("h1"));
+
+    CompactHandle copy = compact;
+    CompactHandle other_copy("h1");
+    other_copy = CompactHandle("h2");
+    copy = other_copy;
+    EXPECT_EQ(copy, "h2");
+    EXPECT_EQ(other_copy, "h2");
+    string as_string = compact;
+    EXPECT_EQ(as_string, hex);
+
+    set<string> string_set;
+    set<CompactHandle> compact_set;
+    unordered_set<CompactHandle> compact_hash_set;
+    for (unsigned int i = 0; i < 1000; i++) {
+        string value = (i % 10 == 0) ? "h" + std::to_string(i) : random_handle();
+        string_set.insert(value);
+        compact_set.insert(CompactHandle(value));
+        compact_hash_set.insert(CompactHandle(value));
+    }
+    EXPECT_EQ(compact_set.size(), string_set.size());
+    EXPECT_EQ(compact_hash_set.size(), string_set.size());
+    auto cursor = compact_set.begin();
+    for (const string& value : string_set) {
+        EXPECT_EQ(cursor->to_string(), value);
+        EXPECT_TRUE(compact_hash_set.find(CompactHandle(value)) != compact_hash_set.end());
+        cursor++;
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    Utils::init_random(0);
+    return RUN_ALL_TESTS();
+}
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <cstdlib>
 #include <thread>
 #include <vector>
@@ -770,6 +771,87 @@ TEST(HandleTrieTest, remove_after_merge) {
     EXPECT_TRUE(value == NULL);
 }
 
+TEST(HandleTrieTest, handle_keys) {
+    HandleTrie trie(HANDLE_HASH_SIZE - 1);
+    vector<string> keys;
+    for (unsigned int i = 0; i < 1000; i++) {
+        keys.push_back(random_handle());
+    }
+    for (unsigned int i = 0; i < keys.size(); i++) {
+        if ((i % 2) == 0) {
+            trie.insert(keys[i], new TestValue(i));
+        } else {
+            trie.insert(Handle(keys[i]), new TestValue(i));
+        }
+    }
+    for (unsigned int i = 0; i < keys.size(); i++) {
+        TestValue* value1 = (TestValue*) trie.lookup(keys[i]);
+        TestValue* value2 = (TestValue*) trie.lookup(Handle(keys[i]));
+        EXPECT_TRUE(value1 != NULL);
+        EXPECT_EQ(value1, value2);
+        EXPECT_EQ(value1->count, i);
+        EXPECT_TRUE(trie.exists(Handle(keys[i])));
+    }
+    EXPECT_TRUE(trie.remove(Handle(keys[0])));
+    EXPECT_TRUE(trie.lookup(keys[0]) == NULL);
+    EXPECT_FALSE(trie.remove(Handle(keys[0])));
+    EXPECT_EQ(trie.size(), keys.size() - 1);
+
+    HandleTrie small_trie(4);
+    EXPECT_THROW(small_trie.insert(Handle(keys[1]), new TestValue()), runtime_error);
+}
+
+static void stable_key_reader(HandleTrie* trie, vector<string>* keys, atomic<bool>* done) {
+    while (!done->load()) {
+        for (unsigned int i = 0; i < keys->size(); i++) {
+            TestValue* value = (TestValue*) trie->lookup((*keys)[i]);
+            ASSERT_TRUE(value != NULL);
+            EXPECT_EQ(value->count, i);
+            unsigned int* count = (unsigned int*) trie->lookup_stored_object((*keys)[i], false);
+            ASSERT_TRUE(count != NULL);
+            EXPECT_EQ(*count, i);
+            EXPECT_TRUE(trie->exists((*keys)[i]));
+        }
+    }
+}
+
+TEST(HandleTrieTest, lookups_during_insertions) {
+    // Keys inserted before the readers start must be visible all the time while concurrent
+    // insertions split and push down the nodes in their path.
+    HandleTrie trie(HANDLE_HASH_SIZE - 1);
+    vector<string> stable_keys;
+    for (unsigned int i = 0; i < 1000; i++) {
+        stable_keys.push_back(random_handle());
+        trie.insert(stable_keys.back(), new TestValue(i));
+    }
+    atomic<bool> done(false);
+    vector<thread*> readers;
+    for (unsigned int i = 0; i < 4; i++) {
+        readers.push_back(new thread(&stable_key_reader, &trie, &stable_keys, &done));
+    }
+    vector<thread*> writers;
+    for (unsigned int i = 0; i < 4; i++) {
+        writers.push_back(new thread([&trie]() {
+            for (unsigned int j = 0; j < 20000; j++) {
+                trie.insert(random_handle(), new AccumulatorValue());
+            }
+        }));
+    }
+    for (thread* t : writers) {
+        t->join();
+        delete t;
+    }
+    done = true;
+    for (thread* t : readers) {
+        t->join();
+        delete t;
+    }
+    EXPECT_EQ(trie.size(), 81000);
+    for (unsigned int i = 0; i < stable_keys.size(); i++) {
+        EXPECT_EQ(((TestValue*) trie.lookup(stable_keys[i]))->count, i);
+    }
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     Utils::init_random(0);
@@ -0,0 +1,147 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Handle.h"
+#include "Hasher.h"
+#include "expression_hasher.h"
+#include "gtest/gtest.h"
+#include "mbedtls/md5.h"
+
+using namespace commons;
+using namespace std;
+
+// Reference implementation: one-shot MD5 of the whole (already joined) string
+static string reference_hash(const string& input) {
+    unsigned char digest[16];
+    mbedtls_md5((const unsigned char*) input.data(), input.size(), digest);
+    char output[HANDLE_HASH_SIZE];
+    for (unsigned int i = 0; i < 16; i++) {
+        snprintf(output + 2 * i, 3, "%02x", digest[i]);
+    }
+    return string(output, 32);
+}
+
+static string joined(const vector<string>& elements) {
+    string answer;
+    for (unsigned int i = 0; i < elements.size(); i++) {
+        if (i > 0) {
+            answer += JOINING_CHAR;
+        }
+        answer += elements[i];
+    }
+    return answer;
+}
+
+static string random_string(unsigned int size) {
+    string answer(size, ' ');
+    for (unsigned int i = 0; i < size; i++) {
+        answer[i] = (char) (1 + (rand() % 255));
+    }
+    return answer;
+}
+
+TEST(HasherTest, known_handles) {
+    string human = "8860480382d0ddf62623abf5c860e51d";
+    string mammal = "2e49bfe7f9b46c1e403b841970205a82";
+    string inheritance = "9028a696c1b6d3d9ff8c4f496da77378";
+    EXPECT_EQ(Hasher::plain_string_hash(""), "d41d8cd98f00b204e9800998ecf8427e");
+    EXPECT_EQ(Hasher::type_handle("Symbol"), "02c86eb2792f3262c21d030a87e19793");
+    EXPECT_EQ(Hasher::node_handle("Symbol", "\"human\""), human);
+    EXPECT_EQ(Hasher::node_handle("Symbol", "\"mammal\""), mammal);
+    EXPECT_EQ(Hasher::node_handle("Symbol", "Inheritance"), inheritance);
+    EXPECT_EQ(Hasher::link_handle("Expression", {inheritance, human, mammal}),
+              "76a21d549ea70cda9b5433e7a1f62960");
+    EXPECT_EQ(Hasher::composite_handle({human, mammal}), "7834061725640ed4397e0d7e1da9974d");
+}
+
+TEST(HasherTest, legacy_api) {
+    char* h1 = compute_hash((char*) "Symbol");
+    char* h2 = named_type_hash((char*) "Symbol");
+    char* h3 = terminal_hash((char*) "Symbol", (char*) "\"human\"");
+    EXPECT_EQ(string(h1), Hasher::type_handle("Symbol"));
+    EXPECT_EQ(string(h2), Hasher::type_handle("Symbol"));
+    EXPECT_EQ(string(h3), Hasher::node_handle("Symbol", "\"human\""));
+    char* type_hash = named_type_hash((char*) "Expression");
+    char* targets[] = {h3, h1};
+    char* h4 = expression_hash(type_hash, targets, 2);
+    char* h5 = composite_hash(targets, 2);
+    EXPECT_EQ(string(h4), Hasher::link_handle("Expression", {string(h3), string(h1)}));
+    EXPECT_EQ(string(h5), Hasher::composite_handle({string(h3), string(h1)}));
+    for (char* h : {h1, h2, h3, h4, h5, type_hash}) {
+        delete[] h;
+    }
+}
+
+TEST(HasherTest, caller_buffers) {
+    for (unsigned int i = 0; i < 200; i++) {
+        string type = random_string(rand() % 20);
+        string name = random_string(rand() % 200);
+        vector<string> targets;
+        for (unsigned int j = 0; j < (i % 5); j++) {
+            targets.push_back(random_string(32));
+        }
+
+        char output[HANDLE_HASH_SIZE];
+        unsigned char digest[HANDLE_DIGEST_SIZE];
+        Hasher::plain_string_hash(name, output);
+        EXPECT_EQ(string(output), reference_hash(name));
+        Hasher::node_handle(type, name, output);
+        EXPECT_EQ(string(output), reference_hash(type + " " + name));
+        Hasher::node_digest(type, name, digest);
+        EXPECT_EQ(Handle::from_bytes(digest).to_string(), reference_hash(type + " " + name));
+
+        vector<string> link_elements = {reference_hash(type)};
+        link_elements.insert(link_elements.end(), targets.begin(), targets.end());
+        Hasher::link_handle(type, targets, output);
+        EXPECT_EQ(string(output), reference_hash(joined(link_elements)));
+        Hasher::link_digest(type, targets, digest);
+        EXPECT_EQ(Handle::from_bytes(digest).to_string(), reference_hash(joined(link_elements)));
+        Hasher::composite_handle(targets, output);
+        EXPECT_EQ(string(output), reference_hash(joined(targets)));
+    }
+}
+
+TEST(HasherTest, batch) {
+    // Sizes around the MD5 block boundaries (55/56 bytes are the limit for single-block padding)
+    vector<string> inputs;
+    for (unsigned int size : {0, 1, 31, 32, 55, 56, 57, 63, 64, 65, 119, 120, 127, 128, 129, 1000}) {
+        inputs.push_back(random_string(size));
+    }
+    for (unsigned int i = 0; i < 1000; i++) {
+        inputs.push_back(random_string(rand() % 300));
+    }
+    vector<const char*> pointers;
+    vector<size_t> sizes;
+    for (const auto& input : inputs) {
+        pointers.push_back(input.data());
+        sizes.push_back(input.size());
+    }
+    // Every batch size modulo the number of lanes
+    for (unsigned int count : vector<unsigned int>({1, 2, 3, 4, 5, 17, (unsigned int) inputs.size()})) {
+        vector<char> hashes(count * HANDLE_HASH_SIZE);
+        compute_hash_batch(pointers.data(), sizes.data(), count, hashes.data());
+        vector<unsigned char> digests(count * HANDLE_DIGEST_SIZE);
+        compute_digest_batch(pointers.data(), sizes.data(), count, digests.data());
+        for (unsigned int i = 0; i < count; i++) {
+            string expected = reference_hash(inputs[i]);
+            EXPECT_EQ(string(hashes.data() + i * HANDLE_HASH_SIZE), expected);
+            EXPECT_EQ(Handle::from_bytes(digests.data() + i * HANDLE_DIGEST_SIZE).to_string(), expected);
+        }
+    }
+
+    vector<vector<string>> composites;
+    for (unsigned int i = 0; i < 100; i++) {
+        vector<string> elements;
+        for (unsigned int j = 0; j < (i % 7); j++) {
+            elements.push_back(random_string(1 + (rand() % 40)));
+        }
+        composites.push_back(elements);
+    }
+    vector<string> handles = Hasher::composite_handles(composites);
+    ASSERT_EQ(handles.size(), composites.size());
+    for (unsigned int i = 0; i < composites.size(); i++) {
+        EXPECT_EQ(handles[i], Hasher::composite_handle(composites[i]));
+    }
+    EXPECT_TRUE(Hasher::composite_handles({}).empty());
+}
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <fstream>
 #include <map>
 #include <memory>
 #include <set>
@@ -187,6 +188,48 @@ TEST_F(InMemoryDBTest, QueryForPatternNoMatches) {
     EXPECT_EQ(result->size(), 0);
 }
 
+TEST_F(InMemoryDBTest, PatternGenerations) {
+    string similarity_handle = db->add_node(new Node("Symbol", "Similarity"));
+    string inheritance_handle = db->add_node(new Node("Symbol", "Inheritance"));
+    string human_handle = db->add_node(new Node("Symbol", "\"human\""));
+    string monkey_handle = db->add_node(new Node("Symbol", "\"monkey\""));
+    string mammal_handle = db->add_node(new Node("Symbol", "\"mammal\""));
+
+    LinkSchema similarity_schema({"LINK_TEMPLATE",
+                                  "Expression",
+                                  "3",
+                                  "NODE",
+                                  "Symbol",
+                                  "Similarity",
+                                  "VARIABLE",
+                                  "x",
+                                  "VARIABLE",
+                                  "y"});
+    LinkSchema any_schema(
+        {"LINK_TEMPLATE", "Expression", "3", "VARIABLE", "x", "VARIABLE", "y", "VARIABLE", "z"});
+
+    unsigned long similarity_generation = AtomDB::pattern_generation(similarity_schema);
+    unsigned long any_generation = AtomDB::pattern_generation(any_schema);
+
+    // Links which can't match similarity_schema don't change its generation
+    string link_handle =
+        db->add_link(new Link("Expression", {inheritance_handle, human_handle, mammal_handle}));
+    EXPECT_EQ(AtomDB::pattern_generation(similarity_schema), similarity_generation);
+    EXPECT_NE(AtomDB::pattern_generation(any_schema), any_generation);
+
+    db->add_link(new Link("Expression", {similarity_handle, human_handle, monkey_handle}));
+    EXPECT_NE(AtomDB::pattern_generation(similarity_schema), similarity_generation);
+
+    // Re-adding an existing link doesn't change anything
+    similarity_generation = AtomDB::pattern_generation(similarity_schema);
+    db->add_link(new Link("Expression", {similarity_handle, human_handle, monkey_handle}));
+    EXPECT_EQ(AtomDB::pattern_generation(similarity_schema), similarity_generation);
+
+    // Deletions change the generation of all patterns
+    EXPECT_TRUE(db->delete_link(link_handle, false));
+    EXPECT_NE(AtomDB::pattern_generation(similarity_schema), similarity_generation);
+}
+
 TEST_F(InMemoryDBTest, QueryForTargets) {
     auto node1 = new Node("Symbol", "Node1");
     auto node2 = new Node("Symbol", "Node2");
@@ -212,6 +255,26 @@ TEST_F(InMemoryDBTest, QueryForTargets) {
     EXPECT_EQ(string(link1_targets->get_handle(3)), node3_handle);
 }
 
+TEST_F(InMemoryDBTest, HandleOverloads) {
+    // Handle overloads are callable through the derived type (not only through AtomDB*)
+    string node1_handle = db->add_node(new Node("Symbol", "Node1"));
+    string node2_handle = db->add_node(new Node("Symbol", "Node2"));
+    string link_handle = db->add_link(new Link("Expression", {node1_handle, node2_handle}));
+    Handle node1(node1_handle);
+    Handle link(link_handle);
+
+    EXPECT_EQ(db->get_atom(node1)->handle(), node1_handle);
+    EXPECT_EQ(db->get_node(node1)->handle(), node1_handle);
+    EXPECT_EQ(db->get_link(link)->handle(), link_handle);
+    EXPECT_TRUE(db->atom_exists(node1));
+    EXPECT_TRUE(db->node_exists(node1));
+    EXPECT_TRUE(db->link_exists(link));
+    EXPECT_EQ(db->query_for_targets(link)->size(), 2);
+    EXPECT_EQ(db->query_for_incoming_set(node1)->size(), 1);
+    EXPECT_TRUE(db->delete_link(link));
+    EXPECT_FALSE(db->link_exists(link));
+}
+
 TEST_F(InMemoryDBTest, QueryForTargetsNonExistent) {
     string non_existent_handle = "00000000000000000000000000000000";
     auto targets = db->query_for_targets(non_existent_handle);
@@ -615,6 +678,7 @@ TEST_F(InMemoryDBTest, DropAllClearsAtomsAndIndexes) {
                             "\"mammal\""});
 
     EXPECT_EQ(db->query_for_pattern(link_schema)->size(), 2);
+    EXPECT_EQ(db->count_for_pattern(link_schema), 2);
     EXPECT_EQ(db->query_for_incoming_set(human_handle)->size(), 1);
     EXPECT_NE(db->query_for_targets(link1_handle), nullptr);
 
@@ -625,6 +689,7 @@ TEST_F(InMemoryDBTest, DropAllClearsAtomsAndIndexes) {
     EXPECT_EQ(db->get_atom(human_handle), nullptr);
     EXPECT_EQ(db->get_atom(link1_handle), nullptr);
     EXPECT_EQ(db->query_for_pattern(link_schema)->size(), 0);
+    EXPECT_EQ(db->count_for_pattern(link_schema), 0);
     EXPECT_EQ(db->query_for_incoming_set(human_handle)->size(), 0);
     EXPECT_EQ(db->query_for_targets(link1_handle), nullptr);
 }
@@ -1371,6 +1436,92 @@ TEST_F(InMemoryDBTest, ConcurrentPatternQueriesSurviveReIndex) {
     EXPECT_EQ(db->atom_count(), static_cast<size_t>(2 * kNodes));
 }
 
+static set<string> handle_set_contents(shared_ptr<HandleSet> handle_set) {
+    set<string> handles;
+    auto it = handle_set->get_iterator();
+    char* handle;
+    while ((handle = it->next()) != nullptr) {
+        handles.insert(handle);
+    }
+    return handles;
+}
+
+TEST_F(InMemoryDBTest, SaveAndLoadSnapshot) {
+    string file_name = "/tmp/inmemorydb_test_snapshot.bin";
+    Properties custom_attributes;
+    custom_attributes["truth_value"] = 0.75;
+    custom_attributes["source"] = string("test");
+
+    string human_handle = db->add_node(new Node("Symbol", "\"human\"", false, custom_attributes));
+    string mammal_handle = db->add_node(new Node("Symbol", "\"mammal\""));
+    string inheritance_handle = db->add_node(new Node("Symbol", "Inheritance"));
+    string link_handle = db->add_link(
+        new Link("Expression", {inheritance_handle, human_handle, mammal_handle}, true));
+    LinkSchema link_schema({"LINK_TEMPLATE",
+                            "Expression",
+                            "3",
+                            "NODE",
+                            "Symbol",
+                            "Inheritance",
+                            "VARIABLE",
+                            "x",
+                            "NODE",
+                            "Symbol",
+                            "\"mammal\""});
+    db->save_snapshot(file_name);
+
+    auto loaded = make_shared<InMemoryDB>("inmemorydb_test_loaded_");
+    loaded->add_node(new Node("Symbol", "discarded"));
+    loaded->load_snapshot(file_name);
+    EXPECT_EQ(loaded->atom_count(), 4);
+    EXPECT_FALSE(loaded->node_exists(Node("Symbol", "discarded").handle()));
+    EXPECT_TRUE(loaded->link_exists(link_handle));
+    auto human = loaded->get_node(human_handle);
+    ASSERT_NE(human, nullptr);
+    EXPECT_EQ(human->name, "\"human\"");
+    EXPECT_EQ(human->custom_attributes.get<string>("source"), "test");
+    auto link = loaded->get_link(link_handle);
+    ASSERT_NE(link, nullptr);
+    EXPECT_TRUE(link->is_toplevel);
+    EXPECT_EQ(link->targets, vector<string>({inheritance_handle, human_handle, mammal_handle}));
+    EXPECT_EQ(handle_set_contents(loaded->query_for_pattern(link_schema)), set<string>({link_handle}));
+    EXPECT_EQ(handle_set_contents(loaded->query_for_incoming_set(human_handle)),
+              set<string>({link_handle}));
+
+    // Loaded DB is fully writable and can be saved again (not decoded atoms are copied as is)
+    string chimp_handle = loaded->add_node(new Node("Symbol", "\"chimp\""));
+    string link2_handle = loaded->add_link(
+        new Link("Expression", {inheritance_handle, chimp_handle, mammal_handle}));
+    EXPECT_TRUE(loaded->delete_link(link_handle));
+    loaded->save_snapshot(file_name);
+    auto reloaded = make_shared<InMemoryDB>("inmemorydb_test_reloaded_");
+    reloaded->load_snapshot(file_name);
+    EXPECT_EQ(reloaded->atom_count(), 5);
+    EXPECT_FALSE(reloaded->link_exists(link_handle));
+    EXPECT_EQ(reloaded->get_node(mammal_handle)->name, "\"mammal\"");
+    EXPECT_EQ(handle_set_contents(reloaded->query_for_pattern(link_schema)),
+              set<string>({link2_handle}));
+
+    // Corrupted snapshots are rejected and the current contents are kept
+    string corrupted_file_name = "/tmp/inmemorydb_test_snapshot_corrupted.bin";
+    {
+        ifstream source(file_name, ios::binary);
+        ofstream target(corrupted_file_name, ios::binary | ios::trunc);
+        target << source.rdbuf();
+    }
+    {
+        fstream file(corrupted_file_name, ios::binary | ios::in | ios::out);
+        file.seekp(-1, ios::end);
+        file.put('#');
+    }
+    EXPECT_THROW(reloaded->load_snapshot(corrupted_file_name), runtime_error);
+    EXPECT_EQ(reloaded->atom_count(), 5);
+    EXPECT_EQ(reloaded->get_node(chimp_handle)->name, "\"chimp\"");
+    EXPECT_THROW(reloaded->load_snapshot("/tmp/inmemorydb_test_no_such_file.bin"), runtime_error);
+    remove(corrupted_file_name.c_str());
+    remove(file_name.c_str());
+}
+
 TEST_F(InMemoryDBTest, GetAccessPermissionsReturnsEmpty) {
     auto permissions = db->get_access_permissions(PublicKey("any_key"));
     EXPECT_TRUE(permissions.empty());
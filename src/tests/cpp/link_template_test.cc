@@ -1,17 +1,25 @@
+#include <grpcpp/grpcpp.h>
+
 #include <cstdlib>
 
 #include "AtomDBAPITypes.h"
 #include "AtomDBSingleton.h"
+#include "AttentionBrokerClient.h"
 #include "Hasher.h"
+#include "InMemoryDB.h"
+#include "Link.h"
 #include "LinkTemplate.h"
+#include "Node.h"
 #include "QueryAnswer.h"
 #include "QueryNode.h"
 #include "Terminal.h"
 #include "TestAtomDBJsonConfig.h"
+#include "attention_broker.grpc.pb.h"
 #include "gtest/gtest.h"
 #include "test_utils.h"
 
 using namespace atomdb;
+using namespace attention_broker;
 using namespace query_engine;
 using namespace query_element;
 
@@ -73,6 +81,175 @@ TEST(LinkTemplate, basics) {
     EXPECT_TRUE(ent_flag);
 }
 
+TEST(LinkTemplate, top_k_streaming) {
+    string server_node_id = "SERVER_TOP_K";
+    QueryNodeServer server_node(server_node_id);
+
+    AtomDBSingleton::init(test_atomdb_json_config());
+    string symbol = "Symbol";
+
+    auto v1 = make_shared<Terminal>("v1");
+    auto similarity = make_shared<Terminal>();
+    similarity->handle = Hasher::node_handle(symbol, "Similarity");
+    auto human = make_shared<Terminal>(symbol, "\"human\"");
+
+    // 3 links match the LinkTemplate but only the top 2 are reported
+    LinkTemplate link_template(
+        "Expression", {similarity, human, v1}, "", 0.0, false, false, false, false);
+    link_template.set_top_k_streaming(2, 1);
+    link_template.build();
+    link_template.get_source_element()->subsequent_id = server_node_id;
+    link_template.get_source_element()->setup_buffers();
+    Utils::sleep(2000);
+
+    unsigned int count = 0;
+    double last_importance = 1.0;
+    QueryAnswer* query_answer;
+    while ((query_answer = dynamic_cast<QueryAnswer*>(server_node.pop_query_answer())) != NULL) {
+        EXPECT_NE(string(query_answer->assignment.get("v1")), "");
+        EXPECT_LE(query_answer->importance, last_importance);
+        last_importance = query_answer->importance;
+        count++;
+    }
+    EXPECT_EQ(count, 2);
+}
+
+TEST(LinkTemplate, answer_limit) {
+    string server_node_id = "SERVER_LIMIT";
+    QueryNodeServer server_node(server_node_id);
+
+    AtomDBSingleton::init(test_atomdb_json_config());
+    string symbol = "Symbol";
+
+    auto v1 = make_shared<Terminal>("v1");
+    auto similarity = make_shared<Terminal>();
+    similarity->handle = Hasher::node_handle(symbol, "Similarity");
+    auto human = make_shared<Terminal>(symbol, "\"human\"");
+
+    // 3 links match the LinkTemplate but processing stops after the first one
+    LinkTemplate link_template(
+        "Expression", {similarity, human, v1}, "", 0.0, false, true, false, false);
+    link_template.set_answer_limit(1);
+    link_template.build();
+    link_template.get_source_element()->subsequent_id = server_node_id;
+    link_template.get_source_element()->setup_buffers();
+    Utils::sleep(2000);
+
+    unsigned int count = 0;
+    QueryAnswer* query_answer;
+    while ((query_answer = dynamic_cast<QueryAnswer*>(server_node.pop_query_answer())) != NULL) {
+        EXPECT_NE(string(query_answer->assignment.get("v1")), "");
+        count++;
+    }
+    EXPECT_EQ(count, 1);
+}
+
+// Fake AttentionBroker which answers get_importance() with the importance set in the test for
+// each handle (0 for the others).
+class RankingAttentionBroker final : public dasproto::AttentionBroker::Service {
+   public:
+    map<string, float> importance;
+
+    grpc::Status ping(grpc::ServerContext* grpc_context,
+                      const dasproto::Empty* request,
+                      dasproto::Ack* reply) override {
+        reply->set_msg("PING");
+        return grpc::Status::OK;
+    }
+
+    grpc::Status get_importance(grpc::ServerContext* grpc_context,
+                                const dasproto::HandleList* request,
+                                dasproto::ImportanceList* reply) override {
+        for (int i = 0; i < request->list_size(); i++) {
+            auto iterator = this->importance.find(request->list(i));
+            reply->add_list(iterator == this->importance.end() ? 0.0 : iterator->second);
+        }
+        return grpc::Status::OK;
+    }
+};
+
+static string RANKING_SERVER_ADDRESS = "localhost:40054";
+
+// Adds link_count links (Similarity "human" n<i>) to a fresh InMemoryDB and makes the importance
+// of each link grow with i. Returns the handles of the nodes n<i>.
+static vector<string> setup_ranked_links(RankingAttentionBroker& broker, unsigned int link_count) {
+    auto db = make_shared<InMemoryDB>("link_template_test_");
+    AtomDBSingleton::provide(db);
+    string similarity = db->add_node(new Node("Symbol", "Similarity"));
+    string human = db->add_node(new Node("Symbol", "\"human\""));
+    vector<string> nodes;
+    for (unsigned int i = 0; i < link_count; i++) {
+        nodes.push_back(db->add_node(new Node("Symbol", "n" + std::to_string(i))));
+        string link = db->add_link(new Link("Expression", {similarity, human, nodes.back()}));
+        broker.importance[link] = (float) (i + 1) / link_count;
+    }
+    AttentionBrokerClient::set_server_address(RANKING_SERVER_ADDRESS);
+    AttentionBrokerClient::set_get_importance_flush_deadline(0);
+    return nodes;
+}
+
+static vector<string> ranked_answers(LinkTemplate& link_template, const string& server_node_id) {
+    QueryNodeServer server_node(server_node_id);
+    link_template.build();
+    link_template.get_source_element()->subsequent_id = server_node_id;
+    link_template.get_source_element()->setup_buffers();
+    vector<string> answers;
+    while (!(server_node.is_query_answers_finished() && server_node.is_query_answers_empty())) {
+        QueryAnswer* query_answer = dynamic_cast<QueryAnswer*>(server_node.pop_query_answer());
+        if (query_answer == NULL) {
+            server_node.wait_query_answer(100);
+        } else {
+            answers.push_back(string(query_answer->assignment.get("v1")));
+            delete query_answer;
+        }
+    }
+    return answers;
+}
+
+TEST(LinkTemplate, top_k_streaming_is_global) {
+    RankingAttentionBroker broker;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(RANKING_SERVER_ADDRESS, grpc::InsecureServerCredentials());
+    builder.RegisterService(&broker);
+    auto server = builder.BuildAndStart();
+    vector<string> nodes = setup_ranked_links(broker, 40);
+
+    // The top 3 links are spread across 10 chunks but they are still the ones reported
+    auto v1 = make_shared<Terminal>("v1");
+    auto similarity = make_shared<Terminal>("Symbol", "Similarity");
+    auto human = make_shared<Terminal>("Symbol", "\"human\"");
+    LinkTemplate link_template(
+        "Expression", {similarity, human, v1}, "", 0.0, false, false, false, false);
+    link_template.set_top_k_streaming(3, 4);
+    EXPECT_EQ(ranked_answers(link_template, "SERVER_TOP_K_GLOBAL"),
+              vector<string>({nodes[39], nodes[38], nodes[37]}));
+
+    server->Shutdown();
+}
+
+TEST(LinkTemplate, answer_limit_is_ranked_globally) {
+    RankingAttentionBroker broker;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(RANKING_SERVER_ADDRESS, grpc::InsecureServerCredentials());
+    builder.RegisterService(&broker);
+    auto server = builder.BuildAndStart();
+    vector<string> nodes = setup_ranked_links(broker, 40);
+
+    // The most important links are past the first chunk but an answer limit doesn't make
+    // importance be ranked only within the chunks which are read
+    auto v1 = make_shared<Terminal>("v1");
+    auto similarity = make_shared<Terminal>("Symbol", "Similarity");
+    auto human = make_shared<Terminal>("Symbol", "\"human\"");
+    LinkTemplate link_template(
+        "Expression", {similarity, human, v1}, "", 0.0, false, false, false, false);
+    link_template.set_top_k_streaming(0, 4);
+    link_template.set_answer_limit(2);
+    EXPECT_EQ(ranked_answers(link_template, "SERVER_LIMIT_GLOBAL"),
+              vector<string>({nodes[39], nodes[38]}));
+
+    server->Shutdown();
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     Utils::init_random(0);
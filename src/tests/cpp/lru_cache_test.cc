@@ -0,0 +1,146 @@
+#include "LRUCache.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace commons;
+using namespace std;
+
+TEST(LRUCache, basics) {
+    LRUCache<string, int> cache(3, 1);
+    int value;
+
+    EXPECT_FALSE(cache.get("a", value));
+    cache.set("a", 1);
+    cache.set("b", 2);
+    cache.set("c", 3);
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_TRUE(cache.get("a", value));
+    EXPECT_EQ(value, 1);
+
+    // "b" is the least recently used entry
+    cache.set("d", 4);
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_FALSE(cache.get("b", value));
+    EXPECT_TRUE(cache.get("a", value));
+    EXPECT_TRUE(cache.get("c", value));
+    EXPECT_TRUE(cache.get("d", value));
+    EXPECT_EQ(value, 4);
+
+    cache.set("d", 40);
+    EXPECT_TRUE(cache.get("d", value));
+    EXPECT_EQ(value, 40);
+    EXPECT_EQ(cache.size(), 3);
+
+    cache.remove("d");
+    EXPECT_FALSE(cache.get("d", value));
+    EXPECT_EQ(cache.size(), 2);
+
+    EXPECT_EQ(cache.hits(), 5);
+    EXPECT_EQ(cache.misses(), 3);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_FALSE(cache.get("a", value));
+}
+
+TEST(LRUCache, versions) {
+    LRUCache<string, int> cache(4, 2);
+    int value;
+
+    // Removing a key makes values computed before the removal not be stored
+    unsigned long version = cache.version("a");
+    cache.remove("a");
+    EXPECT_FALSE(cache.set_if_unchanged("a", 1, version));
+    EXPECT_FALSE(cache.get("a", value));
+    version = cache.version("a");
+    EXPECT_TRUE(cache.set_if_unchanged("a", 1, version));
+    EXPECT_TRUE(cache.get("a", value));
+    EXPECT_EQ(value, 1);
+
+    // Versions are kept per shard so removals in another shard don't matter
+    string other;
+    for (unsigned int i = 0; other.empty(); i++) {
+        string key = "k" + std::to_string(i);
+        if ((hash<string>()(key) % 2) != (hash<string>()("a") % 2)) {
+            other = key;
+        }
+    }
+    version = cache.version("a");
+    cache.remove(other);
+    EXPECT_TRUE(cache.set_if_unchanged("a", 2, version));
+    cache.clear();
+    EXPECT_FALSE(cache.set_if_unchanged("a", 3, version));
+}
+
+TEST(LRUCache, disabled) {
+    LRUCache<string, int> cache(0);
+    int value;
+    cache.set("a", 1);
+    EXPECT_FALSE(cache.get("a", value));
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.misses(), 1);
+}
+
+TEST(LRUCache, weighted_entries) {
+    LRUCache<string, int> cache(10, 1);
+    int value;
+
+    EXPECT_TRUE(cache.set("a", 1, 4));
+    EXPECT_TRUE(cache.set("b", 2, 4));
+    EXPECT_EQ(cache.weight(), 8);
+    EXPECT_TRUE(cache.get("a", value));
+
+    // "b" is evicted to make room for "c"
+    EXPECT_TRUE(cache.set("c", 3, 5));
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.weight(), 9);
+    EXPECT_EQ(cache.evictions(), 1);
+    EXPECT_FALSE(cache.get("b", value));
+
+    // Replacing an entry updates its weight
+    EXPECT_TRUE(cache.set("c", 30, 1));
+    EXPECT_EQ(cache.weight(), 5);
+    EXPECT_TRUE(cache.get("c", value));
+    EXPECT_EQ(value, 30);
+
+    // Entries heavier than the whole cache are not stored
+    EXPECT_FALSE(cache.set("d", 4, 11));
+    EXPECT_FALSE(cache.get("d", value));
+    EXPECT_EQ(cache.size(), 2);
+
+    // Both remaining entries are evicted
+    EXPECT_TRUE(cache.set("e", 5, 10));
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(cache.evictions(), 3);
+
+    cache.remove("e");
+    EXPECT_EQ(cache.weight(), 0);
+}
+
+TEST(LRUCache, concurrent_access) {
+    unsigned int capacity = 1000;
+    LRUCache<string, unsigned int> cache(capacity, 8);
+    vector<thread> threads;
+    for (unsigned int t = 0; t < 8; t++) {
+        threads.push_back(thread([&cache, t]() {
+            unsigned int value;
+            for (unsigned int i = 0; i < 5000; i++) {
+                string key = to_string((i * 7 + t) % 2000);
+                if (cache.get(key, value)) {
+                    EXPECT_EQ(to_string(value), key);
+                } else {
+                    cache.set(key, (i * 7 + t) % 2000);
+                }
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_LE(cache.size(), capacity);
+    EXPECT_EQ(cache.hits() + cache.misses(), 8 * 5000);
+}
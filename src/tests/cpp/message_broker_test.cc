@@ -1,4 +1,11 @@
+#include <grpcpp/grpcpp.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "MessageBroker.h"
+#include "Utils.h"
 #include "gtest/gtest.h"
 
 using namespace distributed_algorithm_node;
@@ -9,6 +16,29 @@ class MessageFactoryTest : public MessageFactory {
     }
 };
 
+static atomic<unsigned int> received_messages(0);
+
+class CountMessage : public Message {
+   public:
+    void act(shared_ptr<MessageFactory> node) { received_messages++; }
+};
+
+class CountMessageFactory : public MessageFactory {
+    shared_ptr<Message> message_factory(string& command, vector<string>& args) {
+        return make_shared<CountMessage>();
+    }
+};
+
+// Peer which takes too long to answer
+class SlowService final : public dasproto::DistributedAlgorithmNode::Service {
+    grpc::Status execute_message(grpc::ServerContext* context,
+                                 const dasproto::MessageData* request,
+                                 dasproto::Empty* reply) override {
+        Utils::sleep(2000);
+        return grpc::Status::OK;
+    }
+};
+
 TEST(MessageBroker, basics) {
     try {
         MessageBroker::factory((MessageBrokerType) -1, NULL, "");
@@ -42,3 +72,72 @@ TEST(MessageBroker, basics) {
     shared_ptr<MessageBroker> message_broker_grpc = MessageBroker::factory(
         MessageBrokerType::GRPC, shared_ptr<MessageFactory>(new MessageFactoryTest()), "");
 }
+
+TEST(MessageBroker, grpc_peer_channel) {
+    string server_id = "localhost:40051";
+    shared_ptr<MessageBroker> server = MessageBroker::factory(
+        MessageBrokerType::GRPC, shared_ptr<MessageFactory>(new CountMessageFactory()), server_id);
+    server->join_network();
+
+    unsigned int num_threads = 8;
+    unsigned int num_messages = 50;
+    GRPCPeerChannel peer_channel(server_id, 2);
+    dasproto::MessageData message_data;
+    message_data.set_command("count");
+    message_data.set_sender("test");
+    message_data.set_is_broadcast(false);
+    vector<thread> threads;
+    atomic<unsigned int> failures(0);
+    for (unsigned int i = 0; i < num_threads; i++) {
+        threads.push_back(thread([&]() {
+            for (unsigned int j = 0; j < num_messages; j++) {
+                if (!peer_channel.execute_message(message_data).ok()) {
+                    failures++;
+                }
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (unsigned int i = 0; (i < 50) && (received_messages < num_threads * num_messages); i++) {
+        Utils::sleep(100);
+    }
+    EXPECT_EQ(failures, 0);
+    EXPECT_EQ(received_messages, num_threads * num_messages);
+    // The same channel is reused by all rpc calls
+    EXPECT_EQ(peer_channel.connection_count(), 1);
+    EXPECT_TRUE(peer_channel.is_healthy());
+    server->stop();
+
+    // Nobody listening: the message is never sent, so the channel is re-created and the call is
+    // retried once
+    GRPCPeerChannel dead_peer_channel("localhost:40052", 2);
+    EXPECT_FALSE(dead_peer_channel.execute_message(message_data).ok());
+    EXPECT_EQ(dead_peer_channel.connection_count(), 2);
+}
+
+TEST(MessageBroker, grpc_peer_channel_deadline) {
+    string server_id = "localhost:40053";
+    SlowService service;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(server_id, grpc::InsecureServerCredentials());
+    builder.RegisterService(&service);
+    unique_ptr<grpc::Server> server = builder.BuildAndStart();
+
+    GRPCPeerChannel peer_channel(server_id, 2, 200);
+    dasproto::MessageData message_data;
+    message_data.set_command("slow");
+    message_data.set_sender("test");
+    message_data.set_is_broadcast(false);
+    auto start = chrono::steady_clock::now();
+    grpc::Status status = peer_channel.execute_message(message_data);
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::DEADLINE_EXCEEDED);
+    EXPECT_LT(elapsed.count(), 1500);
+    server->Shutdown(chrono::system_clock::now());
+
+    EXPECT_FALSE(MessageBroker::is_idempotent_command("slow"));
+    MessageBroker::add_idempotent_command("slow");
+    EXPECT_TRUE(MessageBroker::is_idempotent_command("slow"));
+}
@@ -0,0 +1,102 @@
+#include "MettaFileLoader.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "InMemoryDB.h"
+#include "MettaParser.h"
+#include "MettaParserActions.h"
+
+using namespace atomdb;
+using namespace atoms;
+using namespace metta;
+using namespace mains;
+using namespace std;
+
+static string FILE_NAME = "/tmp/metta_file_loader_test.metta";
+
+static void write_file(const string& contents) {
+    ofstream file(FILE_NAME, ios::trunc);
+    file << contents;
+    file.close();
+}
+
+// Handles of all the atoms in the passed expressions, parsed one by one
+static set<string> expected_handles(const vector<string>& expressions) {
+    set<string> answer;
+    for (const string& expression : expressions) {
+        auto parser_actions = make_shared<MettaParserActions>();
+        MettaParser parser(expression, parser_actions);
+        EXPECT_FALSE(parser.parse(false));
+        for (const auto& pair : parser_actions->handle_to_atom) {
+            answer.insert(pair.first);
+        }
+    }
+    return answer;
+}
+
+TEST(MettaFileLoader, multi_line_expressions) {
+    vector<string> expressions = {
+        "(Similarity \"human\" \"monkey\")",
+        "(Similarity\n    \"human\"\n    \"chimp\")",
+        "(Inheritance (Concept \"(not a link)\")\n    (Concept \"mammal\"))",
+        "(Evaluation \"a\\\"b\" (List 1 2 3))",
+        "(Similarity \"human\" \"monkey\")",
+        "(Inheritance human mammal)",
+        "(Inheritance chimp mammal)"};
+    string contents = "";
+    for (const string& expression : expressions) {
+        contents += expression + "\n\n";
+    }
+    write_file(contents);
+    for (unsigned int chunk_size : {1, 2, 3, 100}) {
+        auto db = make_shared<InMemoryDB>("metta_file_loader_test_");
+        MettaFileLoader loader(db, 2, 2, chunk_size, 2);
+        loader.set_progress_interval(0);
+        loader.load(FILE_NAME);
+        EXPECT_EQ(loader.expression_count(), expressions.size());
+        EXPECT_EQ(loader.parse_error_count(), 0);
+        EXPECT_EQ(loader.write_error_count(), 0);
+        set<string> handles = expected_handles(expressions);
+        EXPECT_GE(loader.atom_count(), handles.size());
+        for (const string& handle : handles) {
+            EXPECT_TRUE(db->atom_exists(handle)) << handle;
+        }
+    }
+}
+
+TEST(MettaFileLoader, invalid_expressions) {
+    vector<string> valid = {"(Similarity \"human\" \"monkey\")",
+                            "(Similarity (Concept \"chimp\") \"human\")",
+                            "(Inheritance human mammal)"};
+    // Stray ')' after the second expression
+    write_file(valid[0] + "\n" + valid[1] + ")\n" + valid[2] + "\n");
+    auto db = make_shared<InMemoryDB>("metta_file_loader_test_");
+    MettaFileLoader loader(db, 1, 1, 10, 1);
+    loader.set_progress_interval(0);
+    loader.load(FILE_NAME);
+    // The stray ')' is a toplevel expression by itself
+    EXPECT_EQ(loader.expression_count(), 4);
+    EXPECT_EQ(loader.parse_error_count(), 1);
+    set<string> handles = expected_handles(valid);
+    EXPECT_EQ(loader.atom_count(), handles.size());
+    for (const string& handle : handles) {
+        EXPECT_TRUE(db->atom_exists(handle)) << handle;
+    }
+}
+
+TEST(MettaFileLoader, empty_file) {
+    write_file("");
+    auto db = make_shared<InMemoryDB>("metta_file_loader_test_");
+    MettaFileLoader loader(db);
+    loader.load(FILE_NAME);
+    EXPECT_EQ(loader.expression_count(), 0);
+    EXPECT_EQ(loader.atom_count(), 0);
+    EXPECT_THROW(loader.load("/tmp/metta_file_loader_test_missing_file.metta"), runtime_error);
+    EXPECT_THROW(MettaFileLoader(db, 0), runtime_error);
+}
@@ -605,6 +605,70 @@ TEST(PatternMatchingQuery, queries) {
     }
     EXPECT_EQ(count, 1U);
 
+    // Query plan
+    shared_ptr<PatternMatchingQueryProxy> explain_proxy(new PatternMatchingQueryProxy(q3, "PatternMatchingQuery.queries"));
+    explain_proxy->parameters[PatternMatchingQueryProxy::COST_BASED_JOIN_FLAG] = true;
+    explain_proxy->parameters[PatternMatchingQueryProxy::EXPLAIN_FLAG] = true;
+    client_bus->issue_bus_command(explain_proxy);
+    while (!explain_proxy->finished()) {
+        Utils::sleep();
+    }
+    EXPECT_FALSE(explain_proxy->error_flag);
+    EXPECT_TRUE(explain_proxy->pop() == nullptr);
+    vector<string> plan = explain_proxy->get_query_plan();
+    ASSERT_EQ(plan.size(), 3U);
+    EXPECT_EQ(plan[0].find("AND [best-first product]"), 0U);
+    EXPECT_EQ(plan[1].find("  LinkTemplate "), 0U);
+    EXPECT_EQ(plan[2].find("  LinkTemplate "), 0U);
+    for (auto line : plan) {
+        EXPECT_NE(line.find("(estimated answers: "), string::npos);
+    }
+
+    // exists_only queries (q1 is answered by the pattern index, q3 stops after its first answer)
+    vector<string> no_match = {
+        "LINK_TEMPLATE", "Expression", "3",
+            "NODE", "Symbol", "Unknown",
+            "VARIABLE", "v1",
+            "VARIABLE", "v2"
+    };
+    vector<vector<string>> exists_queries = {q1, q3, no_match};
+    vector<unsigned int> exists_expected = {1, 1, 0};
+    for (unsigned int i = 0; i < exists_queries.size(); i++) {
+        shared_ptr<PatternMatchingQueryProxy> exists_proxy(new PatternMatchingQueryProxy(exists_queries[i], "PatternMatchingQuery.queries"));
+        exists_proxy->parameters[PatternMatchingQueryProxy::EXISTS_FLAG] = true;
+        client_bus->issue_bus_command(exists_proxy);
+        while (!exists_proxy->finished()) {
+            Utils::sleep();
+        }
+        EXPECT_FALSE(exists_proxy->error_flag);
+        EXPECT_EQ(exists_proxy->get_count(), exists_expected[i]);
+        EXPECT_THROW(exists_proxy->pop(), runtime_error);
+    }
+
+    // Pagination (q1 has 14 answers)
+    vector<vector<unsigned int>> pages = {{5, 0, 5}, {5, 10, 4}, {0, 12, 2}, {5, 20, 0}};
+    for (auto page : pages) {
+        shared_ptr<PatternMatchingQueryProxy> page_proxy(new PatternMatchingQueryProxy(q1, "PatternMatchingQuery.queries"));
+        page_proxy->parameters[BaseQueryProxy::MAX_ANSWERS] = page[0];
+        page_proxy->parameters[PatternMatchingQueryProxy::OFFSET] = page[1];
+        client_bus->issue_bus_command(page_proxy);
+        count = 0;
+        while (!page_proxy->finished()) {
+            while (!(answer = page_proxy->pop())) {
+                if (page_proxy->finished()) {
+                    break;
+                } else {
+                    Utils::sleep();
+                }
+            }
+            if (answer) {
+                count++;
+            }
+        }
+        EXPECT_FALSE(page_proxy->error_flag);
+        EXPECT_EQ(count, page[2]);
+    }
+
     // clang-format on
 }
 
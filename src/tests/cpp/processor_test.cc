@@ -4,7 +4,9 @@
 
 #include "DedicatedThread.h"
 #include "Logger.h"
+#include "PooledThread.h"
 #include "Utils.h"
+#include "WorkStealingExecutor.h"
 #include "processor/ThreadPool.h"
 
 using namespace std;
@@ -217,6 +219,184 @@ TEST(ProcessorTest, thread_pool) {
     }
 }
 
+class CounterThreadMethod : public ThreadMethod {
+   public:
+    atomic<unsigned int> count;
+    atomic<unsigned int> available;
+    unsigned int target;
+    CounterThreadMethod(unsigned int target, unsigned int available) {
+        this->count = 0;
+        this->target = target;
+        this->available = available;
+    }
+    bool thread_one_step() {
+        if (this->available == 0) {
+            return false;
+        }
+        this->available--;
+        this->count++;
+        return true;
+    }
+    bool thread_finished() { return (this->target > 0) && (this->count == this->target); }
+};
+
+TEST(ProcessorTest, pooled_thread) {
+    auto executor = make_shared<WorkStealingExecutor>("executor", 2);
+    executor->setup();
+    executor->start();
+    CounterThreadMethod job(0, 0);
+    PooledThread pooled_thread("blah", &job, nullptr, executor);
+    pooled_thread.setup();
+    pooled_thread.start();
+    Utils::sleep(200);
+    EXPECT_EQ(job.count, 0);
+    // Woken up tasks don't wait for the idle timeout
+    for (unsigned int i = 1; i <= 10; i++) {
+        job.available = 1;
+        pooled_thread.wake();
+        unsigned int wait = 0;
+        while ((job.count < i) && (wait++ < 10)) {
+            Utils::sleep(5);
+        }
+        EXPECT_EQ(job.count, i);
+    }
+    // Not woken up tasks are run again when the idle timeout expires
+    job.available = 5;
+    Utils::sleep(3 * WorkStealingExecutor::IDLE_TIMEOUT);
+    EXPECT_EQ(job.count, 15);
+    EXPECT_FALSE(pooled_thread.stopped());
+    pooled_thread.stop();
+    EXPECT_TRUE(pooled_thread.stopped());
+    job.available = 5;
+    pooled_thread.wake();
+    Utils::sleep(3 * WorkStealingExecutor::IDLE_TIMEOUT);
+    EXPECT_EQ(job.count, 15);
+    executor->stop();
+}
+
+TEST(ProcessorTest, work_stealing_executor) {
+    for (unsigned int n_threads : {1, 2, 4, 8}) {
+        auto executor = make_shared<WorkStealingExecutor>("executor", n_threads);
+        EXPECT_EQ(executor->size(), n_threads);
+        executor->setup();
+        executor->start();
+        // Way more tasks than threads, each of them yielding the worker several times
+        unsigned int n_tasks = 200;
+        unsigned int n_steps = 10 * WorkStealingExecutor::STEPS_PER_SLICE + 1;
+        vector<shared_ptr<CounterThreadMethod>> jobs;
+        vector<shared_ptr<PooledThread>> threads;
+        for (unsigned int i = 0; i < n_tasks; i++) {
+            jobs.push_back(make_shared<CounterThreadMethod>(n_steps, n_steps));
+            threads.push_back(make_shared<PooledThread>(
+                "task_" + std::to_string(i), jobs.back().get(), nullptr, executor));
+            threads.back()->setup();
+            threads.back()->start();
+        }
+        unsigned int wait = 0;
+        bool all_finished = false;
+        while (!all_finished && (wait++ < 100)) {
+            Utils::sleep(100);
+            all_finished = true;
+            for (auto job : jobs) {
+                all_finished = all_finished && job->thread_finished();
+            }
+        }
+        EXPECT_TRUE(all_finished);
+        for (unsigned int i = 0; i < n_tasks; i++) {
+            EXPECT_EQ(jobs[i]->count, n_steps);
+            threads[i]->stop();
+        }
+        executor->stop();
+    }
+}
+
+// Job whose steps block (e.g. waiting for a remote call) for step_time milliseconds
+class BlockingThreadMethod : public ThreadMethod {
+   public:
+    atomic<bool> finished;
+    unsigned int step_time;
+    BlockingThreadMethod(unsigned int step_time) : finished(false), step_time(step_time) {}
+    bool thread_one_step() {
+        Utils::sleep(this->step_time);
+        return true;
+    }
+    bool thread_finished() { return this->finished; }
+};
+
+TEST(ProcessorTest, shared_executors) {
+    auto executor = WorkStealingExecutor::get_shared();
+    auto io_executor = WorkStealingExecutor::get_shared_io();
+    EXPECT_NE(executor, io_executor);
+    EXPECT_EQ(executor, WorkStealingExecutor::get_shared());
+    EXPECT_EQ(io_executor, WorkStealingExecutor::get_shared_io());
+    EXPECT_GE(executor->size(), WorkStealingExecutor::MIN_SHARED_THREADS);
+    EXPECT_GE(io_executor->size(), WorkStealingExecutor::MIN_SHARED_IO_THREADS);
+
+    // Blocking steps in every I/O worker don't delay the tasks in the other executor
+    vector<shared_ptr<BlockingThreadMethod>> blocking_jobs;
+    vector<shared_ptr<PooledThread>> blocking_threads;
+    for (unsigned int i = 0; i < io_executor->size(); i++) {
+        blocking_jobs.push_back(make_shared<BlockingThreadMethod>(200));
+        blocking_threads.push_back(make_shared<PooledThread>(
+            "blocking_" + std::to_string(i), blocking_jobs.back().get(), nullptr, io_executor));
+        blocking_threads.back()->setup();
+        blocking_threads.back()->start();
+    }
+    CounterThreadMethod job(100, 100);
+    PooledThread pooled_thread("counter", &job, nullptr, executor);
+    pooled_thread.setup();
+    pooled_thread.start();
+    unsigned int wait = 0;
+    while (!job.thread_finished() && (wait++ < 50)) {
+        Utils::sleep(10);
+    }
+    EXPECT_TRUE(job.thread_finished());
+    pooled_thread.stop();
+    for (auto job : blocking_jobs) {
+        job->finished = true;
+    }
+    for (auto thread : blocking_threads) {
+        thread->stop();
+    }
+}
+
+TEST(ProcessorTest, cancellation_token) {
+    auto executor = make_shared<WorkStealingExecutor>("executor", 4);
+    executor->setup();
+    executor->start();
+    auto token = make_shared<CancellationToken>();
+    auto other_token = make_shared<CancellationToken>();
+    vector<shared_ptr<CounterThreadMethod>> jobs;
+    vector<shared_ptr<PooledThread>> threads;
+    for (unsigned int i = 0; i < 20; i++) {
+        jobs.push_back(make_shared<CounterThreadMethod>(0, 1000000000));
+        threads.push_back(make_shared<PooledThread>(
+            "task_" + std::to_string(i), jobs.back().get(), (i % 2) ? token : other_token, executor));
+        threads.back()->setup();
+        threads.back()->start();
+    }
+    Utils::sleep(200);
+    EXPECT_FALSE(token->is_cancelled());
+    token->cancel();
+    EXPECT_TRUE(token->is_cancelled());
+    Utils::sleep(200);
+    vector<unsigned int> count;
+    for (unsigned int i = 0; i < jobs.size(); i++) {
+        EXPECT_EQ(threads[i]->stopped(), (i % 2) == 1);
+        count.push_back(jobs[i]->count);
+    }
+    Utils::sleep(200);
+    for (unsigned int i = 0; i < jobs.size(); i++) {
+        if (i % 2) {
+            EXPECT_EQ(jobs[i]->count, count[i]);
+        } else {
+            EXPECT_GT(jobs[i]->count, count[i]);
+        }
+        threads[i]->stop();
+    }
+    executor->stop();
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     Utils::init_random(0);
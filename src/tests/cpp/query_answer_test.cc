@@ -90,6 +90,99 @@ TEST(QueryAnswer, assignments_basics) {
     EXPECT_TRUE(mapping4.to_string() != "");
 }
 
+TEST(QueryAnswer, assignments_table) {
+    Assignment mapping1;
+    EXPECT_TRUE(mapping1.assign("v3", "3"));
+    EXPECT_TRUE(mapping1.assign("v1", "1"));
+    EXPECT_TRUE(mapping1.assign("v2", "2"));
+    Assignment mapping2;
+    EXPECT_TRUE(mapping2.assign("v2", "2"));
+    EXPECT_TRUE(mapping2.assign("v1", "1"));
+    EXPECT_TRUE(mapping2.assign("v3", "3"));
+
+    // Iteration is in label order regardless of the order of the assignments
+    vector<string> labels;
+    for (auto pair : mapping1.table) {
+        labels.push_back(pair.first);
+        EXPECT_EQ(pair.second, mapping1.get(pair.first));
+    }
+    EXPECT_EQ(labels, vector<string>({"v1", "v2", "v3"}));
+    EXPECT_EQ(mapping1.to_string(), "{(v1: 1), (v2: 2), (v3: 3)}");
+    EXPECT_TRUE(mapping1 == mapping2);
+    EXPECT_EQ(mapping1.hash(), mapping2.hash());
+
+    EXPECT_TRUE(mapping1.table.find("v2") != mapping1.table.end());
+    EXPECT_EQ((*mapping1.table.find("v2")).second, "2");
+    EXPECT_TRUE(mapping1.table.find("v4") == mapping1.table.end());
+    EXPECT_TRUE(mapping1.table.find("never_assigned_label") == mapping1.table.end());
+    EXPECT_EQ(mapping1.get("never_assigned_label"), "");
+
+    // Copies are independent
+    Assignment mapping3 = mapping1;
+    EXPECT_TRUE(mapping3.assign("v4", "4"));
+    EXPECT_EQ(mapping1.variable_count(), 3);
+    EXPECT_EQ(mapping3.variable_count(), 4);
+    EXPECT_FALSE(mapping1 == mapping3);
+    mapping3.clear();
+    EXPECT_EQ(mapping3.variable_count(), 0);
+    EXPECT_EQ(mapping3.hash(), Assignment().hash());
+
+    // More variables than bits in the id mask
+    Assignment mapping4;
+    Assignment mapping5;
+    for (unsigned int i = 0; i < MAX_NUMBER_OF_VARIABLES_IN_QUERY; i++) {
+        EXPECT_TRUE(mapping4.assign("x" + std::to_string(i), std::to_string(i)));
+        EXPECT_TRUE(mapping5.assign("y" + std::to_string(i), std::to_string(i)));
+    }
+    EXPECT_GE(VariableDictionary::size(), 2 * MAX_NUMBER_OF_VARIABLES_IN_QUERY);
+    EXPECT_TRUE(mapping4.is_compatible(mapping5));
+    EXPECT_TRUE(mapping4.assign("x70", "70"));
+    EXPECT_FALSE(mapping4.assign("x70", "7"));
+    EXPECT_EQ(mapping4.get("x70"), "70");
+    EXPECT_EQ(mapping4.get("x6"), "6");
+    EXPECT_THROW(mapping4.assign("x_too_many", "0"), runtime_error);
+}
+
+TEST(QueryAnswer, assignments_handle_values) {
+    string handle1 = "0123456789abcdef0123456789abcdef";
+    string handle2 = "fedcba9876543210fedcba9876543210";
+    Assignment mapping1;
+    EXPECT_TRUE(mapping1.assign("v1", handle1));
+    EXPECT_TRUE(mapping1.assign("v2", "not a handle"));
+    EXPECT_TRUE(mapping1.assign("v3", "0123456789ABCDEF0123456789ABCDEF"));
+    Assignment mapping2;
+    EXPECT_TRUE(mapping2.assign("v1", Handle(handle1)));
+    EXPECT_TRUE(mapping2.assign("v2", "not a handle"));
+    EXPECT_TRUE(mapping2.assign("v3", "0123456789ABCDEF0123456789ABCDEF"));
+
+    // Lower case hex handles are kept as Handles, anything else is kept as is
+    EXPECT_TRUE(mapping1.get("v1").is_handle());
+    EXPECT_FALSE(mapping1.get("v2").is_handle());
+    EXPECT_FALSE(mapping1.get("v3").is_handle());
+    EXPECT_EQ(mapping1.get("v1"), handle1);
+    EXPECT_EQ(mapping1.get("v2"), "not a handle");
+    EXPECT_EQ(mapping1.get("v3"), "0123456789ABCDEF0123456789ABCDEF");
+    EXPECT_EQ(mapping1.to_string(),
+              "{(v1: " + handle1 + "), (v2: not a handle), (v3: 0123456789ABCDEF0123456789ABCDEF)}");
+    EXPECT_TRUE(mapping1 == mapping2);
+    EXPECT_EQ(mapping1.hash(), mapping2.hash());
+    EXPECT_TRUE(mapping1.is_compatible(mapping2));
+
+    EXPECT_TRUE(mapping2.assign("v1", handle1));
+    EXPECT_FALSE(mapping2.assign("v1", Handle(handle2)));
+    EXPECT_FALSE(mapping2.assign("v3", "0123456789abcdef0123456789abcdef"));
+    Assignment mapping3;
+    EXPECT_TRUE(mapping3.assign("v1", handle2));
+    EXPECT_FALSE(mapping1.is_compatible(mapping3));
+
+    // Copies share nothing with the original
+    Assignment mapping4 = mapping1;
+    mapping1.clear();
+    EXPECT_EQ(mapping4.get("v1"), handle1);
+    EXPECT_EQ(mapping4.get("v2"), "not a handle");
+    EXPECT_TRUE(mapping4 == mapping2);
+}
+
 TEST(QueryAnswer, unique_assignment_flag) {
     Assignment mapping1(true);
     EXPECT_TRUE(mapping1.assign("v1", "1"));
@@ -448,6 +541,95 @@ void query_answers_equal_including_metta(QueryAnswer* qa1, QueryAnswer* qa2) {
     EXPECT_EQ(qa1->metta_expression, qa2->metta_expression);
 }
 
+TEST(QueryAnswer, binary_tokenization) {
+    unsigned int NUM_TESTS = 10000;
+    unsigned int BUNDLE_SIZE = 100;
+    unsigned int MAX_PATHS = 5;
+    unsigned int MAX_PATH_SIZE = 10;
+    unsigned int MAX_HANDLES = 5;
+    unsigned int MAX_ASSIGNMENTS = 10;
+
+    BinaryAnswerWriter writer;
+    vector<QueryAnswer*> bundle;
+    for (unsigned int test = 0; test < NUM_TESTS; test++) {
+        QueryAnswer* input = new QueryAnswer((double) rand() / RAND_MAX);
+        input->strength = (double) rand() / RAND_MAX;
+        unsigned int num_handles = (rand() % MAX_HANDLES) + 1;
+        for (unsigned int i = 0; i < num_handles; i++) {
+            input->add_handle(random_handle());
+        }
+        unsigned int num_paths = rand() % MAX_PATHS;
+        for (unsigned int i = 0; i < num_paths; i++) {
+            unsigned int path_index = input->add_path();
+            unsigned int path_size = (rand() % MAX_PATH_SIZE) + 1;
+            for (unsigned int j = 0; j < path_size; j++) {
+                input->add_path_element(path_index, random_handle());
+            }
+        }
+        unsigned int num_assignments = rand() % MAX_ASSIGNMENTS;
+        for (unsigned int i = 0; i < num_assignments; i++) {
+            input->assignment.assign("v" + std::to_string(rand() % (2 * MAX_ASSIGNMENTS)),
+                                     random_handle());
+        }
+        if (Utils::flip_coin(0.1)) {
+            input->metta_expression[input->get_handles_vector()[0]] = "(Similarity \"a b\" (c))";
+        }
+        if (Utils::flip_coin(0.01)) {
+            // Not a valid hex handle so handles are written as strings
+            input->add_handle("h" + std::to_string(test));
+        }
+        writer.add(input);
+        bundle.push_back(input);
+        if ((bundle.size() == BUNDLE_SIZE) || (test == (NUM_TESTS - 1))) {
+            EXPECT_EQ(writer.size(), bundle.size());
+            string buffer = Utils::base64_decode(Utils::base64_encode(writer.buffer()));
+            EXPECT_TRUE(BinaryAnswerReader::is_binary_bundle(buffer));
+            BinaryAnswerReader reader(buffer);
+            for (QueryAnswer* expected : bundle) {
+                QueryAnswer* output = reader.next();
+                ASSERT_TRUE(output != NULL);
+                EXPECT_EQ(output->strength, expected->strength);
+                EXPECT_EQ(output->importance, expected->importance);
+                query_answers_equal_including_metta(expected, output);
+                delete output;
+                delete expected;
+            }
+            EXPECT_TRUE(reader.next() == NULL);
+            bundle.clear();
+            writer.clear();
+        }
+    }
+    EXPECT_EQ(writer.size(), 0);
+}
+
+TEST(QueryAnswer, binary_bundle_validation) {
+    QueryAnswer answer(random_handle(), 0.5);
+    answer.assignment.assign("v1", random_handle());
+    BinaryAnswerWriter writer;
+    writer.add(&answer);
+    string buffer = writer.buffer();
+    unsigned int header_size = strlen(BinaryAnswerWriter::BINARY_FORMAT_MAGIC) + 1;
+
+    EXPECT_FALSE(BinaryAnswerReader::is_binary_bundle(answer.tokenize()));
+    EXPECT_THROW(BinaryAnswerReader reader(answer.tokenize()), runtime_error);
+
+    // Unknown version
+    string newer_version = buffer;
+    newer_version[header_size - 1] = (char) (BinaryAnswerWriter::BINARY_FORMAT_VERSION + 1);
+    EXPECT_THROW(BinaryAnswerReader reader(newer_version), runtime_error);
+
+    // Truncated answer
+    string truncated = buffer.substr(0, buffer.size() - 1);
+    BinaryAnswerReader truncated_reader(truncated);
+    EXPECT_THROW(truncated_reader.next(), runtime_error);
+
+    // Empty bundle
+    writer.clear();
+    string empty = writer.buffer();
+    BinaryAnswerReader empty_reader(empty);
+    EXPECT_TRUE(empty_reader.next() == NULL);
+}
+
 TEST(QueryAnswer, json_rebuild) {
     QueryAnswer input(0.75);
     input.strength = 0.25;
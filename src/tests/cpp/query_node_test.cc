@@ -65,3 +65,134 @@ TEST(QueryNode, basics) {
     EXPECT_TRUE(client2.is_query_answers_empty());
     EXPECT_TRUE(client2.is_query_answers_finished());
 }
+
+TEST(QueryNode, wait_query_answer) {
+    string server_id = "wait_server";
+    string client_id = "wait_client";
+
+    QueryNodeServer server(server_id);
+    QueryNodeClient client(client_id, server_id);
+    StopWatch timer;
+
+    EXPECT_FALSE(server.wait_query_answer(200));
+
+    timer.start();
+    client.add_query_answer((QueryAnswer*) 1);
+    while (server.is_query_answers_empty()) {
+        server.wait_query_answer(10000);
+    }
+    timer.stop();
+    // Answers are not supposed to wait for any polling interval to flow from client to server
+    EXPECT_TRUE(timer.milliseconds() < 100);
+    ASSERT_TRUE(server.pop_query_answer() == (QueryAnswer*) 1);
+
+    shared_ptr<EventSignal> signal = make_shared<EventSignal>();
+    server.set_query_answer_signal(signal);
+    EXPECT_TRUE(signal->wait(0));
+    client.query_answers_finished();
+    while (!server.is_query_answers_finished()) {
+        EXPECT_TRUE(signal->wait(10000));
+    }
+}
+
+TEST(QueryNode, query_answer_channel) {
+    QueryAnswerChannel channel(4);
+    deque<unique_ptr<QueryAnswer>> batch;
+    for (unsigned int i = 0; i < 6; i++) {
+        batch.push_back(make_unique<QueryAnswer>((double) i));
+    }
+    unsigned int wake_count = 0;
+    EXPECT_EQ(channel.push(batch, [&wake_count]() { wake_count++; }), 4);
+    EXPECT_EQ(channel.size(), 4);
+    EXPECT_EQ(batch.size(), 2);
+
+    // Producers are woken up only when the channel is drained to half its capacity
+    delete channel.pop();
+    EXPECT_EQ(wake_count, 0);
+    QueryAnswer* query_answer = channel.pop();
+    EXPECT_EQ(query_answer->importance, 1.0);
+    delete query_answer;
+    EXPECT_EQ(wake_count, 1);
+
+    EXPECT_EQ(channel.push(batch, [&wake_count]() { wake_count++; }), 2);
+    EXPECT_TRUE(batch.empty());
+    for (unsigned int i = 2; i < 6; i++) {
+        query_answer = channel.pop();
+        EXPECT_EQ(query_answer->importance, (double) i);
+        delete query_answer;
+    }
+    EXPECT_TRUE(channel.empty());
+    EXPECT_TRUE(channel.pop() == NULL);
+    EXPECT_EQ(wake_count, 1);
+}
+
+TEST(QueryNode, local_channel_backpressure) {
+    string server_id = "channel_server";
+    string client_id = "channel_client";
+    unsigned int num_answers = 1000;
+
+    QueryNodeServer server(server_id, MessageBrokerType::RAM, 10);
+    QueryNodeClient client(client_id, server_id);
+
+    for (unsigned int i = 0; i < num_answers; i++) {
+        client.add_query_answer(new QueryAnswer((double) i));
+    }
+    client.query_answers_finished();
+
+    unsigned int count = 0;
+    while (!(server.is_query_answers_finished() && server.is_query_answers_empty())) {
+        QueryAnswer* query_answer = server.pop_query_answer();
+        if (query_answer == NULL) {
+            server.wait_query_answer(10000);
+        } else {
+            EXPECT_EQ(query_answer->importance, (double) count);
+            delete query_answer;
+            count++;
+        }
+    }
+    EXPECT_EQ(count, num_answers);
+}
+
+TEST(QueryNode, producer_backpressure) {
+    string server_id = "backpressure_server";
+    string client_id = "backpressure_client";
+    unsigned int num_answers = 1000;
+    unsigned int capacity = 10;
+
+    QueryNodeServer server(server_id, MessageBrokerType::RAM, capacity);
+    QueryNodeClient client(client_id, server_id);
+
+    atomic<bool> producer_waiting(false);
+    atomic<unsigned int> count_wakeups(0);
+    unsigned int count_added = 0;
+    unsigned int count = 0;
+    while (count < num_answers) {
+        // The producer yields when the client is full and resumes when it's woken up
+        while ((count_added < num_answers) && !producer_waiting) {
+            producer_waiting = true;
+            if (!client.has_room([&producer_waiting, &count_wakeups]() {
+                    count_wakeups++;
+                    producer_waiting = false;
+                })) {
+                break;
+            }
+            producer_waiting = false;
+            client.add_query_answer(new QueryAnswer((double) count_added++));
+            if (count_added == num_answers) {
+                client.query_answers_finished();
+            }
+        }
+        // Answers wait in the client's queue, in the batch being pushed and in the channel
+        EXPECT_LE(count_added - count, 3 * capacity);
+        QueryAnswer* query_answer = server.pop_query_answer();
+        if (query_answer == NULL) {
+            server.wait_query_answer(100);
+        } else {
+            EXPECT_EQ(query_answer->importance, (double) count);
+            delete query_answer;
+            count++;
+        }
+    }
+    EXPECT_EQ(count, num_answers);
+    EXPECT_GT(count_wakeups, 0);
+}
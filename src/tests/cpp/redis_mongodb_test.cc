@@ -381,6 +381,69 @@ TEST_F(RedisMongoDBTest, AddGetAndDeleteNode) {
     EXPECT_TRUE(deleted);
 }
 
+TEST_F(RedisMongoDBTest, AtomCache) {
+    auto node = new Node("Symbol", "AtomCacheNode");
+    auto handle = db->add_node(node);
+
+    auto hits = db->atom_cache_hits();
+    auto misses = db->atom_cache_misses();
+    auto first = db->get_node(handle);
+    auto second = db->get_node(handle);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(first->name, "AtomCacheNode");
+    EXPECT_EQ(second->name, "AtomCacheNode");
+    // Cached atoms are copied so callers can't change the cached object
+    EXPECT_NE(first.get(), second.get());
+    EXPECT_EQ(db->atom_cache_misses(), misses + 1);
+    EXPECT_EQ(db->atom_cache_hits(), hits + 1);
+
+    // Replacing the atom invalidates its cache entry
+    Properties custom_attributes;
+    custom_attributes["weight"] = 0.5;
+    auto updated = new Node("Symbol", "AtomCacheNode", false, custom_attributes);
+    db->add_node(updated);
+    auto third = db->get_node(handle);
+    EXPECT_EQ(db->atom_cache_misses(), misses + 2);
+    EXPECT_EQ(third->custom_attributes.get<double>("weight"), 0.5);
+
+    EXPECT_TRUE(db->delete_node(handle));
+    EXPECT_EQ(db->get_node(handle), nullptr);
+}
+
+TEST_F(RedisMongoDBTest, AtomCacheReadsInterleavedWithUpdates) {
+    auto node = new Node("Symbol", "AtomCacheInterleavedNode");
+    auto handle = db->add_node(node);
+
+    // Readers keep filling the cache while the atom is replaced and then deleted
+    atomic<bool> stop_flag{false};
+    vector<thread> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&]() {
+            while (!stop_flag) {
+                db->get_node(handle);
+            }
+        });
+    }
+    const int num_updates = 50;
+    for (int i = 1; i <= num_updates; i++) {
+        Properties custom_attributes;
+        custom_attributes["weight"] = (double) i;
+        auto updated = new Node("Symbol", "AtomCacheInterleavedNode", false, custom_attributes);
+        db->add_node(updated);
+        auto current = db->get_node(handle);
+        ASSERT_NE(current, nullptr);
+        EXPECT_EQ(current->custom_attributes.get<double>("weight"), (double) i);
+    }
+    EXPECT_TRUE(db->delete_node(handle));
+    EXPECT_EQ(db->get_node(handle), nullptr);
+    stop_flag = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(db->get_node(handle), nullptr);
+}
+
 TEST_F(RedisMongoDBTest, AddAndDeleteNodes) {
     vector<Node*> nodes;
     for (int i = 0; i < 10; i++) {
@@ -474,6 +537,38 @@ TEST_F(RedisMongoDBTest, AddAndDeleteLinks) {
     EXPECT_EQ(db->delete_nodes(test_node_handles), test_node_handles.size());
 }
 
+TEST_F(RedisMongoDBTest, AddLinksWithSmallWriteBatch) {
+    vector<Link*> links;
+    vector<string> test_node_handles;
+
+    // Forces several flushes (and score reservations) in a single add_links() call
+    uint write_batch_size = RedisMongoDB::REDIS_WRITE_BATCH_SIZE;
+    RedisMongoDB::REDIS_WRITE_BATCH_SIZE = 3;
+
+    auto similarity_node = new Node("Symbol", "WriteBatchSimilarity");
+    test_node_handles.push_back(db->add_node(similarity_node));
+    for (int i = 0; i < 10; i++) {
+        auto test_1_node = new Node("Symbol", "write-batch-1-" + to_string(i));
+        auto test_2_node = new Node("Symbol", "write-batch-2-" + to_string(i));
+        test_node_handles.push_back(db->add_node(test_1_node));
+        test_node_handles.push_back(db->add_node(test_2_node));
+        links.push_back(new Link(
+            "Expression", {similarity_node->handle(), test_1_node->handle(), test_2_node->handle()}));
+    }
+
+    auto handles = db->add_links(links);
+    RedisMongoDB::REDIS_WRITE_BATCH_SIZE = write_batch_size;
+    EXPECT_EQ(handles.size(), 10);
+    EXPECT_EQ(db->query_for_incoming_set(similarity_node->handle())->size(), 10);
+    for (auto link : links) {
+        EXPECT_EQ(db->query_for_incoming_set(link->targets[1])->size(), 1);
+    }
+
+    EXPECT_EQ(db->delete_atoms(handles), 10);
+    EXPECT_EQ(db->query_for_incoming_set(similarity_node->handle())->size(), 0);
+    EXPECT_EQ(db->delete_nodes(test_node_handles), test_node_handles.size());
+}
+
 TEST_F(RedisMongoDBTest, DeleteNodesAndLinks) {
     vector<atoms::Node*> nodes;
     vector<atoms::Link*> links;
@@ -679,6 +774,49 @@ TEST_F(RedisMongoDBTest, QueryForIncomingSet) {
     EXPECT_EQ(db->atoms_exist(handles).size(), 0);
 }
 
+TEST_F(RedisMongoDBTest, StreamedIncomingSetWithMaxResults) {
+    vector<Link*> links;
+    vector<string> test_node_handles;
+
+    // Forces the incoming set to be streamed in several chunks
+    uint chunk_size = RedisMongoDB::REDIS_CHUNK_SIZE;
+    RedisMongoDB::REDIS_CHUNK_SIZE = 3;
+
+    auto symbol = new Node("Symbol", "StreamedIncomingSet");
+    test_node_handles.push_back(db->add_node(symbol));
+    for (int i = 0; i < 10; i++) {
+        auto node = new Node("Symbol", "streamed-" + to_string(i));
+        test_node_handles.push_back(db->add_node(node));
+        links.push_back(new Link("Expression", {symbol->handle(), node->handle()}));
+    }
+    auto handles = db->add_links(links);
+
+    auto handle_set = db->query_for_incoming_set(symbol->handle());
+    EXPECT_EQ(handle_set->size(), 10);
+    set<string> streamed;
+    auto iterator = handle_set->get_iterator();
+    char* handle;
+    while ((handle = iterator->next()) != nullptr) {
+        streamed.insert(string(handle));
+    }
+    EXPECT_EQ(streamed, set<string>(handles.begin(), handles.end()));
+
+    // The limit is pushed down through the AtomDB interface
+    shared_ptr<AtomDB> atomdb = db;
+    handle_set = atomdb->query_for_incoming_set(symbol->handle(), 4);
+    EXPECT_EQ(handle_set->size(), 4);
+    unsigned int count = 0;
+    iterator = handle_set->get_iterator();
+    while ((handle = iterator->next()) != nullptr) {
+        count++;
+    }
+    EXPECT_EQ(count, 4);
+
+    RedisMongoDB::REDIS_CHUNK_SIZE = chunk_size;
+    EXPECT_EQ(db->delete_atoms(handles), 10);
+    EXPECT_EQ(db->delete_nodes(test_node_handles), test_node_handles.size());
+}
+
 TEST_F(RedisMongoDBTest, QueryForSimilarityIncomingSet) {
     vector<string> handles;
 
@@ -1185,6 +1185,174 @@ TEST(RemoteAtomDBFederationTest, ConcurrentAddAndReleaseLosesNoWrites) {
     }
 }
 
+namespace {
+// Backend whose reads take delay_ms milliseconds. Used to verify that RemoteAtomDB fans reads out
+// to peers concurrently (and gives up on slow peers when a peer timeout is set).
+class SlowInMemoryDB : public InMemoryDB {
+   public:
+    SlowInMemoryDB(const string& context, unsigned int delay_ms)
+        : InMemoryDB(context), delay_ms(delay_ms) {}
+
+    unsigned int delay_ms;
+
+    shared_ptr<Atom> get_atom(const string& handle) override {
+        this_thread::sleep_for(chrono::milliseconds(delay_ms));
+        return InMemoryDB::get_atom(handle);
+    }
+
+    shared_ptr<HandleSet> query_for_pattern(const LinkSchema& link_schema) override {
+        this_thread::sleep_for(chrono::milliseconds(delay_ms));
+        return InMemoryDB::query_for_pattern(link_schema);
+    }
+};
+
+set<string> handle_set_members(shared_ptr<HandleSet> handle_set) {
+    set<string> members;
+    auto it = handle_set->get_iterator();
+    char* h;
+    while ((h = it->next()) != nullptr) {
+        members.insert(string(h));
+    }
+    return members;
+}
+
+unsigned long elapsed_ms(chrono::steady_clock::time_point start) {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+}
+
+// Peer i has its own Inheritance(x_i, "mammal") link (plus the nodes) in a backend which answers
+// in delays[i] milliseconds.
+map<string, shared_ptr<RemoteAtomDBPeer>> build_slow_peers(const vector<unsigned int>& delays,
+                                                           vector<string>& link_handles) {
+    map<string, shared_ptr<RemoteAtomDBPeer>> peers;
+    for (unsigned int i = 0; i < delays.size(); i++) {
+        string uid = "slow_peer" + to_string(i);
+        auto backend = make_shared<SlowInMemoryDB>(uid + "_", delays[i]);
+        auto inheritance = new Node("Symbol", "Inheritance");
+        auto animal = new Node("Symbol", "\"animal_" + to_string(i) + "\"");
+        auto mammal = new Node("Symbol", "\"mammal\"");
+        backend->add_node(inheritance);
+        backend->add_node(animal);
+        backend->add_node(mammal);
+        auto link = new Link("Expression", {inheritance->handle(), animal->handle(), mammal->handle()});
+        link_handles.push_back(backend->add_link(link));
+        peers[uid] = make_shared<RemoteAtomDBPeer>(backend, nullptr, uid);
+    }
+    return peers;
+}
+}  // namespace
+
+TEST(RemoteAtomDBFanOutTest, ConcurrentPatternQuery) {
+    vector<string> link_handles;
+    auto db = make_shared<RemoteAtomDB>(build_slow_peers({300, 300, 300, 300, 300}, link_handles));
+
+    auto start = chrono::steady_clock::now();
+    auto result = db->query_for_pattern(inheritance_mammal_schema());
+    // Sequential calls would take 1500ms
+    EXPECT_LT(elapsed_ms(start), 1000u);
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(handle_set_members(result), set<string>(link_handles.begin(), link_handles.end()));
+    EXPECT_FALSE(result->is_partial());
+
+    auto stats = db->get_peer_latency_stats();
+    ASSERT_EQ(stats.size(), 5u);
+    for (const auto& [uid, peer_stats] : stats) {
+        EXPECT_EQ(peer_stats.calls, 1u) << uid;
+        EXPECT_EQ(peer_stats.timeouts, 0u) << uid;
+        EXPECT_GE(peer_stats.max_latency_us, 300000u) << uid;
+        EXPECT_EQ(peer_stats.max_latency_us, peer_stats.last_latency_us) << uid;
+    }
+    db->reset_peer_latency_stats();
+    EXPECT_EQ(db->get_peer_latency_stats()["slow_peer0"].calls, 0u);
+
+    // Sequential fan-out gives the same answer
+    db->set_parallel_fanout(false);
+    db->release_caches(inheritance_mammal_schema(), false, true);
+    result = db->query_for_pattern(inheritance_mammal_schema());
+    EXPECT_EQ(result->size(), 5u);
+}
+
+TEST(RemoteAtomDBFanOutTest, FirstHitWinsPointLookup) {
+    vector<string> link_handles;
+    // Only the fast peer has the link
+    auto db = make_shared<RemoteAtomDB>(build_slow_peers({2000, 2000, 10}, link_handles));
+
+    auto start = chrono::steady_clock::now();
+    auto atom = db->get_atom(link_handles[2]);
+    EXPECT_LT(elapsed_ms(start), 1000u);
+    ASSERT_NE(atom, nullptr);
+    EXPECT_EQ(atom->handle(), link_handles[2]);
+    EXPECT_EQ(db->get_peer_latency_stats()["slow_peer2"].calls, 1u);
+}
+
+TEST(RemoteAtomDBFanOutTest, BatchedGetAtoms) {
+    vector<string> link_handles;
+    auto db = make_shared<RemoteAtomDB>(build_slow_peers({10, 10, 10}, link_handles));
+
+    vector<string> handles = {link_handles[2], "00000000000000000000000000000000", link_handles[0]};
+    auto atoms = db->get_atoms(handles);
+    ASSERT_EQ(atoms.size(), 3u);
+    ASSERT_NE(atoms[0], nullptr);
+    EXPECT_EQ(atoms[0]->handle(), link_handles[2]);
+    EXPECT_EQ(atoms[1], nullptr);
+    ASSERT_NE(atoms[2], nullptr);
+    EXPECT_EQ(atoms[2]->handle(), link_handles[0]);
+    // One batched call per peer
+    for (const auto& [uid, peer_stats] : db->get_peer_latency_stats()) {
+        EXPECT_EQ(peer_stats.calls, 1u) << uid;
+    }
+}
+
+TEST(RemoteAtomDBFanOutTest, CountForPattern) {
+    vector<string> link_handles;
+    auto db = make_shared<RemoteAtomDB>(build_slow_peers({2000, 2000, 2000}, link_handles));
+
+    // Links are counted by the peers' backends without running (slow) pattern queries
+    auto start = chrono::steady_clock::now();
+    EXPECT_EQ(db->count_for_pattern(inheritance_mammal_schema()), 3u);
+    EXPECT_LT(elapsed_ms(start), 1000u);
+    for (const auto& [uid, peer_stats] : db->get_peer_latency_stats()) {
+        EXPECT_EQ(peer_stats.calls, 1u) << uid;
+    }
+}
+
+TEST(RemoteAtomDBFanOutTest, PeerTimeout) {
+    vector<string> link_handles;
+    auto db = make_shared<RemoteAtomDB>(build_slow_peers({10, 10000, 10}, link_handles));
+    db->set_peer_timeout(300);
+    EXPECT_EQ(db->get_peer_timeout(), 300u);
+
+    auto start = chrono::steady_clock::now();
+    auto result = db->query_for_pattern(inheritance_mammal_schema());
+    EXPECT_LT(elapsed_ms(start), 1500u);
+    // Slow peer is left out of the answer, which is flagged as partial
+    EXPECT_EQ(handle_set_members(result), set<string>({link_handles[0], link_handles[2]}));
+    EXPECT_TRUE(result->is_partial());
+
+    auto stats = db->get_peer_latency_stats();
+    EXPECT_EQ(stats["slow_peer0"].timeouts, 0u);
+    EXPECT_EQ(stats["slow_peer1"].timeouts, 1u);
+    EXPECT_EQ(stats["slow_peer2"].timeouts, 0u);
+
+    // Point lookups missing in every peer also give up on the slow one
+    EXPECT_EQ(db->get_atom("00000000000000000000000000000000"), nullptr);
+    EXPECT_EQ(db->get_peer_latency_stats()["slow_peer1"].timeouts, 2u);
+
+    // The slow peer has its own queue so it doesn't delay the calls to the other peers
+    for (unsigned int i = 0; i < 3; i++) {
+        start = chrono::steady_clock::now();
+        result = db->query_for_pattern(inheritance_mammal_schema());
+        EXPECT_LT(elapsed_ms(start), 1500u);
+        EXPECT_EQ(handle_set_members(result), set<string>({link_handles[0], link_handles[2]}));
+    }
+
+    // Destroying the RemoteAtomDB doesn't wait for the calls still running on the slow peer (only
+    // for the other peers to stop their cleanup threads)
+    start = chrono::steady_clock::now();
+    db.reset();
+    EXPECT_LT(elapsed_ms(start), 5000u);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
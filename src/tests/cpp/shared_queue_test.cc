@@ -1,7 +1,9 @@
 #include "AttentionBrokerServer.h"
+#include "Utils.h"
 #include "gtest/gtest.h"
 
 using namespace attention_broker;
+using namespace commons;
 
 class TestSharedQueue : public SharedQueue {
    public:
@@ -78,3 +80,25 @@ TEST(SharedQueueTest, basics) {
     unsigned long p2 = (unsigned long) q2.dequeue();
     EXPECT_EQ(p1, p2);
 }
+
+TEST(SharedQueueTest, wait) {
+    SharedQueue q;
+    StopWatch timer;
+
+    timer.start();
+    EXPECT_FALSE(q.wait(200));
+    timer.stop();
+    EXPECT_TRUE(timer.milliseconds() >= 200);
+
+    thread producer([&q]() {
+        Utils::sleep(100);
+        q.enqueue((void*) "1");
+    });
+    EXPECT_TRUE(q.wait(10000));
+    EXPECT_STREQ((char*) q.dequeue(), "1");
+    producer.join();
+
+    q.enqueue((void*) "2");
+    EXPECT_TRUE(q.wait(0));
+    EXPECT_STREQ((char*) q.dequeue(), "2");
+}
@@ -89,7 +89,17 @@ TEST(SystemParametersValidationTest, rejects_unsupported_schema_version) {
             "positive_importance_flag": false,
             "disregard_importance_flag": false,
             "unique_value_flag": false,
-            "count_flag": false
+            "count_flag": false,
+            "exists_flag": false,
+            "offset": 0,
+            "hash_join_flag": false,
+            "link_template_cache_refresh": false,
+            "link_template_cache_max_entry_size": 0,
+            "importance_streaming_flag": false,
+            "importance_chunk_size": 1000,
+            "cost_based_join_flag": false,
+            "explain_flag": false,
+            "chain_expansion_workers": 1
           }
         }
       }
@@ -107,6 +117,16 @@ TEST(SystemParametersValidationTest, rejects_unknown_parameter_key) {
             "disregard_importance_flag": false,
             "unique_value_flag": false,
             "count_flag": false,
+            "exists_flag": false,
+            "offset": 0,
+            "hash_join_flag": false,
+            "link_template_cache_refresh": false,
+            "link_template_cache_max_entry_size": 0,
+            "importance_streaming_flag": false,
+            "importance_chunk_size": 1000,
+            "cost_based_join_flag": false,
+            "explain_flag": false,
+            "chain_expansion_workers": 1,
             "unknown_param": true
           }
         }
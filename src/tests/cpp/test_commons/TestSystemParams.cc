@@ -26,7 +26,8 @@ const char kAgentsJson[] = R"({
         "use_link_template_cache": false,
         "populate_metta_mapping": false,
         "use_metta_as_query_tokens": false,
-        "allow_incomplete_chain_path": false
+        "allow_incomplete_chain_path": false,
+        "answer_format_version": 0
       }
     },
     "query": {
@@ -36,7 +37,17 @@ const char kAgentsJson[] = R"({
         "positive_importance_flag": false,
         "disregard_importance_flag": false,
         "unique_value_flag": false,
-        "count_flag": false
+        "count_flag": false,
+        "exists_flag": false,
+        "offset": 0,
+        "hash_join_flag": false,
+        "link_template_cache_refresh": false,
+        "link_template_cache_max_entry_size": 0,
+        "importance_streaming_flag": false,
+        "importance_chunk_size": 1000,
+        "cost_based_join_flag": false,
+        "explain_flag": false,
+        "chain_expansion_workers": 1
       }
     },
     "link_creation": {
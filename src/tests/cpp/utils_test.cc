@@ -128,6 +128,25 @@ TEST(LocalFileTestSuite, uint_rand) {
     EXPECT_THROW(Utils::uint_rand(2, 1), runtime_error);
 }
 
+TEST(LocalFileTestSuite, base64) {
+    EXPECT_EQ(Utils::base64_encode(""), "");
+    EXPECT_EQ(Utils::base64_encode("f"), "Zg==");
+    EXPECT_EQ(Utils::base64_encode("fo"), "Zm8=");
+    EXPECT_EQ(Utils::base64_encode("foo"), "Zm9v");
+    EXPECT_EQ(Utils::base64_encode("foobar"), "Zm9vYmFy");
+    for (unsigned int size = 0; size < 100; size++) {
+        string bytes;
+        for (unsigned int i = 0; i < size; i++) {
+            bytes.push_back((char) Utils::uint_rand(256));
+        }
+        EXPECT_EQ(Utils::base64_decode(Utils::base64_encode(bytes)), bytes);
+    }
+    EXPECT_THROW(Utils::base64_decode("Zm9"), runtime_error);
+    EXPECT_THROW(Utils::base64_decode("Zm9*"), runtime_error);
+    EXPECT_THROW(Utils::base64_decode("Zg==Zm9v"), runtime_error);
+    EXPECT_THROW(Utils::base64_decode("Z=g="), runtime_error);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     Utils::init_random(0);
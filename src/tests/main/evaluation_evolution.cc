@@ -174,7 +174,7 @@ static string answer_to_string_2(shared_ptr<QueryAnswer> answer) {
         string path = "";
         vector<string> path_link = {" -> ", " -> "};
         bool first = true;
-        for (string& handle : answer->get_path_vector(i)) {
+        for (string handle : answer->get_path_vector(i)) {
             auto link = db->get_link(handle);
             auto target1 = db->get_link(link->targets[1]);
             auto target2 = db->get_link(link->targets[2]);
@@ -204,7 +204,7 @@ static string answer_to_string_1(shared_ptr<QueryAnswer> answer) {
     string path = "";
     string path_link = " -> ";
     bool first = true;
-    for (string& handle : answer->get_path_vector(0)) {
+    for (string handle : answer->get_path_vector(0)) {
         auto link = db->get_link(handle);
         auto target1 = db->get_link(link->targets[1]);
         auto target2 = db->get_link(link->targets[2]);
@@ -350,7 +350,7 @@ static void compute_counts(const vector<vector<string>>& query_tokens,
                 Utils::sleep();
             } else {
                 d = 1;
-                for (string& h : query_answer->get_handles_vector()) {
+                for (string h : query_answer->get_handles_vector()) {
                     d *= get_strength(h);
                 }
                 handle = query_answer->get(target_element);
@@ -503,7 +503,7 @@ static bool build_and_predicate_link(shared_ptr<QueryAnswer> query_answer,
         add_and_predicate(predicate1, predicate2, context, link_created_flag);
     if ((link_created_flag) && (new_predicate != nullptr)) {
         double strength = 1;
-        for (string& h : query_answer->get_handles_vector()) {
+        for (string h : query_answer->get_handles_vector()) {
             strength *= get_strength(h);
         }
         add_or_update_link(
@@ -767,7 +767,7 @@ static bool build_evaluation_link(shared_ptr<QueryAnswer> query_answer,
     visited_at_least_one = true;
     visited.insert({predicate, concept_});
     double strength = 1;
-    for (string& h : query_answer->get_handles_vector()) {
+    for (string h : query_answer->get_handles_vector()) {
         strength *= get_strength(h);
     }
     bool link_created_flag;